@@ -0,0 +1,288 @@
+/***************************************************************************
+ *   Copyright (C) 2008-2011 LpzRobots development team                    *
+ *    Joerg Weider   <joergweide84 at aol dot com> (robot12)               *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *    Joern Hoffmann <jhoffmann at informatik dot uni-leipzig dot de       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "DenseGenome.h"
+
+#include <math.h>
+#include <algorithm>
+
+//ga_tools includes
+#include "GenPrototype.h"
+#include "Generation.h"
+#include "Individual.h"
+#include "Gen.h"
+#include "IFitnessStrategy.h"
+#include "SingletonIndividualFactory.h"
+#include "EliteSelectStrategy.h"
+
+DenseGenome::DenseGenome() {
+  // nothing
+}
+
+DenseGenome::DenseGenome(const std::vector<GenPrototype*>& prototypes, int capacity) {
+  DenseGenomeColumn column;
+
+  for(std::vector<GenPrototype*>::const_iterator iter = prototypes.begin(); iter != prototypes.end(); iter++) {
+    column.prototype = *iter;
+    column.mutationProbability = (*iter)->getMutationProbability();
+    column.fixMutationFactor = false;
+    column.mutationFactor = 0.0;
+    column.mean = 0.0;
+    column.deviation = 0.0;
+    m_columns.push_back(column);
+  }
+
+  m_numIndividuals = 0;
+  m_scratch = 0;
+  if(capacity>0)
+    m_values.reserve(capacity*m_columns.size());
+}
+
+DenseGenome::~DenseGenome() {
+  if(m_scratch!=0) {
+    // the genes of the scratch individual are not registered in the engine
+    for(int x=0;x<m_scratch->getSize();x++) {
+      delete m_scratch->getGen(x);
+    }
+    delete m_scratch;
+    m_scratch = 0;
+  }
+  m_scratchValues.clear();
+}
+
+void DenseGenome::setFixMutationFactor(int column, double factor) {
+  m_columns[column].fixMutationFactor = true;
+  m_columns[column].mutationFactor = factor;
+}
+
+int DenseGenome::addIndividual(void) {
+  m_values.resize((m_numIndividuals+1)*m_columns.size());
+  return m_numIndividuals++;
+}
+
+int DenseGenome::addRandomIndividual(void) {
+  int row = addIndividual();
+  double* values = getRow(row);
+  IValue* value;
+  TemplateValue<double>* tValue;
+
+  for(unsigned int x=0;x<m_columns.size();x++) {
+    value = m_columns[x].prototype->getRandomValue();
+    tValue = dynamic_cast<TemplateValue<double>* >(value);
+    values[x] = tValue!=0?tValue->getValue():0.0;
+    delete value;
+  }
+
+  return row;
+}
+
+void DenseGenome::resize(int size) {
+  m_values.resize(size*m_columns.size());
+  m_numIndividuals = size;
+}
+
+void DenseGenome::calcStatistics(void) {
+  int numGenes = m_columns.size();
+  std::vector<double> sum(numGenes,0.0);
+  std::vector<double> sum2(numGenes,0.0);
+  const double* values;
+  double diff;
+
+  if(m_numIndividuals==0)
+    return;
+
+  // the inner loops go over contiguous memory
+  for(int y=0;y<m_numIndividuals;y++) {
+    values = getRow(y);
+    for(int x=0;x<numGenes;x++)
+      sum[x] += values[x];
+  }
+  for(int x=0;x<numGenes;x++)
+    sum[x] /= (double)m_numIndividuals;
+
+  for(int y=0;y<m_numIndividuals;y++) {
+    values = getRow(y);
+    for(int x=0;x<numGenes;x++) {
+      diff = values[x] - sum[x];
+      sum2[x] += diff * diff;
+    }
+  }
+
+  for(int x=0;x<numGenes;x++) {
+    m_columns[x].mean = sum[x];
+    m_columns[x].deviation = m_numIndividuals>1?sqrt(sum2[x] / (double)(m_numIndividuals-1)):0.0;
+  }
+}
+
+bool DenseGenome::mutate(int row, RandGen* random) {
+  int numGenes = m_columns.size();
+  double* values = getRow(row);
+  const double* decision;
+  const double* sign;
+  bool mutated = false;
+  double factor;
+
+  // two random values per gene in one bulk: decision and sign of the mutation
+  m_random.resize(2*numGenes);
+  random->fillUniform(m_random.data(),2*numGenes);
+  decision = m_random.data();
+  sign = &m_random[numGenes];
+
+  for(int x=0;x<numGenes;x++) {
+    if(((int)(decision[x]*10000.0))%1000 < m_columns[x].mutationProbability) {
+      factor = m_columns[x].fixMutationFactor?m_columns[x].mutationFactor:m_columns[x].deviation;
+      values[x] += ((int)(sign[x]*10000.0))%2==0?-factor:factor;
+      mutated = true;
+    }
+  }
+
+  return mutated;
+}
+
+bool DenseGenome::crossover(int parent1, int parent2, int child, RandGen* random) {
+  int numGenes = m_columns.size();
+  const double* p1 = getRow(parent1);
+  const double* p2 = getRow(parent2);
+  double* values = getRow(child);
+
+  m_random.resize(numGenes);
+  random->fillUniform(m_random.data(),numGenes);
+  for(int x=0;x<numGenes;x++) {
+    values[x] = ((int)(m_random[x]*10000.0))%2==0?p1[x]:p2[x];
+  }
+
+  return mutate(child,random);
+}
+
+void DenseGenome::crossover(int size, RandGen* random, std::vector<int>* parents) {
+  int r1,r2;
+  int child;
+  int active = m_numIndividuals;
+
+  if(active<2)
+    return;
+
+  m_values.reserve(size*m_columns.size());
+  while(m_numIndividuals<size) {
+    r1 = ((int)(random->rand()*1000000.0))%active;
+    r2 = r1;
+    while(r1==r2)
+      r2 = ((int)(random->rand()*1000000.0))%active;
+
+    child = addIndividual();
+    crossover(r1,r2,child,random);
+    if(parents!=0) {
+      parents->push_back(r1);
+      parents->push_back(r2);
+    }
+  }
+}
+
+// helper for sorting the rows by fitness (order of the EliteSelectStrategy, equal values keep their order)
+struct DenseGenomeFitnessLess {
+  const std::vector<double>& fitness;
+  DenseGenomeFitnessLess(const std::vector<double>& fitness) : fitness(fitness) {}
+  bool operator()(int a, int b)const {
+    if(EliteSelectStrategy::isBetter(fitness[a],fitness[b])) return true;
+    if(EliteSelectStrategy::isBetter(fitness[b],fitness[a])) return false;
+    return a<b;
+  }
+};
+
+void DenseGenome::selectElite(std::vector<double>& fitness, int numSurvivors) {
+  int numGenes = m_columns.size();
+  std::vector<int> order(m_numIndividuals);
+  std::vector<double> values;
+  std::vector<double> newFitness;
+
+  if(numSurvivors>=m_numIndividuals)
+    numSurvivors = m_numIndividuals;
+
+  for(int x=0;x<m_numIndividuals;x++)
+    order[x] = x;
+  std::partial_sort(order.begin(),order.begin()+numSurvivors,order.end(),DenseGenomeFitnessLess(fitness));
+
+  values.resize(numSurvivors*numGenes);
+  newFitness.resize(numSurvivors);
+  for(int x=0;x<numSurvivors;x++) {
+    std::copy(getRow(order[x]),getRow(order[x])+numGenes,&values[x*numGenes]);
+    newFitness[x] = fitness[order[x]];
+  }
+
+  m_values.swap(values);
+  m_numIndividuals = numSurvivors;
+  fitness.swap(newFitness);
+}
+
+double DenseGenome::getFitness(int row, IFitnessStrategy* strategy) {
+  const double* values = getRow(row);
+  Gen* gen;
+
+  if(m_scratch==0) {
+    m_scratch = new Individual("dense",-1);
+    for(unsigned int x=0;x<m_columns.size();x++) {
+      gen = new Gen(m_columns[x].prototype,-1);
+      m_scratchValues.push_back(new TemplateValue<double>(0.0));
+      gen->setValue(m_scratchValues[x]);
+      m_scratch->addGen(gen);
+    }
+  }
+
+  for(unsigned int x=0;x<m_columns.size();x++)
+    m_scratchValues[x]->setValue(values[x]);
+
+  return strategy->getFitness(m_scratch);
+}
+
+void DenseGenome::getFitness(IFitnessStrategy* strategy, std::vector<double>& fitness) {
+  fitness.resize(m_numIndividuals);
+  for(int x=0;x<m_numIndividuals;x++)
+    fitness[x] = getFitness(x,strategy);
+}
+
+void DenseGenome::loadGeneration(const Generation* generation) {
+  const std::vector<Individual*>& individuals = generation->getAllIndividual();
+
+  resize(individuals.size());
+  for(unsigned int x=0;x<individuals.size();x++)
+    loadIndividual(x,individuals[x]);
+}
+
+void DenseGenome::loadIndividual(int row, const Individual* individual) {
+  double* values = getRow(row);
+  Gen* gen;
+  TemplateValue<double>* tValue;
+
+  for(unsigned int x=0;x<m_columns.size();x++) {
+    gen = individual->getGen(x);
+    tValue = gen!=0?dynamic_cast<TemplateValue<double>* >(gen->getValue()):0;
+    values[x] = tValue!=0?tValue->getValue():0.0;
+  }
+}
+
+Individual* DenseGenome::createIndividual(int row, Individual* parent1, Individual* parent2)const {
+  return SingletonIndividualFactory::getInstance()->createIndividual(getRow(row),m_columns.size(),parent1,parent2);
+}
@@ -0,0 +1,270 @@
+/***************************************************************************
+ *   Copyright (C) 2008-2011 LpzRobots development team                    *
+ *    Joerg Weider   <joergweide84 at aol dot com> (robot12)               *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *    Joern Hoffmann <jhoffmann at informatik dot uni-leipzig dot de       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef DENSEGENOME_H_
+#define DENSEGENOME_H_
+
+// standard includes
+#include <vector>
+#include <string>
+#include <selforg/randomgenerator.h>
+
+// forward declarations
+class GenPrototype;
+class Generation;
+class Individual;
+class Gen;
+class IFitnessStrategy;
+
+// gen. alg. includes
+#include "TemplateValue.h"
+
+/**
+ * meta data of one column of the DenseGenome (one GenPrototype)
+ */
+struct DenseGenomeColumn {
+	GenPrototype* prototype;		///< the prototype of the genes in this column
+	int mutationProbability;		///< mutation probability in 1/1000 (from the prototype)
+	bool fixMutationFactor;			///< use mutationFactor instead of the deviation of the column
+	double mutationFactor;			///< the size of a mutation step
+	double mean;					///< average of the column (see calcStatistics)
+	double deviation;				///< standard deviation of the column (see calcStatistics)
+};
+
+/**
+ * The DenseGenome class
+ *   This class stores the gene values (double) of a whole population in one
+ *   contiguous matrix (one row per individual, one column per GenPrototype).
+ *   Mutation, crossover and selection work directly on the rows without
+ *   creating Gen or IValue objects. It does the same like the
+ *   SingletonIndividualFactory with the ValueMutationStrategy and the
+ *   StandartMutationFactorStrategy (uniform crossover, mutation by +/- the
+ *   standard deviation of the gene in the old generation).
+ *
+ *   As adapter to the rest of the gen. alg. it can load a Generation, create
+ *   registered individuals from rows and calculate the fitness of a row with
+ *   every existing IFitnessStrategy (through one reused individual).
+ */
+class DenseGenome {
+public:
+	/**
+	 * constructor
+	 * creates an empty population with one column for every GenPrototype
+	 * @param prototypes (const vector<GenPrototype*>&) the prototypes (normally SingletonGenEngine::getSetOfGenPrototyps())
+	 * @param capacity (int) number of rows which are reserved
+	 */
+	DenseGenome(const std::vector<GenPrototype*>& prototypes, int capacity = 0);
+
+	/**
+	 * destructor
+	 */
+	virtual ~DenseGenome();
+
+	/**
+	 * [inline], [const]
+	 * returns the number of individuals (rows)
+	 * @return (int) the number
+	 */
+	inline int getNumIndividuals(void)const {return m_numIndividuals;}
+
+	/**
+	 * [inline], [const]
+	 * returns the number of genes per individual (columns)
+	 * @return (int) the number
+	 */
+	inline int getNumGenes(void)const {return m_columns.size();}
+
+	/**
+	 * [inline]
+	 * returns the gene values of one individual
+	 * @param row (int) the individual
+	 * @return (double*) pointer to getNumGenes() values
+	 */
+	inline double* getRow(int row) {return &m_values[row*m_columns.size()];}
+
+	/**
+	 * [inline], [const]
+	 * returns the gene values of one individual
+	 * @param row (int) the individual
+	 * @return (const double*) pointer to getNumGenes() values
+	 */
+	inline const double* getRow(int row)const {return &m_values[row*m_columns.size()];}
+
+	/**
+	 * [inline]
+	 * returns the meta data of one column
+	 * @param column (int) the column
+	 * @return (DenseGenomeColumn&) the meta data
+	 */
+	inline DenseGenomeColumn& getColumn(int column) {return m_columns[column];}
+
+	/**
+	 * sets a fix mutation factor for one column (like the FixMutationFactorStrategy)
+	 * @param column (int) the column
+	 * @param factor (double) the mutation factor
+	 */
+	void setFixMutationFactor(int column, double factor);
+
+	/**
+	 * adds a new individual (uninitialised values)
+	 * @return (int) the row of the new individual
+	 */
+	int addIndividual(void);
+
+	/**
+	 * adds a new individual with random values (uses the random strategy of the prototypes)
+	 * @return (int) the row of the new individual
+	 */
+	int addRandomIndividual(void);
+
+	/**
+	 * changes the number of individuals (the first rows are kept)
+	 * @param size (int) the new number of individuals
+	 */
+	void resize(int size);
+
+	/**
+	 * calculates the average and the standard deviation of all columns in one pass
+	 */
+	void calcStatistics(void);
+
+	/**
+	 * mutates one individual: every gene is mutated with the mutation probability
+	 * of its column by +/- the mutation factor of the column.
+	 * The random values for all genes are drawn at once (RandGen::fillUniform).
+	 * Call calcStatistics before, if there are columns without fix mutation factor.
+	 * @param row (int) the individual
+	 * @param random (RandGen*) random generator
+	 * @return (bool) true if at least one gene was mutated
+	 */
+	bool mutate(int row, RandGen* random);
+
+	/**
+	 * creates a child by uniform crossover of two parents and mutation
+	 * (see mutate, the statistics must be up to date)
+	 * @param parent1 (int) row of the first parent
+	 * @param parent2 (int) row of the second parent
+	 * @param child (int) row of the child
+	 * @param random (RandGen*) random generator
+	 * @return (bool) true if the child is mutated
+	 */
+	bool crossover(int parent1, int parent2, int child, RandGen* random);
+
+	/**
+	 * fills the population up to size like Generation::crossover does it.
+	 * The parents are randomly taken from the existing rows.
+	 * @param size (int) the new number of individuals
+	 * @param random (RandGen*) random generator
+	 * @param parents (vector<int>*) if not zero the two parents of every new row are stored here
+	 */
+	void crossover(int size, RandGen* random, std::vector<int>* parents = 0);
+
+	/**
+	 * keeps only the best individuals (fitness closest to zero, like the EliteSelectStrategy).
+	 * The survivors are moved to the first rows (ordered by fitness).
+	 * @param fitness (vector<double>&) fitness of every row, will be reordered in the same way
+	 * @param numSurvivors (int) number of individuals which survive
+	 */
+	void selectElite(std::vector<double>& fitness, int numSurvivors);
+
+	/**
+	 * calculates the fitness of one row with a normal fitness strategy.
+	 * For this the values are copied into a reused individual (which isn't registered in the engine).
+	 * @param row (int) the individual
+	 * @param strategy (IFitnessStrategy*) the strategy
+	 * @return (double) the fitness
+	 */
+	double getFitness(int row, IFitnessStrategy* strategy);
+
+	/**
+	 * calculates the fitness of all rows
+	 * @param strategy (IFitnessStrategy*) the strategy
+	 * @param fitness (vector<double>&) the result
+	 */
+	void getFitness(IFitnessStrategy* strategy, std::vector<double>& fitness);
+
+	/**
+	 * replaces the population by the values of the individuals in a generation.
+	 * Genes which aren't TemplateValue<double> are set to zero.
+	 * @param generation (const Generation*) the generation
+	 */
+	void loadGeneration(const Generation* generation);
+
+	/**
+	 * copies the values of an individual into a row
+	 * @param row (int) the row
+	 * @param individual (const Individual*) the individual
+	 */
+	void loadIndividual(int row, const Individual* individual);
+
+	/**
+	 * creates a new individual in the engine (with genes in the actual generation) from one row.
+	 * @param row (int) the row
+	 * @param parent1 (Individual*) parent 1 or zero
+	 * @param parent2 (Individual*) parent 2 or zero
+	 * @return (Individual*) the new individual
+	 */
+	Individual* createIndividual(int row, Individual* parent1 = 0, Individual* parent2 = 0)const;
+
+protected:
+	/**
+	 * the meta data for every column
+	 */
+	std::vector<DenseGenomeColumn> m_columns;
+
+	/**
+	 * all values (row after row)
+	 */
+	std::vector<double> m_values;
+
+	/**
+	 * the number of rows
+	 */
+	int m_numIndividuals;
+
+	/**
+	 * the individual which is used for the fitness strategies (created on demand)
+	 */
+	Individual* m_scratch;
+
+	/**
+	 * the values of m_scratch
+	 */
+	std::vector<TemplateValue<double>*> m_scratchValues;
+
+	/**
+	 * buffer for the random values of mutate and crossover
+	 */
+	std::vector<double> m_random;
+
+private:
+	/**
+	 * disable the default constructor
+	 */
+	DenseGenome();
+};
+
+#endif /* DENSEGENOME_H_ */
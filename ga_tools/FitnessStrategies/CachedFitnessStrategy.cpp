@@ -0,0 +1,406 @@
+/***************************************************************************
+ *   Copyright (C) 2008-2011 LpzRobots development team                    *
+ *    Joerg Weider   <joergweide84 at aol dot com> (robot12)               *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *    Joern Hoffmann <jhoffmann at informatik dot uni-leipzig dot de       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "CachedFitnessStrategy.h"
+
+#include <math.h>
+#include <limits.h>
+#include <string>
+#include <algorithm>
+
+#include "Individual.h"
+#include "Gen.h"
+#include "IValue.h"
+#include "TemplateValue.h"
+#include "EliteSelectStrategy.h"
+
+size_t CachedFitnessKeyHash::operator()(const std::vector<long long>& key)const {
+  unsigned long long hash = 14695981039346656037ULL;   // FNV-1a
+
+  for(unsigned int x=0;x<key.size();x++) {
+    hash ^= (unsigned long long)key[x];
+    hash *= 1099511628211ULL;
+  }
+
+  return (size_t)hash;
+}
+
+// helper for ranking the predictions like the EliteSelectStrategy
+static bool predictionLess(const std::pair<double,int>& a, const std::pair<double,int>& b) {
+  if(EliteSelectStrategy::isBetter(a.first,b.first)) return true;
+  if(EliteSelectStrategy::isBetter(b.first,a.first)) return false;
+  return a.second<b.second;
+}
+
+CachedFitnessStrategy::CachedFitnessStrategy() {
+  // nothing
+}
+
+CachedFitnessStrategy::CachedFitnessStrategy(IFitnessStrategy* strategy, double quantum) : Inspectable("FitnessCache") {
+  m_strategy = strategy;
+  m_quantum = quantum;
+  m_k = 0;
+  m_screenFraction = 1.0;
+  m_minSamples = 0;
+  m_maxSamples = 0;
+  m_sampleSize = -1;
+  m_nextSample = 0;
+
+  m_requests = 0.0;
+  m_hits = 0.0;
+  m_evaluations = 0.0;
+  m_predictions = 0.0;
+  m_saved = 0.0;
+  m_hitRate = 0.0;
+  m_cacheSize = 0.0;
+
+  pthread_mutex_init(&m_mutex,NULL);
+
+  addInspectableValue("REQUESTS",&m_requests,"number of fitness requests");
+  addInspectableValue("HITS",&m_hits,"requests answered by the cache");
+  addInspectableValue("EVALUATIONS",&m_evaluations,"evaluations of the other strategy");
+  addInspectableValue("PREDICTIONS",&m_predictions,"requests answered by the surrogate");
+  addInspectableValue("SAVED",&m_saved,"saved evaluations (hits + predictions)");
+  addInspectableValue("HITRATE",&m_hitRate,"hits / requests");
+  addInspectableValue("CACHESIZE",&m_cacheSize,"number of stored genomes");
+}
+
+CachedFitnessStrategy::~CachedFitnessStrategy() {
+  pthread_mutex_destroy(&m_mutex);
+  m_strategy = 0;
+}
+
+void CachedFitnessStrategy::setSurrogate(int k, double screenFraction, int minSamples, int maxSamples) {
+  pthread_mutex_lock(&m_mutex);
+  m_k = k>0?k:0;
+  m_screenFraction = screenFraction>0.0?std::min(screenFraction,1.0):1.0;
+  m_minSamples = std::max(minSamples,m_k);
+  m_maxSamples = maxSamples;
+  pthread_mutex_unlock(&m_mutex);
+}
+
+double CachedFitnessStrategy::getFitness(const Individual* individual) {
+  std::vector<double> genes;
+  std::vector<long long> key;
+  double fitness;
+
+  getGenes(individual,genes);
+  getKey(genes,key);
+
+  pthread_mutex_lock(&m_mutex);
+  m_requests++;
+  if(lookup(key,fitness)) {
+    m_hits++;
+    m_saved++;
+    updateStatistics();
+    pthread_mutex_unlock(&m_mutex);
+    return fitness;
+  }
+  pthread_mutex_unlock(&m_mutex);
+
+  fitness = m_strategy->getFitness(individual);
+
+  pthread_mutex_lock(&m_mutex);
+  m_evaluations++;
+  insert(key,genes,fitness);
+  updateStatistics();
+  pthread_mutex_unlock(&m_mutex);
+
+  return fitness;
+}
+
+void CachedFitnessStrategy::getFitnessBatch(const std::vector<const Individual*>& individuals, std::vector<double>& fitness) {
+  int num = individuals.size();
+  std::vector<std::vector<double> > genes(num);
+  std::vector<std::vector<long long> > keys(num);
+  std::vector<int> source(num,-1);                 // -1: known, otherwise index of the individual which is evaluated
+  std::unordered_map<std::vector<long long>,int,CachedFitnessKeyHash> firstMiss;
+  std::vector<int> misses;
+  std::vector<std::pair<double,int> > predictions;
+  std::vector<const Individual*> batch;
+  std::vector<int> batchIndex;
+  std::vector<double> results;
+  int numEval;
+
+  fitness.resize(num);
+  for(int x=0;x<num;x++) {
+    getGenes(individuals[x],genes[x]);
+    getKey(genes[x],keys[x]);
+  }
+
+  pthread_mutex_lock(&m_mutex);
+  m_requests += num;
+  m_predicted.clear();
+  for(int x=0;x<num;x++) {
+    if(lookup(keys[x],fitness[x])) {
+      m_hits++;
+      m_saved++;
+      continue;
+    }
+    // same genome twice in the batch -> evaluate only once
+    std::unordered_map<std::vector<long long>,int,CachedFitnessKeyHash>::iterator iter = firstMiss.find(keys[x]);
+    if(iter!=firstMiss.end()) {
+      source[x] = iter->second;
+      m_hits++;
+      m_saved++;
+      continue;
+    }
+    firstMiss[keys[x]] = x;
+    source[x] = x;
+    misses.push_back(x);
+  }
+
+  // pre-screen the misses with the surrogate (the best ones in the order of the select are evaluated)
+  numEval = misses.size();
+  if(m_k>0 && (int)m_sampleFitness.size()>=m_minSamples && numEval>1) {
+    for(unsigned int x=0;x<misses.size();x++)
+      predictions.push_back(std::make_pair(predict(genes[misses[x]]),misses[x]));
+    std::sort(predictions.begin(),predictions.end(),predictionLess);
+    numEval = (int)ceil(m_screenFraction*(double)misses.size());
+    for(unsigned int x=numEval;x<predictions.size();x++) {
+      fitness[predictions[x].second] = predictions[x].first;
+      source[predictions[x].second] = -1;
+      m_predicted.insert(individuals[predictions[x].second]);
+      m_predictions++;
+      m_saved++;
+    }
+    for(int x=0;x<numEval;x++)
+      misses[x] = predictions[x].second;
+    misses.resize(numEval);
+  }
+  pthread_mutex_unlock(&m_mutex);
+
+  // evaluate the rest in one batch
+  for(unsigned int x=0;x<misses.size();x++)
+    batch.push_back(individuals[misses[x]]);
+  if(batch.size()>0)
+    m_strategy->getFitnessBatch(batch,results);
+
+  pthread_mutex_lock(&m_mutex);
+  for(unsigned int x=0;x<misses.size();x++) {
+    fitness[misses[x]] = results[x];
+    insert(keys[misses[x]],genes[misses[x]],results[x]);
+  }
+  m_evaluations += misses.size();
+  // copy the values for the duplicates (predicted or evaluated)
+  for(int x=0;x<num;x++) {
+    if(source[x]>=0 && source[x]!=x) {
+      fitness[x] = fitness[source[x]];
+      if(m_predicted.count(individuals[source[x]])>0)
+        m_predicted.insert(individuals[x]);
+    }
+  }
+  updateStatistics();
+  pthread_mutex_unlock(&m_mutex);
+}
+
+bool CachedFitnessStrategy::submit(Individual* individual) {
+  Pending pending;
+  double fitness;
+
+  getGenes(individual,pending.genes);
+  getKey(pending.genes,pending.key);
+
+  pthread_mutex_lock(&m_mutex);
+  if(lookup(pending.key,fitness)) {
+    m_requests++;
+    m_hits++;
+    m_saved++;
+    updateStatistics();
+    pthread_mutex_unlock(&m_mutex);
+    individual->setFitness(fitness);
+    return true;
+  }
+  pthread_mutex_unlock(&m_mutex);
+
+  // otherwise the request is counted by getFitnessBatch
+  if(!m_strategy->submit(individual))
+    return false;
+
+  pending.individual = individual;
+  pthread_mutex_lock(&m_mutex);
+  m_requests++;
+  m_pending.push_back(pending);
+  pthread_mutex_unlock(&m_mutex);
+  return true;
+}
+
+int CachedFitnessStrategy::collect(void) {
+  int num = m_strategy->collect();
+
+  pthread_mutex_lock(&m_mutex);
+  for(std::vector<Pending>::iterator iter = m_pending.begin(); iter != m_pending.end(); iter++) {
+    if(!iter->individual->isFitnessCalculated())
+      continue;
+    m_evaluations++;
+    insert(iter->key,iter->genes,iter->individual->getFitness());
+  }
+  m_pending.clear();
+  updateStatistics();
+  pthread_mutex_unlock(&m_mutex);
+
+  return num;
+}
+
+bool CachedFitnessStrategy::isPredicted(const Individual* individual) {
+  bool result;
+
+  pthread_mutex_lock(&m_mutex);
+  result = m_predicted.count(individual)>0;
+  pthread_mutex_unlock(&m_mutex);
+
+  return result;
+}
+
+double CachedFitnessStrategy::predictFitness(const Individual* individual) {
+  std::vector<double> genes;
+  double result;
+
+  getGenes(individual,genes);
+
+  pthread_mutex_lock(&m_mutex);
+  result = predict(genes);
+  pthread_mutex_unlock(&m_mutex);
+
+  return result;
+}
+
+void CachedFitnessStrategy::clear(void) {
+  pthread_mutex_lock(&m_mutex);
+  m_cache.clear();
+  m_predicted.clear();
+  m_samples.clear();
+  m_sampleFitness.clear();
+  m_nextSample = 0;
+  updateStatistics();
+  pthread_mutex_unlock(&m_mutex);
+}
+
+void CachedFitnessStrategy::getGenes(const Individual* individual, std::vector<double>& genes)const {
+  int num = individual->getSize();
+  TemplateValue<double>* tValue;
+
+  genes.resize(num);
+  for(int x=0;x<num;x++) {
+    tValue = dynamic_cast<TemplateValue<double>* >(individual->getGen(x)->getValue());
+    genes[x] = tValue!=0?tValue->getValue():0.0;
+  }
+}
+
+void CachedFitnessStrategy::getKey(const std::vector<double>& genes, std::vector<long long>& key)const {
+  union { double d; long long l; } exact;
+  double quantised;
+
+  key.resize(genes.size());
+  for(unsigned int x=0;x<genes.size();x++) {
+    if(m_quantum>0.0) {
+      quantised = floor(genes[x]/m_quantum + 0.5);
+      // clamp before the conversion (out of range and NaN are undefined)
+      if(quantised!=quantised)
+        key[x] = LLONG_MIN;
+      else if(quantised<-9.0e18)
+        key[x] = -9000000000000000000LL;
+      else if(quantised>9.0e18)
+        key[x] = 9000000000000000000LL;
+      else
+        key[x] = (long long)quantised;
+    }
+    else {
+      exact.d = genes[x]==0.0?0.0:genes[x];   // -0.0 == 0.0
+      key[x] = exact.l;
+    }
+  }
+}
+
+bool CachedFitnessStrategy::lookup(const std::vector<long long>& key, double& fitness)const {
+  std::unordered_map<std::vector<long long>,double,CachedFitnessKeyHash>::const_iterator iter = m_cache.find(key);
+
+  if(iter==m_cache.end())
+    return false;
+
+  fitness = iter->second;
+  return true;
+}
+
+void CachedFitnessStrategy::insert(const std::vector<long long>& key, const std::vector<double>& genes, double fitness) {
+  m_cache[key] = fitness;
+
+  if(m_k<=0)
+    return;
+
+  if(m_sampleSize<0)
+    m_sampleSize = genes.size();
+  if((int)genes.size()!=m_sampleSize)
+    return;
+
+  if(m_maxSamples>0 && (int)m_sampleFitness.size()>=m_maxSamples) {
+    std::copy(genes.begin(),genes.end(),m_samples.begin()+m_nextSample*m_sampleSize);
+    m_sampleFitness[m_nextSample] = fitness;
+    m_nextSample = (m_nextSample+1)%m_maxSamples;
+  }
+  else {
+    m_samples.insert(m_samples.end(),genes.begin(),genes.end());
+    m_sampleFitness.push_back(fitness);
+  }
+}
+
+double CachedFitnessStrategy::predict(const std::vector<double>& genes)const {
+  int num = m_sampleFitness.size();
+  int k = std::min(m_k>0?m_k:1,num);
+  std::vector<std::pair<double,int> > distances(num);
+  const double* sample;
+  double dist, diff, weight, sumWeight = 0.0, sum = 0.0;
+
+  if(num==0 || (int)genes.size()!=m_sampleSize)
+    return 0.0;
+
+  for(int x=0;x<num;x++) {
+    sample = &m_samples[x*m_sampleSize];
+    dist = 0.0;
+    for(int y=0;y<m_sampleSize;y++) {
+      diff = sample[y] - genes[y];
+      dist += diff * diff;
+    }
+    distances[x] = std::make_pair(dist,x);
+  }
+  std::partial_sort(distances.begin(),distances.begin()+k,distances.end());
+
+  // inverse distance weighting of the k nearest neighbours
+  for(int x=0;x<k;x++) {
+    if(distances[x].first<=0.0)
+      return m_sampleFitness[distances[x].second];
+    weight = 1.0 / sqrt(distances[x].first);
+    sum += weight * m_sampleFitness[distances[x].second];
+    sumWeight += weight;
+  }
+
+  return sum / sumWeight;
+}
+
+void CachedFitnessStrategy::updateStatistics(void) {
+  m_hitRate = m_requests>0.0?m_hits/m_requests:0.0;
+  m_cacheSize = (double)m_cache.size();
+}
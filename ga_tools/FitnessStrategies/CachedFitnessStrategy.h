@@ -0,0 +1,296 @@
+/***************************************************************************
+ *   Copyright (C) 2008-2011 LpzRobots development team                    *
+ *    Joerg Weider   <joergweide84 at aol dot com> (robot12)               *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *    Joern Hoffmann <jhoffmann at informatik dot uni-leipzig dot de       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef CACHEDFITNESSSTRATEGY_H_
+#define CACHEDFITNESSSTRATEGY_H_
+
+// standard includes
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <pthread.h>
+#include <selforg/inspectable.h>
+
+//forward declaration
+class Individual;
+
+//ga_tools includes
+#include "IFitnessStrategy.h"
+
+/**
+ * hash of the quantised genes (key of the CachedFitnessStrategy)
+ */
+struct CachedFitnessKeyHash {
+	size_t operator()(const std::vector<long long>& key)const;
+};
+
+/**
+ * This fitness strategy remembers the fitness values of an other strategy.
+ * The genes of an individual are quantised (by quantum) and hashed, so an
+ * individual with the same (or nearly the same) genes as one which was
+ * evaluated before gets the stored value without a new evaluation.
+ *
+ * Optional a k-nearest-neighbour surrogate over all evaluated genomes can
+ * pre-screen the individuals of a batch (getFitnessBatch): only the most
+ * promising part (screenFraction, ranked like the EliteSelectStrategy) is
+ * evaluated by the other strategy, the rest gets the predicted fitness.
+ * Predicted values are never stored in the cache or used as samples, and the
+ * engine marks these individuals (see isPredicted, Individual::isFitnessPredicted).
+ *
+ * Place this strategy outside of a ParallelFitnessStrategy, the misses of a
+ * batch are given to the other strategy as one batch and submitted individuals
+ * (see submit) are forwarded to it.
+ * The statistics are available as inspectable values (HITS, MISSES, SAVED, HITRATE, ...).
+ */
+class CachedFitnessStrategy : public IFitnessStrategy, public Inspectable {
+public:
+	/**
+	 * constructor
+	 * @param strategy (IFitnessStrategy*) the strategy which calculates the real fitness
+	 * @param quantum (double) the resolution of the genes for the cache key (0 means exact values)
+	 */
+	CachedFitnessStrategy(IFitnessStrategy* strategy, double quantum = 0.0);
+
+	/**
+	 * default destructor
+	 */
+	virtual ~CachedFitnessStrategy();
+
+	/**
+	 * enables the k-nearest-neighbour surrogate for getFitnessBatch.
+	 * @param k (int) number of neighbours (0 disables the surrogate)
+	 * @param screenFraction (double) part of the missed individuals of a batch which are really evaluated (0..1]
+	 * @param minSamples (int) the surrogate is used first if so many genomes are evaluated
+	 * @param maxSamples (int) maximal number of genomes in the surrogate (oldest are replaced)
+	 */
+	void setSurrogate(int k, double screenFraction = 0.5, int minSamples = 50, int maxSamples = 5000);
+
+	/**
+	 * returns the fitness from the cache or from the other strategy
+	 * @param individual (const Individual*) calculate the fitness for this individual
+	 * @return (double) The fitness value
+	 */
+	virtual double getFitness(const Individual* individual);
+
+	/**
+	 * answers the hits from the cache, screens the misses with the surrogate and
+	 * evaluates the promising ones with the other strategy in one batch.
+	 * @param individuals (const vector<const Individual*>&) calculate the fitness for these individuals
+	 * @param fitness (vector<double>&) the resulting fitness values
+	 */
+	virtual void getFitnessBatch(const std::vector<const Individual*>& individuals, std::vector<double>& fitness);
+
+	/**
+	 * answers a hit directly, otherwise the individual is forwarded to the other strategy
+	 * (if it is asynchronous). The result is stored by collect().
+	 * @param individual (Individual*) the individual which should be evaluated
+	 * @return (bool) true if the individual got its fitness or is evaluated in the background
+	 */
+	virtual bool submit(Individual* individual);
+
+	/**
+	 * collects the submitted individuals from the other strategy and stores their fitness.
+	 * @return (int) number of individuals which got a fitness value
+	 */
+	virtual int collect(void);
+
+	/**
+	 * returns true if the individual got a predicted fitness in the last getFitnessBatch
+	 * @param individual (const Individual*) the individual
+	 * @return (bool) true if the fitness is a prediction of the surrogate
+	 */
+	virtual bool isPredicted(const Individual* individual);
+
+	/**
+	 * predicts the fitness of an individual with the surrogate (no evaluation)
+	 * @param individual (const Individual*) the individual
+	 * @return (double) the predicted fitness (0 if there are no samples)
+	 */
+	double predictFitness(const Individual* individual);
+
+	/**
+	 * removes all stored values and samples (the statistics are kept)
+	 */
+	void clear(void);
+
+	/**
+	 * [inline], [const]
+	 * @return (int) number of answers from the cache
+	 */
+	inline int getNumHits(void)const {return (int)m_hits;}
+
+	/**
+	 * [inline], [const]
+	 * @return (int) number of evaluations by the other strategy
+	 */
+	inline int getNumEvaluations(void)const {return (int)m_evaluations;}
+
+	/**
+	 * [inline], [const]
+	 * @return (int) number of answers from the surrogate
+	 */
+	inline int getNumPredictions(void)const {return (int)m_predictions;}
+
+	/**
+	 * [inline], [const]
+	 * @return (int) number of saved evaluations (hits + predictions)
+	 */
+	inline int getNumSaved(void)const {return (int)m_saved;}
+
+	/**
+	 * [inline], [const]
+	 * @return (double) part of the requests which are answered by the cache
+	 */
+	inline double getHitRate(void)const {return m_hitRate;}
+
+protected:
+	/**
+	 * an individual which is submitted to the other strategy
+	 */
+	struct Pending {
+		Individual* individual;			///< the individual
+		std::vector<long long> key;		///< the quantised genes
+		std::vector<double> genes;		///< the genes
+	};
+
+	/**
+	 * reads the gene values of an individual (non double genes are zero)
+	 */
+	void getGenes(const Individual* individual, std::vector<double>& genes)const;
+
+	/**
+	 * quantises the genes (the key of the cache)
+	 */
+	void getKey(const std::vector<double>& genes, std::vector<long long>& key)const;
+
+	/**
+	 * looks for a stored value (without locking)
+	 * @return (bool) true if found
+	 */
+	bool lookup(const std::vector<long long>& key, double& fitness)const;
+
+	/**
+	 * stores a value in the cache and the surrogate (without locking)
+	 */
+	void insert(const std::vector<long long>& key, const std::vector<double>& genes, double fitness);
+
+	/**
+	 * the surrogate prediction (without locking)
+	 */
+	double predict(const std::vector<double>& genes)const;
+
+	/**
+	 * updates the derived statistics
+	 */
+	void updateStatistics(void);
+
+	/**
+	 * the other strategy
+	 */
+	IFitnessStrategy* m_strategy;
+
+	/**
+	 * resolution of the genes
+	 */
+	double m_quantum;
+
+	/**
+	 * the cache (quantised genes -> fitness)
+	 */
+	std::unordered_map<std::vector<long long>,double,CachedFitnessKeyHash> m_cache;
+
+	/**
+	 * the individuals which got a predicted fitness in the last batch
+	 */
+	std::unordered_set<const Individual*> m_predicted;
+
+	/**
+	 * the submitted individuals which are not collected yet
+	 */
+	std::vector<Pending> m_pending;
+
+	/**
+	 * number of neighbours of the surrogate (0 = disabled)
+	 */
+	int m_k;
+
+	/**
+	 * part of the misses which is evaluated
+	 */
+	double m_screenFraction;
+
+	/**
+	 * minimal number of samples for the surrogate
+	 */
+	int m_minSamples;
+
+	/**
+	 * maximal number of samples for the surrogate
+	 */
+	int m_maxSamples;
+
+	/**
+	 * the genes of the evaluated individuals (contiguous, one row per sample)
+	 */
+	std::vector<double> m_samples;
+
+	/**
+	 * the fitness of the samples
+	 */
+	std::vector<double> m_sampleFitness;
+
+	/**
+	 * number of genes per sample
+	 */
+	int m_sampleSize;
+
+	/**
+	 * the next sample which is replaced if m_maxSamples is reached
+	 */
+	int m_nextSample;
+
+	/**
+	 * protects the cache (getFitness can be called from more threads)
+	 */
+	pthread_mutex_t m_mutex;
+
+	// statistics (as double for the inspectable interface)
+	double m_requests;
+	double m_hits;
+	double m_evaluations;
+	double m_predictions;
+	double m_saved;
+	double m_hitRate;
+	double m_cacheSize;
+
+private:
+	/**
+	 * disable the default constructor
+	 */
+	CachedFitnessStrategy();
+};
+
+#endif /* CACHEDFITNESSSTRATEGY_H_ */
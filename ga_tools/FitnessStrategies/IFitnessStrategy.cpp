@@ -33,3 +33,22 @@ IFitnessStrategy::IFitnessStrategy() {
 IFitnessStrategy::~IFitnessStrategy() {
         // nothing
 }
+
+void IFitnessStrategy::getFitnessBatch(const std::vector<const Individual*>& individuals, std::vector<double>& fitness) {
+  fitness.resize(individuals.size());
+  for(unsigned int x=0;x<individuals.size();x++) {
+    fitness[x] = getFitness(individuals[x]);
+  }
+}
+
+bool IFitnessStrategy::submit(Individual* /*individual*/) {
+  return false;
+}
+
+int IFitnessStrategy::collect(void) {
+  return 0;
+}
+
+bool IFitnessStrategy::isPredicted(const Individual* /*individual*/) {
+  return false;
+}
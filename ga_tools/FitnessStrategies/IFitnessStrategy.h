@@ -27,6 +27,9 @@
 #ifndef IFITNESSSTRATEGY_H_
 #define IFITNESSSTRATEGY_H_
 
+// standard includes
+#include <vector>
+
 // forward declaration
 class Individual;
 
@@ -55,6 +58,46 @@ public:
 	 * @return (double) The fitness value
 	 */
 	virtual double getFitness(const Individual* individual) = 0;
+
+	/**
+	 * calculates the fitness values of a set of individuals at once. The default
+	 * implementation calls getFitness for every individual one after the other.
+	 * Strategies which can evaluate many individuals at the same time (e.g. by running
+	 * one SimulationTask per individual with the SimulationTaskSupervisor) should
+	 * overwrite this function.
+	 *
+	 * @param individuals (const vector<const Individual*>&) calculate the fitness for these individuals
+	 * @param fitness (vector<double>&) the resulting fitness values (same order as individuals)
+	 */
+	virtual void getFitnessBatch(const std::vector<const Individual*>& individuals, std::vector<double>& fitness);
+
+	/**
+	 * starts the evaluation of an individual in the background (asynchronous strategies).
+	 * The result is written into the individual by collect(). The default implementation
+	 * does nothing and returns false, then the individual is evaluated by getFitnessBatch.
+	 * Strategies which wrap an other strategy should forward it.
+	 *
+	 * @param individual (Individual*) the individual which should be evaluated
+	 * @return (bool) true if the individual is evaluated in the background
+	 */
+	virtual bool submit(Individual* individual);
+
+	/**
+	 * waits for all individuals which are given to submit and sets their fitness values.
+	 * The default implementation does nothing.
+	 *
+	 * @return (int) number of individuals which got a fitness value
+	 */
+	virtual int collect(void);
+
+	/**
+	 * returns true if the last fitness value of the individual is only a prediction
+	 * (e.g. by a surrogate model) and no real evaluation. The default implementation returns false.
+	 *
+	 * @param individual (const Individual*) the individual
+	 * @return (bool) true if the value is predicted
+	 */
+	virtual bool isPredicted(const Individual* individual);
 };
 
 #endif /* IFITNESSSTRATEGY_H_ */
@@ -0,0 +1,380 @@
+/***************************************************************************
+ *   Copyright (C) 2008-2011 LpzRobots development team                    *
+ *    Joerg Weider   <joergweide84 at aol dot com> (robot12)               *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *    Joern Hoffmann <jhoffmann at informatik dot uni-leipzig dot de       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ParallelFitnessStrategy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+#include "Individual.h"
+
+// the seed of the evaluation which runs in the current thread
+static thread_local long s_evaluationSeed = 0;
+// the random generator of the evaluation which runs in the current thread
+static thread_local RandGen s_evaluationRandGen;
+
+ParallelFitnessStrategy::ParallelFitnessStrategy() {
+  // nothing
+}
+
+ParallelFitnessStrategy::ParallelFitnessStrategy(IFitnessStrategy* strategy, int numWorkers, ParallelFitnessMode mode, long seed, int batchSize) {
+  m_strategy = strategy;
+  m_numWorkers = numWorkers;
+  if(m_numWorkers<=0)
+    m_numWorkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if(m_numWorkers<=0)
+    m_numWorkers = 1;
+  m_mode = mode;
+  m_seed = seed;
+  m_batchSize = batchSize>0?batchSize:1;
+  m_nextJob = 0;
+  m_doneJobs = 0;
+  m_stop = false;
+
+  pthread_mutex_init(&m_mutex,NULL);
+  pthread_cond_init(&m_jobAvailable,NULL);
+  pthread_cond_init(&m_jobDone,NULL);
+}
+
+ParallelFitnessStrategy::~ParallelFitnessStrategy() {
+  waitForAll();
+  finishJobs();
+
+  // stop the worker threads
+  pthread_mutex_lock(&m_mutex);
+  m_stop = true;
+  pthread_cond_broadcast(&m_jobAvailable);
+  pthread_mutex_unlock(&m_mutex);
+  for(std::vector<pthread_t>::iterator iter = m_threads.begin(); iter != m_threads.end(); iter++) {
+    pthread_join(*iter,NULL);
+  }
+  m_threads.clear();
+
+  pthread_cond_destroy(&m_jobDone);
+  pthread_cond_destroy(&m_jobAvailable);
+  pthread_mutex_destroy(&m_mutex);
+
+  m_strategy = 0;
+}
+
+double ParallelFitnessStrategy::getFitness(const Individual* individual) {
+  Job job;
+  job.individual = individual;
+  job.target = 0;
+  job.seed = getSeed(individual);
+  job.fitness = 0.0;
+  job.done = false;
+
+  evaluate(job);
+
+  return job.fitness;
+}
+
+void ParallelFitnessStrategy::getFitnessBatch(const std::vector<const Individual*>& individuals, std::vector<double>& fitness) {
+  int first;
+
+  pthread_mutex_lock(&m_mutex);
+  first = m_jobs.size();
+  for(std::vector<const Individual*>::const_iterator iter = individuals.begin(); iter != individuals.end(); iter++) {
+    addJob(*iter,0);
+  }
+  pthread_cond_broadcast(&m_jobAvailable);
+  pthread_mutex_unlock(&m_mutex);
+
+  waitForAll();
+
+  fitness.resize(individuals.size());
+  for(unsigned int x=0;x<individuals.size();x++) {
+    fitness[x] = m_jobs[first+x].fitness;
+  }
+
+  finishJobs();
+}
+
+bool ParallelFitnessStrategy::submit(Individual* individual) {
+  if(m_mode==PARALLEL_FITNESS_THREADS) {
+    startThreads();
+    pthread_mutex_lock(&m_mutex);
+    addJob(individual,individual);
+    pthread_cond_signal(&m_jobAvailable);
+    pthread_mutex_unlock(&m_mutex);
+  }
+  else {
+    addJob(individual,individual);
+    pollChildren(false);
+    startChildren(false);
+  }
+  return true;
+}
+
+int ParallelFitnessStrategy::collect(void) {
+  waitForAll();
+  return finishJobs();
+}
+
+int ParallelFitnessStrategy::getNumPending(void) {
+  int result;
+
+  pthread_mutex_lock(&m_mutex);
+  result = m_jobs.size();
+  pthread_mutex_unlock(&m_mutex);
+
+  return result;
+}
+
+long ParallelFitnessStrategy::getSeed(const Individual* individual)const {
+  // mix the base seed and the ID (splitmix64), so the seed doesn't depend on the evaluation order
+  unsigned long long z = (unsigned long long)m_seed + 0x9E3779B97F4A7C15ULL * (unsigned long long)(individual->getID()+1);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z = z ^ (z >> 31);
+
+  return (long)(z & 0x7fffffffULL);
+}
+
+long ParallelFitnessStrategy::getEvaluationSeed(void) {
+  return s_evaluationSeed;
+}
+
+RandGen* ParallelFitnessStrategy::getEvaluationRandGen(void) {
+  return &s_evaluationRandGen;
+}
+
+void ParallelFitnessStrategy::evaluate(Job& job) {
+  long oldSeed = s_evaluationSeed;
+
+  s_evaluationSeed = job.seed;
+  s_evaluationRandGen.initCounterBased(job.seed);
+  job.fitness = m_strategy->getFitness(job.individual);
+  s_evaluationSeed = oldSeed;
+}
+
+void ParallelFitnessStrategy::addJob(const Individual* individual, Individual* target) {
+  Job job;
+
+  job.individual = individual;
+  job.target = target;
+  job.seed = getSeed(individual);
+  job.fitness = 0.0;
+  job.done = false;
+  m_jobs.push_back(job);
+}
+
+void ParallelFitnessStrategy::waitForAll(void) {
+  if(m_mode==PARALLEL_FITNESS_THREADS) {
+    if(m_jobs.size()>0)
+      startThreads();
+    pthread_mutex_lock(&m_mutex);
+    while(m_doneJobs<(int)m_jobs.size())
+      pthread_cond_wait(&m_jobDone,&m_mutex);
+    pthread_mutex_unlock(&m_mutex);
+  }
+  else {
+    startChildren(true);
+    while(m_doneJobs<(int)m_jobs.size()) {
+      pollChildren(true);
+      startChildren(true);
+    }
+  }
+}
+
+int ParallelFitnessStrategy::finishJobs(void) {
+  int num = 0;
+
+  pthread_mutex_lock(&m_mutex);
+  for(std::deque<Job>::iterator iter = m_jobs.begin(); iter != m_jobs.end(); iter++) {
+    if(iter->target!=0) {
+      iter->target->setFitness(iter->fitness);
+      num++;
+    }
+  }
+  m_jobs.clear();
+  m_nextJob = 0;
+  m_doneJobs = 0;
+  pthread_mutex_unlock(&m_mutex);
+
+  return num;
+}
+
+void ParallelFitnessStrategy::startThreads(void) {
+  pthread_t thread;
+
+  if(m_mode!=PARALLEL_FITNESS_THREADS || (int)m_threads.size()>=m_numWorkers)
+    return;
+
+  while((int)m_threads.size()<m_numWorkers) {
+    if(pthread_create(&thread,NULL,threadRun,this)!=0) {
+      printf("\n\n\t>>> [WARNING] <<<\nParallelFitnessStrategy: could not create worker thread.\n\t>>> [END] <<<\n\n\n");
+      break;
+    }
+    m_threads.push_back(thread);
+  }
+}
+
+void* ParallelFitnessStrategy::threadRun(void* strategy) {
+  ParallelFitnessStrategy* self = (ParallelFitnessStrategy*)strategy;
+  Job* job;
+
+  pthread_mutex_lock(&self->m_mutex);
+  while(true) {
+    while(!self->m_stop && self->m_nextJob>=(int)self->m_jobs.size())
+      pthread_cond_wait(&self->m_jobAvailable,&self->m_mutex);
+    if(self->m_nextJob>=(int)self->m_jobs.size())
+      break;
+
+    job = &self->m_jobs[self->m_nextJob++];
+    pthread_mutex_unlock(&self->m_mutex);
+    // the global generators are only reproducible if no other thread uses them
+    if(self->m_numWorkers==1) {
+      srand48(job->seed);
+      srand((unsigned int)job->seed);
+    }
+    self->evaluate(*job);
+    pthread_mutex_lock(&self->m_mutex);
+
+    job->done = true;
+    self->m_doneJobs++;
+    pthread_cond_broadcast(&self->m_jobDone);
+  }
+  pthread_mutex_unlock(&self->m_mutex);
+
+  return 0;
+}
+
+void ParallelFitnessStrategy::startChildren(bool flush) {
+  int num;
+  int fds[2];
+  Child child;
+
+  while((int)m_children.size()<m_numWorkers && m_nextJob<(int)m_jobs.size()) {
+    num = m_jobs.size() - m_nextJob;
+    if(num<m_batchSize && !flush)
+      break;
+    if(num>m_batchSize)
+      num = m_batchSize;
+
+    child.begin = m_nextJob;
+    child.end = m_nextJob + num;
+    m_nextJob += num;
+
+    fflush(0);
+    if(pipe(fds)!=0 || (child.pid = fork())<0) {
+      // no process available -> evaluate it here
+      printf("\n\n\t>>> [WARNING] <<<\nParallelFitnessStrategy: could not fork worker, evaluate in this process.\n\t>>> [END] <<<\n\n\n");
+      for(int x=child.begin;x<child.end;x++) {
+        evaluate(m_jobs[x]);
+        m_jobs[x].done = true;
+        m_doneJobs++;
+      }
+      continue;
+    }
+
+    if(child.pid==0) {
+      // worker process: evaluate the batch and send the results back
+      close(fds[0]);
+      for(int x=child.begin;x<child.end;x++) {
+        srand48(m_jobs[x].seed);
+        srand((unsigned int)m_jobs[x].seed);
+        evaluate(m_jobs[x]);
+        const char* data = (const char*)&m_jobs[x].fitness;
+        size_t written = 0;
+        while(written<sizeof(double)) {
+          ssize_t w = write(fds[1],data+written,sizeof(double)-written);
+          if(w<=0)
+            _exit(1);
+          written += w;
+        }
+      }
+      close(fds[1]);
+      _exit(0);
+    }
+
+    close(fds[1]);
+    child.fd = fds[0];
+    child.buffer.clear();
+    m_children.push_back(child);
+  }
+}
+
+void ParallelFitnessStrategy::pollChildren(bool block) {
+  std::vector<struct pollfd> fds(m_children.size());
+  char buffer[4096];
+  ssize_t num;
+
+  if(m_children.size()==0)
+    return;
+
+  for(unsigned int x=0;x<m_children.size();x++) {
+    fds[x].fd = m_children[x].fd;
+    fds[x].events = POLLIN;
+    fds[x].revents = 0;
+  }
+
+  if(poll(&fds[0],fds.size(),block?-1:0)<=0)
+    return;
+
+  // go backwards, because finished children are removed
+  for(int x=(int)m_children.size()-1;x>=0;x--) {
+    if(fds[x].revents==0)
+      continue;
+    num = read(m_children[x].fd,buffer,sizeof(buffer));
+    if(num>0) {
+      m_children[x].buffer.insert(m_children[x].buffer.end(),buffer,buffer+num);
+    }
+    else {
+      finishChild(m_children[x]);
+      m_children.erase(m_children.begin()+x);
+    }
+  }
+}
+
+void ParallelFitnessStrategy::finishChild(Child& child) {
+  int status = 0;
+  int received = child.buffer.size() / sizeof(double);
+
+  close(child.fd);
+  waitpid(child.pid,&status,0);
+
+  for(int x=child.begin;x<child.end;x++) {
+    if(x-child.begin<received) {
+      memcpy(&m_jobs[x].fitness,&child.buffer[(x-child.begin)*sizeof(double)],sizeof(double));
+    }
+    else {
+      // the worker crashed -> evaluate the rest here (same seed, same result)
+      if(x-child.begin==received)
+        printf("\n\n\t>>> [WARNING] <<<\nParallelFitnessStrategy: worker %i failed, evaluate the rest of its batch in this process.\n\t>>> [END] <<<\n\n\n",(int)child.pid);
+      srand48(m_jobs[x].seed);
+      srand((unsigned int)m_jobs[x].seed);
+      evaluate(m_jobs[x]);
+    }
+    m_jobs[x].done = true;
+    m_doneJobs++;
+  }
+}
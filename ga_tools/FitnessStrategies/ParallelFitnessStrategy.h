@@ -0,0 +1,302 @@
+/***************************************************************************
+ *   Copyright (C) 2008-2011 LpzRobots development team                    *
+ *    Joerg Weider   <joergweide84 at aol dot com> (robot12)               *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *    Joern Hoffmann <jhoffmann at informatik dot uni-leipzig dot de       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PARALLELFITNESSSTRATEGY_H_
+#define PARALLELFITNESSSTRATEGY_H_
+
+// standard includes
+#include <vector>
+#include <deque>
+#include <pthread.h>
+#include <sys/types.h>
+#include <selforg/randomgenerator.h>
+
+//forward declaration
+class Individual;
+
+//ga_tools includes
+#include "IFitnessStrategy.h"
+
+/**
+ * the way how the ParallelFitnessStrategy evaluates the individuals
+ */
+enum ParallelFitnessMode {
+	PARALLEL_FITNESS_THREADS,	///< a pool of worker threads inside this process
+	PARALLEL_FITNESS_FORK		///< forked worker processes which send the results back over pipes
+};
+
+/**
+ * This fitness strategy evaluates the fitness of many individuals in parallel
+ * with the help of an other fitness strategy (e.g. one which makes a full simulation).
+ *
+ * In the thread mode the other strategy must be thread safe (it is called at the same time
+ * from different threads). In the fork mode every batch of individuals is evaluated in an
+ * own process (copy of the current state) and only the fitness values are send back.
+ *
+ * Every evaluation gets a seed which only depends on the seed of this strategy and the ID
+ * of the individual. So the results are independent from the number of workers and the order
+ * of the evaluation. The seed is accessible with getEvaluationSeed() and a random generator
+ * which is seeded with it for every evaluation (in both modes) with getEvaluationRandGen().
+ * In the fork mode and with one worker thread also srand and srand48 are initialised with it.
+ * With more worker threads these global generators are shared by the threads, so a strategy
+ * which should be reproducible has to use getEvaluationRandGen().
+ *
+ * The workers are independent from the SimulationTaskSupervisor of the ode_robots, because
+ * ga_tools only depends on selforg and the wrapped strategy need not be a simulation.
+ * A strategy which runs simulations can use the supervisor in getFitnessBatch instead.
+ *
+ * Individuals can also be submitted one after the other (submit), so the evaluation can start
+ * while the gen. alg. still creates the rest of the generation (see SingletonGenEngine::crossover).
+ * Wrap this strategy around the other strategies (e.g. around the InvertedFitnessStrategy),
+ * which do not forward submit (only the CachedFitnessStrategy does).
+ */
+class ParallelFitnessStrategy : public IFitnessStrategy {
+public:
+	/**
+	 * constructor
+	 * @param strategy (IFitnessStrategy*) the strategy which calculates the fitness of one individual
+	 * @param numWorkers (int) number of parallel workers (threads or processes). 0 means number of processors.
+	 * @param mode (ParallelFitnessMode) threads or forked processes
+	 * @param seed (long) the base seed for all evaluations
+	 * @param batchSize (int) number of individuals which are given to a worker at once (only fork mode)
+	 */
+	ParallelFitnessStrategy(IFitnessStrategy* strategy, int numWorkers = 0, ParallelFitnessMode mode = PARALLEL_FITNESS_THREADS, long seed = 0, int batchSize = 1);
+
+	/**
+	 * default destructor
+	 * waits for all running evaluations and stops the workers.
+	 */
+	virtual ~ParallelFitnessStrategy();
+
+	/**
+	 * calculates the fitness of one individual directly in the calling thread.
+	 * @param individual (const Individual*) calculate the fitness for this individual
+	 * @return (double) The fitness value
+	 */
+	virtual double getFitness(const Individual* individual);
+
+	/**
+	 * calculates the fitness values of all individuals in parallel and waits for the results.
+	 * @param individuals (const vector<const Individual*>&) calculate the fitness for these individuals
+	 * @param fitness (vector<double>&) the resulting fitness values
+	 */
+	virtual void getFitnessBatch(const std::vector<const Individual*>& individuals, std::vector<double>& fitness);
+
+	/**
+	 * gives an individual to the workers. The function returns immediately.
+	 * The result is written into the individual by collect().
+	 * @param individual (Individual*) the individual which should be evaluated
+	 * @return (bool) always true
+	 */
+	virtual bool submit(Individual* individual);
+
+	/**
+	 * waits for all submitted individuals and sets their fitness values.
+	 * @return (int) number of individuals which got a fitness value
+	 */
+	virtual int collect(void);
+
+	/**
+	 * returns the number of submitted individuals which are not collected yet.
+	 * @return (int) the number
+	 */
+	int getNumPending(void);
+
+	/**
+	 * returns the number of workers
+	 * @return (int) the number
+	 */
+	inline int getNumWorkers(void)const {return m_numWorkers;}
+
+	/**
+	 * returns the seed which is used for the evaluation of the individual
+	 * @param individual (const Individual*) the individual
+	 * @return (long) the seed
+	 */
+	long getSeed(const Individual* individual)const;
+
+	/**
+	 * returns the seed of the evaluation which is currently running in the calling thread.
+	 * Can be used inside the other strategy to initialise an own random generator.
+	 * @return (long) the seed
+	 */
+	static long getEvaluationSeed(void);
+
+	/**
+	 * returns the random generator of the calling thread. It is seeded with the seed of
+	 * the evaluation (see getEvaluationSeed()) before every evaluation.
+	 * @return (RandGen*) the random generator
+	 */
+	static RandGen* getEvaluationRandGen(void);
+
+protected:
+	/**
+	 * one evaluation
+	 */
+	struct Job {
+		const Individual* individual;	///< the individual which is evaluated
+		Individual* target;				///< the individual which gets the result (or zero)
+		long seed;						///< seed of the evaluation
+		double fitness;					///< the result
+		bool done;						///< is the result available
+	};
+
+	/**
+	 * a running worker process (fork mode)
+	 */
+	struct Child {
+		pid_t pid;						///< the process
+		int fd;							///< read end of the pipe
+		int begin;						///< first job of the batch
+		int end;						///< behind the last job of the batch
+		std::vector<char> buffer;		///< the received data
+	};
+
+	/**
+	 * evaluates one job in the calling thread/process.
+	 */
+	void evaluate(Job& job);
+
+	/**
+	 * adds a new job (without locking)
+	 */
+	void addJob(const Individual* individual, Individual* target);
+
+	/**
+	 * waits until all jobs are done
+	 */
+	void waitForAll(void);
+
+	/**
+	 * writes the results to the targets and removes all jobs
+	 */
+	int finishJobs(void);
+
+	/**
+	 * starts the worker threads (if not done yet)
+	 */
+	void startThreads(void);
+
+	/**
+	 * the main function of the worker threads
+	 */
+	static void* threadRun(void* strategy);
+
+	/**
+	 * starts worker processes for the waiting jobs as long as workers are free.
+	 * @param flush (bool) start also batches which are smaller than the batch size
+	 */
+	void startChildren(bool flush);
+
+	/**
+	 * reads the results from the worker processes.
+	 * @param block (bool) wait until at least one worker is finished
+	 */
+	void pollChildren(bool block);
+
+	/**
+	 * finishes a worker process and takes the results
+	 */
+	void finishChild(Child& child);
+
+	/**
+	 * the other strategy
+	 */
+	IFitnessStrategy* m_strategy;
+
+	/**
+	 * number of workers
+	 */
+	int m_numWorkers;
+
+	/**
+	 * the mode
+	 */
+	ParallelFitnessMode m_mode;
+
+	/**
+	 * the base seed
+	 */
+	long m_seed;
+
+	/**
+	 * the batch size for the fork mode
+	 */
+	int m_batchSize;
+
+	/**
+	 * all jobs since the last collect (deque, because the worker holds references)
+	 */
+	std::deque<Job> m_jobs;
+
+	/**
+	 * the next job which is not given to a worker
+	 */
+	int m_nextJob;
+
+	/**
+	 * number of done jobs
+	 */
+	int m_doneJobs;
+
+	/**
+	 * the worker threads
+	 */
+	std::vector<pthread_t> m_threads;
+
+	/**
+	 * the running worker processes
+	 */
+	std::vector<Child> m_children;
+
+	/**
+	 * mutex for the jobs
+	 */
+	pthread_mutex_t m_mutex;
+
+	/**
+	 * signals new jobs to the worker threads
+	 */
+	pthread_cond_t m_jobAvailable;
+
+	/**
+	 * signals finished jobs to the waiting thread
+	 */
+	pthread_cond_t m_jobDone;
+
+	/**
+	 * flag for stopping the worker threads
+	 */
+	bool m_stop;
+
+private:
+	/**
+	 * disable the default constructor
+	 */
+	ParallelFitnessStrategy();
+};
+
+#endif /* PARALLELFITNESSSTRATEGY_H_ */
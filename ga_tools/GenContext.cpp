@@ -68,18 +68,18 @@ void GenContext::update(double factor) {
     if (tValue != 0)
       list.push_back(tValue->getValue());
   }
-  DOUBLE_ANALYSATION_CONTEXT* context = new DOUBLE_ANALYSATION_CONTEXT(list);
+  SelectionAnalysation statistic;
+  statistic.setValues(list);
+  statistic.analyse(factor);
 
-  m_q1 = context->getQuartil1();
-  m_q3 = context->getQuartil3();
-  m_med = context->getMedian();
-  m_avg = context->getAvg();
-  m_w1 = context->getWhisker1(factor);
-  m_w3 = context->getWhisker3(factor);
-  m_min = context->getMin();
-  m_max = context->getMax();
-
-  delete context;
+  m_q1 = statistic.getQuartil1();
+  m_q3 = statistic.getQuartil3();
+  m_med = statistic.getMedian();
+  m_avg = statistic.getAvg();
+  m_w1 = statistic.getWhisker1();
+  m_w3 = statistic.getWhisker3();
+  m_min = statistic.getMin();
+  m_max = statistic.getMax();
 }
 
 bool GenContext::restore() {
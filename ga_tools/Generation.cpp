@@ -73,6 +73,7 @@ void Generation::crossover(RandGen* random) {
     count++;
     ind = SingletonIndividualFactory::getInstance()->createIndividual(m_individual[r1],m_individual[r2],random);  // create new individual with the 2 other individuals which are represented with the 2 random numbers
     addIndividual(ind);                                 // insert the new individual
+    SingletonGenEngine::getInstance()->submitFitness(ind); // start the evaluation (only if it is parallel)
   }
 }
 
@@ -101,23 +102,31 @@ std::vector<double>* Generation::getAllFitness(void)const {
 }
 
 void Generation::update(double factor) {
-  std::vector<double>* ptrFitnessVector = getAllFitness();
-  DOUBLE_ANALYSATION_CONTEXT* context = new DOUBLE_ANALYSATION_CONTEXT(*ptrFitnessVector);
-
-  m_q1 = context->getQuartil1();
-  m_q3 = context->getQuartil3();
-  m_med = context->getMedian();
-  m_avg = context->getAvg();
-  m_w1 = context->getWhisker1(factor);
-  m_w3 = context->getWhisker3(factor);
-  m_min = context->getMin();
-  m_max = context->getMax();
-  m_best = context->getBest();
+  // selection instead of a full sort, same values like DOUBLE_ANALYSATION_CONTEXT
+  // predicted fitness values are no measurements, they are only used if nothing else exists
+  m_statistic.clear();
+  for(std::vector<Individual*>::const_iterator iter = m_individual.begin(); iter != m_individual.end(); iter++) {
+    if(!(*iter)->isFitnessPredicted())
+      m_statistic.add((*iter)->getFitness());
+  }
+  if(m_statistic.size()==0) {
+    for(std::vector<Individual*>::const_iterator iter = m_individual.begin(); iter != m_individual.end(); iter++) {
+      m_statistic.add((*iter)->getFitness());
+    }
+  }
+  m_statistic.analyse(factor);
+
+  m_q1 = m_statistic.getQuartil1();
+  m_q3 = m_statistic.getQuartil3();
+  m_med = m_statistic.getMedian();
+  m_avg = m_statistic.getAvg();
+  m_w1 = m_statistic.getWhisker1();
+  m_w3 = m_statistic.getWhisker3();
+  m_min = m_statistic.getMin();
+  m_max = m_statistic.getMax();
+  m_best = m_statistic.getBest();
   m_dSize = (double)m_size;
   m_dNumChildren = (double)m_numChildren;
-
-  delete context;
-  delete ptrFitnessVector;
 }
 
 std::vector<Individual*>* Generation::getAllUnCalculatedIndividuals(void)const {
@@ -33,6 +33,7 @@
 #include <map>
 #include <selforg/randomgenerator.h>
 #include <selforg/inspectable.h>
+#include <selforg/selectionanalysation.h>
 
 // forward declarations
 class Individual;
@@ -255,6 +256,12 @@ private:
 	 */
 	double m_best;
 
+	/**
+	 * the buffer for the statistical values. It is reused in every update,
+	 * so the fitness values are not copied into new memory every time.
+	 */
+	SelectionAnalysation m_statistic;
+
 	/**
 	 * the number of individual inside the generation (will be)
 	 */
@@ -58,10 +58,11 @@ int StandartGenerationSizeStrategy::calcGenerationSize(Generation* oldGeneration
         try{
                 std::vector<double>* values = oldGeneration->getAllFitness();
                 //double best = GET_DOUBLE_ANALYSATION(*values,AM_BEST);
-                DOUBLE_ANALYSATION_CONTEXT* context = new DOUBLE_ANALYSATION_CONTEXT(*values);
-                double best = context->getBest();
+                SelectionAnalysation statistic;
+                statistic.setValues(*values);
+                statistic.analyse();
+                double best = statistic.getBest();
 
-                delete context;
                 delete values;
 
                 //if it the first run than set some values and return the startsize
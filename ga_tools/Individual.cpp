@@ -39,6 +39,7 @@ Individual::Individual(std::string name, int id, Individual* p1, Individual* p2)
   m_parent1 = p1;
   m_parent2 = p2;
   m_fitnessCalculated = false;
+  m_fitnessPredicted = false;
 }
 
 Individual::~Individual() {
@@ -120,6 +120,14 @@ public:
    */
   double getFitnessC()const;
 
+	/**
+	 * sets the fitness value of the individual, which was calculated outside
+	 * (e.g. by a parallel evaluation). After this getFitness returns this value.
+	 * @param fitness (double) the fitness value
+	 * @param predicted (bool) true if the value is only predicted and not evaluated
+	 */
+	inline void setFitness(double fitness, bool predicted=false) {m_fitness=fitness;m_fitnessCalculated=true;m_fitnessPredicted=predicted;}
+
 	/**
 	 * this select the individual as a product of mutation.
 	 */
@@ -162,6 +170,12 @@ public:
 	 */
 	inline bool isFitnessCalculated()const {return m_fitnessCalculated;}
 
+	/**
+	 * returns the m_fitnessPredicted flag, which represent, that the fitness value is only predicted.
+	 * @return (bool) the flag m_fitnessPredicted
+	 */
+	inline bool isFitnessPredicted()const {return m_fitnessPredicted;}
+
 	/**
 	 * store the individual in a file
 	 * @param f (FILE) the file to store in
@@ -223,6 +237,11 @@ protected:
 	 */
 	bool m_fitnessCalculated;
 
+	/**
+	 * remember if the fitness value is only predicted
+	 */
+	bool m_fitnessPredicted;
+
 	/**
 	 * save the calculated fitness value
 	 */
@@ -39,7 +39,7 @@ public:
         Individual* ind;
 
         inline bool operator<(SfitnessEliteStrategyStruct other) {
-                return (fitness*fitness)<(other.fitness*other.fitness);
+                return EliteSelectStrategy::isBetter(fitness,other.fitness);
         }
 
         ~SfitnessEliteStrategyStruct() {
@@ -54,6 +54,16 @@ public:
 	 * @param newGeneration (Generation*) the new generation
 	 */
 	virtual void select(Generation* oldGeneration, Generation* newGeneration);
+
+	/**
+	 * [inline], [static]
+	 * the order of the elite select: the fitness which is closer to zero is better.
+	 * Other parts which rank individuals like the select (e.g. DenseGenome) should use it.
+	 * @param fitness1 (double) the first fitness
+	 * @param fitness2 (double) the second fitness
+	 * @return (bool) true if fitness1 is better than fitness2
+	 */
+	inline static bool isBetter(double fitness1, double fitness2) {return (fitness1*fitness1)<(fitness2*fitness2);}
 };
 
 #endif /* ELITESELECTSTRATEGY_H_ */
@@ -62,10 +62,15 @@ void RandomSelectStrategy::select(Generation* oldGeneration, Generation* newGene
         }
 
         // calc range and min of all fitness
-        DOUBLE_ANALYSATION_CONTEXT* context = new DOUBLE_ANALYSATION_CONTEXT(*oldGeneration->getAllFitness());
-        range = context->getRange();
-        min = context->getMin();
-        delete context;
+        // only min and max are needed, so one linear pass is enough
+        min = 0.0;
+        double max = 0.0;
+        for(int y=0;y<num;y++) {
+                double fitness = list[y]->getFitness();
+                if(y==0 || fitness<min) min = fitness;
+                if(y==0 || fitness>max) max = fitness;
+        }
+        range = max - min;
 
         // kill some elements
         while(kill>0) {
@@ -34,6 +34,7 @@
 #include "Gen.h"
 #include "Individual.h"
 #include "Generation.h"
+#include "DenseGenome.h"
 
 #include "IGenerationSizeStrategy.h"
 #include "FixGenerationSizeStrategy.h"
@@ -45,6 +46,8 @@
 #include "ExtreamTestFitnessStrategy.h"
 #include "TestFitnessStrategy.h"
 #include "InvertedFitnessStrategy.h"
+#include "ParallelFitnessStrategy.h"
+#include "CachedFitnessStrategy.h"
 
 #include "IRandomStrategy.h"
 #include "DoubleRandomStrategy.h"
@@ -106,6 +109,14 @@ IFitnessStrategy* SingletonGenAlgAPI::createInvertedFitnessStrategy(IFitnessStra
         return new InvertedFitnessStrategy(strategy);
 }
 
+IFitnessStrategy* SingletonGenAlgAPI::createParallelFitnessStrategy(IFitnessStrategy* strategy, int numWorkers, ParallelFitnessMode mode, long seed, int batchSize)const {
+        return new ParallelFitnessStrategy(strategy, numWorkers, mode, seed, batchSize);
+}
+
+IFitnessStrategy* SingletonGenAlgAPI::createCachedFitnessStrategy(IFitnessStrategy* strategy, double quantum)const {
+        return new CachedFitnessStrategy(strategy, quantum);
+}
+
 IRandomStrategy* SingletonGenAlgAPI::createDoubleRandomStrategy(RandGen* random, double base, double factor, double epsilon)const {
         return new DoubleRandomStrategy(random,base,factor,epsilon);
 }
@@ -163,6 +174,10 @@ void SingletonGenAlgAPI::update(double factor) {
         SingletonGenEngine::getInstance()->update(factor);
 }
 
+void SingletonGenAlgAPI::calcFitness(void) {
+        SingletonGenEngine::getInstance()->calcFitness();
+}
+
 void SingletonGenAlgAPI::prepare(int startSize, int numChildren, RandGen* random, bool withUpdate) {
         SingletonGenEngine::getInstance()->prepare(startSize, numChildren, (InspectableProxy*&)m_generation, (InspectableProxy*&)m_inspectable, random, m_plotEngine, m_plotEngineGenContext, withUpdate);
 }
@@ -197,6 +212,10 @@ GenPrototype* SingletonGenAlgAPI::createPrototype(std::string name, IRandomStrat
         return new GenPrototype(name,randomStrategy,mutationStrategy);
 }
 
+DenseGenome* SingletonGenAlgAPI::createDenseGenome(int capacity)const {
+        return new DenseGenome(SingletonGenEngine::getInstance()->getSetOfGenPrototyps(),capacity);
+}
+
 void SingletonGenAlgAPI::insertGenPrototype(GenPrototype* prototype) {
         SingletonGenEngine::getInstance()->addGenPrototype(prototype);
 }
@@ -45,6 +45,7 @@ class IGenerationSizeStrategy;
 class IRandomStrategy;
 class IValue;
 class IFitnessStrategy;
+class DenseGenome;
 
 //forward declaration for LPZROBOTS
 class PlotOptionEngine;
@@ -52,6 +53,7 @@ class PlotOption;
 
 //ga_tools includes
 #include "SingletonGenEngine.h"
+#include "ParallelFitnessStrategy.h"
 
 /**
  * This is a facade for the gen. alg.
@@ -76,6 +78,10 @@ public:
 	 * @param factor (double) normal=1.5 is needed for the whisker distance
 	 */
 	void update(double factor = 1.5);
+	/**
+	 * calculates the missing fitness values of the actual generation (in parallel if possible)
+	 */
+	void calcFitness(void);
 	/**
 	 * prepares the first generation and optional the enabled measure
 	 * @param startSize (int) Number of individual at begin of the gen. alg.
@@ -187,6 +193,23 @@ public:
 	 * @return (IFitnessStrategy*) the resulting strategy
 	 */
 	IFitnessStrategy* createInvertedFitnessStrategy(IFitnessStrategy* strategy)const;
+	/**
+	 * returns a fitness strategy which evaluates the individuals of an other strategy in parallel.
+	 * @param strategy (IFitnessStrategy*) the other strategy
+	 * @param numWorkers (int) number of threads or processes (0 = number of processors)
+	 * @param mode (ParallelFitnessMode) threads or forked processes
+	 * @param seed (long) base seed of all evaluations
+	 * @param batchSize (int) individuals per worker process (fork mode)
+	 * @return (IFitnessStrategy*) the resulting strategy
+	 */
+	IFitnessStrategy* createParallelFitnessStrategy(IFitnessStrategy* strategy, int numWorkers = 0, ParallelFitnessMode mode = PARALLEL_FITNESS_THREADS, long seed = 0, int batchSize = 1)const;
+	/**
+	 * returns a fitness strategy which caches the values of an other strategy (see CachedFitnessStrategy).
+	 * @param strategy (IFitnessStrategy*) the other strategy
+	 * @param quantum (double) resolution of the genes for the cache (0 = exact)
+	 * @return (IFitnessStrategy*) the resulting strategy
+	 */
+	IFitnessStrategy* createCachedFitnessStrategy(IFitnessStrategy* strategy, double quantum = 0.0)const;
 	/**
 	 * creates a random strategy for double values.
 	 * The values will be generated in the intervals [base-epsilon:-epsilon] or [epsilon:factor+base+epsilon]
@@ -295,6 +318,12 @@ public:
 	 * @return (GenPrototype*) the prototype
 	 */
 	GenPrototype* createPrototype(std::string name, IRandomStrategy* randomStrategy, IMutationStrategy* mutationStrategy)const;
+	/**
+	 * creates a dense (contiguous) storage for a population with one column for every inserted prototype.
+	 * @param capacity (int) number of individuals which are reserved
+	 * @return (DenseGenome*) the storage
+	 */
+	DenseGenome* createDenseGenome(int capacity = 0)const;
 
 	// singleton
 	/**
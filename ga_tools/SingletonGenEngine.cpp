@@ -247,6 +247,7 @@ void SingletonGenEngine::runGenAlg(int startSize, int numChildren, int numGenera
   prepare(startSize,numChildren,actualGeneration,actualContext,random,plotEngine,plotEngineGenContext);
 
   // generate the other generations
+  // (the children are evaluated while the crossover runs, if the fitness strategy is asynchronous)
   for(int x=0;x<numGeneration;x++) {
     select();
     crossover(random);
@@ -266,6 +267,9 @@ void SingletonGenEngine::select(bool createNextGeneration) {
   if(createNextGeneration)
     getInstance()->prepareNextGeneration(m_generationSizeStrategy->calcGenerationSize(getActualGeneration()),getActualGeneration()->getNumChildren());
 
+  // all individuals which should be selected need their fitness
+  calcFitness(getInstance()->m_generation[getInstance()->m_actualGeneration-1]);
+
   //std::cout<<"begin select\n";
   getInstance()->m_selectStrategy->select(getInstance()->m_generation[getInstance()->m_actualGeneration-1],getInstance()->m_generation[getInstance()->m_actualGeneration]);
   //std::cout<<"select OK\n";
@@ -297,6 +301,7 @@ void SingletonGenEngine::crossover(RandGen* random) {
 }
 
 void SingletonGenEngine::update(double factor) {
+  calcFitness(m_generation[m_actualGeneration]);
   m_generation[m_actualGeneration]->update(factor);
 
   for(std::vector<GenPrototype*>::const_iterator iter = m_prototype.begin(); iter!=m_prototype.end(); iter++) {
@@ -304,6 +309,41 @@ void SingletonGenEngine::update(double factor) {
   }
 }
 
+void SingletonGenEngine::setFitnessStrategy(IFitnessStrategy* strategy) {
+  m_fitnessStrategy = strategy;
+}
+
+void SingletonGenEngine::calcFitness(Generation* generation) {
+  std::vector<Individual*>* individuals;
+  std::vector<const Individual*> batch;
+  std::vector<double> fitness;
+
+  if(m_fitnessStrategy==0)
+    return;
+
+  // take the results of the asynchronous evaluations
+  m_fitnessStrategy->collect();
+
+  if(generation==0)
+    generation = getActualGeneration();
+
+  individuals = generation->getAllUnCalculatedIndividuals();
+  if(individuals->size()>0) {
+    batch.assign(individuals->begin(),individuals->end());
+    m_fitnessStrategy->getFitnessBatch(batch,fitness);
+    for(unsigned int x=0;x<individuals->size();x++) {
+      (*individuals)[x]->setFitness(fitness[x],m_fitnessStrategy->isPredicted((*individuals)[x]));
+    }
+  }
+
+  delete individuals;
+}
+
+void SingletonGenEngine::submitFitness(Individual* individual) {
+  if(m_fitnessStrategy!=0)
+    m_fitnessStrategy->submit(individual);
+}
+
 double SingletonGenEngine::getFitness(const Individual* individual) {
   return m_fitnessStrategy->getFitness(individual);
 }
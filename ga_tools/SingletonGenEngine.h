@@ -206,6 +206,7 @@ public:
 
 	/**
 	 * this function makes a update on the statistical data of the gen. alg.
+	 * Before the missing fitness values are calculated (see calcFitness).
 	 * @param factor (double) the factor is for the whisker distance
 	 */
 	void update(double factor = 1.5);
@@ -226,7 +227,24 @@ public:
 	 * decide the fitness strategy.
 	 * @param strategy (IFitnessStrategy*) the fitness strategy of the alg.
 	 */
-	inline void setFitnessStrategy(IFitnessStrategy* strategy) {m_fitnessStrategy = strategy;}
+	void setFitnessStrategy(IFitnessStrategy* strategy);
+
+	/**
+	 * calculates the fitness values of all individuals of a generation which have no
+	 * fitness value yet. All of them are given at once to the fitness strategy
+	 * (see IFitnessStrategy::getFitnessBatch), so they can be evaluated in parallel.
+	 * Individuals which are submitted (see submitFitness) are collected before.
+	 * @param generation (Generation*) the generation. If zero the actual generation is used.
+	 */
+	void calcFitness(Generation* generation = 0);
+
+	/**
+	 * gives a new individual to the fitness strategy (see IFitnessStrategy::submit). If the strategy
+	 * is asynchronous (e.g. a ParallelFitnessStrategy, also wrapped in a CachedFitnessStrategy)
+	 * the evaluation starts while the other individuals are created. Otherwise nothing happens.
+	 * @param individual (Individual*) the new individual
+	 */
+	void submitFitness(Individual* individual);
 
 	/**
 	 * calculate for a individual the fitness value.
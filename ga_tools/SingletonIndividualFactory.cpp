@@ -32,6 +32,8 @@
 #include "Generation.h"
 #include "Gen.h"
 #include "GenContext.h"
+#include "GenPrototype.h"
+#include "TemplateValue.h"
 
 SingletonIndividualFactory* SingletonIndividualFactory::m_factory = 0;
 int SingletonIndividualFactory::m_number = 0;
@@ -95,3 +97,21 @@ Individual* SingletonIndividualFactory::createIndividual(Individual* individual1
 
         return newInd;
 }
+
+Individual* SingletonIndividualFactory::createIndividual(const double* values, int numValues, Individual* individual1, Individual* individual2, std::string name)const {
+        Individual* ind = new Individual(name,m_number++,individual1,individual2);
+        GenPrototype* prototype;
+        std::vector<GenPrototype*> storage;
+        Generation* generation = SingletonGenEngine::getInstance()->getActualGeneration();
+
+        storage = SingletonGenEngine::getInstance()->getSetOfGenPrototyps();
+        int num = storage.size();
+        for(int x=0;x<num && x<numValues;x++) {
+                prototype = storage[x];
+                SingletonGenFactory::getInstance()->createGen(prototype->getContext(generation),ind,prototype,new TemplateValue<double>(values[x]));
+        }
+
+        SingletonGenEngine::getInstance()->addIndividual(ind);
+
+        return ind;
+}
@@ -75,6 +75,16 @@ public:
 	 * @return (Individual*) the new individual
 	 */
 	Individual* createIndividual(Individual* individual1, Individual* individual2, RandGen* random, std::string name=createName())const;	// recombinate
+	/**
+	 * create a new individual with given double values (one for every GenPrototype, see DenseGenome)
+	 * @param values (const double*) the values of the genes
+	 * @param numValues (int) number of values
+	 * @param individual1 (Individual*) parent 1 or zero
+	 * @param individual2 (Individual*) parent 2 or zero
+	 * @param name (string) the name of the new individual. Will be automaticly created
+	 * @return (Individual*) the new individual
+	 */
+	Individual* createIndividual(const double* values, int numValues, Individual* individual1=0, Individual* individual2=0, std::string name=createName())const;	// from values
 
 	//reset m_number inside restore
 	/**
@@ -0,0 +1,90 @@
+/***************************************************************************
+                          densegenometest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the DenseGenome
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/randomgenerator.h>
+
+#include "SingletonGenAlgAPI.h"
+#include "SingletonGenEngine.h"
+#include "Generation.h"
+#include "Individual.h"
+#include "Gen.h"
+#include "TemplateValue.h"
+#include "DenseGenome.h"
+#include "EliteSelectStrategy.h"
+
+#include <vector>
+
+using namespace std;
+
+/// creates a first generation of size individuals with numGenes genes in [-1,1]
+Generation* setupGenAlg(int numGenes, int size, RandGen* random){
+  SingletonGenAlgAPI* api = SingletonGenAlgAPI::getInstance();
+  api->setGenerationSizeStrategy(api->createFixGenerationSizeStrategy(size));
+  api->setSelectStrategy(api->createEliteSelectStrategy());
+  api->setFitnessStrategy(api->createSumFitnessStrategy());
+  IMutationFactorStrategy* mfs = api->createFixMutationFactorStrategy(api->createDoubleValue(0.1));
+  IMutationStrategy* ms = api->createValueMutationStrategy(mfs, 50);
+  for(int x=0; x<numGenes; x++){
+    api->insertGenPrototype(api->createPrototype("g", api->createDoubleRandomStrategy(random,-1.0,2.0,0.0), ms));
+  }
+  api->prepare(size, 0, random);
+  return api->getEngine()->getActualGeneration();
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckSelectElite ) {
+  cout << "\n -[ Check selectElite against the EliteSelectStrategy ]-\n";
+  RandGen rand;
+  rand.init(1);
+  const int numGenes = 4;
+  const int survivors = 8;
+  Generation* old = setupGenAlg(numGenes, 10, &rand);
+  const int size = old->getCurrentSize();
+  unit_assert( "population", size > survivors );
+
+  // mixed sign fitness (also with equal absolute values)
+  vector<double> fitness(size);
+  for(int x=0; x<size; x++){
+    fitness[x] = (x%2==0 ? -1.0 : 1.0) * (0.05 + (double)((x*7)%size)/size);
+    old->getIndividual(x)->setFitness(fitness[x]);
+  }
+  fitness[3] = -fitness[2];
+  old->getIndividual(3)->setFitness(fitness[3]);
+
+  Generation selected(1, survivors, 0);
+  EliteSelectStrategy elite;
+  elite.select(old, &selected);
+  unit_assert( "elite size", selected.getCurrentSize() == survivors );
+
+  DenseGenome dense(SingletonGenEngine::getInstance()->getSetOfGenPrototyps(), size);
+  dense.loadGeneration(old);
+  dense.selectElite(fitness, survivors);
+  unit_assert( "dense size", dense.getNumIndividuals() == survivors );
+
+  bool same = true;
+  for(int x=0; x<survivors; x++){
+    const Individual* ind = selected.getIndividual(x);
+    const double* row = dense.getRow(x);
+    same &= fitness[x] == ind->getFitnessC();
+    for(int y=0; y<numGenes; y++){
+      TemplateValue<double>* v = dynamic_cast<TemplateValue<double>*>(ind->getGen(y)->getValue());
+      same &= v!=0 && v->getValue() == row[y];
+    }
+  }
+  unit_assert( "same survivors", same );
+  unit_pass();
+}
+
+UNIT_TEST_RUN( "DenseGenome Tests" )
+  ADD_TEST( CheckSelectElite )
+
+  UNIT_TEST_END
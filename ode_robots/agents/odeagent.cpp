@@ -123,11 +123,15 @@ namespace lpzrobots {
       FOREACHC(std::list<Configurable*>, globalData->globalconfigurables, c){
         plotEngine.addConfigurable(*c);
       }
+      // before init(), which would otherwise seed the agent with rand()
+      if(globalData->odeConfig.randomStreams)
+        setRandomStream(globalData->odeConfig.getRandomSeed(),
+                        globalData->odeConfig.nextRandomStream());
     }
   }
 
-  void OdeAgent::step(double noise, double time){
-    Agent::step(noise, time);
+  void OdeAgent::sense(double time){
+    Agent::sense(time);
     // for the main trace we do not call track, this in done in agent
     // track the segments
     FOREACH(TraceDrawerList, segmentTracking, td){
@@ -175,16 +179,6 @@ namespace lpzrobots {
     }
   }
 
-  void OdeAgent::stepOnlyWiredController(double noise, double time) {
-    WiredController::step(rsensors,rsensornumber, rmotors, rmotornumber, noise, time);
-    trackrobot.track(robot, time); // we have to do this here because agent.step is not called
-    // track the segments
-    FOREACH(TraceDrawerList, segmentTracking, td){
-      td->track(time);
-    }
-
-  }
-
   void OdeAgent::trace(GlobalData& global){
     mainTrace.drawTrace(global);
     FOREACH(TraceDrawerList, segmentTracking, td){
@@ -252,18 +246,6 @@ namespace lpzrobots {
   }
 
 
-  void OdeAgent::setMotorsGetSensors() {
-    robot->setMotors(rmotors, rmotornumber);
-
-    assert(robot && rsensors && rmotors);
-
-    int len =  robot->getSensors(rsensors, rsensornumber);
-    if(len != rsensornumber){
-      fprintf(stderr, "%s:%i: Got not enough sensors, expected %i, got %i!\n", __FILE__, __LINE__,
-        rsensornumber, len);
-    }
-  }
-
   void OdeAgent::fixateRobot(GlobalData& global, int primitiveID, double time){
     OdeRobot* r = dynamic_cast<OdeRobot*>(robot);
     if(!r) return;
@@ -88,25 +88,10 @@ namespace lpzrobots {
       return Agent::init(controller, robot, wiring, seed);
     }
 
-    virtual void step(double noise, double time);
+    /** sense stage (see Agent::sense()), additionally tracks the segments */
+    virtual void sense(double time);
 
-    /**
-     * Special function for the class Simulation to seperate the step
-     * of the WiredController (plus TrackRobot) and the setting and getting
-     * of the motor- and sensorvalues.
-     * @param noise @see step()
-     * @param time @see step()
-     */
-    virtual void stepOnlyWiredController(double noise, double time);
-
-    /**
-     * Special function for the class Simulation to seperate the step
-     * of the WiredController (plus TrackRobot) and the setting and getting
-     * of the motor- and sensorvalues.
-     */
-    virtual void setMotorsGetSensors();
-
-    /** should be called before step() or stepOnlyWiredController()
+    /** should be called before step() or sense()
         and calls operators and robot->sense()
     */
     virtual void beforeStep(GlobalData& global);
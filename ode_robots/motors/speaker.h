@@ -52,7 +52,7 @@ namespace lpzrobots {
     virtual bool act(GlobalData& globaldata){
       Sound s = Sound(globaldata.time, own->getPosition(),
                       intensity,frequency, (void*)own);
-      globaldata.sounds.push_back(s);
+      globaldata.addSound(s);
       s.createVisual(globaldata, visualSize, visualOffset);
 
       return true;
@@ -50,6 +50,8 @@ namespace lpzrobots {
     drawInterval = calcDrawInterval(fps,realTimeFactor);
     // prepare name;
     videoRecordingMode=false;
+    randomStreams=false;
+    randomStreamCount=0;
   }
 
 
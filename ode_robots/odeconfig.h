@@ -24,6 +24,7 @@
 #ifndef __ODECONFIG_H
 #define __ODECONFIG_H
 
+#include <stdint.h>
 #include <selforg/configurable.h>
 #include "odehandle.h"
 
@@ -47,6 +48,12 @@ namespace lpzrobots {
       randomSeedCopy = randomSeed;
     }
 
+    /** returns the stream of the counter based random generator for the next agent
+        (see Agent::setRandomStream()). The agents get the streams 0,1,2...
+        in the order of their construction.
+    */
+    virtual uint64_t nextRandomStream() const { return randomStreamCount++; }
+
     virtual void setOdeHandle(const OdeHandle& odeHandle);
 
     virtual void setVideoRecordingMode(bool mode);
@@ -74,9 +81,12 @@ namespace lpzrobots {
 
     double realTimeFactor;
     double fps;
+    /// agents use independent counter based random streams of the random seed (cmdline -rngstream)
+    bool randomStreams;
   protected:
     long randomSeed;
     double randomSeedCopy;
+    mutable uint64_t randomStreamCount;
   };
 
 }
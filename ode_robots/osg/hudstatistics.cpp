@@ -51,6 +51,7 @@ namespace lpzrobots {
     fontsize=12;
     yOffset = fontsize + 4;
     statTool = new StatisticTools();
+    shownUpdate = -1;
   }
 
   HUDStatisticsManager::~HUDStatisticsManager() {
@@ -79,7 +80,9 @@ StatisticMeasure* HUDStatisticsManager::getMeasure(double& observedValue, const
   text->setText(buffer);
 
   // create WindowStatistic
-  this->windowStatisticList.push_back(new WindowStatistic(newMeasure,text));
+  WindowStatistic* ws = new WindowStatistic(newMeasure,text);
+  this->windowStatisticList.push_back(ws);
+  this->windowStatisticMap.insert(std::make_pair(newMeasure->getName(), ws));
   return newMeasure;
 }
 
@@ -108,7 +111,9 @@ double& HUDStatisticsManager::addMeasure(AbstractMeasure* measure) {
   text->setText(buffer);
 
   // create WindowStatistic
-  this->windowStatisticList.push_back(new WindowStatistic(measure,text));
+  WindowStatistic* ws = new WindowStatistic(measure,text);
+  this->windowStatisticList.push_back(ws);
+  this->windowStatisticMap.insert(std::make_pair(measure->getName(), ws));
   this->statTool->addMeasure(measure);
   return  measure->getValueAddress();
 }
@@ -135,30 +140,37 @@ double& HUDStatisticsManager::addMeasureList(std::list<StatisticMeasure*> measur
 }
 
 HUDStatisticsManager::WindowStatistic* HUDStatisticsManager::getMeasureWS(const std::string& measureName){
-  FOREACH(std::list<WindowStatistic*>, windowStatisticList, i) {
-    if((*i)->getMeasure()->getName() == measureName){
-      return *i;
-    }
-  }
-  return 0;
+  std::map<std::string, WindowStatistic*>::const_iterator it = windowStatisticMap.find(measureName);
+  return it != windowStatisticMap.end() ? it->second : 0;
 }
 
 
+void HUDStatisticsManager::WindowStatistic::updateText() {
+  double v = measure->getValue();
+  // setText retriggers the glyph layout, so only do it if needed
+  if (shown && v == shownValue)
+    return;
+  char valueBuf[100];
+  char printstr[24];
+  sprintf(printstr, ": %%.%if", measure->getDisplayPrecision());
+  sprintf(valueBuf,printstr,v);
+
+  std::string buffer(measure->getName());
+  buffer.append(valueBuf);
+  text->setText(buffer);
+  shownValue = v;
+  shown = true;
+}
+
 void HUDStatisticsManager::doOnCallBack(BackCaller* source, BackCaller::CallbackableType /* = BackCaller::DEFAULT_CALLBACKABLE_TYPE */) {
   // go through WindowStatictList and update the graphical text, that should be all!
-  if (statTool->measureStarted())
+  // Nothing to do if the measures were not updated since the last frame (e.g. paused)
+  if (statTool->measureStarted() && statTool->getUpdateCount() != shownUpdate) {
     FOREACHC(std::list<WindowStatistic*>, windowStatisticList, i) {
-      char valueBuf[100];
-      char printstr[24];
-      sprintf(printstr, ": %%.%if", (*i)->getMeasure()->getDisplayPrecision());
-
-      sprintf(valueBuf,printstr,(*i)->getMeasure()->getValue());
-
-      std::string buffer((*i)->getMeasure()->getName());
-      buffer.append(valueBuf);
-
-      (*i)->getText()->setText(buffer);
+      (*i)->updateText();
     }
+    shownUpdate = statTool->getUpdateCount();
+  }
 
 }
 
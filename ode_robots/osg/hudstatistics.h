@@ -25,6 +25,7 @@
 #define __HUD_STATISTICS_H
 
 #include <selforg/statistictools.h>
+#include <map>
 
 #include "color.h"
 
@@ -67,7 +68,7 @@ public:
   public:
 
     WindowStatistic(AbstractMeasure* measure, osgText::Text* text) : measure(measure),
-      text(text) {}
+      text(text), shownValue(0), shown(false) {}
 
     virtual ~WindowStatistic() {}
 
@@ -75,9 +76,14 @@ public:
 
     virtual osgText::Text* getText() { return text; }
 
+    /// updates the text if the value of the measure changed since the last call
+    virtual void updateText();
+
   private:
     AbstractMeasure* measure;
     osgText::Text* text;
+    double shownValue; // value currently displayed
+    bool shown;        // false until the first value is displayed
   };
 
 public:
@@ -186,8 +192,8 @@ public:
 
   virtual StatisticTools* getStatisticTools() { return statTool; }
 
-  /** searches for the measure with the given name and returns it windowstatistics
-      (measure and graphics together)
+  /** returns the windowstatistics (measure and graphics together)
+      of the measure with the given name (map lookup)
       @return 0 if not measure was found
    */
   virtual WindowStatistic* getMeasureWS(const std::string& measureName);
@@ -200,6 +206,10 @@ protected:
 
 /// the struct list which holds the measures and the appropiate text
   std::list<WindowStatistic*> windowStatisticList;
+  /// index of windowStatisticList by measure name
+  std::map<std::string, WindowStatistic*> windowStatisticMap;
+  /// update count of statTool at the last refresh of the texts
+  long shownUpdate;
 
   StatisticTools* statTool;
 
@@ -156,16 +156,17 @@ namespace lpzrobots {
   }
 
   void OSGPrimitive::setColor(const Color& color){
+    // the color is also kept without graphics (used by headless cameras)
+    osgHandle.color = color;
     if (!osgHandle.cfg || osgHandle.cfg->noGraphics)
       return;
     if(shape.valid()){
-      osgHandle.color = color;
       shape->setColor(color);
     }
   }
 
   void OSGPrimitive::setColor(const std::string& color){
-    if (!osgHandle.cfg || osgHandle.cfg->noGraphics)
+    if (!osgHandle.cfg)
       return;
     setColor(osgHandle.getColor(color));
   }
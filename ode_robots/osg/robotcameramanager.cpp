@@ -33,6 +33,7 @@
 #include <osg/Geode>
 
 #include <selforg/stl_adds.h>
+#include <algorithm>
 
 
 namespace lpzrobots {
@@ -57,6 +58,10 @@ namespace lpzrobots {
 
   void RobotCameraManager::addCamera(Camera* cam){
     if(!cam) return;
+    if(cam->isHeadless()){ // nothing to display
+      headlessCameras.push_back(cam);
+      return;
+    }
     RobotCam robotcam;
     robotcam.cam    = cam;
     const Camera::CameraImages& imgs = cam->getImages();
@@ -70,6 +75,11 @@ namespace lpzrobots {
   }
 
   void RobotCameraManager::removeCamera(Camera* cam){
+    if(cam->isHeadless()){
+      headlessCameras.erase(std::remove(headlessCameras.begin(), headlessCameras.end(), cam),
+                            headlessCameras.end());
+      return;
+    }
     FOREACH(RobotCams,cameras,it){
       if(it->cam == cam){
         cameras.erase(it);
@@ -82,6 +92,12 @@ namespace lpzrobots {
 
 
 
+  void RobotCameraManager::renderHeadless(){
+    FOREACH(std::vector<Camera*>, headlessCameras, c){
+      (*c)->renderHeadless();
+    }
+  }
+
   void RobotCameraManager::updateView(){
     display->removeChildren(0,display->getNumChildren());
     if(!enabled) return;
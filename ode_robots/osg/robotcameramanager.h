@@ -35,6 +35,7 @@ namespace lpzrobots {
      Manages camera sensors. The cameras are rendered to texture offscreen,
      meaning independent of the normal graphical rendering.
      Additionally the view of the cameras is displayed as an overlay.
+     Without graphics the cameras are rendered on the CPU (see renderHeadless).
    */
   class RobotCameraManager : public osgGA::GUIEventHandler {
     struct Overlay {
@@ -63,6 +64,9 @@ namespace lpzrobots {
     virtual osg::Group* getDisplay() { return display; }
     virtual osg::Group* getOffScreen()  { return offscreen; }
 
+    /// renders all cameras that have no OpenGL context (noGraphics mode)
+    virtual void renderHeadless();
+
     /* ** GUIEventHandler interface **/
     virtual bool handle (const osgGA::GUIEventAdapter& ea,
                          osgGA::GUIActionAdapter& aa,
@@ -76,6 +80,7 @@ namespace lpzrobots {
     osg::ref_ptr<osg::Group> display;
     osg::ref_ptr<osg::Group> offscreen;
     RobotCams cameras;
+    std::vector<Camera*> headlessCameras;
 
     bool enabled;
     float scale;
@@ -211,6 +211,10 @@ namespace lpzrobots {
     setCollisionCallback(dummyCallBack,0);
   }
 
+  bool Substance::isNoContact() const {
+    return callback == dummyCallBack;
+  }
+
 
   // *** Anisotop friction stuff ****
 
@@ -166,6 +166,9 @@ namespace lpzrobots {
      */
     void toNoContact();
 
+    /// true if the substance was set with toNoContact()
+    bool isNoContact() const;
+
     /** enables anisotrop friction.
         The friction along the given axis is ratio fold of the friction in the other directions.
         If ratio = 0.1 and axis=Axis(0,0,1) then the fiction along the z-axis
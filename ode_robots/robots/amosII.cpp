@@ -556,64 +556,54 @@ namespace lpzrobots {
 
 //------------------------Add GoalSensor by Ren-------------------
     if (GoalSensor_active) {
+      // each goal sensor gives the relative position (x,y,z)
+      sensor gls_val[3];
       //the first goal
       std::vector<RelativePositionSensor>::iterator it = GoalSensor.begin(); //we only use one goal sensor
-      std::list<sensor> gls_val = it->getList();
-      sensors[G0z_s] = gls_val.back();
-      gls_val.pop_back();
-      sensors[G0y_s] = gls_val.back();
-      gls_val.pop_back();
-      sensors[G0x_s] = gls_val.back();
-      gls_val.pop_back();
+      it->get(gls_val, 3);
+      sensors[G0x_s] = gls_val[0];
+      sensors[G0y_s] = gls_val[1];
+      sensors[G0z_s] = gls_val[2];
 
       //the second goal
       it++;
-      gls_val = it->getList();
-      sensors[G1z_s] = gls_val.back();
-      gls_val.pop_back();
-      sensors[G1y_s] = gls_val.back();
-      gls_val.pop_back();
-      sensors[G1x_s] = gls_val.back();
-      gls_val.pop_back();
+      it->get(gls_val, 3);
+      sensors[G1x_s] = gls_val[0];
+      sensors[G1y_s] = gls_val[1];
+      sensors[G1z_s] = gls_val[2];
 
       //the third goal
       it++;
-      gls_val = it->getList();
-      sensors[G2z_s] = gls_val.back();
-      gls_val.pop_back();
-      sensors[G2y_s] = gls_val.back();
-      gls_val.pop_back();
-      sensors[G2x_s] = gls_val.back();
-      gls_val.pop_back();
+      it->get(gls_val, 3);
+      sensors[G2x_s] = gls_val[0];
+      sensors[G2y_s] = gls_val[1];
+      sensors[G2z_s] = gls_val[2];
     }
     //------------------------Add GoalSensor by Ren-------------------
 
     //------------------------Add Orientation Sensor by Ren-------------------
 
-    std::list<sensor> Ori_lst =  OrientationSensor->getList();
+    sensor ori[9]; // at most 3 axes with 3 components
+    OrientationSensor->get(ori, 9);
 
     double ori1,ori2,ori3;
 
-    ori1 = Ori_lst.front();
-    Ori_lst.pop_front();
-    ori2 = Ori_lst.front();
-    Ori_lst.pop_front();
-    ori3 = Ori_lst.front();
+    ori1 = ori[0];
+    ori2 = ori[1];
+    ori3 = ori[2];
     sensors[BX_ori] = ori1; //atan2(ori2,ori1)*180/M_PI;
     sensors[BY_ori] = ori2;
     sensors[BZ_ori] = ori3;
 
     //Adding for Ren simulated annealing experiment
     sensors[G0angleyaw_s] = atan2(ori2,ori1)*180/M_PI;
-
-    Ori_lst.clear();
     //------------------------Add Orientation Sensor by Ren-------------------
 
 
     //Added sound sensors (2) // get sensor signals and send to controller
-    sensors[Microphone0_s] = soundsensors.at(0)->getList().front();
-    sensors[Microphone1_s] = soundsensors.at(1)->getList().front();
-    sensors[Microphone2_s] = soundsensors.at(2)->getList().front();
+    soundsensors.at(0)->get(&sensors[Microphone0_s], 1);
+    soundsensors.at(1)->get(&sensors[Microphone1_s], 1);
+    soundsensors.at(2)->get(&sensors[Microphone2_s], 1);
 
 #ifdef VERBOSE
     std::cerr << "AmosII::getSensors END\n";
@@ -58,14 +58,25 @@ namespace lpzrobots {
 
   int  OdeRobot::getSensors(sensor* sensors_, int sensornumber) {
     assert(initialized);
-    int len = 0;
-    len += getSensorsIntern(sensors_,sensornumber);
-    for(auto& i: sensors){
-      len += i.first->get(sensors_ + len, sensornumber - len);
+    if(sensorSlots.size() != sensors.size())
+      updateSensorSlots();
+    int len = getSensorsIntern(sensors_,sensornumber);
+    // each sensor writes directly at its position in the sensor vector
+    for(auto& s: sensorSlots){
+      len = s.second + s.first->get(sensors_ + s.second, sensornumber - s.second);
     }
     return len;
   }
 
+  void OdeRobot::updateSensorSlots(){
+    sensorSlots.clear();
+    int offset = getSensorNumberIntern();
+    for(auto& i: sensors){
+      sensorSlots.push_back(std::pair<Sensor*, int>(i.first.get(), offset));
+      offset += i.first->getSensorNumber();
+    }
+  }
+
   void OdeRobot::setMotors(const double* motors_, int motornumber) {
     assert(initialized);
     int len = 0;
@@ -83,6 +94,7 @@ namespace lpzrobots {
       s += i.first->getSensorNumber();
     }
     askedfornumber=true;
+    updateSensorSlots();
     return getSensorNumberIntern()  + s;
   }
 
@@ -157,6 +169,7 @@ namespace lpzrobots {
       attachSensor(sa);
     }
     sensors.push_back(sa);
+    sensorSlots.clear();
   }
 
   void OdeRobot::addMotor(std::shared_ptr<Motor> motor, Attachment attachment){
@@ -185,6 +198,7 @@ namespace lpzrobots {
 
   void OdeRobot::cleanup(){
     sensors.clear();
+    sensorSlots.clear();
     motors.clear(); // this also deletes the pointers
     FOREACH(std::vector<Joint*>, joints, j){
       if(*j) delete *j;
@@ -260,6 +260,9 @@ namespace lpzrobots {
     /// deletes all objects (primitives) and joints (is called automatically in destructor)
     virtual void cleanup();
 
+    /// computes the position of each generic sensor in the sensor vector (see sensorSlots)
+    void updateSensorSlots();
+
   protected:
     /// list of objects (should be populated by subclasses)
     Primitives objects;
@@ -268,6 +271,9 @@ namespace lpzrobots {
 
     std::list<SensorAttachment> sensors; // list of generic sensors
     std::list<MotorAttachment> motors;   // list of generic motors
+    /** generic sensors with their offset in the sensor vector (flat copy of sensors,
+        such that getSensors does not need to count or traverse the list) */
+    std::vector<std::pair<Sensor*, int> > sensorSlots;
 
     TmpJoint* fixationTmpJoint;
     Pose initialPose;                    // initial pose of main primitive
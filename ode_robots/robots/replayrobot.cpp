@@ -27,31 +27,28 @@
 
 #include "replayrobot.h"
 using namespace std;
-using namespace matrix;
 
 namespace lpzrobots {
 
   ReplayRobot::ReplayRobot(const OdeHandle& odeHandle,
                  const OsgHandle& osgHandle,
-                 const char* filename)
+                 const char* filename, bool repeat)
     : OdeRobot(odeHandle, osgHandle, "ReplayRobot", "$Id$"),
-      filename(filename){
+      filename(filename), repeat(repeat), position(0) {
 
-    f=fopen(filename,"r");
-    if(!f){
-      cerr<< "ReplayRobot: error while opening file " << filename << endl;
-      exit(1);
-    }
-    if(!parseDataFileForHeader(f, sensorStart, sensorEnd,  motorStart, motorEnd)){
-      cerr<< "ReplayRobot: error while seaching for header in file " << filename << endl;
+    log = ReplayLog::open(filename);
+    if(!log){
+      cerr<< "ReplayRobot: error while opening file or seaching for header in file " << filename << endl;
       exit(1);
     }
+    log->getColumnRange("x[", sensorStart, sensorEnd);
+    log->getColumnRange("y[", motorStart, motorEnd);
+    addParameterDef("speed", &speed, 1.0, -100, 100, "playback speed (lines per step)");
     printf("Test: %i, %i, %i, %i\n", sensorStart, sensorEnd, motorStart, motorEnd);
 
   };
 
   ReplayRobot::~ReplayRobot(){
-    if(f) fclose(f);
   }
 
   void ReplayRobot::setMotorsIntern(const double* _motors, int motornumber){
@@ -59,91 +56,14 @@ namespace lpzrobots {
 
   int ReplayRobot::getSensorsIntern(sensor* s, int sensornumber){
     assert(sensornumber == (sensorEnd-sensorStart + 1));
-    if(!parseDataLine(sensors,f)){
-      cout << "ReplayRobot: no datafile in file" << endl;
-    }else{
-      sensors=sensors.rows(sensorStart, sensorEnd);
+    int line = log->getLine(position, repeat);
+    if(line < 0 || (!repeat && (position < 0 || position >= log->getLineNumber()))){
+      cout << "ReplayRobot: no data in file" << endl;
     }
-    sensors.convertToBuffer(s,sensorEnd-sensorStart + 1);
+    if(line >= 0)
+      log->getColumns(line, sensorStart, sensorEnd, s);
+    position += speed;
     return sensorEnd-sensorStart + 1;
   };
 
-  bool ReplayRobot::parseDataFileForHeader(FILE* f, int & sensorstart, int& sensorend,  int& motorstart, int& motorend){
-    char buffer[1024];
-    int i;
-    sensorstart=-1;
-    sensorend=-1;
-    motorstart=-1;
-    motorend=-1;
-
-    while(fgets(buffer, 1024, f)) {
-      if(buffer[0]=='#' && buffer[1]=='C'){
-        // scan line and return
-        i=0;
-        char* p;
-        p=strtok(buffer," ");
-        if(!p) return false; // frist one is #C
-        while((p=strtok(NULL," "))!=NULL )  {
-          if(p[0]=='x' && p[1]=='['){
-            if(sensorstart==-1) sensorstart=i;
-            sensorend=i;
-          }
-          if(p[0]=='y' && p[1]=='['){
-            if(motorstart==-1) motorstart=i;
-            motorend=i;
-          }
-          i++;
-        }
-        return true;
-      }
-    }
-    return false;
-  }
-
-  bool ReplayRobot::isEmpty(const char* c){
-    const char* p = c;
-    bool foundsomething = false;
-    while(*p != 0){
-      if(*p > ' ') foundsomething = true;
-      p++;
-    }
-    return !foundsomething;
-  }
-
-
-  bool ReplayRobot::check4Number(const char* c){
-    const char* p = c;
-    while(*p != 0){
-      if(*p >= '0' && *p <= '9') return true;
-      p++;
-    }
-    return false;
-  }
-
-  bool ReplayRobot::parseDataLine(Matrix& data, FILE* f){
-    char buffer[1024];
-    int i;
-    double dat[1024];
-    while(fgets(buffer, 1024, f)){
-      if(buffer[0]=='#' || isEmpty(buffer)){
-        continue;
-      }else{
-        i=0;
-        char* p;
-        p=strtok(buffer," ");
-        if(!p) return false;
-        dat[i] = atof(p);
-        i++;
-        while((p=strtok(NULL," "))!=NULL )  {
-          if(!check4Number(p)) continue;
-          dat[i] = atof(p);
-          i++;
-        };
-        data.set(i,1,dat);
-        return true;
-      }
-    };
-    return false;
-  }
-
 }
@@ -27,16 +27,21 @@
 
 #include "oderobot.h"
 #include <selforg/types.h>
-#include <selforg/matrix.h>
+#include <selforg/replaylog.h>
 
 namespace lpzrobots {
 
   /**
-   *
+   * Robot that replays the sensor values of a log file.
+   * The log is indexed once and shared by all ReplayRobots (and
+   * ReplayControllers) using the same file (@see ReplayLog).
+   * The playback speed (lines per step) is given by the parameter "speed"
+   * and the position can be changed with seek().
    */
   class ReplayRobot : public OdeRobot{
   public:
-    ReplayRobot(const OdeHandle& odeHandle, const OsgHandle& osgHandle, const char* filename);
+    ReplayRobot(const OdeHandle& odeHandle, const OsgHandle& osgHandle, const char* filename,
+                bool repeat = false);
 
     ~ReplayRobot();
 
@@ -74,15 +79,15 @@ namespace lpzrobots {
     */
     virtual void doInternalStuff(GlobalData& globalData) {}
 
+    /// sets the playback position (line of the log)
+    virtual void seek(double line) { position = line; }
+
+    virtual double getPosition() const { return position; }
+
   protected:
     /** the main object of the robot, which is used for position and speed tracking */
     virtual Primitive* getMainPrimitive() const { return 0; }
 
-    static bool parseDataFileForHeader(FILE* f, int & sensorstart, int& sensorend,  int& motorstart, int& motorend);
-    static bool parseDataLine(matrix::Matrix& data, FILE* f);
-    static bool isEmpty(const char* c);
-    static bool check4Number(const char* c);
-
 
   protected:
     int sensorStart;
@@ -90,9 +95,11 @@ namespace lpzrobots {
     int motorStart;
     int motorEnd;
 
-    matrix::Matrix sensors;
     const char* filename;
-    FILE* f;
+    std::shared_ptr<ReplayLog> log;
+    bool repeat;
+    double position;
+    paramval speed;
 
 
   };
@@ -80,22 +80,30 @@ namespace lpzrobots {
 
   int AxisOrientationSensor::get(sensor* sensors, int length) const{
     assert(own);
-    matrix::Matrix A = odeRto3x3RotationMatrix ( dBodyGetRotation ( own->getBody() ) );
+    // same as getList, but directly from the ODE rotation (A(i,j) = R[4*i+j],
+    //  see odeRto3x3RotationMatrix) without temporary matrices
+    const dReal* R = dBodyGetRotation ( own->getBody() );
+    int n=0;
     switch (mode) {
-    case OnlyZAxis:
-      if(dimensions == (X | Y | Z)) return A.column(2).convertToBuffer(sensors, length);
-      else return selectrows(sensors, length, A.column(2),dimensions);
+    case OnlyZAxis: // z-column
+      for(int i=0; i<3; i++){
+        if(( (1 << i) & dimensions) && n<length) sensors[n++] = R[4*i+2];
+      }
       break;
-    case ZProjection:
-      if(dimensions == (X | Y | Z)) return A.row(2).convertToBuffer(sensors, length);
-      else return selectrows(sensors, length, A.row(2)^(matrix::T),dimensions);
+    case ZProjection: // z-row
+      for(int i=0; i<3; i++){
+        if(( (1 << i) & dimensions) && n<length) sensors[n++] = R[8+i];
+      }
       break;
-    case Axis:
-      if(dimensions == (X | Y | Z)) return A.convertToBuffer(sensors, length);
-      else return selectrows(sensors, length, A,dimensions);
+    case Axis: // selected rows
+      for(int i=0; i<3; i++){
+        if(( 1 << i) & dimensions){
+          for(int j=0; j<3 && n<length; j++) sensors[n++] = R[4*i+j];
+        }
+      }
       break;
     }
-    return 0;
+    return n;
   }
 
 }
@@ -25,6 +25,11 @@
 #include "camera.h"
 
 #include <assert.h>
+#include <math.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/time.h>
+#include <pthread.h>
 
 #include <selforg/position.h>
 #include <osg/Matrix>
@@ -37,6 +42,7 @@
 #include "primitive.h"
 #include "pos.h"
 #include "axis.h"
+#include "color.h"
 #include <selforg/stl_adds.h>
 
 
@@ -61,9 +67,19 @@ namespace lpzrobots {
     sensorBody1 = 0;
     sensorBody2 = 0;
     ccd = 0;
+    cam = 0;
+    initialized = false;
+    headless = false;
+    rayCaster = 0;
+    renderTime = 0;
   }
 
   Camera::~Camera(){
+    if(headless && initialized)
+      osgHandle.scene->robotCamManager->removeCamera(this);
+    FOREACH(std::vector<RenderJob*>, renderJobs, j){
+      delete *j;
+    }
     if(ccd) ccd->unref();
     if(sensorBody1) delete sensorBody1;
     if(sensorBody2) delete sensorBody2;
@@ -87,35 +103,54 @@ namespace lpzrobots {
     }        
     conf.behind -= conf.camSize/2 + conf.camSize/6;
 
-    // set up the render to texture (image) camera.
-    cam = new osg::Camera;
-    cam->setClearMask(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    ccd = new osg::Image;
+    ccd->allocateImage(conf.width, conf.height, 1, GL_RGB, GL_UNSIGNED_BYTE);
 
-    // set up projection.
-    float ratio = (double)conf.width/(double)conf.height;
-    cam->setProjectionMatrixAsPerspective(conf.fov/ratio, conf.anamorph*ratio,0.05,50);        
-    cam->setComputeNearFarMode(osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR); 
+    headless = osgHandle.cfg && osgHandle.cfg->noGraphics;
+    if(headless){
+      // no OpenGL available: the image is rendered with the ray caster
+      rayCaster = odeHandle.getRayCaster();
+      assert(rayCaster);
+      int threads = conf.renderThreads;
+      if(threads <= 0)
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+      threads = std::max(1, std::min(threads, conf.height));
+      for(int i=0; i<threads; i++){
+        RenderJob* job = new RenderJob();
+        job->cam      = this;
+        job->rowStart = conf.height * i / threads;
+        job->rowEnd   = conf.height * (i+1) / threads;
+        renderJobs.push_back(job);
+      }
+    } else {
+      // set up the render to texture (image) camera.
+      cam = new osg::Camera;
+      cam->setClearMask(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // set view
-    cam->setReferenceFrame(osg::Transform::ABSOLUTE_RF);
-    osg::Matrix p = pose * body->getPose();
-    cam->setViewMatrixAsLookAt(Pos(0,0,-conf.behind)*p, Pos(Axis(0,0,1)*p), Pos(Axis(0,1,0)*p));
+      // set up projection.
+      float ratio = (double)conf.width/(double)conf.height;
+      cam->setProjectionMatrixAsPerspective(conf.fov/ratio, conf.anamorph*ratio,0.05,50);        
+      cam->setComputeNearFarMode(osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR); 
 
-    cam->setViewport(0, 0, conf.width, conf.height);
+      // set view
+      cam->setReferenceFrame(osg::Transform::ABSOLUTE_RF);
+      osg::Matrix p = pose * body->getPose();
+      cam->setViewMatrixAsLookAt(Pos(0,0,-conf.behind)*p, Pos(Axis(0,0,1)*p), Pos(Axis(0,1,0)*p));
+
+      cam->setViewport(0, 0, conf.width, conf.height);
     
-    // Frame buffer objects are the best option
-    cam->setRenderTargetImplementation(osg::Camera::FRAME_BUFFER_OBJECT);    
-    // We need to render to the texture BEFORE we render to the screen 
-    //  (does not matter because we do it offscreen)
-    cam->setRenderOrder(osg::Camera::PRE_RENDER);    
-    // Add world to be drawn to the texture/image
-    cam->addChild(osgHandle.scene->world_noshadow);
+      // Frame buffer objects are the best option
+      cam->setRenderTargetImplementation(osg::Camera::FRAME_BUFFER_OBJECT);    
+      // We need to render to the texture BEFORE we render to the screen 
+      //  (does not matter because we do it offscreen)
+      cam->setRenderOrder(osg::Camera::PRE_RENDER);    
+      // Add world to be drawn to the texture/image
+      cam->addChild(osgHandle.scene->world_noshadow);
   
-    ccd = new osg::Image;
-    ccd->allocateImage(conf.width, conf.height, 1, GL_RGB, GL_UNSIGNED_BYTE);    
-    // The camera will render into the image and its copied on each time it is rendered
-    cam->attach(osg::Camera::COLOR_BUFFER, ccd);   
-    cam->setPostDrawCallback(new PostDrawCallback(this));
+      // The camera will render into the image and its copied on each time it is rendered
+      cam->attach(osg::Camera::COLOR_BUFFER, ccd);   
+      cam->setPostDrawCallback(new PostDrawCallback(this));
+    }
 
         
     cameraImages.push_back(CameraImage(ccd, conf.show, conf.scale, conf.name));
@@ -149,7 +184,100 @@ namespace lpzrobots {
       sensorBody2->setMatrix(osg::Matrix::translate(0,-conf.camSize/6.0,
                                                     conf.camSize/6.0 + conf.camSize/4.0) * p);
     }
-    cam->setViewMatrixAsLookAt(Pos(0,0,-conf.behind)*p, Pos(0,0,1)*p, Pos(Axis(0,1,0)*p));
+    if(cam)
+      cam->setViewMatrixAsLookAt(Pos(0,0,-conf.behind)*p, Pos(0,0,1)*p, Pos(Axis(0,1,0)*p));
+  }
+
+  void Camera::renderHeadless(){
+    if(!headless || !initialized) return;
+    struct timeval start, end;
+    gettimeofday(&start, 0);
+
+    renderPose = pose * body->getPose();
+    rayCaster->update();
+    // the first job is done by the calling thread
+    std::vector<pthread_t> threads(renderJobs.size());
+    for(unsigned int i=1; i<renderJobs.size(); i++){
+      pthread_create(&threads[i], 0, renderThread, renderJobs[i]);
+    }
+    renderRows(renderJobs[0]->rowStart, renderJobs[0]->rowEnd, renderJobs[0]->query);
+    for(unsigned int i=1; i<renderJobs.size(); i++){
+      pthread_join(threads[i], 0);
+    }
+    ccd->dirty();
+
+    // start the image processing chain now
+    FOREACH(ImageProcessors, conf.processors, ip){
+      (*ip)->process();
+    }
+
+    gettimeofday(&end, 0);
+    renderTime = (end.tv_sec - start.tv_sec)*1000.0 + (end.tv_usec - start.tv_usec)/1000.0;
+  }
+
+  void* Camera::renderThread(void* data){
+    RenderJob* job = (RenderJob*)data;
+    job->cam->renderRows(job->rowStart, job->rowEnd, job->query);
+    return 0;
+  }
+
+  /// color of the primitive belonging to the geom (transforms are resolved)
+  static Color geomColor(dGeomID geom){
+    if(dGeomGetClass(geom) == dGeomTransformClass && dGeomTransformGetGeom(geom))
+      geom = dGeomTransformGetGeom(geom);
+    Primitive* prim = (Primitive*)dGeomGetData(geom);
+    if(prim && prim->getOSGPrimitive())
+      return prim->getOSGPrimitive()->getColor();
+    return Color(0.5, 0.5, 0.5);
+  }
+
+  void Camera::renderRows(int rowStart, int rowEnd, RayCaster::Query& query){
+    // same projection as the OpenGL camera (see init)
+    const double nearPlane = 0.05, farPlane = 50;
+    const double ratio  = (double)conf.width/(double)conf.height;
+    const double tanY   = tan(conf.fov/ratio * M_PI / 360.0);
+    const double tanX   = tanY * conf.anamorph * ratio;
+    const Color background(0.2, 0.2, 0.4);
+    const osg::Vec3 light = osg::Vec3(0.3, 0.2, 1) / osg::Vec3(0.3, 0.2, 1).length();
+
+    const osg::Vec3 eye = Pos(0, 0, -conf.behind) * renderPose;
+    const dGeomID ownGeom = body->getGeom();
+    unsigned char* data = ccd->data();
+    dContactGeom contact;
+    for(int j=rowStart; j<rowEnd; j++){ // row 0 is the bottom row
+      const double y = (2.0*(j+0.5)/conf.height - 1.0) * tanY;
+      unsigned char* pixel = data + j*conf.width*3;
+      for(int i=0; i<conf.width; i++, pixel+=3){
+        const double x = (2.0*(i+0.5)/conf.width - 1.0) * tanX;
+        // the camera looks along the local z-axis with the y-axis upwards,
+        //  thus the image x-axis is the negative local x-axis
+        osg::Vec3 dir = osg::Matrix::transform3x3(osg::Vec3(-x, y, 1), renderPose);
+        const double len = dir.normalize();
+        double start = nearPlane * len;
+        const double end = farPlane * len;
+        const double d[3] = { dir.x(), dir.y(), dir.z() };
+        Color c = background;
+        // the camera is mounted on its body, so the body itself is not seen
+        while(start < end){
+          const double o[3] = { eye.x() + d[0]*start, eye.y() + d[1]*start, eye.z() + d[2]*start };
+          if(!rayCaster->castRay(query, o, d, end - start, 0, contact))
+            break;
+          dGeomID hit = contact.g2;
+          if(hit == ownGeom || (dGeomGetClass(hit) == dGeomTransformClass &&
+                                dGeomTransformGetGeom(hit) == ownGeom)){
+            start += contact.depth + 1e-4;
+            continue;
+          }
+          const osg::Vec3 normal(contact.normal[0], contact.normal[1], contact.normal[2]);
+          const double diffuse = fabs(normal * light);
+          c = geomColor(hit) * (0.35 + 0.65 * diffuse);
+          break;
+        }
+        pixel[0] = (unsigned char)(std::min(std::max(c.r(), 0.0f), 1.0f) * 255);
+        pixel[1] = (unsigned char)(std::min(std::max(c.g(), 0.0f), 1.0f) * 255);
+        pixel[2] = (unsigned char)(std::min(std::max(c.b(), 0.0f), 1.0f) * 255);
+      }
+    }
   }
   
 }
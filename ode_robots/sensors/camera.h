@@ -28,6 +28,7 @@
 
 #include "osghandle.h"
 #include "odehandle.h"
+#include "raycaster.h"
 
 #include <osg/Matrix>
 #include <osg/Camera>
@@ -59,12 +60,17 @@ namespace lpzrobots {
     float scale;     ///< scaling for display
     std::string name; ///< name of the camera
     ImageProcessors processors; ///< list of image processors that filter the raw image
+    int renderThreads; ///< number of threads for rendering without graphics (0: one per core)
 
     /// removes and deletes all  processor
     void removeProcessors();
   };
 
   /** A Robot Camera. Implements a simulated camera with full OpenGL rendering.
+      Without graphics (-nographics) the image is rendered on the CPU by casting
+      one ray per pixel into the ODE scene (see renderHeadless), which is meant
+      for small resolutions (16x16 up to 128x128). Only the colors of the
+      primitives with a simple diffuse lighting are rendered (no textures and sky).
    */
   class Camera {
   public:
@@ -111,6 +117,7 @@ namespace lpzrobots {
       c.show      = true;
       c.scale     = 1.0;
       c.name      = "raw";
+      c.renderThreads = 0;
       return c;
     }
 
@@ -142,8 +149,30 @@ namespace lpzrobots {
 
     virtual void update();
 
+    /** renders the image on the CPU with the ray caster of the OdeHandle
+        and runs the image processors (used without graphics).
+        Called by the RobotCameraManager at each control step.
+    */
+    virtual void renderHeadless();
+
+    /// whether the camera is rendered on the CPU (no graphics)
+    bool isHeadless() const { return headless; }
+
+    /// time in ms needed to render the last headless frame (including image processing)
+    double getRenderTime() const { return renderTime; }
+
     bool isInitialized() { return initialized; }
   private:
+    struct RenderJob {
+      Camera* cam;
+      int rowStart;
+      int rowEnd;
+      RayCaster::Query query;
+    };
+    static void* renderThread(void* job);
+    /// renders the given image rows (from the bottom)
+    void renderRows(int rowStart, int rowEnd, RayCaster::Query& query);
+
     CameraConf conf;
 
     osg::Camera* cam;
@@ -159,6 +188,12 @@ namespace lpzrobots {
     Transform* transform;
 
     bool initialized;
+
+    bool headless;
+    RayCaster* rayCaster;
+    std::vector<RenderJob*> renderJobs;
+    osg::Matrix renderPose; ///< pose of the camera during headless rendering
+    double renderTime;
   };
 
 }
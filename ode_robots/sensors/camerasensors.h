@@ -251,11 +251,16 @@ namespace lpzrobots {
       for(int r=0; r< h; r++){
         const unsigned char* row = img->data(0, r);
         double pY = ((double)r-centerY);
+        // integer sums per row (exact and vectorisable)
+        int rowSum = 0;
+        long rowMoment = 0;
         for(int c=0; c < w; c++){
-          sum += row[c];
-          x  += row[c] * ((double)c-centerX);
-          y  += row[c] * pY;
+          rowSum    += row[c];
+          rowMoment += row[c] * c;
         }
+        sum += rowSum;
+        x   += rowMoment - rowSum * centerX;
+        y   += rowSum * pY;
       }
       if(sum<threshold){
         x = y = size = 0;
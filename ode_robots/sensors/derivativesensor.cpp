@@ -11,6 +11,7 @@ namespace lpzrobots {
   void DerivativeSensor::init(Primitive* own, Joint* joint){
     this->attachedSensor->init(own, joint);
     this->oldValues.resize(this->attachedSensor->getSensorNumber());
+    this->newValues.resize(this->attachedSensor->getSensorNumber());
   }
 
   int DerivativeSensor::getSensorNumber() const{
@@ -24,19 +25,18 @@ namespace lpzrobots {
   }
 
   std::list<sensor> DerivativeSensor::getList() const {
-    std::list<sensor> newValues = this->attachedSensor->getList();
-    std::list<sensor> derivatives(newValues.size());
-    auto iterNewValues = newValues.cbegin();
-    auto iterOldValues = this->oldValues.begin();
-    for(sensor& d: derivatives){
-      d = (*iterNewValues - *iterOldValues) / this->timeStepSize;
-      d *= this->factor;
-      *iterOldValues = *iterNewValues;
-      iterOldValues++;
-      iterNewValues++;
-    }
+    return getListOfArray();
+  }
 
-    return derivatives;
+  int DerivativeSensor::get(sensor* sensors, int length) const {
+    int n = this->attachedSensor->get(newValues.data(), newValues.size());
+    assert(length>=n);
+    for(int i=0; i<n; i++){
+      sensors[i] = (newValues[i] - oldValues[i]) / this->timeStepSize;
+      sensors[i] *= this->factor;
+      oldValues[i] = newValues[i];
+    }
+    return n;
   }
 
 }
@@ -2,6 +2,7 @@
 #define __DERIVATIVESENSOR_H
 
 #include "sensor.h"
+#include <vector>
 
 namespace lpzrobots {
 
@@ -27,11 +28,15 @@ namespace lpzrobots {
 
     virtual std::list<sensor> getList() const;
 
+    virtual int get(sensor* sensors, int length) const;
+
   protected:
     //Current time step of the simulation
     double timeStepSize;
     //Values of last time step
-    mutable std::list<sensor> oldValues;
+    mutable std::vector<sensor> oldValues;
+    //Buffer for the values of the attached sensor
+    mutable std::vector<sensor> newValues;
     //Sensor of which to measure derivatives
     Sensor* attachedSensor;
     //Scaling factor for derivative (if derivative is too small)
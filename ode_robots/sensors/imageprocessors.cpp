@@ -0,0 +1,158 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#include "imageprocessors.h"
+
+#include <unistd.h>
+#include <pthread.h>
+#include <algorithm>
+
+namespace lpzrobots {
+
+  unsigned char HSVImgProc::hueTable[3][256][511];
+  unsigned char HSVImgProc::satTable[256][256];
+  bool HSVImgProc::tablesInitialised = false;
+
+  void HSVImgProc::initTables(){
+    if(tablesInitialised) return;
+    // same calculations as in RGBtoHSV
+    for(int d=0; d<256; d++){
+      float delta = d;
+      for(int max=0; max<256; max++){
+        satTable[d][max] = (max == 0 || d == 0) ? 0 : (unsigned char)(255.0*delta / max);
+      }
+      for(int sector=0; sector<3; sector++){
+        for(int diff=-255; diff<=255; diff++){
+          if(d == 0){
+            hueTable[sector][d][diff+255] = 255;
+            continue;
+          }
+          float hue;
+          if(sector == 0)
+            hue = float( diff ) / delta;
+          else if(sector == 1)
+            hue = 2.0 + float( diff ) / delta;
+          else
+            hue = 4.0 + float( diff ) / delta;
+          hue *=30;
+          if( hue < 0 )
+            hue += 180;
+          hueTable[sector][d][diff+255] = int(hue);
+        }
+      }
+    }
+    tablesInitialised = true;
+  }
+
+  FusedImgProc::FusedImgProc(int threads, int minParallelPixels)
+    : threads(threads), minParallelPixels(minParallelPixels) {
+    if(this->threads <= 0)
+      this->threads = sysconf(_SC_NPROCESSORS_ONLN);
+  }
+
+  FusedImgProc::~FusedImgProc(){
+    FOREACH(std::vector<RowImageProcessor*>, stages, s){
+      delete *s;
+    }
+    FOREACH(std::vector<Job*>, jobs, j){
+      delete *j;
+    }
+  }
+
+  FusedImgProc* FusedImgProc::add(RowImageProcessor* stage){
+    assert(stage && (stages.empty() || !stages.back()->isReduction()));
+    stages.push_back(stage);
+    return this;
+  }
+
+  Camera::CameraImage FusedImgProc::init(const Camera::CameraImages& imgs){
+    assert(imgs.size()>0 && stages.size()>0);
+    src = imgs.back();
+    // initialise the stages as if they were a normal processing chain
+    Camera::CameraImages chain(imgs);
+    unsigned int maxRowBytes = 0;
+    FOREACH(std::vector<RowImageProcessor*>, stages, s){
+      const osg::Image* in = chain.back().img;
+      assert(in->t() == src.img->t()); // only the last stage may change the number of rows
+      rowBytes.push_back(in->getRowSizeInBytes());
+      chain.push_back((*s)->init(chain));
+      if(!(*s)->isReduction()){
+        assert(chain.back().img->s() == in->s());
+        maxRowBytes = std::max(maxRowBytes, chain.back().img->getRowSizeInBytes());
+      }
+    }
+    dest = chain.back();
+
+    // distribute the rows to the jobs
+    int h = src.img->t();
+    int n = (src.img->s() * h >= minParallelPixels) ? std::min(threads, h) : 1;
+    for(int i=0; i<n; i++){
+      Job* job = new Job();
+      job->proc     = this;
+      job->rowStart = h * i / n;
+      job->rowEnd   = h * (i+1) / n;
+      job->buffers[0].resize(maxRowBytes);
+      job->buffers[1].resize(maxRowBytes);
+      jobs.push_back(job);
+    }
+    return dest;
+  }
+
+  void FusedImgProc::processRows(int rowStart, int rowEnd, std::vector<unsigned char>* buffers){
+    const int w = src.img->s();
+    const int last = stages.size()-1;
+    for(int r=rowStart; r<rowEnd; r++){
+      const unsigned char* in = src.img->data(0, r);
+      for(int s=0; s<=last; s++){
+        unsigned char* out;
+        if(s == last)
+          out = stages[s]->isReduction() ? 0 : dest.img->data(0, r);
+        else
+          out = &buffers[s%2][0];
+        stages[s]->processRow(in, out, w, r);
+        in = out;
+      }
+    }
+  }
+
+  void* FusedImgProc::runJob(void* data){
+    Job* job = (Job*)data;
+    job->proc->processRows(job->rowStart, job->rowEnd, job->buffers);
+    return 0;
+  }
+
+  void FusedImgProc::process(){
+    // the first job is done by the calling thread
+    std::vector<pthread_t> ids(jobs.size());
+    for(unsigned int i=1; i<jobs.size(); i++){
+      pthread_create(&ids[i], 0, runJob, jobs[i]);
+    }
+    runJob(jobs[0]);
+    for(unsigned int i=1; i<jobs.size(); i++){
+      pthread_join(ids[i], 0);
+    }
+    stages.back()->finishFrame(dest.img);
+    dest.img->dirty();
+  }
+
+}
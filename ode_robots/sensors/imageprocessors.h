@@ -27,6 +27,7 @@
 #include "imageprocessor.h"
 
 #include <selforg/stl_adds.h>
+#include <vector>
 
 #define MIN3(x,y,z) x<y ? (x<z ? x : z) : (y<z ? y : z)
 #define MAX3(x,y,z) x>y ? (x>z ? x : z) : (y>z ? y : z)
@@ -75,14 +76,50 @@ namespace lpzrobots {
   };
 
 
+  /** Image processor that works row by row (pixel wise operations or sums).
+      Several of them can be fused into one pass over the image with FusedImgProc.
+      processRow must only write to dest (and for reductions to row specific data),
+      such that different rows can be processed in parallel.
+      @see StdImageProcessor
+   */
+  struct RowImageProcessor : public StdImageProcessor {
+    RowImageProcessor(bool show, float scale)
+      : StdImageProcessor(show,scale) {}
+
+    virtual ~RowImageProcessor() {}
+
+    /** processes one row of the source image.
+        @param src source pixels of the row
+        @param dest destination pixels of the row (0 for reductions)
+        @param width number of pixels in the row
+        @param row index of the row
+    */
+    virtual void processRow(const unsigned char* src, unsigned char* dest, int width, int row) = 0;
+
+    /// true if the destination has no pixel to pixel correspondence to the source (e.g. sums)
+    virtual bool isReduction() const { return false; }
+
+    /// called after all rows are processed, reductions write their result here
+    virtual void finishFrame(osg::Image* dest) {}
+
+    virtual void process(const osg::Image* src, osg::Image* dest){
+      bool reduction = isReduction();
+      for(int r=0; r < src->t(); ++r) {
+        processRow(src->data(0, r), reduction ? 0 : dest->data(0, r), src->s(), r);
+      }
+      finishFrame(dest);
+    }
+  };
+
+
 
   /// black and white image @see StdImageProcessor
-  struct BWImageProcessor : public StdImageProcessor {
+  struct BWImageProcessor : public RowImageProcessor {
     enum ChannelMask {Red = 1, Green = 2, Blue = 4, Hue = 1, Saturation = 2, Value = 4};
 
     /// @param channelmask which channels to consider, @see BWImageProcessor::ChannelMask
     BWImageProcessor(bool show, float scale, char channelmask = 7)
-      : StdImageProcessor(show,scale), channelmask(channelmask) {}
+      : RowImageProcessor(show,scale), channelmask(channelmask) {}
 
     virtual ~BWImageProcessor() {}
 
@@ -96,23 +133,24 @@ namespace lpzrobots {
       printf("BWImageProcessor: Select: Red %i, Green %i, Blue %i : numchannels %i\n",
              red, green, blue,numchannels);
       if(numchannels==0) numchannels=1; // avoid division by 0
+      // table for the division by the number of channels
+      for(int i=0; i<3*256; i++){
+        average[i] = i/numchannels;
+      }
+      assert(src.img->getPixelFormat()==GL_RGB && src.img->getDataType()==GL_UNSIGNED_BYTE);
     }
 
-    virtual void process(const osg::Image* src, osg::Image* dest){
-      assert(src && src->getPixelFormat()==GL_RGB && src->getDataType()==GL_UNSIGNED_BYTE);
-      for(int r=0; r < src->t(); ++r) {
-        const unsigned char* sdata = src->data(0, r);
-        unsigned char* ddata = dest->data(0, r);
-        for(int c=0; c < src->s(); ++c) {
-          (*ddata) =  (*(sdata)*red + *(sdata+1)*green + *(sdata+2)*blue)/numchannels;
-          sdata+=3;
-          ddata++;
-        }
+    virtual void processRow(const unsigned char* sdata, unsigned char* ddata, int width, int row){
+      const int r = red, g = green, b = blue;
+      for(int c=0; c < width; ++c) {
+        ddata[c] = average[sdata[0]*r + sdata[1]*g + sdata[2]*b];
+        sdata+=3;
       }
     }
     bool red, green, blue;
     char numchannels;
     char channelmask;
+    unsigned char average[3*256];
   };
 
   /** converts the image to a HSV coded image @see StdImageProcessor.
@@ -120,12 +158,12 @@ namespace lpzrobots {
       The h (hue) values are given by HSVImgProc::Colors
   */
 
-  struct HSVImgProc : public StdImageProcessor {
+  struct HSVImgProc : public RowImageProcessor {
     enum Colors {Red=0, Yellow=30, Green=60, Cyan=90,
                  Blue=120, Magenta=150, Red2=180, Gray=255, Span=30};
 
     HSVImgProc(bool show, float scale)
-      : StdImageProcessor(show,scale) {
+      : RowImageProcessor(show,scale) {
     }
 
     virtual ~HSVImgProc() {}
@@ -133,19 +171,16 @@ namespace lpzrobots {
     virtual void initDestImage(Camera::CameraImage& dest, const Camera::CameraImage& src){
       dest.img->allocateImage(src.img->s(), src.img->t(), 1, GL_RGB, GL_UNSIGNED_BYTE);
       dest.name  = "hsv(" + src.name + ")";
+      assert(src.img->getPixelFormat()==GL_RGB && src.img->getDataType()==GL_UNSIGNED_BYTE);
+      initTables();
     }
 
-    virtual void process(const osg::Image* src, osg::Image* dest){
-      assert(src && src->getPixelFormat()==GL_RGB && src->getDataType()==GL_UNSIGNED_BYTE);
-      for(int r=0; r < src->t(); ++r) {
-        const unsigned char* sdata = src->data(0, r);
-        unsigned char* ddata = dest->data(0, r);
-        for(int c=0; c < src->s(); ++c) {
-          RGBtoHSV(*(sdata),*(sdata+1),*(sdata+2),
-                   (*ddata), *(ddata+1), *(ddata+2));
-          sdata+=3;
-          ddata+=3;
-        }
+    virtual void processRow(const unsigned char* sdata, unsigned char* ddata, int width, int row){
+      for(int c=0; c < width; ++c) {
+        RGBtoHSVTab(*(sdata),*(sdata+1),*(sdata+2),
+                    (*ddata), *(ddata+1), *(ddata+2));
+        sdata+=3;
+        ddata+=3;
       }
     }
 
@@ -155,8 +190,8 @@ namespace lpzrobots {
         h is the standard hue value/2 (since 360 cannot be represented)
         and 255 if undefined (gray)
     */
-    void RGBtoHSV( unsigned char r, unsigned char g, unsigned char b,
-                   unsigned char& h, unsigned char& s, unsigned char& v ) {
+    static void RGBtoHSV( unsigned char r, unsigned char g, unsigned char b,
+                          unsigned char& h, unsigned char& s, unsigned char& v ) {
       unsigned char min, max;
       float delta;
       float hue;
@@ -185,6 +220,29 @@ namespace lpzrobots {
         hue += 180;
       h = int(hue);
     }
+
+    /** same as RGBtoHSV but with lookup tables (no divisions and fewer branches).
+        The tables have to be initialised with initTables().
+    */
+    static inline void RGBtoHSVTab( unsigned char r, unsigned char g, unsigned char b,
+                                    unsigned char& h, unsigned char& s, unsigned char& v ) {
+      int max   = MAX3( r, g, b );
+      int delta = max - (MIN3( r, g, b ));
+      int sector, diff;
+      if( r == max )      { sector = 0; diff = g - b; }
+      else if( g == max ) { sector = 1; diff = b - r; }
+      else                { sector = 2; diff = r - g; }
+      v = max;
+      s = satTable[delta][max];
+      h = hueTable[sector][delta][diff+255];
+    }
+
+    /// computes the lookup tables for RGBtoHSVTab (with RGBtoHSV, so results are identical)
+    static void initTables();
+
+    static unsigned char hueTable[3][256][511]; ///< hue by sector, max-min and difference
+    static unsigned char satTable[256][256];    ///< saturation by max-min and max
+    static bool tablesInitialised;
   };
 
 
@@ -196,10 +254,10 @@ namespace lpzrobots {
       @see HSVImgProc
       @see StdImageProcessor
   */
-  struct ColorFilterImgProc : public StdImageProcessor {
+  struct ColorFilterImgProc : public RowImageProcessor {
     ColorFilterImgProc(bool show, float scale, int minhue, int maxhue,
                        int sat_threshold=100, int val_threshold=50)
-      : StdImageProcessor(show,scale),
+      : RowImageProcessor(show,scale),
         minhue(minhue), maxhue(maxhue), sat_threshold(sat_threshold), val_threshold(val_threshold) {
     }
 
@@ -209,24 +267,17 @@ namespace lpzrobots {
       dest.img->allocateImage(src.img->s(), src.img->t(), 1, GL_LUMINANCE, GL_UNSIGNED_BYTE);
           //      dest.img->allocateImage(16, 1, 1, GL_LUMINANCE, GL_UNSIGNED_BYTE);
       dest.name  = "spots(" + src.name + ")";
+      // actually we need HSV but there is no coding for it
+      assert(src.img->getPixelFormat()==GL_RGB && src.img->getDataType()==GL_UNSIGNED_BYTE);
     }
 
-    virtual void process(const osg::Image* src, osg::Image* dest){
-      // actually we need HSV but there is no coding for it
-      assert(src && src->getPixelFormat()==GL_RGB && src->getDataType()==GL_UNSIGNED_BYTE);
-      for(int r=0; r < src->t(); ++r) {
-        const unsigned char* sdata = src->data(0, r);
-        unsigned char* ddata = dest->data(0, r);
-        for(int c=0; c < src->s(); ++c) {
-          if(*(sdata) >= minhue && *(sdata) < maxhue
-             && *(sdata+1) > sat_threshold && *(sdata+2) > val_threshold){
-            (*ddata) = *(sdata+2);
-          } else{
-            (*ddata) = 0;
-          }
-          sdata+=3;
-          ddata++;
-        }
+    virtual void processRow(const unsigned char* sdata, unsigned char* ddata, int width, int row){
+      for(int c=0; c < width; ++c) {
+        // branch free, such that the compiler can vectorise the loop
+        bool pass = (sdata[0] >= minhue) & (sdata[0] < maxhue)
+          & (sdata[1] > sat_threshold) & (sdata[2] > val_threshold);
+        ddata[c] = pass ? sdata[2] : 0;
+        sdata+=3;
       }
     }
     int minhue;
@@ -243,9 +294,9 @@ namespace lpzrobots {
       @param factor factor for average pixel value (rescaling)
       @see StdImageProcessor
   */
-  struct LineImgProc : public StdImageProcessor {
+  struct LineImgProc : public RowImageProcessor {
     LineImgProc(bool show, float scale, int num, double factor = 20.0)
-      : StdImageProcessor(show,scale), num(num), factor(factor) {
+      : RowImageProcessor(show,scale), num(num), factor(factor) {
     }
 
     virtual ~LineImgProc() {}
@@ -253,26 +304,35 @@ namespace lpzrobots {
     virtual void initDestImage(Camera::CameraImage& dest, const Camera::CameraImage& src){
       dest.img->allocateImage(num, 1, 1, GL_LUMINANCE, GL_UNSIGNED_BYTE);
       dest.name  = "line(" + src.name + ")";
+      assert(src.img->getPixelFormat()==GL_LUMINANCE && src.img->getDataType()==GL_UNSIGNED_BYTE);
+      size = src.img->s()/num;
+      numpixel_per_segm = size*src.img->t();
+      rowsums.assign(src.img->t()*num, 0);
     }
 
-    virtual void process(const osg::Image* src, osg::Image* dest){
-      // actually we need HSV but there is no coding for it
-      assert(src && src->getPixelFormat()==GL_LUMINANCE  && src->getDataType()==GL_UNSIGNED_BYTE);
+    virtual bool isReduction() const { return true; }
+
+    /// sums up the segments of the row (each row has its own sums)
+    virtual void processRow(const unsigned char* sdata, unsigned char* ddata, int width, int row){
+      int* sums = &rowsums[row*num];
+      for(int k=0; k<num; k++){
+        const unsigned char* pixel = sdata + k*size;
+        int sum = 0;
+        for(int i=0; i< size; i++){
+          sum += pixel[i];
+        }
+        sums[k] = sum;
+      }
+    }
 
-      int w = src->s();
-      int h = src->t();
-      int size = w/num; // size of one segment
-      int numpixel_per_segm = size*h;
+    virtual void finishFrame(osg::Image* dest){
+      int h = rowsums.size()/num;
       int segmentvalue;
       unsigned char* destdata = dest->data();
       for(int k=0; k<num; k++){
         int sum = 0;
         for(int j=0; j<h; j++){
-          const unsigned char* pixel = src->data(k*size, j);
-          for(int i=0; i< size; i++){
-            sum += *pixel;
-            pixel++;
-          }
+          sum += rowsums[j*num+k];
         }
         segmentvalue = int((double)sum*factor/(double)numpixel_per_segm);
         destdata[k] = std::min(segmentvalue,255);
@@ -280,6 +340,9 @@ namespace lpzrobots {
     }
     int num;
     double factor;
+    int size; // size of one segment
+    int numpixel_per_segm;
+    std::vector<int> rowsums;
   };
 
   /** time average of image @see StdImageProcessor.
@@ -320,6 +383,58 @@ namespace lpzrobots {
   };
 
 
+  /** Runs a chain of RowImageProcessors in one pass over the image.
+      Each row of the source passes through all stages using small row buffers,
+      so the intermediate images are neither written nor read
+      (only the last stage writes its image, which is shown with the settings of the last stage).
+      Reductions (e.g. LineImgProc) can only be the last stage.
+      For larger images the rows are distributed over several threads.
+
+      Example: replaces HSVImgProc, ColorFilterImgProc and LineImgProc in the camera conf
+      \code
+      conf.processors.push_back((new FusedImgProc())->add(new HSVImgProc(false,1))
+        ->add(new ColorFilterImgProc(true,.5, HSVImgProc::Red+20, HSVImgProc::Green-20,100))
+        ->add(new LineImgProc(true,20, 3)));
+      \endcode
+   */
+  class FusedImgProc : public ImageProcessor {
+  public:
+    /** @param threads number of threads (0: one per core)
+        @param minParallelPixels images with less pixels are processed in the calling thread
+     */
+    FusedImgProc(int threads = 0, int minParallelPixels = 64*64);
+    /// deletes the stages
+    virtual ~FusedImgProc();
+
+    /// adds a stage (the processor is deleted by this class), returns this for chaining
+    FusedImgProc* add(RowImageProcessor* stage);
+
+    virtual Camera::CameraImage init(const Camera::CameraImages& imgs);
+
+    virtual void process();
+
+    /// processes the given image rows
+    void processRows(int rowStart, int rowEnd, std::vector<unsigned char>* buffers);
+
+  protected:
+    struct Job {
+      FusedImgProc* proc;
+      int rowStart;
+      int rowEnd;
+      std::vector<unsigned char> buffers[2]; // row buffers for intermediate stages
+    };
+    static void* runJob(void* job);
+
+    std::vector<RowImageProcessor*> stages;
+    std::vector<int> rowBytes; // row size of the source of each stage
+    std::vector<Job*> jobs;
+    Camera::CameraImage src;
+    Camera::CameraImage dest;
+    int threads;
+    int minParallelPixels;
+  };
+
+
 //   /** Testing code
 //   */
 //   struct TestLineImgProc : public StdImageProcessor {
@@ -178,15 +178,16 @@ namespace lpzrobots {
 
     p1=I1 + ((field.x - s2) + (field.y - s2)*width)*bytesPerPixel;
     p2=I2 + ((field.x - s2 + d_x) + (field.y - s2 + d_y)*width)*bytesPerPixel;
-    // TODO: use some mmx or sse stuff here
+    // integer sums per row, which the compiler can vectorise
+    const int rowlen = size * bytesPerPixel;
     for (j = 0; j < size; j++) {
-        for (k = 0; k < size * bytesPerPixel; k++) {
-          sum += abs((int)*p1 - (int)*p2);
-          p1++;
-          p2++;
+        int rowsum = 0;
+        for (k = 0; k < rowlen; k++) {
+          rowsum += abs((int)p1[k] - (int)p2[k]);
         }
-        p1 += (width - size) * bytesPerPixel;
-        p2 += (width - size) * bytesPerPixel;
+        sum += rowsum;
+        p1 += width * bytesPerPixel;
+        p2 += width * bytesPerPixel;
     }
     return sum/((double) size *size* bytesPerPixel);
   }
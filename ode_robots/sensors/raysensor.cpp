@@ -22,6 +22,7 @@
  *                                                                         *
  ***************************************************************************/
 #include "raysensor.h"
+#include "raycaster.h"
 
 namespace lpzrobots {
 
@@ -45,6 +46,9 @@ namespace lpzrobots {
     transform=0;
     detection=10^5;
     lasttimeasked=-1;
+    useRayCaster=true;
+    rayCaster=0;
+    rayId=-1;
 
     setBaseInfo(SensorMotorInfo("Ray Sensor").changequantity(SensorMotorInfo::Distance).changemin(0));
   }
@@ -60,6 +64,7 @@ namespace lpzrobots {
   }
 
   RaySensor::~RaySensor(){
+    if(rayCaster) rayCaster->removeRay(rayId);
     if(transform) delete(transform);
 
     //   dGeomDestroy(transform);
@@ -68,6 +73,7 @@ namespace lpzrobots {
 
   RaySensor* RaySensor::clone() const {
     RaySensor* w = new RaySensor(size, range, drawMode);
+    w->setUseRayCaster(useRayCaster);
     w->setInitData(odeHandle, osgHandle, pose);
     return w;
   }
@@ -90,9 +96,24 @@ namespace lpzrobots {
     ray = new Ray(range, 0 /*0.005*/, len); // 0 means that we use a line
     transform = new Transform(own, ray, pose);
     OdeHandle myOdeHandle(odeHandle);
-    transform->init(odeHandle, 0, osgHandle,
+    bool cast = useRayCaster && odeHandle.getRayCaster();
+    if(cast){
+      // the geoms are only used for drawing and are not put into any collision space
+      myOdeHandle.space = 0;
+    }
+    transform->init(myOdeHandle, 0, osgHandle,
                     (drawMode==drawAll || drawMode==drawRay) ? (Primitive::Draw | Primitive::Geom) : Primitive::Geom );
-    transform->substance.setCollisionCallback(rayCollCallback,this);
+    if(cast){
+      rayCaster = odeHandle.getRayCaster();
+      osg::Vec3 p = pose.getTrans();
+      osg::Vec3 d = osg::Matrix::transform3x3(osg::Vec3(0,0,1), pose);
+      dVector3 pos = {p.x(), p.y(), p.z(), 0};
+      dVector3 dir = {d.x(), d.y(), d.z(), 0};
+      // the transform geom stands for the ray in the ignored pairs, like in the collision detection
+      rayId = rayCaster->addRay(own->getGeom(), pos, dir, range, odeHandle.space, &detection,
+                                transform->getGeom(), &rayCaster);
+    } else
+      transform->substance.setCollisionCallback(rayCollCallback,this);
 
     switch(drawMode){
     case drawAll:
@@ -116,6 +137,11 @@ namespace lpzrobots {
     this->range = range;
   }
 
+  void RaySensor::setUseRayCaster(bool useRayCaster){
+    assert(!initialised);
+    this->useRayCaster = useRayCaster;
+  }
+
   void RaySensor::setDrawMode(rayDrawMode drawMode){
     assert(!initialised);
     this->drawMode = drawMode;
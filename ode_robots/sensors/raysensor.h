@@ -45,6 +45,7 @@ namespace lpzrobots {
   class OSGBox;
   class Transform;
   class Ray;
+  class RayCaster;
 
 /** Class for Ray-based sensors.
     This are sensors which are based on distance measurements using the ODE geom class Ray.
@@ -89,6 +90,11 @@ namespace lpzrobots {
     ///Set draw mode of ray
     virtual void setDrawMode(rayDrawMode drawMode);
 
+    /** if enabled (default) the ray is cast by the RayCaster of the OdeHandle
+        instead of being a geom in the collision space. Has to be called before init.
+     */
+    virtual void setUseRayCaster(bool useRayCaster);
+
     ///Set length of ray (needed for callback)
     void setLength(double len, long int time);
 
@@ -111,6 +117,10 @@ namespace lpzrobots {
     Ray* ray;
     bool initialised;
 
+    bool useRayCaster;
+    RayCaster* rayCaster; // the caster the ray is registered at (or 0, reset if the caster is deleted)
+    int rayId;
+
   };
 
 }
@@ -54,8 +54,12 @@ namespace lpzrobots {
   }
 
   std::list<sensor> RelativePositionSensor::getList() const {
+    return getListOfArray();
+  }
+
+  int RelativePositionSensor::get(sensor* sensors, int length) const {
     assert(own);
-    std::list<sensor> s;
+    assert(length>=getSensorNumber());
     osg::Vec3 v;
     osg::Vec3 refpos = ref ? ref->getPosition() : osg::Vec3(0,0,0);
     if (local_coords){
@@ -73,10 +77,11 @@ namespace lpzrobots {
     double scale = rellen>0 ? pow(rellen, exponent)/rellen : 1; // exponential characteristics divided by linear characteristics
     // nonlinear scaling of the vector, such that
     v *= (scale/maxDistance);
-    if (dimensions & X) s.push_back(v.x());
-    if (dimensions & Y) s.push_back(v.y());
-    if (dimensions & Z) s.push_back(v.z());
-    return s;
+    int n=0;
+    if (dimensions & X) sensors[n++] = v.x();
+    if (dimensions & Y) sensors[n++] = v.y();
+    if (dimensions & Z) sensors[n++] = v.z();
+    return n;
   }
 
   bool RelativePositionSensor::sense(const GlobalData& globaldata){
@@ -48,6 +48,7 @@ namespace lpzrobots {
 
     virtual bool sense(const GlobalData& globaldata);
     virtual std::list<sensor> getList() const;
+    virtual int get(sensor* sensors, int length) const;
 
     /**
        Sets the reference object we use for relative position measureing.
@@ -80,8 +80,9 @@ namespace lpzrobots {
 
     /** writes the sensor values (usually in the range [-1,1] )
         into the given sensor array and returns the number of sensors written.
-        A default implementation based on get() is provided. Only if performance
-        matters overwrite this function.
+        A default implementation based on getList() is provided, which allocates
+        a list at every call. This function is used by OdeRobot::getSensors at every
+        control step, so all sensors of the framework overwrite it.
         @param sensors call by refernce array which received the values
         @param length capacity of sensors array
         @return number of sensor values written
@@ -39,6 +39,7 @@ namespace lpzrobots {
     int len = getSensorNumber();
     val = new double[len];
     memset(val,0,sizeof(double)*len);
+    cnt = new int[len];
     oldangle = new double[levels];
     memset(oldangle,0,sizeof(double)*levels);
     setBaseInfo(SensorMotorInfo("Sound").changequantity(SensorMotorInfo::Other));
@@ -46,6 +47,7 @@ namespace lpzrobots {
 
   SoundSensor::~SoundSensor() {
     if(val) delete[] val;
+    if(cnt) delete[] cnt;
     if(oldangle) delete[] oldangle;
   }
 
@@ -56,12 +58,14 @@ namespace lpzrobots {
   bool SoundSensor::sense(const GlobalData& globaldata){
     int len = getSensorNumber();
     memset(val,0,sizeof(double)*len);
-    int *cnt = new int[len];
     memset(cnt,0,sizeof(int)*len);
 
     if(!globaldata.sounds.empty()){
+      // only the sounds in the vicinity are considered
+      globaldata.getSoundsNear(own->getPosition(), maxDistance, hits);
       // multiple signal are simply averaged combined
-      FOREACHC(SoundList, globaldata.sounds, s){
+      FOREACHC(SoundField::Hits, hits, h){
+        const Sound* s = h->second;
         Pos relpos = own->toLocal(s->pos);
         // we have to look at the right dimension because sometimes the
         // robot's coordinate system has Z not looking to the sky
@@ -107,7 +111,7 @@ namespace lpzrobots {
               oldangle[l]= angle;
               val[2*l]   = intens;
               val[2*l+1] = scale*d;
-              cnt[3*l]++; cnt[3*l+1]++;
+              cnt[2*l]++; cnt[2*l+1]++;
             }
             break;
           }
@@ -117,7 +121,6 @@ namespace lpzrobots {
     for(int k=0; k<len; k++){
       if(cnt[k]>0) val[k]/=cnt[k];
     }
-    delete[] cnt;
     return true;
   }
 
@@ -25,6 +25,7 @@
 # define           SOUNDSENSOR_H_
 
 #include "sensor.h"
+#include "soundfield.h"
 
 namespace lpzrobots {
 
@@ -74,6 +75,8 @@ namespace lpzrobots {
     double noisestrength;
 
     double* val;
+    int* cnt;  ///< number of sounds per value (scratch)
+    SoundField::Hits hits; ///< sounds close to the sensor (scratch)
     double* oldangle;
 
     Primitive* own;
@@ -67,12 +67,25 @@ namespace lpzrobots {
   }
 
   int SpeedSensor::get(sensor* sensors, int length) const{
-    const Matrix& m = getSenseMatrix()*(1.0/maxSpeed);
-    if(dimensions == (X | Y | Z))
-      return m.convertToBuffer(sensors, length);
-    else{
-      return selectrows(sensors, length, m, dimensions);
+    assert(own);
+    assert(own->getBody());
+    // same as getSenseMatrix, but without temporary matrices
+    const dReal* v = (mode == Translational || mode == TranslationalRel) ?
+      dBodyGetLinearVel(own->getBody()) : dBodyGetAngularVel(own->getBody());
+    double m[3];
+    if(mode == TranslationalRel || mode == RotationalRel){
+      const osg::Matrix local = own->getPose();
+      for(int i=0; i<3; i++){
+        m[i] = local(i,0)*v[0] + local(i,1)*v[1] + local(i,2)*v[2];
+      }
+    }else{
+      for(int i=0; i<3; i++) m[i] = v[i];
+    }
+    int n=0;
+    for(int i=0; i<3; i++){
+      if(( (1 << i) & dimensions) && n<length) sensors[n++] = m[i]*(1.0/maxSpeed);
     }
+    return n;
   }
 
   Matrix SpeedSensor::getSenseMatrix() const {
@@ -22,6 +22,8 @@
  *                                                                         *
  ***************************************************************************/
 #include <stdlib.h>
+#include <limits.h>
+#include <algorithm>
 #include <signal.h>
 #include <iostream>
 #include <stdexcept>
@@ -58,6 +60,7 @@
 #include "osg/retinawindowsizehandler.h"
 
 #include "primitive.h"
+#include "raycaster.h"
 #include "abstractobstacle.h"
 
 #include "robotcameramanager.h"
@@ -113,6 +116,7 @@ namespace lpzrobots {
     addParameterDef("WindowWidth",&windowWidth,400);
     addParameterDef("WindowHeight",&windowHeight,300);
     addParameterDef("UseOdeThread",&useOdeThread,false);
+    addParameterDef("SensorLatency",&sensorLatency,0);
     addParameterDef("UseOsgThread",&useOsgThread,false);
     addParameterDef("UseQMPThread",&useQMPThreads,true);
     addParameterDef("inTaskedMode",&inTaskedMode,false);
@@ -150,6 +154,7 @@ namespace lpzrobots {
     osgThread = 0;
     odeThreadCreated=false;
     osgThreadCreated=false;
+    staggeredAgents=0;
 
     videostream = new VideoStream();
     videostream->addCallbackable(this, VideoStream::FRAMECAPTURE);
@@ -561,7 +566,7 @@ namespace lpzrobots {
       if(!loop())
         break;
     }
-    if(useOdeThread) pthread_join (odeThread, NULL);
+    waitForPhysics();
     if(useOsgThread) pthread_join (osgThread, NULL);
     QMP_CRITICAL(22);
     closeConsole();
@@ -609,6 +614,7 @@ namespace lpzrobots {
               printf("%li min simulation time reached -> simulation stopped \n", simulation_time);
             }
             simulation_time_reached=true;
+            waitForPhysics(); // the cycle may be restarted
             return run;
           }
         }
@@ -625,76 +631,72 @@ namespace lpzrobots {
 //           }
 //         }
 
-         // for all agents: robots internal stuff and control step if at controlInterval
-//         PARALLEL VERSION
-        if ( (globalData.sim_step % globalData.odeConfig.controlInterval ) == 0 ) {
-          // render offscreen cameras (robot sensor cameras) (does not work in nographics mode)
+        /****************** Sensorimotor pipeline *****************/
+        // Each step is done in three stages: sense -> control -> actuate/physics.
+        // The control stage of agents with a sensor latency (see Agent::setLatency())
+        // does not depend on the physics step that still runs in the ode thread,
+        // so it is done before we wait for it. Agents without latency are
+        // controlled after the sense stage.
+        bool controlStep = (globalData.sim_step % globalData.odeConfig.controlInterval ) == 0;
+        bool overlapped  = false;
+        if (controlStep) {
+          // spread the steps of slower controllers evenly over the control steps
+          if(globalData.agents.size() != staggeredAgents){
+            std::list<AbstractController*> controllers;
+            FOREACH(OdeAgentList, globalData.agents, i) {
+              controllers.push_back((*i)->getController());
+            }
+            AbstractController::staggerPhases(controllers);
+            staggeredAgents = globalData.agents.size();
+          }
+          // the separate ode thread requires a sensor latency of at least 1
+          int minLatency = useOdeThread ? std::max(1, (int)sensorLatency) : (int)sensorLatency;
+          FOREACH(OdeAgentList, globalData.agents, i) {
+            if((*i)->getLatency() < minLatency)
+              (*i)->setLatency(minLatency);
+          }
+
+          overlapped = odeThreadCreated;
+          if(overlapped){
+            QP(PROFILER.beginBlock("controller                   "));
+            controlAgents(1, INT_MAX);
+            QP(PROFILER.endBlock("controller                   "));
+          }
+        }
+
+        /****************** Simulationstep *****************/
+        waitForPhysics();
+
+        if (controlStep) {
+          // render offscreen cameras (robot sensor cameras)
           if(!noGraphics && viewer->needForOffScreenRendering()){
             QP(PROFILER.beginBlock("offScreenRendering           "));
             updateGraphics();
             viewer->renderOffScreen();
             QP(PROFILER.endBlock("offScreenRendering           "));
           }
+          // in nographics mode the cameras are rendered on the CPU with the ray caster
+          if(noGraphics){
+            QP(PROFILER.beginBlock("offScreenRendering           "));
+            osgHandle.scene->robotCamManager->renderHeadless();
+            QP(PROFILER.endBlock("offScreenRendering           "));
+          }
+
+          QP(PROFILER.beginBlock("sense                        "));
+          senseAgents();
+          QP(PROFILER.endBlock("sense                        "));
 
           QP(PROFILER.beginBlock("controller                   "));
-          if (useQMPThreads)
-          {
-            // PARALLEL VERSION (QMP)
-            QMP_SHARE(globalData);
-            // there is a problem with the useOdeThread in the loop (not static)
-            if (useOdeThread) // whether to use a separate thread for ode
-            {
-              QMP_PARALLEL_FOR(i, 0, globalData.agents.size(),quickmp::INTERLEAVED)
-              {
-                QMP_USE_SHARED(globalData, GlobalData);
-                globalData.agents[i]->beforeStep(globalData);
-                globalData.agents[i]->stepOnlyWiredController(globalData.odeConfig.noise, globalData.time);
-              }
-              QMP_END_PARALLEL_FOR;
-            } else {
-              QMP_PARALLEL_FOR(i, 0, globalData.agents.size(),quickmp::INTERLEAVED)
-              {
-                QMP_USE_SHARED(globalData, GlobalData);
-                globalData.agents[i]->beforeStep(globalData);
-                globalData.agents[i]->step(globalData.odeConfig.noise, globalData.time);
-              }
-              QMP_END_PARALLEL_FOR;
-            }
-           } else {
-             // SEQUENTIAL VERSION (NO QMP)
-            // there is a problem with the useOdeThread in the loop (not static)
-            if (useOdeThread) {
-              FOREACH(OdeAgentList, globalData.agents, i) {
-                (*i)->beforeStep(globalData);
-                (*i)->stepOnlyWiredController(globalData.odeConfig.noise, globalData.time);
-              }
-            } else {
-              FOREACH(OdeAgentList, globalData.agents, i) {
-                (*i)->beforeStep(globalData);
-                (*i)->step(globalData.odeConfig.noise, globalData.time);
-              }
-            }
-          }
+          controlAgents(0, overlapped ? 0 : INT_MAX);
           QP(PROFILER.endBlock("controller                   "));
-        }else{ // serial execution is sufficient here
-          FOREACH(OdeAgentList, globalData.agents, i) {
-            (*i)->onlyControlRobot();
-          }
         }
 
-        /****************** Simulationstep *****************/
-        if(useOdeThread){
-          if (odeThreadCreated)
-            pthread_join (odeThread, NULL);
-          else odeThreadCreated=true;
-           }
         // Do this here because it
         // can provide collision handling (old style collision handling)
         // and this crashes in parallel version
         QP(PROFILER.beginBlock("internalstuff_and_addcallback"));
         FOREACH(OdeAgentList, globalData.agents, i) {
-          if (useOdeThread)
-            (*i)->setMotorsGetSensors();
+          (*i)->onlyControlRobot(); // actuate stage
           (*i)->getRobot()->doInternalStuff(globalData);
         }
         addCallback(globalData, t==(globalData.odeConfig.drawInterval-1), pause,
@@ -717,9 +719,10 @@ namespace lpzrobots {
           }
         }
 
-        if(useOdeThread)
+        if(useOdeThread){
           pthread_create (&odeThread, NULL, odeStep_run,this);
-        else
+          odeThreadCreated=true;
+        } else
           odeStep();
 
          // call all registered physical callbackable classes
@@ -1284,6 +1287,10 @@ namespace lpzrobots {
 
     srand(seed);
     globalData.odeConfig.setRandomSeed(seed);
+    if(contains(argv, argc, "-rngstream")) {
+      globalData.odeConfig.randomStreams=true;
+      printf("agents use counter based random streams of seed %li\n", seed);
+    }
 
     int resolindex = contains(argv, argc, "-x");
     if(resolindex && argc > resolindex) {
@@ -1369,6 +1376,11 @@ namespace lpzrobots {
       useOdeThread=true;
       printf("using separate OdeThread\n");
     }
+    index = contains(argv, argc, "-latency");
+    if(index && argc > index) {
+      sensorLatency=std::max(0,atoi(argv[index]));
+      printf("using a sensor latency of %i control steps\n", (int)sensorLatency);
+    }
     if (contains(argv, argc, "-osgthread")) {
       useOsgThread=true;
       printf("using separate OSGThread\n");
@@ -1548,9 +1560,9 @@ namespace lpzrobots {
 
   void Simulation::main_usage(const char* progname) {
     printf("Usage: %s [-f [interval] [filter] [name]] [-{g|m} [interval] [filter]]\n", progname);
-    printf("    \t [-r seed] [-x WxH] [-fs] [-allkeys] [-video NAME]\n");
+    printf("    \t [-r seed] [-rngstream] [-x WxH] [-fs] [-allkeys] [-video NAME]\n");
     printf("    \t [-pause] [-shadow N] [-noshadow] [-drawboundings] [-simtime [min]] [-rtf X]\n");
-    printf("    \t [-threads N] [-odethread] [-osgthread] [-savecfg] [-set keyvaluespairs] [-h|--help] ...\n");
+    printf("    \t [-threads N] [-odethread] [-latency N] [-osgthread] [-savecfg] [-set keyvaluespairs] [-h|--help] ...\n");
     printf("    -conf\t\tuse Configurator\n");
     printf("    -g interval filter\t\tuse guilogger (default interval 1)\n");
     printf("    \t\t filter: \"{+substr -substr}\"\n");
@@ -1559,6 +1571,7 @@ namespace lpzrobots {
     printf("    -m interval  filter\t\tuse matrixviz (default interval 10)\n");
     printf("    -s \"-disc|ampl|freq val\"\n    \t\t\tuse soundMan \n");
     printf("    -r seed\t\trandom number seed\n");
+    printf("    -rngstream\t\teach agent gets its own reproducible random stream of the seed\n");
     printf("    -set keyvaluespairs\toverwrite configurable values at start\n");
     printf("    \t\t keyvaluespairs: \"{key1=value1 key2=value2}\"\n");
     printf("    -x WxH\t\t* window size of width(W) x height(H) is used (default 800x600)\n");
@@ -1581,6 +1594,8 @@ namespace lpzrobots {
     printf("    -savecfg\t\tsafe the configuration file with the values given by the cmd line\n");
     printf("    -threads N\t\tnumber of threads to use (0: number of processors (default))\n");
     printf("    -odethread\t\t* if given the ODE runs in its own thread. -> Sensors are delayed by 1\n");
+    printf("    -latency N\t\t* sensor latency of all agents in control steps (default 0)\n");
+    printf("    \t\t\t  the controllers of delayed agents run in parallel to the ODE thread\n");
     printf("    -osgthread\t\t* if given the OSG runs in its own thread (recommended)\n");
     printf("    -h --help\t\tshow this help\n");
     printf("    * this parameter can be set in the configuration file ~/.lpzrobots/ode_robots.cfg\n");
@@ -1653,6 +1668,9 @@ namespace lpzrobots {
     FOREACHC(vector<dSpaceID>, odeHandle.getSpaces(), i) {
       dSpaceCollide ( *i , this , &nearCallback );
     }
+    // all ray sensors at once (they are not in the collision spaces)
+    if(odeHandle.getRayCaster())
+      odeHandle.getRayCaster()->cast();
     QP(PROFILER.endBlock("collision                    "));
 
     QP(PROFILER.beginBlock("ODEstep                      "));
@@ -1661,6 +1679,55 @@ namespace lpzrobots {
     QP(PROFILER.endBlock("ODEstep                      "));
   }
 
+  void Simulation::waitForPhysics() {
+    if (odeThreadCreated) {
+      pthread_join (odeThread, NULL);
+      odeThreadCreated=false;
+    }
+  }
+
+  void Simulation::senseAgents() {
+    if (useQMPThreads) {
+      QMP_SHARE(globalData);
+      QMP_PARALLEL_FOR(i, 0, globalData.agents.size(),quickmp::INTERLEAVED)
+      {
+        QMP_USE_SHARED(globalData, GlobalData);
+        globalData.agents[i]->beforeStep(globalData);
+        globalData.agents[i]->sense(globalData.time);
+      }
+      QMP_END_PARALLEL_FOR;
+    } else {
+      FOREACH(OdeAgentList, globalData.agents, i) {
+        (*i)->beforeStep(globalData);
+        (*i)->sense(globalData.time);
+      }
+    }
+  }
+
+  void Simulation::controlAgents(int minLatency, int maxLatency) {
+    if (useQMPThreads) {
+      QMP_SHARE(globalData);
+      QMP_SHARE(minLatency);
+      QMP_SHARE(maxLatency);
+      QMP_PARALLEL_FOR(i, 0, globalData.agents.size(),quickmp::INTERLEAVED)
+      {
+        QMP_USE_SHARED(globalData, GlobalData);
+        QMP_USE_SHARED(minLatency, int);
+        QMP_USE_SHARED(maxLatency, int);
+        int latency = globalData.agents[i]->getLatency();
+        if (latency >= minLatency && latency <= maxLatency)
+          globalData.agents[i]->control(globalData.odeConfig.noise, globalData.time);
+      }
+      QMP_END_PARALLEL_FOR;
+    } else {
+      FOREACH(OdeAgentList, globalData.agents, i) {
+        int latency = (*i)->getLatency();
+        if (latency >= minLatency && latency <= maxLatency)
+          (*i)->control(globalData.odeConfig.noise, globalData.time);
+      }
+    }
+  }
+
   void Simulation::osgStep()
   {
     if (viewer)
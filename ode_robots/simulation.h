@@ -191,6 +191,12 @@ namespace lpzrobots {
   private:
     void insertCmdLineOption(int& argc,char**& argv);
     bool loop();
+    /// waits for the physics step running in the ode thread (if any)
+    void waitForPhysics();
+    /// sense stage of the pipeline: beforeStep() and sense() of all agents
+    void senseAgents();
+    /// control stage of the pipeline for all agents with a latency in [minLatency, maxLatency]
+    void controlAgents(int minLatency, int maxLatency);
     /// clears obstacle and agents lists and delete entries
     void tidyUp(GlobalData& globalData);
 
@@ -256,6 +262,7 @@ namespace lpzrobots {
     CameraHandle cameraHandle;
 
     parambool useOdeThread;
+    paramint sensorLatency;   // minimal sensor latency of all agents (in control steps)
     parambool useOsgThread;
     parambool useQMPThreads; // decides if quick mp is used in this simulation
     parambool inTaskedMode;
@@ -282,9 +289,12 @@ namespace lpzrobots {
     // multiprocessoring stuff
     pthread_t odeThread;
     pthread_t osgThread;
-    bool odeThreadCreated;
+    bool odeThreadCreated; // true while a physics step runs in the odeThread
     bool osgThreadCreated;
 
+    // number of agents whose slow controllers got their phases (see AbstractController::setRate())
+    unsigned int staggeredAgents;
+
   private:
     bool commandline_param_dummy;
 
@@ -236,6 +236,9 @@ int main (int argc, char **argv)
   int index = ThisSim::contains(argv, argc, "-nthreads");
   if(index && argc > index)
       simTaskSupervisor->setNumberThreads(atoi(argv[index]));
+  // run every task in its own process (no shared ODE/OSG state, crashed tasks are restarted)
+  if(ThisSim::contains(argv, argc, "-processes"))
+    SimulationTaskSupervisor::setTaskMode(TASKS_AS_PROCESSES);
   // set simTaskHandle and simCreator
   SimulationTaskSupervisor::setSimTaskHandle(simTaskHandle);
   SimulationTaskSupervisor::setTaskedSimCreator(simCreator);
@@ -0,0 +1,130 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Benchmark of the camera image processing: a chain of single processors
+   (one pass per processor) is compared with the same chain in a FusedImgProc
+   (one pass over the image) with one and with all cores.
+   No simulation is started, the processors work on synthetic images.
+   Usage: start [-frames N]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <osg/Image>
+#include <ode_robots/imageprocessors.h>
+
+using namespace lpzrobots;
+using namespace std;
+
+static double timeInUs(){
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec*1e6 + t.tv_usec;
+}
+
+/// image with colored rectangles on a gray background
+static osg::Image* createImage(int size){
+  osg::Image* img = new osg::Image;
+  img->allocateImage(size, size, 1, GL_RGB, GL_UNSIGNED_BYTE);
+  srand(size);
+  unsigned char* d = img->data();
+  for(int i=0; i<size*size*3; i++) d[i] = 100 + rand()%20;
+  for(int k=0; k<8; k++){
+    int x = rand()%size, y = rand()%size, w = 1+rand()%(size/2), h = 1+rand()%(size/2);
+    unsigned char c[3] = { (unsigned char)(rand()%256), (unsigned char)(rand()%256),
+                           (unsigned char)(rand()%256) };
+    for(int r=y; r<std::min(size,y+h); r++)
+      for(int s=x; s<std::min(size,x+w); s++)
+        memcpy(img->data(s,r), c, 3);
+  }
+  return img;
+}
+
+static void createStages(std::vector<RowImageProcessor*>& stages){
+  stages.push_back(new HSVImgProc(false,1));
+  stages.push_back(new ColorFilterImgProc(false,1, HSVImgProc::Red+20, HSVImgProc::Green-20, 100));
+  stages.push_back(new LineImgProc(false,1, 8));
+}
+
+/// runs the processors and returns the time per frame in microseconds
+static double run(const ImageProcessors& procs, int frames){
+  double start = timeInUs();
+  for(int f=0; f<frames; f++){
+    FOREACHC(ImageProcessors, procs, p){
+      (*p)->process();
+    }
+  }
+  return (timeInUs() - start)/frames;
+}
+
+int main (int argc, char **argv)
+{
+  int frames = 1000;
+  for(int i=1; i<argc-1; i++){
+    if(strcmp(argv[i],"-frames")==0) frames = atoi(argv[i+1]);
+  }
+  printf("HSV -> color filter -> line (8 segments), time per frame in us\n");
+  printf("%8s %12s %12s %12s\n", "size", "chain", "fused", "fused(mt)");
+  for(int size=16; size<=512; size*=2){
+    Camera::CameraImages imgs;
+    imgs.push_back(Camera::CameraImage(createImage(size), false, 1, "raw"));
+
+    // separate processors
+    std::vector<RowImageProcessor*> stages;
+    createStages(stages);
+    ImageProcessors chain(stages.begin(), stages.end());
+    Camera::CameraImages chainImgs(imgs);
+    FOREACH(ImageProcessors, chain, p){
+      chainImgs.push_back((*p)->init(chainImgs));
+    }
+    // fused in the calling thread and fused with all cores
+    FusedImgProc* fused   = new FusedImgProc(1);
+    FusedImgProc* fusedMT = new FusedImgProc(0, 0);
+    stages.clear();
+    createStages(stages);
+    FOREACH(std::vector<RowImageProcessor*>, stages, s) fused->add(*s);
+    stages.clear();
+    createStages(stages);
+    FOREACH(std::vector<RowImageProcessor*>, stages, s) fusedMT->add(*s);
+    const osg::Image* resFused   = fused->init(imgs).img;
+    const osg::Image* resFusedMT = fusedMT->init(imgs).img;
+
+    double tChain   = run(chain, frames);
+    double tFused   = run(ImageProcessors(1, fused), frames);
+    double tFusedMT = run(ImageProcessors(1, fusedMT), frames);
+
+    const osg::Image* resChain = chainImgs.back().img;
+    bool same = memcmp(resChain->data(), resFused->data(), resChain->getRowSizeInBytes())==0 &&
+      memcmp(resChain->data(), resFusedMT->data(), resChain->getRowSizeInBytes())==0;
+    printf("%4ix%-4i %12.2f %12.2f %12.2f %s\n", size, size, tChain, tFused, tFusedMT,
+           same ? "" : "RESULTS DIFFER!");
+
+    FOREACH(ImageProcessors, chain, p) delete *p;
+    delete fused;
+    delete fusedMT;
+  }
+  return 0;
+}
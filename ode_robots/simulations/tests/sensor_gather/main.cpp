@@ -0,0 +1,142 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Benchmark of the sensor gathering (OdeRobot::getSensors) per control step
+   for the Skeleton (with additional generic sensors) and the AmosII.
+   The sensors of each robot are read many times per control step and the
+   average time per call is printed every 10 simulated seconds.
+   Usage: start -nographics [-reps N]
+ */
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <selforg/sinecontroller.h>
+#include <selforg/one2onewiring.h>
+#include <selforg/noisegenerator.h>
+#include <selforg/stl_adds.h>
+
+#include <ode_robots/simulation.h>
+#include <ode_robots/odeagent.h>
+#include <ode_robots/playground.h>
+
+#include <ode_robots/skeleton.h>
+#include <ode_robots/amosII.h>
+#include <ode_robots/speedsensor.h>
+#include <ode_robots/axisorientationsensor.h>
+#include <ode_robots/relativepositionsensor.h>
+
+using namespace lpzrobots;
+using namespace std;
+
+static double timeInUs(){
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec*1e6 + t.tv_usec;
+}
+
+class ThisSim : public Simulation {
+public:
+  struct Measurement {
+    OdeRobot* robot;
+    std::vector<sensor> buffer;
+    double time;
+    long calls;
+  };
+
+  ThisSim(int reps) : reps(reps) {}
+
+  void start(const OdeHandle& odeHandle, const OsgHandle& osgHandle, GlobalData& global)
+  {
+    setCameraHomePos(Pos(5.2, 7.3, 3.0),  Pos(147.0, -20.0, 0));
+    global.odeConfig.setParam("noise", 0.05);
+    global.odeConfig.setParam("controlinterval", 1);
+
+    Playground* playground = new Playground(odeHandle, osgHandle, osg::Vec3(20, 0.2, 0.5));
+    playground->setPosition(osg::Vec3(0,0,0.05));
+    global.obstacles.push_back(playground);
+
+    // Skeleton with some generic sensors
+    SkeletonConf conf = Skeleton::getDefaultConf();
+    Skeleton* human = new Skeleton(odeHandle, osgHandle, conf, "Humanoid");
+    human->addSensor(std::make_shared<SpeedSensor>(5, SpeedSensor::Translational));
+    human->addSensor(std::make_shared<SpeedSensor>(5, SpeedSensor::RotationalRel));
+    human->addSensor(std::make_shared<AxisOrientationSensor>(AxisOrientationSensor::Axis));
+    human->addSensor(std::make_shared<RelativePositionSensor>(10, 1, Sensor::XYZ));
+    human->place(osg::Matrix::rotate(M_PI_2,1,0,0)*osg::Matrix::translate(-2,0,1));
+    addAgent(global, human);
+
+    AmosII* amos = new AmosII(odeHandle, osgHandle.changeColor(Color(1, 1, 1)),
+                              AmosII::getDefaultConf(), "AmosII");
+    amos->place(osg::Matrix::translate(2, 0, 0.5));
+    addAgent(global, amos);
+  }
+
+  void addAgent(GlobalData& global, OdeRobot* robot){
+    OdeAgent* agent = new OdeAgent(global);
+    agent->init(new SineController(), robot, new One2OneWiring(new ColorUniformNoise(0.1)));
+    global.agents.push_back(agent);
+    Measurement m;
+    m.robot = robot;
+    m.buffer.resize(robot->getSensorNumber());
+    m.time  = 0;
+    m.calls = 0;
+    measurements.push_back(m);
+  }
+
+  virtual void addCallback(GlobalData& globalData, bool draw, bool pause, bool control) {
+    if(!control) return;
+    FOREACH(std::vector<Measurement>, measurements, m){
+      double start = timeInUs();
+      for(int i=0; i<reps; i++){
+        m->robot->getSensors(m->buffer.data(), m->buffer.size());
+      }
+      m->time  += timeInUs() - start;
+      m->calls += reps;
+    }
+    if(globalData.sim_step % 1000 == 0){
+      FOREACH(std::vector<Measurement>, measurements, m){
+        printf("%-10s %3i sensors: %8.3f us per getSensors\n", m->robot->getName().c_str(),
+               (int)m->buffer.size(), m->calls > 0 ? m->time/m->calls : 0.0);
+        m->time  = 0;
+        m->calls = 0;
+      }
+    }
+  }
+
+protected:
+  int reps;
+  std::vector<Measurement> measurements;
+};
+
+
+int main (int argc, char **argv)
+{
+  int reps = 100;
+  for(int i=1; i<argc-1; i++){
+    if(strcmp(argv[i],"-reps")==0) reps = atoi(argv[i+1]);
+  }
+  ThisSim sim(reps);
+  return sim.run(argc, argv) ? 0 : 1;
+}
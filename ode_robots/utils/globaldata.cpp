@@ -72,8 +72,8 @@ namespace lpzrobots {
   }
 
   void GlobalData::removeExpiredObjects(double time){
+    if(time<0) time=this->time;
     if(!tmpObjects.empty()){
-      if(time<0) time=this->time;
       TmpObjectMap::iterator i = tmpObjects.begin();
       while(i != tmpObjects.end()){
         if( i->first < time ){
@@ -90,8 +90,21 @@ namespace lpzrobots {
     }
 
     // remove old signals from sound list
-    if(!sounds.empty())
+    if(!sounds.empty()){
+      size_t before = sounds.size();
       sounds.remove_if(Sound::older_than(time));
+      // the field only has to be rebuilt if a sound was actually removed
+      if(sounds.size() != before)
+        soundField.invalidate();
+    }
+  }
+
+  void GlobalData::addSound(const Sound& s){
+    soundField.add(sounds, s);
+  }
+
+  void GlobalData::getSoundsNear(const Pos& pos, double radius, SoundField::Hits& hits) const {
+    soundField.query(sounds, pos, radius, hits);
   }
 
 
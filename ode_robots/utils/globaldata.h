@@ -29,6 +29,7 @@
 #include "odehandle.h"
 #include "odeconfig.h"
 #include "sound.h"
+#include "soundfield.h"
 #include "tmpobject.h"
 #include <selforg/plotoption.h>
 #include <selforg/globaldatabase.h>
@@ -46,7 +47,6 @@ namespace lpzrobots {
   typedef std::vector<AbstractObstacle*> ObstacleList;
   typedef Configurable::configurableList ConfigList;
   typedef BackCallerVector<OdeAgent*> OdeAgentList;
-  typedef std::list<Sound> SoundList;
   typedef std::list<PlotOption> PlotOptionList;
   typedef std::multimap<double, TmpObject* > TmpObjectMap;
   typedef std::list< std::pair<double, TmpObject*> > TmpObjectList;
@@ -69,7 +69,7 @@ namespace lpzrobots {
       Primitive* environment; /// < this is used to be able to attach objects to the static environment
 
       // Todo: the sound visualization could be done with the new TmpObjects
-      SoundList sounds; ///< sound space
+      SoundList sounds; ///< sound space (add sounds with addSound)
 
       PlotOptionList plotoptions; ///< plotoptions used for new agents
       std::list<Configurable*> globalconfigurables; ///< global configurables plotted by all agents
@@ -80,6 +80,16 @@ namespace lpzrobots {
       /// returns the list of all agents
       virtual AgentList& getAgents();
 
+      /// adds a sound to the sound space (thread safe)
+      virtual void addSound(const Sound& s);
+
+      /** collects the sounds in the square (in x-y) of half size radius around pos
+          in the order of the sound list (candidates, the distance has to be checked).
+          This uses a spatial index (see SoundField) instead of going through all sounds.
+          @param hits is cleared and filled
+      */
+      virtual void getSoundsNear(const Pos& pos, double radius, SoundField::Hits& hits) const;
+
 
       /// adds a temporary display item with given life duration in sec
       virtual void addTmpObject(TmpObject* i, double duration);
@@ -102,6 +112,7 @@ namespace lpzrobots {
 
     private:
 
+      mutable SoundField soundField;
       TmpObjectList uninitializedTmpObjects;
       TmpObjectMap  tmpObjects;
       AgentList     baseAgents;
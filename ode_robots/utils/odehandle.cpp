@@ -27,14 +27,30 @@
 #include <ode-dbl/ode.h>
 #include <algorithm>
 #include "primitive.h"
+#include "raycaster.h"
 
 namespace lpzrobots
 {
 
+  // geoms without primitive or with a substance without contacts are not seen by rays
+  static bool rayGeomFilter(dGeomID geom){
+    Primitive* p = dynamic_cast<Primitive*>((Primitive*)dGeomGetData(geom));
+    return p && !p->substance.isNoContact();
+  }
+
+  // ignored pairs (see addIgnoredPair) are not seen by rays either
+  static bool rayPairFilter(const void* data, dGeomID g1, dGeomID g2){
+    const HashSet<std::pair<long,long>,geomPairHash >* ignoredPairs =
+      (const HashSet<std::pair<long,long>,geomPairHash >*)data;
+    return ignoredPairs->find(std::pair<long, long>((long)g1,(long)g2)) != ignoredPairs->end()
+      || ignoredPairs->find(std::pair<long, long>((long)g2,(long)g1)) != ignoredPairs->end();
+  }
+
   OdeHandle::OdeHandle()
   {
     ignoredPairs        = 0;
     spaces              = 0;
+    rayCaster           = 0;
   }
 
   OdeHandle::OdeHandle(  dWorldID _world, dSpaceID _space, dJointGroupID _jointGroup )
@@ -44,6 +60,7 @@ namespace lpzrobots
     jointGroup          = _jointGroup;
     ignoredPairs        = 0;
     spaces              = 0;
+    rayCaster           = 0;
   }
 
   void OdeHandle::destroySpaces()
@@ -51,6 +68,9 @@ namespace lpzrobots
     if (spaces)
       delete spaces;
 
+    if (rayCaster)
+      delete rayCaster;
+
     if (ignoredPairs)
       delete ignoredPairs;
   }
@@ -70,7 +90,10 @@ namespace lpzrobots
     //  where a lot of joints are created every step
     jointGroup = dJointGroupCreate ( 1000000 );
     ignoredPairs  = new HashSet<std::pair<long,long>,geomPairHash >();
-
+    rayCaster = new RayCaster(space);
+    rayCaster->setCollisionSpaces(spaces);
+    rayCaster->setGeomFilter(rayGeomFilter);
+    rayCaster->setPairFilter(rayPairFilter, ignoredPairs);
   }
 
   void OdeHandle::close(){
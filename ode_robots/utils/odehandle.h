@@ -33,6 +33,7 @@
 namespace lpzrobots {
 
 class Primitive;
+class RayCaster;
 
 struct geomPairHash{
   size_t operator() (const std::pair<long, long>& p) const {
@@ -86,6 +87,9 @@ public:
 
 
   inline double getTime(){ return *time; }
+
+  /// returns the engine for batched ray queries (used by RaySensor), 0 if not initialised
+  RayCaster* getRayCaster() const { return rayCaster; }
   
   /// adds a pair of geoms to the list of ignored geom pairs for collision detection
   void addIgnoredPair(dGeomID g1, dGeomID g2);
@@ -114,6 +118,9 @@ protected:
   /// set of ignored geom pairs for collision
   HashSet<std::pair<long,long>, geomPairHash >* ignoredPairs;
 
+  /// batched ray queries, cast in every simulation step
+  RayCaster* rayCaster;
+
 };
 
 }
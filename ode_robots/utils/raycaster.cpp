@@ -0,0 +1,283 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "raycaster.h"
+#include <ode-dbl/ode.h>
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+
+namespace lpzrobots {
+
+  RayCaster::Query::Query(){
+    probe = dCreateRay(0, 1);
+    dGeomRaySetParams(probe, 0, 0);
+    dGeomRaySetClosestHit(probe, 1);
+  }
+
+  RayCaster::Query::~Query(){
+    dGeomDestroy(probe);
+  }
+
+  RayCaster::RayCaster(dSpaceID worldSpace)
+    : worldSpace(worldSpace), filter(0), pairFilter(0), pairFilterData(0),
+      collisionSpaces(0), numRays(0) {
+    pthread_mutex_init(&collideMutex, NULL);
+  }
+
+  RayCaster::~RayCaster(){
+    // detach the rays which are still registered (e.g. sensors deleted after the handle)
+    for(std::vector<RayData>::iterator r = rays.begin(); r != rays.end(); ++r){
+      if(r->active && r->owner && *(r->owner) == this)
+        *(r->owner) = 0;
+    }
+    pthread_mutex_destroy(&collideMutex);
+  }
+
+  int RayCaster::addRay(dGeomID geom, const dVector3 pos, const dVector3 dir, double range,
+                        dSpaceID ownSpace, double* result, dGeomID self, RayCaster** owner){
+    assert(result);
+    RayData r;
+    r.geom = geom;
+    double l = sqrt(dir[0]*dir[0] + dir[1]*dir[1] + dir[2]*dir[2]);
+    assert(l > 0);
+    for(int i=0; i<3; i++){
+      r.pos[i] = pos[i];
+      r.dir[i] = dir[i] / l;
+    }
+    r.pos[3] = r.dir[3] = 0;
+    r.range = range;
+    r.ownSpace = ownSpace;
+    r.result = result;
+    r.self = self;
+    r.owner = owner;
+    r.active = true;
+    numRays++;
+    if(!freeIds.empty()){
+      int id = freeIds.back();
+      freeIds.pop_back();
+      rays[id] = r;
+      return id;
+    }
+    rays.push_back(r);
+    return rays.size()-1;
+  }
+
+  void RayCaster::removeRay(int id){
+    assert(id >= 0 && id < (int)rays.size() && rays[id].active);
+    rays[id].active = false;
+    freeIds.push_back(id);
+    numRays--;
+  }
+
+  void RayCaster::setRange(int id, double range){
+    assert(id >= 0 && id < (int)rays.size() && rays[id].active);
+    rays[id].range = range;
+  }
+
+  dSpaceID RayCaster::topLevelSpace(dSpaceID space) const {
+    if(space == worldSpace)
+      return 0;
+    while(space){
+      dSpaceID parent = dGeomGetSpace((dGeomID)space);
+      if(parent == worldSpace || parent == 0)
+        return space;
+      space = parent;
+    }
+    return 0;
+  }
+
+  void RayCaster::collectGeoms(dSpaceID space, dSpaceID root){
+    int n = dSpaceGetNumGeoms(space);
+    for(int i=0; i<n; i++){
+      dGeomID g = dSpaceGetGeom(space, i);
+      if(dGeomIsSpace(g)){
+        collectGeoms((dSpaceID)g, root ? root : (dSpaceID)g);
+        continue;
+      }
+      if(!dGeomIsEnabled(g))
+        continue;
+      int c = dGeomGetClass(g);
+      // other rays (also encapsulated ones) are not obstacles
+      if(c == dRayClass || (c == dGeomTransformClass && dGeomTransformGetGeom(g)
+                            && dGeomGetClass(dGeomTransformGetGeom(g)) == dRayClass))
+        continue;
+      if(filter && !filter(g))
+        continue;
+      dReal aabb[6];
+      dGeomGetAABB(g, aabb);
+      if(aabb[0] > -dInfinity && aabb[1] < dInfinity && aabb[2] > -dInfinity
+         && aabb[3] < dInfinity && aabb[4] > -dInfinity && aabb[5] < dInfinity){
+        geoms.push_back(g);
+        roots.push_back(root);
+        minX.push_back(aabb[0]); maxX.push_back(aabb[1]);
+        minY.push_back(aabb[2]); maxY.push_back(aabb[3]);
+        minZ.push_back(aabb[4]); maxZ.push_back(aabb[5]);
+      } else {
+        unbounded.push_back(g);
+        unboundedRoots.push_back(root);
+      }
+    }
+  }
+
+  bool RayCaster::collide(dGeomID probe, dGeomID geom, double& best, dContactGeom& contact){
+    dContactGeom c;
+    int n;
+    switch(dGeomGetClass(geom)){
+    case dSphereClass:
+    case dBoxClass:
+    case dCapsuleClass:
+    case dCylinderClass:
+    case dPlaneClass:
+    case dConvexClass:
+      // these colliders only read the geom
+      n = dCollide(probe, geom, 1, &c, sizeof(dContactGeom));
+      break;
+    default:
+      pthread_mutex_lock(&collideMutex);
+      n = dCollide(probe, geom, 1, &c, sizeof(dContactGeom));
+      pthread_mutex_unlock(&collideMutex);
+    }
+    if(n > 0 && c.depth < best){
+      best = c.depth;
+      contact = c;
+      return true;
+    }
+    return false;
+  }
+
+  // inverse of a direction component without infinities (avoids nan in the slab test)
+  static inline double safeInverse(double d){
+    if(fabs(d) < 1e-12)
+      return d < 0 ? -1e12 : 1e12;
+    return 1.0/d;
+  }
+
+  void RayCaster::update(){
+    geoms.clear(); roots.clear();
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+    unbounded.clear(); unboundedRoots.clear();
+    collectGeoms(worldSpace, 0);
+  }
+
+  bool RayCaster::castRay(Query& q, const double o[3], const double d[3], double range,
+                          dSpaceID exclude, dContactGeom& contact, dGeomID self){
+    const int n = geoms.size();
+    q.entry.resize(n);
+    double* ent = n ? &q.entry[0] : 0;
+    const double* mnx = n ? &minX[0] : 0;
+    const double* mny = n ? &minY[0] : 0;
+    const double* mnz = n ? &minZ[0] : 0;
+    const double* mxx = n ? &maxX[0] : 0;
+    const double* mxy = n ? &maxY[0] : 0;
+    const double* mxz = n ? &maxZ[0] : 0;
+
+    // slab test against all bounding boxes
+    const double ix = safeInverse(d[0]), iy = safeInverse(d[1]), iz = safeInverse(d[2]);
+    for(int i=0; i<n; i++){
+      double t1 = (mnx[i] - o[0]) * ix, t2 = (mxx[i] - o[0]) * ix;
+      double tnear = std::min(t1, t2), tfar = std::max(t1, t2);
+      t1 = (mny[i] - o[1]) * iy; t2 = (mxy[i] - o[1]) * iy;
+      tnear = std::max(tnear, std::min(t1, t2)); tfar = std::min(tfar, std::max(t1, t2));
+      t1 = (mnz[i] - o[2]) * iz; t2 = (mxz[i] - o[2]) * iz;
+      tnear = std::max(tnear, std::min(t1, t2)); tfar = std::min(tfar, std::max(t1, t2));
+      tnear = std::max(tnear, 0.0);
+      ent[i] = (tnear <= tfar && tnear <= range) ? tnear : dInfinity;
+    }
+
+    // unbounded geoms (usually the ground plane) first, they often shorten the ray
+    dGeomRaySet(q.probe, o[0], o[1], o[2], d[0], d[1], d[2]);
+    dGeomRaySetLength(q.probe, range);
+    double best = range;
+    bool hit = false;
+    const bool checkPairs = self && pairFilter;
+    for(unsigned int i=0; i<unbounded.size(); i++){
+      if((!exclude || unboundedRoots[i] != exclude)
+         && !(checkPairs && pairFilter(pairFilterData, self, unbounded[i])))
+        hit |= collide(q.probe, unbounded[i], best, contact);
+    }
+
+    q.candidates.clear();
+    for(int i=0; i<n; i++){
+      if(ent[i] <= best && (!exclude || roots[i] != exclude)
+         && !(checkPairs && pairFilter(pairFilterData, self, geoms[i])))
+        q.candidates.push_back(std::pair<double, int>(ent[i], i));
+    }
+    std::sort(q.candidates.begin(), q.candidates.end());
+
+    // exact tests, nearest boxes first
+    for(std::vector<std::pair<double, int> >::const_iterator c = q.candidates.begin();
+        c != q.candidates.end(); ++c){
+      if(c->first > best)
+        break;
+      hit |= collide(q.probe, geoms[c->second], best, contact);
+    }
+    return hit;
+  }
+
+  void RayCaster::cast(){
+    if(numRays == 0)
+      return;
+    update();
+
+    dContactGeom contact;
+    for(std::vector<RayData>::iterator r = rays.begin(); r != rays.end(); ++r){
+      if(!r->active)
+        continue;
+      // pose of the ray in world coordinates
+      const dReal* p;
+      const dReal* R;
+      dBodyID body = r->geom ? dGeomGetBody(r->geom) : 0;
+      if(body){
+        p = dBodyGetPosition(body);
+        R = dBodyGetRotation(body);
+      } else if(r->geom && dGeomGetClass(r->geom) != dPlaneClass){
+        p = dGeomGetPosition(r->geom);
+        R = dGeomGetRotation(r->geom);
+      } else {
+        p = 0;
+        R = 0;
+      }
+      double o[3], d[3];
+      for(int i=0; i<3; i++){
+        if(R){
+          o[i] = p[i] + R[i*4]*r->pos[0] + R[i*4+1]*r->pos[1] + R[i*4+2]*r->pos[2];
+          d[i] = R[i*4]*r->dir[0] + R[i*4+1]*r->dir[1] + R[i*4+2]*r->dir[2];
+        } else {
+          o[i] = r->pos[i];
+          d[i] = r->dir[i];
+        }
+      }
+      dSpaceID exclude = topLevelSpace(r->ownSpace);
+      if(exclude && collisionSpaces
+         && std::find(collisionSpaces->begin(), collisionSpaces->end(), exclude) != collisionSpaces->end())
+        exclude = 0;
+
+      if(castRay(query, o, d, r->range, exclude, contact, r->self) && contact.depth < *(r->result))
+        *(r->result) = contact.depth;
+    }
+  }
+
+}
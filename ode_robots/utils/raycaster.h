@@ -0,0 +1,182 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __RAYCASTER_H
+#define __RAYCASTER_H
+
+#include <vector>
+#include <utility>
+#include <pthread.h>
+#include <ode-dbl/common.h>
+#include <ode-dbl/collision.h>
+
+namespace lpzrobots {
+
+  /** Engine for batched ray queries, used by RaySensor (and thus IRSensor,
+      RaySensorBank and RangeFinder).
+
+      Instead of one ODE ray geom per sensor in the collision spaces all rays are
+      registered here and cast together once per simulation step
+      (Simulation::odeStep, after the collision detection).
+      The bounding boxes of all geoms are collected once per step into flat arrays.
+      Each ray is tested against all boxes in one branch-free slab test (vectorised
+      by the compiler) and only the remaining candidates are tested exactly with
+      dCollide, ordered by their distance, until the nearest hit is certain.
+      The measured distance is written directly to the value given at registration.
+
+      As with ray geoms, a ray does not hit geoms inside the top level space it was
+      created in (typically the robot), unless collisions inside this space are enabled.
+      Pairs of the ray geom and other geoms can be ignored like in the collision
+      detection (see setPairFilter and OdeHandle::addIgnoredPair).
+
+      The caster is owned by the OdeHandle and deleted with its spaces. Rays which are
+      still registered then are detached: the owner pointer given to addRay is set to 0.
+   */
+  class RayCaster {
+  public:
+    /// decides whether a geom can be hit by the rays
+    typedef bool (*GeomFilter)(dGeomID geom);
+    /// decides whether a pair of geoms is ignored (true) for the rays
+    typedef bool (*PairFilter)(const void* data, dGeomID g1, dGeomID g2);
+
+    /** probe geom and scratch memory for casting single rays.
+        Every thread needs its own Query (see castRay).
+     */
+    class Query {
+    public:
+      Query();
+      ~Query();
+    protected:
+      friend class RayCaster;
+      dGeomID probe; ///< ray geom (in no space) used for the exact tests
+      std::vector<double> entry;
+      std::vector<std::pair<double, int> > candidates;
+    };
+
+    /// @param worldSpace the top level collision space
+    RayCaster(dSpaceID worldSpace);
+    ~RayCaster();
+
+    /** registers a ray.
+        @param geom the ray is attached to the body of this geom (or to the geom if static)
+        @param pos origin of the ray relative to the body
+        @param dir direction of the ray relative to the body
+        @param range maximal length of the ray
+        @param ownSpace space the ray belongs to (used to exclude the own robot)
+        @param result the distance of a hit is written here if it is smaller than the value
+        @param self geom representing the ray for the pair filter (0 for none)
+        @param owner set to 0 if the caster is deleted before the ray is removed (or 0)
+        @return id of the ray (to be used for removeRay and setRange)
+    */
+    int addRay(dGeomID geom, const dVector3 pos, const dVector3 dir, double range,
+               dSpaceID ownSpace, double* result, dGeomID self = 0, RayCaster** owner = 0);
+
+    /// removes the ray with the given id
+    void removeRay(int id);
+
+    /// sets the maximal length of the ray with the given id
+    void setRange(int id, double range);
+
+    /// number of registered rays
+    int getNumRays() const { return numRays; }
+
+    /// sets a filter for geoms that should be invisible for the rays (0 for none)
+    void setGeomFilter(GeomFilter filter) { this->filter = filter; }
+
+    /// sets a filter for pairs of ray geom and geom that should be ignored (0 for none)
+    void setPairFilter(PairFilter pairFilter, const void* data) {
+      this->pairFilter = pairFilter; pairFilterData = data;
+    }
+
+    /** sets the list of spaces with enabled inside collisions (see OdeHandle::getSpaces).
+        Rays in these spaces hit the geoms of their own space.
+     */
+    void setCollisionSpaces(const std::vector<dSpaceID>* spaces) { collisionSpaces = spaces; }
+
+    /// casts all registered rays
+    void cast();
+
+    /** collects the geoms and their current bounding boxes. This is done by cast()
+        and has to be called before castRay if the scene has changed.
+     */
+    void update();
+
+    /** casts a single ray against the geoms collected by update().
+        Different threads may call this at the same time with different queries.
+        @param origin start of the ray in world coordinates
+        @param dir normalised direction in world coordinates
+        @param range maximal length
+        @param exclude geoms in this top level space are ignored (0 for none)
+        @param contact nearest hit (only valid if true is returned)
+        @param self geom representing the ray for the pair filter (0 for none)
+        @return true if something was hit
+     */
+    bool castRay(Query& query, const double origin[3], const double dir[3], double range,
+                 dSpaceID exclude, dContactGeom& contact, dGeomID self = 0);
+
+    /// the top level space (child of the world space) containing the given space
+    dSpaceID topLevelSpace(dSpaceID space) const;
+
+  protected:
+    struct RayData {
+      dGeomID geom;
+      dVector3 pos;
+      dVector3 dir;
+      double range;
+      dSpaceID ownSpace;
+      double* result;
+      dGeomID self;
+      RayCaster** owner;
+      bool active;
+    };
+
+    /// collects all geoms (recursively) with their bounding boxes
+    void collectGeoms(dSpaceID space, dSpaceID root);
+    /// exact test against one geom, returns true if hit closer than best
+    bool collide(dGeomID probe, dGeomID geom, double& best, dContactGeom& contact);
+
+    dSpaceID worldSpace;
+    Query query; ///< used by cast()
+    /// protects the colliders which modify the geoms (transforms, meshes, heightfields)
+    pthread_mutex_t collideMutex;
+    GeomFilter filter;
+    PairFilter pairFilter;
+    const void* pairFilterData;
+    const std::vector<dSpaceID>* collisionSpaces;
+
+    std::vector<RayData> rays;
+    std::vector<int> freeIds;
+    int numRays;
+
+    // bounded geoms as structure of arrays
+    std::vector<dGeomID> geoms;
+    std::vector<dSpaceID> roots;
+    std::vector<double> minX, minY, minZ, maxX, maxY, maxZ;
+    // geoms without finite bounding box (e.g. planes)
+    std::vector<dGeomID> unbounded;
+    std::vector<dSpaceID> unboundedRoots;
+  };
+
+}
+
+#endif
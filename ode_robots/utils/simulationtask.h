@@ -41,6 +41,8 @@ namespace lpzrobots {
 
     virtual ~SimulationTask() { }
 
+    int getTaskId() const { return taskId; }
+
     virtual int startTask(SimulationTaskHandle& simTaskHandle, TaskedSimulationCreator& simTaskCreator, int* argc, char** argv, std::string nameSuffix)
     {
       int returnValue=0;
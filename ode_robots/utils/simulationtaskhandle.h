@@ -25,6 +25,7 @@
 #define _SIMULATIONTASKHANDLE_H_
 
 #include <vector>
+#include <cstdio>
 
 namespace lpzrobots
 {
@@ -33,9 +34,28 @@ namespace lpzrobots
    * struct which holds all structural data for the simulations.
    * A specialized class can be deduced from this one to hold necessary
    * information, for the methods start and restart of the Simulation.
+   *
+   * If the tasks are running as separate processes
+   * (see SimulationTaskSupervisor::setTaskMode) every task works on its own
+   * copy of the handle. To get results back to the supervising process
+   * overwrite storeTaskResult and restoreTaskResult.
    */
   struct SimulationTaskHandle
   {
+    virtual ~SimulationTaskHandle() {}
+
+    /**
+     * Called inside the process of a task after it has finished.
+     * Write the results of the task with the given id into the file.
+     * @return true if all ok
+     */
+    virtual bool storeTaskResult(int taskId, FILE* f) { return true; }
+
+    /**
+     * Called in the supervising process with the data written by storeTaskResult.
+     * @return true if all ok
+     */
+    virtual bool restoreTaskResult(int taskId, FILE* f) { return true; }
   };
 
 }
@@ -37,6 +37,17 @@
 #include <signal.h>
 #include <primitive.h>
 
+#include <deque>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 using namespace std;
 
 namespace lpzrobots {
@@ -50,6 +61,51 @@ namespace lpzrobots {
   osg::ArgumentParser* SimulationTaskSupervisor::parser = 0;
   //LpzRobotsViewer*               SimulationTaskSupervisor::viewer=0;
   std::string SimulationTaskSupervisor::nameSuffix = "(tasked)";
+  SimulationTaskMode SimulationTaskSupervisor::taskMode = TASKS_AS_THREADS;
+  int SimulationTaskSupervisor::numberProcesses = 0;
+  int SimulationTaskSupervisor::maxRetries = 1;
+  bool SimulationTaskSupervisor::cpuPinning = false;
+
+  namespace {
+  /// bookkeeping of one running task process
+  struct TaskProcess {
+    pid_t pid;
+    int index;      // index in simTaskList
+    int cpu;        // slot of the worker pool (used for pinning)
+    int resultFd;
+    int logFd;
+    std::string result;
+    std::string log;
+  };
+  }
+
+  /// prints all complete lines of the log buffer (or everything if flush)
+  static void forwardTaskLog(TaskProcess& p, int taskId, bool flush){
+    size_t start = 0;
+    size_t end;
+    while((end = p.log.find('\n', start)) != std::string::npos){
+      printf("[task %i] %s\n", taskId, p.log.substr(start, end - start).c_str());
+      start = end + 1;
+    }
+    p.log.erase(0, start);
+    if(flush && !p.log.empty()){
+      printf("[task %i] %s\n", taskId, p.log.c_str());
+      p.log.clear();
+    }
+    fflush(stdout);
+  }
+
+  /// reads available data from fd into buffer, closes fd at the end of file
+  static void readTaskPipe(int& fd, std::string& buffer){
+    char buf[4096];
+    ssize_t len = read(fd, buf, sizeof(buf));
+    if(len > 0)
+      buffer.append(buf, len);
+    else if(len == 0 || (errno != EINTR && errno != EAGAIN)){
+      close(fd);
+      fd = -1;
+    }
+  }
 
   void SimulationTaskSupervisor::runSimTasks(int* _argc, char** _argv) {
     int laststate;
@@ -63,6 +119,14 @@ namespace lpzrobots {
 
     argc = _argc;
     argv = _argv;
+    if(taskMode == TASKS_AS_PROCESSES){
+      runSimTasksInProcesses();
+      for(unsigned int i=0; i<simTaskList.size(); i++)
+        delete simTaskList[i];
+      simTaskList.clear();
+      pthread_setcancelstate(laststate, NULL);
+      return;
+    }
     //viewer = LpzRobotsViewer::getViewerInstance(*argc, argv);
     //parser = viewer->getArgumentParser();
     QP(PROFILER.init());
@@ -98,10 +162,175 @@ namespace lpzrobots {
     simTaskList.clear();
   }
 
+  void SimulationTaskSupervisor::runSimTasksInProcesses() {
+    int numWorkers = numberProcesses > 0 ? numberProcesses : (int)QMP_GET_NUM_PROCS();
+    if(numWorkers < 1)
+      numWorkers = 1;
+    std::deque<int> pending;
+    std::vector<int> tries(simTaskList.size(), 0);
+    std::vector<bool> cpuUsed(numWorkers, false);
+    std::vector<TaskProcess> running;
+    for(unsigned int i=0; i<simTaskList.size(); i++)
+      pending.push_back(i);
+    fflush(stdout);
+    fflush(stderr);
+
+    while(!pending.empty() || !running.empty()){
+      // fill the pool
+      while((int)running.size() < numWorkers && !pending.empty()){
+        int resultPipe[2];
+        int logPipe[2];
+        if(pipe(resultPipe) != 0)
+          break;
+        if(pipe(logPipe) != 0){
+          close(resultPipe[0]); close(resultPipe[1]);
+          break;
+        }
+        int cpu = 0;
+        while(cpuUsed[cpu]) cpu++;
+        int index = pending.front();
+        pid_t pid = fork();
+        if(pid < 0){
+          perror("SimulationTaskSupervisor: fork");
+          close(resultPipe[0]); close(resultPipe[1]);
+          close(logPipe[0]); close(logPipe[1]);
+          break;
+        }
+        if(pid == 0){ // child
+          close(resultPipe[0]);
+          close(logPipe[0]);
+          for(unsigned int k=0; k<running.size(); k++){ // pipes of the other tasks
+            if(running[k].resultFd >= 0) close(running[k].resultFd);
+            if(running[k].logFd >= 0) close(running[k].logFd);
+          }
+          dup2(logPipe[1], STDOUT_FILENO);
+          dup2(logPipe[1], STDERR_FILENO);
+          close(logPipe[1]);
+          runSimTaskInChild(index, resultPipe[1], cpu);
+        }
+        close(resultPipe[1]);
+        close(logPipe[1]);
+        pending.pop_front();
+        cpuUsed[cpu] = true;
+        tries[index]++;
+        TaskProcess p;
+        p.pid = pid;
+        p.index = index;
+        p.cpu = cpu;
+        p.resultFd = resultPipe[0];
+        p.logFd = logPipe[0];
+        running.push_back(p);
+      }
+      if(running.empty()){ // fork failed and nothing is running
+        fprintf(stderr, "SimulationTaskSupervisor: cannot start task processes, %i tasks are skipped\n",
+                (int)pending.size());
+        break;
+      }
+
+      // wait for data of the running tasks
+      std::vector<pollfd> fds;
+      std::vector<int*> fdRefs;
+      std::vector<TaskProcess*> fdOwner;
+      for(unsigned int k=0; k<running.size(); k++){
+        int* refs[2] = { &running[k].resultFd, &running[k].logFd };
+        for(int r=0; r<2; r++){
+          if(*refs[r] < 0) continue;
+          pollfd pfd;
+          pfd.fd = *refs[r];
+          pfd.events = POLLIN;
+          pfd.revents = 0;
+          fds.push_back(pfd);
+          fdRefs.push_back(refs[r]);
+          fdOwner.push_back(&running[k]);
+        }
+      }
+      if(!fds.empty() && poll(&fds[0], fds.size(), -1) > 0){
+        for(unsigned int f=0; f<fds.size(); f++){
+          if(!(fds[f].revents & (POLLIN | POLLHUP | POLLERR)))
+            continue;
+          TaskProcess& p = *fdOwner[f];
+          if(fdRefs[f] == &p.logFd){
+            readTaskPipe(p.logFd, p.log);
+            forwardTaskLog(p, simTaskList[p.index]->getTaskId(), p.logFd < 0);
+          } else
+            readTaskPipe(p.resultFd, p.result);
+        }
+      }
+
+      // collect finished tasks (both pipes closed)
+      for(int k=running.size()-1; k>=0; k--){
+        TaskProcess& p = running[k];
+        if(p.resultFd >= 0 || p.logFd >= 0)
+          continue;
+        int status = 0;
+        while(waitpid(p.pid, &status, 0) < 0 && errno == EINTR);
+        int taskId = simTaskList[p.index]->getTaskId();
+        // a task failed if it was killed or if it exited with an error without any result
+        bool failed = WIFSIGNALED(status) ||
+          (WIFEXITED(status) && WEXITSTATUS(status) != 0 && p.result.empty());
+        if(failed){
+          char reason[64];
+          if(WIFSIGNALED(status))
+            snprintf(reason, sizeof(reason), "crashed (signal %i)", WTERMSIG(status));
+          else
+            snprintf(reason, sizeof(reason), "failed (exit code %i, no result)", WEXITSTATUS(status));
+          if(tries[p.index] <= maxRetries){
+            fprintf(stderr, "SimulationTaskSupervisor: task %i %s, restarting\n", taskId, reason);
+            pending.push_back(p.index);
+          } else
+            fprintf(stderr, "SimulationTaskSupervisor: task %i %s, giving up\n", taskId, reason);
+        } else if(!p.result.empty()){
+          if(WIFEXITED(status) && WEXITSTATUS(status) != 0)
+            fprintf(stderr, "SimulationTaskSupervisor: task %i exited with code %i\n",
+                    taskId, WEXITSTATUS(status));
+          FILE* f = tmpfile();
+          if(f){
+            fwrite(p.result.data(), 1, p.result.size(), f);
+            rewind(f);
+            if(!simTaskHandle->restoreTaskResult(taskId, f))
+              fprintf(stderr, "SimulationTaskSupervisor: cannot restore result of task %i\n", taskId);
+            fclose(f);
+          }
+        }
+        cpuUsed[p.cpu] = false;
+        running.erase(running.begin() + k);
+      }
+    }
+  }
+
+  void SimulationTaskSupervisor::runSimTaskInChild(int index, int resultFd, int cpu) {
+#ifdef __linux__
+    if(cpuPinning){
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu % QMP_GET_NUM_PROCS(), &set);
+      if(sched_setaffinity(0, sizeof(set), &set) != 0)
+        perror("SimulationTaskSupervisor: sched_setaffinity");
+    }
+#endif
+    dInitODE();
+    SimulationTask* task = simTaskList[index];
+    int returnValue = task->startTask(*simTaskHandle, *taskedSimCreator, argc, argv, nameSuffix);
+    FILE* f = fdopen(resultFd, "w");
+    if(f){
+      if(!simTaskHandle->storeTaskResult(task->getTaskId(), f))
+        returnValue = 1;
+      fclose(f);
+    } else
+      close(resultFd);
+    dCloseODE();
+    fflush(stdout);
+    fflush(stderr);
+    // do not run the destructors of the supervising process
+    _exit(returnValue);
+  }
+
   void SimulationTaskSupervisor::setNumberThreads(int numberThreads)
   {
-    if (numberThreads > 0)
+    if (numberThreads > 0) {
       QMP_SET_NUM_THREADS(numberThreads);
+      numberProcesses = numberThreads;
+    }
   }
 
   void SimulationTaskSupervisor::setNumberThreadsPerCore(int numberThreadsPerCore)
@@ -113,5 +342,18 @@ namespace lpzrobots {
   void SimulationTaskSupervisor::setSimTaskNameSuffix(std::string name) {
     nameSuffix = name;
   }
+
+  void SimulationTaskSupervisor::setTaskMode(SimulationTaskMode mode) {
+    taskMode = mode;
+  }
+
+  void SimulationTaskSupervisor::setMaxRetries(int _maxRetries) {
+    if (_maxRetries >= 0)
+      maxRetries = _maxRetries;
+  }
+
+  void SimulationTaskSupervisor::setCPUPinning(bool pinning) {
+    cpuPinning = pinning;
+  }
 }
 
@@ -38,6 +38,12 @@ namespace lpzrobots
 
   class LpzRobotsViewer;
 
+  /// how the SimulationTasks are executed
+  enum SimulationTaskMode {
+    TASKS_AS_THREADS,   ///< all tasks run as threads in one process (default)
+    TASKS_AS_PROCESSES  ///< every task runs in its own forked process
+  };
+
   class SimulationTaskSupervisor
   {
   public:
@@ -93,6 +99,29 @@ namespace lpzrobots
      */
     static void setNumberThreadsPerCore(int numberThreadsPerCore);
 
+    /**
+     * Sets how the tasks are executed. With TASKS_AS_PROCESSES every task is
+     * forked into its own process, so that ODE and OSG do not share any state
+     * between the tasks. At most setNumberThreads() processes run at one time.
+     * Results have to be passed back with SimulationTaskHandle::storeTaskResult
+     * and SimulationTaskHandle::restoreTaskResult. The output of the tasks is
+     * forwarded line by line, prefixed with the taskId.
+     */
+    static void setTaskMode(SimulationTaskMode mode);
+
+    /**
+     * Sets how often a task process is restarted if it crashed (is killed by a signal)
+     * or exited with a non-zero code without writing a result.
+     * Only used with TASKS_AS_PROCESSES. The default value is 1.
+     */
+    static void setMaxRetries(int maxRetries);
+
+    /**
+     * If enabled every task process is bound to one core (only supported on Linux).
+     * Only used with TASKS_AS_PROCESSES. Default is false.
+     */
+    static void setCPUPinning(bool pinning);
+
     /**
      * Creates one SimulationTask with taskId=SimulationTaskHandle.simTaskList.size().
      * @param argc count of arguments in argv
@@ -131,6 +160,12 @@ namespace lpzrobots
 
     SimulationTaskSupervisor() {}
 
+    /// runs the tasks in a bounded pool of forked processes
+    virtual void runSimTasksInProcesses();
+
+    /// executed in the forked process, does not return
+    virtual void runSimTaskInChild(int index, int resultFd, int cpu);
+
     virtual ~SimulationTaskSupervisor() {}
 
     static SimulationTaskSupervisor* singletonInstance;
@@ -142,6 +177,10 @@ namespace lpzrobots
     static osg::ArgumentParser* parser;
     static LpzRobotsViewer* viewer;
     static std::string nameSuffix;
+    static SimulationTaskMode taskMode;
+    static int numberProcesses;
+    static int maxRetries;
+    static bool cpuPinning;
 
 
   };
@@ -0,0 +1,177 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#include "soundfield.h"
+
+#include <math.h>
+#include <algorithm>
+
+namespace lpzrobots {
+
+  SoundField::SoundField()
+    : cellSize(0), valid(false), indexed(0),
+      minX(0), minY(0), cell(1), nx(0), ny(0) {
+    pthread_mutex_init(&mutex, 0);
+  }
+
+  SoundField::SoundField(const SoundField& f)
+    : cellSize(f.cellSize), valid(false), indexed(0),
+      minX(0), minY(0), cell(1), nx(0), ny(0) {
+    pthread_mutex_init(&mutex, 0);
+  }
+
+  SoundField& SoundField::operator=(const SoundField& f){
+    // the index refers to the list of the other object, so it is not copied
+    cellSize = f.cellSize;
+    invalidate();
+    return *this;
+  }
+
+  SoundField::~SoundField(){
+    pthread_mutex_destroy(&mutex);
+  }
+
+  void SoundField::setCellSize(double size){
+    pthread_mutex_lock(&mutex);
+    cellSize = std::max(size, 0.0);
+    valid = false;
+    pthread_mutex_unlock(&mutex);
+  }
+
+  void SoundField::add(SoundList& sounds, const Sound& s){
+    pthread_mutex_lock(&mutex);
+    sounds.push_back(s);
+    pthread_mutex_unlock(&mutex);
+  }
+
+  void SoundField::invalidate(){
+    pthread_mutex_lock(&mutex);
+    valid = false;
+    pthread_mutex_unlock(&mutex);
+  }
+
+  int SoundField::cellX(double x) const {
+    return std::min(std::max(int(floor((x - minX)/cell)), 0), nx-1);
+  }
+
+  int SoundField::cellY(double y) const {
+    return std::min(std::max(int(floor((y - minY)/cell)), 0), ny-1);
+  }
+
+  void SoundField::build(const SoundList& sounds){
+    int n = sounds.size();
+    indexed = n;
+    pending.clear();
+    valid = true;
+    if(n==0){
+      nx = ny = 0;
+      return;
+    }
+    last = --sounds.end();
+
+    double maxX, maxY;
+    minX = maxX = sounds.front().pos.x();
+    minY = maxY = sounds.front().pos.y();
+    for(SoundList::const_iterator s = sounds.begin(); s != sounds.end(); ++s){
+      minX = std::min(minX, (double)s->pos.x()); maxX = std::max(maxX, (double)s->pos.x());
+      minY = std::min(minY, (double)s->pos.y()); maxY = std::max(maxY, (double)s->pos.y());
+    }
+    double w = std::max(maxX - minX, 1e-6);
+    double h = std::max(maxY - minY, 1e-6);
+    cell = cellSize > 0 ? cellSize : std::max(sqrt(w*h/n), std::max(w, h)/n);
+    // limit the number of cells (memory) to a multiple of the number of sounds
+    while((w/cell+1)*(h/cell+1) > 4.0*n + 16) cell*=2;
+    nx = int(w/cell) + 1;
+    ny = int(h/cell) + 1;
+
+    // counting sort of the sounds into the cells (keeps the list order within a cell)
+    cellStart.assign(nx*ny+1, 0);
+    cellOf.resize(n);
+    int i=0;
+    for(SoundList::const_iterator s = sounds.begin(); s != sounds.end(); ++s, ++i){
+      cellOf[i] = cellY(s->pos.y())*nx + cellX(s->pos.x());
+      cellStart[cellOf[i]+1]++;
+    }
+    for(int c=0; c<nx*ny; c++){
+      cellStart[c+1] += cellStart[c];
+    }
+    cellSounds.resize(n);
+    i=0;
+    for(SoundList::const_iterator s = sounds.begin(); s != sounds.end(); ++s, ++i){
+      cellSounds[cellStart[cellOf[i]]++] = std::pair<int, const Sound*>(i, &(*s));
+    }
+    // cellStart was shifted by the filling, restore it
+    for(int c=nx*ny; c>0; c--){
+      cellStart[c] = cellStart[c-1];
+    }
+    cellStart[0] = 0;
+  }
+
+  void SoundField::update(const SoundList& sounds){
+    int n = sounds.size();
+    if(!valid || n < indexed + (int)pending.size()){
+      build(sounds);
+      return;
+    }
+    int known = indexed + pending.size();
+    if(n == known) return;
+    // new sounds at the end of the list
+    SoundList::const_iterator s = last;
+    if(known>0) ++s; else s = sounds.begin();
+    for(int i=known; s != sounds.end(); ++s, ++i){
+      pending.push_back(std::pair<int, const Sound*>(i, &(*s)));
+      last = s;
+    }
+    if((int)pending.size() > std::max(indexed, 8))
+      build(sounds);
+  }
+
+  void SoundField::query(const SoundList& sounds, const Pos& pos, double radius, Hits& hits){
+    hits.clear();
+    pthread_mutex_lock(&mutex);
+    update(sounds);
+    const double x0 = pos.x() - radius, x1 = pos.x() + radius;
+    const double y0 = pos.y() - radius, y1 = pos.y() + radius;
+    if(nx > 0 && x1 >= minX && y1 >= minY && x0 <= minX + nx*cell && y0 <= minY + ny*cell){
+      int cx0 = cellX(x0), cx1 = cellX(x1);
+      int cy0 = cellY(y0), cy1 = cellY(y1);
+      for(int cy=cy0; cy<=cy1; cy++){
+        for(int c=cy*nx+cx0; c<=cy*nx+cx1; c++){
+          for(int k=cellStart[c]; k<cellStart[c+1]; k++){
+            const Sound* s = cellSounds[k].second;
+            if(s->pos.x() >= x0 && s->pos.x() <= x1 && s->pos.y() >= y0 && s->pos.y() <= y1)
+              hits.push_back(cellSounds[k]);
+          }
+        }
+      }
+    }
+    for(Hits::const_iterator p = pending.begin(); p != pending.end(); ++p){
+      const Sound* s = p->second;
+      if(s->pos.x() >= x0 && s->pos.x() <= x1 && s->pos.y() >= y0 && s->pos.y() <= y1)
+        hits.push_back(*p);
+    }
+    pthread_mutex_unlock(&mutex);
+    std::sort(hits.begin(), hits.end());
+  }
+
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __SOUNDFIELD_H
+#define __SOUNDFIELD_H
+
+#include <list>
+#include <vector>
+#include <utility>
+#include <pthread.h>
+
+#include "sound.h"
+
+namespace lpzrobots {
+
+  typedef std::list<Sound> SoundList;
+
+  /** Spatial index of the sounds (GlobalData::sounds), such that a SoundSensor only
+      looks at the sounds near to it and not at all sounds of the simulation.
+
+      The sounds are sorted into a uniform grid in the x-y plane (counting sort into
+      flat arrays, which keep their memory between the steps).
+      Sounds added after the last build are kept in a short list that is searched linearly
+      and the grid is only rebuilt if this list gets longer than the indexed part.
+      Adding and querying is thread safe (agents may run in parallel).
+      Sounds must only be removed with GlobalData::removeExpiredObjects (or invalidate()
+      has to be called).
+   */
+  class SoundField {
+  public:
+    /// a sound together with its index in the sound list
+    typedef std::vector<std::pair<int, const Sound*> > Hits;
+
+    SoundField();
+    SoundField(const SoundField&);
+    SoundField& operator=(const SoundField&);
+    ~SoundField();
+
+    /** sets the cell size of the grid.
+        @param size edge length of a cell, 0: automatic (about one sound per cell)
+    */
+    void setCellSize(double size);
+
+    /// adds a sound to the list (thread safe)
+    void add(SoundList& sounds, const Sound& s);
+
+    /// has to be called if sounds were removed from the list
+    void invalidate();
+
+    /** collects all sounds whose (x,y) position is within a square of half size radius
+        around pos, ordered as in the sound list.
+        The exact distance has to be checked by the caller.
+        @param hits is cleared and filled (its memory is reused)
+    */
+    void query(const SoundList& sounds, const Pos& pos, double radius, Hits& hits);
+
+  protected:
+    /// brings the index up to date with the list (mutex has to be locked)
+    void update(const SoundList& sounds);
+    void build(const SoundList& sounds);
+    inline int cellX(double x) const;
+    inline int cellY(double y) const;
+
+    double cellSize;
+    bool valid;
+    int indexed;       ///< number of sounds (from the front of the list) in the grid
+    SoundList::const_iterator last; ///< last sound known to the index
+    // grid
+    double minX, minY, cell;
+    int nx, ny;
+    std::vector<int> cellStart;  ///< start of cell in cellSounds, size nx*ny+1
+    std::vector<std::pair<int, const Sound*> > cellSounds;
+    std::vector<int> cellOf;     ///< scratch: cell of each sound during build
+    /// sounds added after the last build
+    std::vector<std::pair<int, const Sound*> > pending;
+
+    pthread_mutex_t mutex;
+  };
+
+}
+
+#endif
@@ -40,6 +40,7 @@ Agent::Agent(const PlotOption& plotOption, double noisefactor, const iparamkey&
   : WiredController(plotOption, noisefactor, name, revision) {
   robot      = 0;
   rsensors=0; rmotors=0;
+  latency=0; queueHead=0; queueSize=0;
 }
 
 
@@ -47,6 +48,7 @@ Agent::Agent(const std::list<PlotOption>& plotOptions, double noisefactor, const
   : WiredController(plotOptions, noisefactor, name, revision){
   robot      = 0;
   rsensors=0; rmotors=0;
+  latency=0; queueHead=0; queueSize=0;
 }
 
 Agent::~Agent(){
@@ -63,8 +65,10 @@ bool Agent::init(AbstractController* controller, AbstractRobot* robot,
   this->robot   = robot;
   assert(robot);
 
-  if(!seed) seed=rand();
-  randGen.init(seed);
+  if(!randGen.isCounterBased()){
+    if(!seed) seed=rand();
+    randGen.init(seed);
+  }
 
   rsensornumber = robot->getSensorNumber();
   rmotornumber  = robot->getMotorNumber();
@@ -72,6 +76,7 @@ bool Agent::init(AbstractController* controller, AbstractRobot* robot,
   rmotors       = (motor*)  malloc(sizeof(motor)  * rmotornumber);
   memset(rsensors,0, sizeof(motor)*rsensornumber);
   memset(rmotors,0, sizeof(motor)*rmotornumber);
+  setLatency(latency);
 
   // add robot to inspectables
   Inspectable* in = dynamic_cast<Inspectable*>(robot);
@@ -87,17 +92,51 @@ bool Agent::init(AbstractController* controller, AbstractRobot* robot,
 
 
 void Agent::step(double noise, double time){
+  sense(time);
+  control(noise, time);
+  onlyControlRobot();
+}
+
+void Agent::sense(double time){
   assert(robot && rsensors && rmotors);
 
-  int len =  robot->getSensors(rsensors, rsensornumber);
+  // the queue is bounded: if control() was not called the oldest frame is dropped
+  if(queueSize > latency){
+    queueHead = (queueHead+1) % (latency+1);
+    queueSize--;
+  }
+  sensor* frame = sensorQueue.data() + ((queueHead + queueSize) % (latency+1)) * rsensornumber;
+  int len =  robot->getSensors(frame, rsensornumber);
   if(len != rsensornumber){
     fprintf(stdout, "%s:%i: Got not enough sensors, expected %i, got %i!\n", __FILE__, __LINE__,
             rsensornumber, len);
   }
+  queueSize++;
+  trackrobot.track(robot, time);
+}
+
+void Agent::control(double noise, double time){
+  assert(robot && rsensors && rmotors);
 
+  // take the oldest frame (if the queue is empty the last one is used again)
+  if(queueSize > 0){
+    memcpy(rsensors, sensorQueue.data() + queueHead * rsensornumber, sizeof(sensor) * rsensornumber);
+    queueHead = (queueHead+1) % (latency+1);
+    queueSize--;
+  }
   WiredController::step(rsensors,rsensornumber, rmotors, rmotornumber, noise, time);
-  robot->setMotors(rmotors, rmotornumber);
-  trackrobot.track(robot, time);
+}
+
+void Agent::setLatency(int latency){
+  this->latency = latency < 0 ? 0 : latency;
+  if(!rsensors) return; // the queue is created in init()
+  // the queue is filled with the last sensor values
+  sensorQueue.resize((this->latency+1) * rsensornumber);
+  for(int f=0; f < this->latency; f++){
+    memcpy(sensorQueue.data() + f * rsensornumber, rsensors, sizeof(sensor) * rsensornumber);
+  }
+  queueHead = 0;
+  queueSize = this->latency;
 }
 
 // Sends only last motor commands again to robot.
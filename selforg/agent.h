@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "wiredcontroller.h"
 #include "randomgenerator.h"
@@ -72,6 +73,15 @@ public:
   virtual bool init(AbstractController* controller, AbstractRobot* robot,
                     AbstractWiring* wiring, long int seed=0);
 
+  /** switches the random generator of the agent (used by wiring, noise
+      and controller) to the counter based generator. Call it before init(),
+      which then ignores its seed. With a common seed and the agent index as
+      stream all agents get independent and reproducible random numbers.
+  */
+  virtual void setRandomStream(uint64_t seed, uint64_t stream){
+    randGen.initCounterBased(seed, stream);
+  }
+
   /** Performs an step of the agent, including sensor reading, pushing sensor values through the wiring,
       controller step, pushing controller outputs (= motorcommands) back through the wiring and sent
       resulting motorcommands to robot.
@@ -80,9 +90,34 @@ public:
   */
   virtual void step(double noise, double time=-1);
 
+  /** The step can also be performed in three stages (used by a pipelined simulation):
+      sense(), control() and onlyControlRobot() (actuation).
+      sense() reads the sensor values of the robot into the sensor queue
+      (and does the tracking).
+      @param time (optional) current simulation time (used for logging)
+  */
+  virtual void sense(double time=-1);
+
+  /** control stage: takes the oldest sensor frame from the sensor queue and performs
+      the step of the wired controller. The motor commands are sent to the robot
+      by onlyControlRobot(). With a latency > 0 it can be called before sense()
+      of the same step, because it does not depend on the current sensor values.
+      @param noise Noise strength.
+      @param time (optional) current simulation time (used for logging)
+  */
+  virtual void control(double noise, double time=-1);
+
   /** Sends only last motor commands again to robot.  */
   virtual void onlyControlRobot();
 
+  /** sets the sensor latency (in control steps): the controller gets the sensor values
+      that were sensed latency steps before. The sensor queue holds latency+1 frames
+      and is filled with the last sensor values on change.
+  */
+  virtual void setLatency(int latency);
+  /// returns the sensor latency in control steps
+  virtual int getLatency() const { return latency; }
+
 
   /** Returns a pointer to the robot.
    */
@@ -109,6 +144,11 @@ protected:
   TrackRobot trackrobot;
   int t; // access to this variable is needed from OdeAgent
 
+  int latency; // sensor latency in control steps
+  std::vector<sensor> sensorQueue; // ring buffer of latency+1 sensor frames
+  int queueHead; // index of the oldest frame in the sensorQueue
+  int queueSize; // number of frames in the sensorQueue
+
 
 };
 
@@ -24,8 +24,37 @@
 
 #include "abstractcontroller.h"
 
+#include <vector>
+#include <climits>
+
 using namespace std;
 
+namespace {
+  /// a controller to schedule together with period and phase of its caller
+  struct ScheduleEntry {
+    AbstractController* controller;
+    long outerRate;  // in steps of the control loop
+    long outerPhase;
+  };
+
+  long gcd(long a, long b){
+    while(b){ long r = a % b; a = b; b = r; }
+    return a;
+  }
+
+  /// collects the least common multiple (lcm) and the maximum of the periods
+  void collectPeriods(AbstractController* c, long outerRate, long& lcm, long& maxPeriod){
+    long period = outerRate * c->getRate();
+    if(period > 1){
+      if(lcm <= 100000) lcm = lcm / gcd(lcm, period) * period;
+      maxPeriod = max(maxPeriod, period);
+    }
+    list<AbstractController*> subs = c->getSubControllers();
+    for(list<AbstractController*>::iterator s = subs.begin(); s != subs.end(); s++)
+      collectPeriods(*s, period, lcm, maxPeriod);
+  }
+}
+
 void AbstractController::sensorInfos(std::list<SensorMotorInfo> sensorInfos) {
   FOREACHIa(sensorInfos, s, i){
     sensorIndexMap[s->name] = i;
@@ -88,3 +117,58 @@ SensorMotorInfo AbstractController::MInfo(int index){
     return SensorMotorInfo();
   }
 }
+
+void AbstractController::staggerPhases(const std::list<AbstractController*>& controllers){
+  // the load is counted over one hyper period (common multiple of all periods),
+  //  if it is too long over the longest period (then it is only approximately balanced)
+  long lcm = 1;
+  long maxPeriod = 1;
+  for(list<AbstractController*>::const_iterator c = controllers.begin(); c != controllers.end(); c++)
+    collectPeriods(*c, 1, lcm, maxPeriod);
+  long len = lcm <= 10000 ? lcm : maxPeriod;
+  vector<int> load(len, 0); // number of controllers stepped at each step
+
+  list<ScheduleEntry> level;
+  for(list<AbstractController*>::const_iterator c = controllers.begin(); c != controllers.end(); c++){
+    ScheduleEntry e = { *c, 1, 0 };
+    level.push_back(e);
+  }
+  // level by level, because the phase of a subcontroller depends on its caller
+  while(!level.empty()){
+    list<ScheduleEntry> next;
+    // first the ones with given phase, then we choose the others
+    for(int pass = 0; pass < 2; pass++){
+      for(list<ScheduleEntry>::iterator e = level.begin(); e != level.end(); e++){
+        AbstractController* c = e->controller;
+        long rate  = c->getRate();
+        bool given = rate == 1 || c->getPhase() >= 0;
+        if(given != (pass == 0)) continue;
+        long period = e->outerRate * rate;
+        if(!given){
+          long best = 0, bestLoad = LONG_MAX;
+          for(long p = 0; p < rate; p++){
+            long l = 0;
+            for(long s = e->outerPhase + p * e->outerRate; s < len; s += period)
+              l += load[s];
+            if(l < bestLoad){
+              bestLoad = l;
+              best     = p;
+            }
+          }
+          c->setRate(rate, best);
+        }
+        long phase = e->outerPhase + max(c->getPhase(), 0) * e->outerRate;
+        if(period > 1){
+          for(long s = phase; s < len; s += period)
+            load[s]++;
+        }
+        list<AbstractController*> subs = c->getSubControllers();
+        for(list<AbstractController*>::iterator sub = subs.begin(); sub != subs.end(); sub++){
+          ScheduleEntry se = { *sub, period, phase };
+          next.push_back(se);
+        }
+      }
+    }
+    level.swap(next);
+  }
+}
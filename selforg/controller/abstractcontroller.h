@@ -42,6 +42,11 @@
  *  - init() is called first to initialise the dimension of sensor- and motor space
  *  - each time step
  *     either step() or stepNoLearning() is called to ask the controller for motor values.
+ *
+ * A controller can run at a lower rate than the control loop (see setRate()):
+ *  then it is only stepped every rate-th step and its last motor values
+ *  are held in between (by WiredController or the AbstractControllerAdapter
+ *  that calls it).
  */
 class AbstractController : public Configurable, public Inspectable, public Storeable {
 public:
@@ -50,7 +55,7 @@ public:
 
   /// contructor (hint: use $ID$ for revision)
   AbstractController(const std::string& name, const std::string& revision)
-    : Configurable(name, revision), Inspectable(name) {}
+    : Configurable(name, revision), Inspectable(name), controlRate(1), controlPhase(-1) {}
 
   /** initialisation of the controller with the given sensor/ motornumber
       Must be called before use. The random generator is optional.
@@ -87,6 +92,37 @@ public:
   virtual void motorBabblingStep(const sensor* , int number_sensors,
                                  const motor* , int number_motors) {};
 
+  /** sets the rate of the controller: it is stepped only every rate-th
+      (control) step, namely if step % rate == phase.
+      With phase -1 the phase is chosen by staggerPhases()
+      (and is 0 until then).
+   */
+  virtual void setRate(int rate, int phase = -1){
+    controlRate  = rate < 1 ? 1 : rate;
+    controlPhase = phase < 0 ? -1 : phase % controlRate;
+  }
+  /// every how many steps the controller is stepped (1: every step)
+  int getRate() const { return controlRate; }
+  /// phase of the controller within its rate (-1: not yet chosen)
+  int getPhase() const { return controlPhase; }
+
+  /// returns true if the controller has to be stepped at the given step
+  bool isDue(long step) const {
+    return controlRate == 1 || step % controlRate == (controlPhase < 0 ? 0 : controlPhase);
+  }
+
+  /// controllers that are called by this one (e.g. by adapters), used by staggerPhases()
+  virtual std::list<AbstractController*> getSubControllers() {
+    return std::list<AbstractController*>();
+  }
+
+  /** chooses the phases of all given controllers (and their subcontrollers)
+      that have a rate larger than 1 and no phase yet, such that the
+      number of controllers that are stepped in the same step is as even
+      as possible. This flattens the computational load per step.
+   */
+  static void staggerPhases(const std::list<AbstractController*>& controllers);
+
   /** the controller is notified about the information on sensor.
       This is called after init and before step
       By default the sensorIndexMap and sensorInfoMap is updated and
@@ -114,6 +150,9 @@ public:
   virtual SensorMotorInfo MInfo(int index);
 
 protected:
+  int controlRate;  ///< the controller is stepped every controlRate-th step
+  int controlPhase; ///< ... at this phase (-1: not chosen)
+
   std::map<std::string, int> sensorIndexMap;
   std::map<std::string, int> motorIndexMap;
   std::map<int, SensorMotorInfo> sensorInfoMap;
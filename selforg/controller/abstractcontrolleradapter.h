@@ -27,6 +27,7 @@
 #include "abstractcontroller.h"
 
 #include <selforg/stl_adds.h>
+#include <vector>
 
 /**
  * Abstract adapter class (interface) for robot controller.
@@ -48,12 +49,16 @@
  *
  *  The store and restore-functionality is lead through, thus only store() and restore()
  *  from
+ *
+ *  If the adapted controller runs at a lower rate (AbstractController::setRate())
+ *  it is only stepped when it is due and its last motor values are held
+ *  in between (use stepController() in derived classes).
  */
 class AbstractControllerAdapter : public AbstractController {
 public:
 
   AbstractControllerAdapter(AbstractController* controller, const std::string& name, const std::string& revision)
-    : AbstractController(name, revision), controller(controller)
+    : AbstractController(name, revision), controller(controller), adapterStep(0)
   {
     //  register the inspectable and configureable controller
     addConfigurable(controller);
@@ -98,7 +103,7 @@ public:
   */
   virtual void step(const sensor* sensors, int sensornumber,
                     motor* motors, int motornumber) {
-    controller->step(sensors, sensornumber, motors,  motornumber);
+    stepController(sensors, sensornumber, motors,  motornumber, true);
   }
 
   /** performs one step without learning.
@@ -106,7 +111,12 @@ public:
   */
   virtual void stepNoLearning(const sensor* sensors , int sensornumber,
                               motor* motors, int motornumber) {
-    controller->stepNoLearning(sensors,sensornumber,motors,motornumber);
+    stepController(sensors,sensornumber,motors,motornumber, false);
+  }
+
+  /// the adapted controller
+  virtual std::list<AbstractController*> getSubControllers() {
+    return std::list<AbstractController*>(1, controller);
   }
 
   /****************************************************************************/
@@ -155,7 +165,30 @@ public:
 
 
 protected:
+  /** steps the adapted controller (with or without learning) if it is due,
+      otherwise the motor values of its last step are held.
+      Has to be called once per step.
+   */
+  void stepController(const sensor* sensors, int sensornumber,
+                      motor* motors, int motornumber, bool learning){
+    if(controller->isDue(adapterStep)){
+      if(learning)
+        controller->step(sensors, sensornumber, motors, motornumber);
+      else
+        controller->stepNoLearning(sensors, sensornumber, motors, motornumber);
+      if(controller->getRate() > 1)
+        heldMotors.assign(motors, motors + motornumber);
+    } else {
+      heldMotors.resize(motornumber, 0);
+      for(int i = 0; i < motornumber; i++)
+        motors[i] = heldMotors[i];
+    }
+    adapterStep++;
+  }
+
   AbstractController* controller; // the controller for the adapter to handle
+  long adapterStep;               // number of steps of this adapter
+  std::vector<motor> heldMotors;  // last motor values of a slow controller
 
 };
 
@@ -92,6 +92,13 @@ public:
         virtual void stepNoLearning(const sensor* sensors , int sensornumber,
                                     motor* motors, int motornumber)=0;
 
+  /// the active controller and the other controllers
+        virtual std::list<AbstractController*> getSubControllers() {
+          std::list<AbstractController*> subs(controllerList);
+          subs.push_front(controller);
+          return subs;
+        }
+
 
 /****************************************************************************/
 /*        END methods of AbstractController                                             */
@@ -105,6 +105,28 @@ const Matrix ControllerNet::process (const Matrix& input) {
   return y[layernum-1];
 }
 
+Matrix ControllerNet::processBatch (const Matrix& inputs, Matrices* ys, Matrices* gps) const {
+  assert(initialised);
+  unsigned int layernum = layers.size();
+  Matrices ysLocal;
+  if(!ys) ys = &ysLocal;
+  ys->resize(layernum);
+  if(gps) gps->resize(layernum);
+
+  for(unsigned int i = 0; i < layernum; i++) {
+    Matrix zb = weights[i] * (i==0 ? inputs : (*ys)[i-1]);
+    for(unsigned int k = 0; k < zb.getM(); k++){ // add bias to all samples
+      const double b = bias[i].val(k,0);
+      for(unsigned int l = 0; l < zb.getN(); l++) zb.val(k,l) += b;
+    }
+    if(i==(layernum-1) && useBypass)
+      zb += bypassWeights * inputs;
+    (*ys)[i] = zb.map(layers[i].actfun);
+    if(gps) (*gps)[i] = zb.map(layers[i].dactfun);
+  }
+  return (*ys)[layernum-1];
+}
+
 const Matrix ControllerNet::processX (const Matrix& input, const Matrix& injection,
                                       unsigned int injectInLayer){
   assert(initialised);
@@ -263,6 +285,35 @@ const Matrix ControllerNet::backpropagation(const Matrix& error,
   return result;
 }
 
+Matrix ControllerNet::backpropagationBatch(const Matrix& error, const Matrices& gps,
+                                           Matrices* errors, Matrices* zetas) const {
+  assert(initialised);
+  int layernum  = (int)layers.size();
+  assert((int)gps.size() == layernum);
+  Matrices errorsLocal;
+  Matrices zetasLocal;
+  if(!errors) errors = &errorsLocal;
+  if(!zetas)  zetas  = &zetasLocal;
+  errors->resize(layernum+1);
+  zetas->resize(layernum);
+
+  (*errors)[layernum] = error;
+  for(int i=layernum-1; i>=0; i--){
+    // error o g' (elementwise for all samples)
+    Matrix& zeta = (*zetas)[i];
+    zeta = (*errors)[i+1];
+    for(unsigned int k = 0; k < zeta.getM(); k++)
+      for(unsigned int l = 0; l < zeta.getN(); l++)
+        zeta.val(k,l) *= gps[i].val(k,l);
+    // W^T * (error o g')
+    (*errors)[i] = (weights[i]^T) * zeta;
+  }
+  if(useBypass){
+    (*errors)[0]+= (bypassWeights^T) * (*zetas)[layernum-1];
+  }
+  return (*errors)[0];
+}
+
 const Matrix ControllerNet::backpropagationX(const Matrix& error,
                                              Matrices* errors, Matrices* zetas,
                                              int startWithLayer
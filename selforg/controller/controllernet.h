@@ -66,6 +66,28 @@ public:
                                          const matrix::Matrix& injection,
                                          unsigned int injectInLayer);
 
+  /** passive processing of many inputs at once (columns of inputs).
+      The internal state (activations, response) is not changed.
+      @param ys if given the activations of all layers are stored here (columnwise)
+      @param gps if given the derivatives g' of all layers are stored here (columnwise),
+        which are needed for backpropagationBatch
+      @return the outputs (columnwise)
+   */
+  virtual matrix::Matrix processBatch (const matrix::Matrix& inputs,
+                                       matrix::Matrices* ys = 0,
+                                       matrix::Matrices* gps = 0) const;
+
+  /** backpropagation of many error vectors (columns of error) at once,
+      using the derivatives gps from processBatch (same samples in the same order).
+      The errors and zetas of all layers are columnwise as well,
+      such that e.g. a weight update is a single product zetas[i] * ys[i-1]^T.
+      @see backpropagation
+   */
+  virtual matrix::Matrix backpropagationBatch(const matrix::Matrix& error,
+                                              const matrix::Matrices& gps,
+                                              matrix::Matrices* errors = 0,
+                                              matrix::Matrices* zetas = 0) const;
+
   /// damps the weights and the biases by multiplying (1-damping)
   virtual void damp(double damping);
 
@@ -27,7 +27,7 @@ void CrossMotorCoupling::step(const sensor* sensors, int sensornumber,
 
   // teaching
   const matrix::Matrix& m = teachable->getLastMotorValues();
-  controller->step(sensors, sensornumber, motors,  motornumber);
+  stepController(sensors, sensornumber, motors,  motornumber, true);
   matrix::Matrix teaching = m; // default is to teach with the motor value itself
   for(unsigned int i=0; i< cmc.size(); i++){
     double incom=0;
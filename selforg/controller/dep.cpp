@@ -22,17 +22,143 @@
 
 #include "dep.h"
 #include <selforg/matrixutils.h>
+#include <selforg/asynclearner.h>
 
 #include <numeric>
 
 using namespace matrix;
 using namespace std;
 
+/// upper bound of the maxstaleness parameter
+static const int maxStalenessLimit = 100;
+
+/// what the learner thread gets from one control step
+struct DEPSample {
+  Matrix x;          // smoothed sensor values
+  Matrix y;          // motor values that were sent
+  // parameters in effect at this step
+  DEPConf::LearningRule learningRule;
+  double epsC, epsh, epsA, damping, urate, synboost, timedist;
+  int s4delay, indnorm, regularization, calcEVInterval;
+};
+
+/// parameter version published by the learner thread
+struct DEPVersion {
+  Matrix A, C, C_update, h, normmot;
+  double norming;
+  Matrix eigenvaluesLRe, eigenvaluesLIm, eigenvectors;
+  double proj_ev1, proj_ev2;
+};
+
+/**
+ * Learner thread of DEP (conf.asyncLearning):
+ * a private synchronous DEP learns from the samples of the control thread.
+ * Different from DEP::step() the motor values of a step are computed
+ * before the controller learned from that step (staleness is at least 1).
+ */
+class DEPLearner : public AsyncLearner<DEPSample, DEPVersion> {
+public:
+  DEPLearner(const DEPConf& conf, int sensornumber, int motornumber, RandGen* randGen)
+    : AsyncLearner<DEPSample, DEPVersion>(maxStalenessLimit+1), dep(learnerConf(conf)) {
+    dep.init(sensornumber, motornumber, randGen);
+  }
+
+  virtual ~DEPLearner(){
+    stop();
+  }
+
+  /// waits for the learner and gives it the state of the control side
+  void reset(const DEP& f){
+    wait();
+    fetch(); // versions published before are dropped
+    dep.A = f.A;  dep.C = f.C;  dep.C_update = f.C_update;  dep.S = f.S;
+    dep.h = f.h;  dep.b = f.b;  dep.normmot = f.normmot;   dep.norming = f.norming;
+    dep.x_buffer = f.x_buffer;
+    dep.y_buffer = f.y_buffer;
+    dep.t = f.t;
+  }
+
+  /// takes over the latest published version (if new)
+  void update(DEP& f){
+    if(!fetch()) return;
+    const DEPVersion& v = current();
+    f.A = v.A;  f.C = v.C;  f.C_update = v.C_update;  f.h = v.h;
+    f.normmot = v.normmot;  f.norming = v.norming;
+    if(f.conf.calcEigenvalues){
+      f.eigenvaluesLRe = v.eigenvaluesLRe;
+      f.eigenvaluesLIm = v.eigenvaluesLIm;
+      f.eigenvectors   = v.eigenvectors;
+      f.proj_ev1       = v.proj_ev1;
+      f.proj_ev2       = v.proj_ev2;
+    }
+  }
+
+  /// hands over the last step of the control side
+  void submit(DEP& f){
+    DEPSample& s = nextSample();
+    s.x = f.x_smooth;
+    s.y = f.y_buffer[f.t - 1];
+    s.learningRule   = f.conf.learningRule;
+    s.epsC           = f.epsC;
+    s.epsh           = f.epsh;
+    s.epsA           = f.epsA;
+    s.damping        = f.damping;
+    s.urate          = f.urate;
+    s.synboost       = f.synboost;
+    s.timedist       = f.timedist;
+    s.s4delay        = f.s4delay;
+    s.indnorm        = f.indnorm;
+    s.regularization = f.regularization;
+    s.calcEVInterval = f.calcEVInterval;
+    AsyncLearner<DEPSample, DEPVersion>::submit(max(f.maxStaleness, 0));
+  }
+
+protected:
+  virtual void learn(const DEPSample& s, DEPVersion& v){
+    dep.conf.learningRule = s.learningRule;
+    dep.epsC           = s.epsC;
+    dep.epsh           = s.epsh;
+    dep.epsA           = s.epsA;
+    dep.damping        = s.damping;
+    dep.urate          = s.urate;
+    dep.synboost       = s.synboost;
+    dep.timedist       = s.timedist;
+    dep.s4delay        = s.s4delay;
+    dep.indnorm        = s.indnorm;
+    dep.regularization = s.regularization;
+    dep.calcEVInterval = s.calcEVInterval;
+    dep.learnFrom(s.x, s.y);
+    v.A = dep.A;  v.C = dep.C;  v.C_update = dep.C_update;  v.h = dep.h;
+    v.normmot = dep.normmot;  v.norming = dep.norming;
+    if(dep.conf.calcEigenvalues){
+      v.eigenvaluesLRe = dep.eigenvaluesLRe;
+      v.eigenvaluesLIm = dep.eigenvaluesLIm;
+      v.eigenvectors   = dep.eigenvectors;
+      v.proj_ev1       = dep.proj_ev1;
+      v.proj_ev2       = dep.proj_ev2;
+    }
+  }
+
+  static DEPConf learnerConf(DEPConf conf){
+    conf.asyncLearning = false;
+    return conf;
+  }
+
+  DEP dep;
+};
+
 DEP::DEP(const DEPConf& conf)
   : AbstractController("DEP", "1.0"),
     conf(conf)
 {
   t=0;
+  evWorker=0;
+  asyncLearner = 0;
+  asyncReset   = false;
+  maxStaleness = 0;
+  learnerLag   = 0;
+  staleness    = 0;
+  calcEVInterval = 1;
 
   addParameterDef("epsC", &epsC, 0.1,     0,5, "learning rate of the controller");
   addParameterDef("epsh", &epsh, 0.1,     0,5, "learning rate of the controller bias");
@@ -72,10 +198,20 @@ DEP::DEP(const DEPConf& conf)
   addInspectableValue("norming", &norming, "Normalization");
   addInspectableMatrix("normmor", &normmot, false, "individual motor normalization factor");
 
+  if(conf.asyncLearning){
+    addParameterDef("maxstaleness", &maxStaleness, 2, 0, maxStalenessLimit,
+                    "maximal number of steps the learner may lag behind");
+    addInspectableValue("learnerlag", &learnerLag, "number of steps not yet learned");
+    addInspectableValue("staleness",  &staleness,
+                        "number of steps the used controller parameters are behind");
+  }
+
   _internWithLearning=false; // used in step to enable learning in stepNoLearning and have only one function
 };
 
 DEP::~DEP(){
+  if(asyncLearner) delete asyncLearner;
+  if(evWorker) delete evWorker;
 }
 
 
@@ -116,12 +252,32 @@ void DEP::init(int sensornumber, int motornumber, RandGen* randGen){
 
   x_buffer.init(buffersize, Matrix(number_sensors,1));
   y_buffer.init(buffersize, Matrix(number_motors,1));
+
+  if(conf.asyncLearning){
+    if(asyncLearner) delete asyncLearner;
+    asyncLearner = new DEPLearner(conf, number_sensors, number_motors, randGen);
+    asyncReset   = true;
+  }
  }
 
 
 // performs one step (includes learning). Calculates motor commands from sensor inputs.
 void DEP::step(const sensor* x_, int number_sensors,
                motor* y_, int number_motors){
+  if(asyncLearner){
+    // the motor values are computed with the latest published C,h
+    if(asyncReset){
+      asyncLearner->reset(*this);
+      asyncReset = false;
+    } else
+      asyncLearner->update(*this);
+    stepNoLearning(x_, number_sensors, y_, number_motors);
+    staleness  = asyncLearner->getSubmitted() - asyncLearner->currentStamp() + 1;
+    asyncLearner->submit(*this);
+    learnerLag = asyncLearner->getLag();
+    return;
+  }
+
   _internWithLearning=true;
   stepNoLearning(x_, number_sensors, y_, number_motors);
   _internWithLearning=false;
@@ -172,6 +328,15 @@ void DEP::stepNoLearning(const sensor* x_, int number_sensors_robot,
 };
 
 
+void DEP::learnFrom(const Matrix& x_smooth, const Matrix& y){
+  x_buffer[t] = x_smooth;
+  learnController();
+  y_buffer[t] = y;
+  if(epsA!=0)
+    learnModel(epsA);
+  t++;
+}
+
 void DEP::learnController(){
   ///////////////// START of Controller Learning / Update  ////////////////
 
@@ -249,14 +414,16 @@ void DEP::learnController(){
     C *= synboost;
     break;
   }}
-  if(conf.calcEigenvalues){
+  // with asynchronous learning the eigenvalues come from the learner (see DEPLearner::update),
+  //  only the learner's own DEP (conf.asyncLearning is false there) has an EigenWorker
+  if(conf.calcEigenvalues && !conf.asyncLearning){
+    // the decomposition is done in the background, the results arrive some steps later
+    if(!evWorker) evWorker = new EigenWorker(true, true);
     if(calcEVInterval!=0 && (t%calcEVInterval==0)){
-      Matrix EVImag;
-      const Matrix& L=A*C;
-      eigenValuesVectors(L, eigenvaluesLRe, eigenvaluesLIm, eigenvectors, EVImag);
-      toPositiveSignEigenVectors(eigenvectors, EVImag);
-      scaleEigenVectorsWithValue(eigenvaluesLRe, eigenvaluesLIm, eigenvectors, EVImag);
+      evWorker->submit(A*C);
     }
+    Matrix EVImag;
+    evWorker->fetch(eigenvaluesLRe, eigenvaluesLIm, eigenvectors, EVImag);
     // calc overlap of sensor state with first 2 eigenvectors (this we do every step
     proj_ev1=((eigenvectors.column(0)^T) * x).val(0,0);
     proj_ev2=((eigenvectors.column(1)^T) * x).val(0,0);
@@ -301,6 +468,7 @@ void DEP::motorBabblingStep(const sensor* x_, int number_sensors_robot,
   learnModel(1.0/(sqrt(t+1)));
 
   t++;
+  asyncReset = true;
 }
 
 
@@ -328,5 +496,6 @@ bool DEP::restore(FILE* f){
   S.restore(f);
   Configurable::parse(f);
   t=0; // set time to zero to ensure proper filling of buffers
+  asyncReset=true;
   return true;
 }
@@ -29,6 +29,7 @@
 
 #include <selforg/matrix.h>
 #include <selforg/ringbuffer.h>
+#include <selforg/eigenworker.h>
 
 /// configuration object for DEP controller. Use DEP::getDefaultConf().
 struct DEPConf {
@@ -64,8 +65,15 @@ struct DEPConf {
 
   double factorS;             ///< factor for learning rate of S
   double factorh;             ///< factor for learning rate of h
+
+  /** if true the learning runs in a background thread and the control step
+      uses the latest published C,h (at most maxstaleness steps old)
+   */
+  bool   asyncLearning;
 };
 
+class DEPLearner;
+
 
 /**
  * This controller implements a new very much simplified algorihm derived from TiPI maximization
@@ -90,6 +98,7 @@ public:
 
     conf.factorS              = 0.1;
     conf.factorh              = 1;
+    conf.asyncLearning        = false;
     return conf;
   }
 
@@ -124,9 +133,12 @@ public:
   virtual void setA(const matrix::Matrix& _A){
     assert(A.getM() == _A.getM() && A.getN() == _A.getN());
     A=_A;
+    asyncReset=true;
   }
 
 protected:
+  friend class DEPLearner;
+
   unsigned short number_sensors;
   unsigned short number_motors;
   static const unsigned short buffersize = 150;
@@ -154,6 +166,7 @@ protected:
   double proj_ev1; // projection of x into first eigenvector
   double proj_ev2; // projection of x into second eigenvector
   int calcEVInterval;
+  EigenWorker* evWorker; // calculates the eigenvalues of L in the background
 
   int t;
 
@@ -176,12 +189,23 @@ protected:
   paramval timedist;
   bool _internWithLearning;
 
+  DEPLearner* asyncLearner; // learner thread (only with conf.asyncLearning)
+  bool asyncReset;          // state was changed from outside, learner needs it
+  paramint maxStaleness;    // max. number of steps the learner may lag behind
+  double learnerLag;        // number of samples not yet learned
+  double staleness;         // age (in steps) of the C,h used for the motor values
+
   /// learn  model (M = A^T )
   virtual void learnModel(double eps);
 
   /// learn controller (C,h, C_update)
   virtual void learnController();
 
+  /** puts the smoothed sensor values and the actually used motor values
+      into the buffers and learns (used by the learner thread)
+   */
+  void learnFrom(const matrix::Matrix& x_smooth, const matrix::Matrix& y);
+
 
   /// neuron transfer function
   static double g(double z)
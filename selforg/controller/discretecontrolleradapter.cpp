@@ -114,13 +114,13 @@ void DiscreteControllerAdapter::setSensorIntervalRange(double minSensorRange, do
 
 void DiscreteControllerAdapter::step(const sensor* sensors, int sensornumber, motor* motors, int motornumber) {
         this->doDiscretisizeSensorValues( sensors,sensornumber);
-        controller->step(discreteSensors,sensornumber,motors,motornumber);
+        stepController(discreteSensors,sensornumber,motors,motornumber,true);
         this->doDiscretisizeMotorValues( motors,motornumber);
 }
 
 void DiscreteControllerAdapter::stepNoLearning(const sensor* sensors, int sensornumber, motor* motors, int motornumber) {
         this->doDiscretisizeSensorValues( sensors,sensornumber);
-        this->controller->stepNoLearning(discreteSensors,sensornumber,motors,motornumber);
+        stepController(discreteSensors,sensornumber,motors,motornumber,false);
         this->doDiscretisizeMotorValues( motors,motornumber);
 }
 
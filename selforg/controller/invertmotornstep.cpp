@@ -344,57 +344,108 @@ void InvertMotorNStep::calcCandHUpdates(Matrix& C_update, Matrix& H_update, int
   // Matrix& eta = zero_eta;
   // Matrix v_old = (eta_buffer[t%buffersize]).map(g);
   bool teaching = (modelCompliant!=0) || useTeaching || (continuity!=0);
+  const unsigned int M = C.getM();
+  const unsigned int N = C.getN();
+  const unsigned int horizon = (unsigned int)steps;
+  v = zero_eta;
+  double shiftlimit = 1; //maximal size of vector components in shifts
+  //and other intermediate vectors calculated with the inverse or pseudoinverse
+  if(horizon == 0)
+  {
+    reinforcefactor=1;
+    return;
+  }
+
+  // C and A do not change within the horizon, so the pseudoinverse
+  //  (R R^T + lambda I)^-1 with R = C*A is calculated only once
+  R                    = C * A;
+  // Georg 09.10.2008: consider to use different pseudoinverse: (R+\lambda I)^-1
+  const Matrix R_pinv  = (R.multMT()+SmallID)^-1;
+
+  // the horizon is stacked columnwise: X = (x_{t-1},...,x_{t-horizon}) and Z = C*X (+H)
+  Matrix X(N, horizon);
+  for(unsigned int s = 1; s <= horizon; s++)
+  {
+    const Matrix& x = x_buffer[(t-s)%buffersize];
+    for(unsigned int i = 0; i < N; i++) X.val(i, s-1) = x.val(i,0);
+  }
+  //const Matrix& x      = A * z.map(g) + xsi;
+  //    z                    = R * z.map(g) + H + C*xsi; // z is a dynamic itself (not successful)
+  Matrix Z   = C * X;
+  Matrix Chi(M, horizon);
+  Matrix V(M, horizon);
+  Matrix Rho(M, horizon);
+  Matrix zeta(M, 1);
+  Matrix g_2p_div_p(M, 1);
+  Matrix g_prime1(M, 1); // g' of the first step (for the teaching terms)
+
+  // v of one step enters the shift of the next, so the horizon is iterated,
+  //  but each step is just one fused elementwise pass and two matrix-vector products
+  for(unsigned int s = 1; s <= horizon; s++)
+  {
+    const unsigned int c = s-1;
+    const Matrix& eta_raw = eta_buffer[(t-s)%buffersize];
+    for(unsigned int i = 0; i < M; i++)
+    {
+      const double z     = Z.val(i,c) + H.val(i,0);
+      Z.val(i,c)         = z;
+      // limit shift by shiftlimit (arbitrary choice)
+      const double shift = squash(&shiftlimit, g(eta_raw.val(i,0)) + v.val(i,0));
+      const double gp    = g_s(z, shift);
+      if(s == 1) g_prime1.val(i,0) = gp;
+      g_2p_div_p.val(i,0) = g_ss_div_s(z, shift);
+      zeta.val(i,0)      = shift * one_over(gp); // G'(Z)^-1 * (eta+v)
+    }
+    // chi = (R R^T + lambda I)^-1 zeta
+    for(unsigned int i = 0; i < M; i++)
+    {
+      double sum = 0;
+      for(unsigned int j = 0; j < M; j++) sum += R_pinv.val(i,j) * zeta.val(j,0);
+      Chi.val(i,c) = sum;
+    }
+    // v = R^T chi limited by shiftlimit and rho = -g''/g' * chi * zeta
+    for(unsigned int i = 0; i < M; i++)
+    {
+      double sum = 0;
+      for(unsigned int j = 0; j < M; j++) sum += R.val(j,i) * Chi.val(j,c);
+      v.val(i,0)   = squash(&shiftlimit, sum);
+      V.val(i,c)   = v.val(i,0);
+      Rho.val(i,c) = g_2p_div_p.val(i,0) * (Chi.val(i,c) * zeta.val(i,0)) * -1;
+      H_update.val(i,0) += Rho.val(i,c) * -epsC;
+    }
+  }
+
+  // calculate updates of C over the whole horizon
+  // delta C += eps * (zeta * v^T * A^T + beta * x^T)
+  //  q_prime_inv.elementProduct is the correction of negled terms
+  //   (LL^T)^-1 from learning rule, which drive the system out of saturation. (important)
+  // double q_prime_invers = q_prime_inv.elementProduct();
+  C_update += ( (Chi * (V^T)) * (A^T) - Rho * (X^T) ) * epsC;
+
   Matrix C_updateTeaching;
   Matrix H_updateTeaching;
   if(teaching)
   {
     C_updateTeaching.set(C.getM(), C.getN());
     H_updateTeaching.set(H.getM(), H.getN());
-  }
-  v = zero_eta;
-  double shiftlimit = 1; //maximal size of vector components in shifts
-  //and other intermediate vectors calculated with the inverse or pseudoinverse
-  for(unsigned int s = 1; s <= steps; s++)
-  {
-    const Matrix& eta = eta_buffer[(t-s)%buffersize].map(g);
-
-    //const Matrix& x      = A * z.map(g) + xsi;
-    //    z                    = R * z.map(g) + H + C*xsi; // z is a dynamic itself (not successful)
-    const Matrix& x          = x_buffer[(t-s)%buffersize];
-    const Matrix& z          = C * x + H;
-    const Matrix shift       = (eta + v).mapP(&shiftlimit,squash); // limit shift by shiftlimit (arbitrary choice)
-    const Matrix g_prime     = Matrix::map2(g_s, z, shift);
-    const Matrix g_prime_inv = g_prime.map(one_over);
-    const Matrix g_2p_div_p  = Matrix::map2(g_ss_div_s, z, shift);
-
-    const Matrix zeta = shift.multrowwise(g_prime_inv); // G'(Z)^-1 * (eta+v)
-    R                 = C * A;
-    // Georg 09.10.2008: consider to use different pseudoinverse: (R+\lambda I)^-1
-    const Matrix chi  = (((R.multMT()+SmallID)^-1) * zeta);
-    v                 = ((R^T) * chi).mapP(&shiftlimit,squash);// limit by shiftlimit // New Georg 10.2007;
-    const Matrix rho  = g_2p_div_p.multrowwise(chi.multrowwise(zeta)) * -1;
-
-    // calculate updates of H,C
-    // delta C += eps * (zeta * v^T * A^T + beta * x^T)
-    //  q_prime_inv.elementProduct is the correction of negled terms
-    //   (LL^T)^-1 from learning rule, which drive the system out of saturation. (important)
-    // double q_prime_invers = q_prime_inv.elementProduct();
-    C_update += ( chi*(v^T)*(A^T) - rho*(x^T) ) * epsC;
-    H_update += rho * -epsC;
-
+    // the teaching terms only use the first step of the horizon
+    const Matrix& x       = X.column(0);
+    const Matrix& z       = Z.column(0);
+    const Matrix& g_prime = g_prime1;
     Matrix LLT_I;
-    if(teaching){
+    if(continuity!=0 || useTeaching){
       // scale of the additional terms
       LLT_I = ((R & g_prime).multMT()+SmallID)^-1;
     }
 
-    if(modelCompliant!=0 && s==1)
+    if(modelCompliant!=0)
     {  // learning of the forward task:
       // eta is difference between last y and reconstructed one
       //    -> used as forward error signal
       // The question is which delta to use: eta (linearised), zeta (neuron
       // inverse) or eta*g' (Backprop) !
       // Also: we need to make sure that z+delta is not in the saturation region
+      const Matrix& eta = eta_buffer[(t-1)%buffersize].map(g);
       Matrix delta = eta.multrowwise(g_prime);// eta; // zeta; //eta.multrowwise(g_prime);
       double cutat = 3;
       delta = (delta + z).mapP(&cutat, squash)-delta; // this not quite clean
@@ -402,7 +453,7 @@ void InvertMotorNStep::calcCandHUpdates(Matrix& C_update, Matrix& H_update, int
       H_updateTeaching += delta * (modelCompliant * epsC);
 
     }
-    if(continuity!=0 && s==1)
+    if(continuity!=0)
     {  // learning to keep motorcommands smooth
       // the teaching signal is the previous motor command
       const Matrix& y_tm1 = y_buffer[(t-1-delay)% buffersize];
@@ -418,7 +469,7 @@ void InvertMotorNStep::calcCandHUpdates(Matrix& C_update, Matrix& H_update, int
       H_updateTeaching += (LLT_I*delta) * (continuity * epsC);
       // cerr << v.multTM().val(0,0) << "\t" << xsi.multTM().val(0,0) << "\n";
     }
-    if(useTeaching && s==1)
+    if(useTeaching)
     {
       const Matrix& y = y_buffer[(t-1-delay)% buffersize]; // eventuell t-1
       //      printf("Learn: %i\n", t-1-delay);
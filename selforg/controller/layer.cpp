@@ -75,7 +75,7 @@ void Layer::setActFun(ActivationFunction actfun){
 }
 
 bool Layer::store(FILE* f) const {
-        fprintf(f,"%i %g %s\n", size, factor_bias, actFun2String(actfun));
+        fprintf(f,"%i %.17g %s\n", size, factor_bias, actFun2String(actfun));
         return true;
 }
 
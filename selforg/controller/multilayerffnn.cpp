@@ -138,6 +138,89 @@ const Matrix MultiLayerFFNN::learn (const Matrix& input,
   return ys[layernum-1];
 }
 
+// adds the column vector b to all columns of m
+static void addToColumns(Matrix& m, const Matrix& b){
+  for(unsigned int i = 0; i < m.getM(); i++){
+    const double v = b.val(i,0);
+    for(unsigned int j = 0; j < m.getN(); j++) m.val(i,j) += v;
+  }
+}
+
+// sums of the rows of m (as column vector)
+static Matrix rowSums(const Matrix& m){
+  Matrix s(m.getM(), 1);
+  for(unsigned int i = 0; i < m.getM(); i++){
+    double v = 0;
+    for(unsigned int j = 0; j < m.getN(); j++) v += m.val(i,j);
+    s.val(i,0) = v;
+  }
+  return s;
+}
+
+void MultiLayerFFNN::processBatch(const Matrix& inputs,
+                                  vector<Matrix>& zsBatch, vector<Matrix>& ysBatch) const {
+  assert(initialised);
+  unsigned int layernum = layers.size();
+  zsBatch.resize(layernum);
+  ysBatch.resize(layernum);
+  for(unsigned int i = 0; i < layernum; i++) {
+    zsBatch[i] = weights[i] * (i==0 ? inputs : ysBatch[i-1]);
+    addToColumns(zsBatch[i], bias[i]);
+    if(i==(layernum-1) && useBypass)
+      zsBatch[i] += bypassWeights * inputs;
+    ysBatch[i] = zsBatch[i].map(layers[i].actfun);
+  }
+}
+
+Matrix MultiLayerFFNN::processBatch (const Matrix& inputs) const {
+  vector<Matrix> zsBatch;
+  vector<Matrix> ysBatch;
+  processBatch(inputs, zsBatch, ysBatch);
+  return ysBatch.back();
+}
+
+void MultiLayerFFNN::learnBatch (const Matrix& inputs, const Matrix& nom_outputs,
+                                 double learnRateFactor) {
+  assert(initialised);
+  assert(inputs.getN() == nom_outputs.getN() && inputs.getN() > 0);
+  int layernum  = layers.size();
+  // mean gradient of the batch
+  double epsilon = eps*learnRateFactor/inputs.getN();
+
+  vector<Matrix> zsBatch;
+  vector<Matrix> ysBatch;
+  processBatch(inputs, zsBatch, ysBatch);
+
+  // the deltas of all samples are the columns of delta
+  Matrix delta;
+  for( int i = layernum-1; i >= 0; i--) {
+    Matrix xsi = ( i == layernum-1 )
+      ? nom_outputs - ysBatch[layernum-1]
+      : (weights[i+1]^T) * delta;
+    // elementwise with g'
+    const Matrix& g_prime = zsBatch[i].map(layers[i].dactfun);
+    for(unsigned int k = 0; k < xsi.getM(); k++)
+      for(unsigned int l = 0; l < xsi.getN(); l++)
+        xsi.val(k,l) *= g_prime.val(k,l);
+    delta = xsi;
+    if(i==layernum-1 && useBypass){ // last layers xsi also has to train bypass
+      bypassWeights   += delta * (inputs^T) * epsilon;
+    }
+    weights[i]     += delta * ((i!=0 ? ysBatch[i-1] : inputs)^T) * epsilon;
+    bias[i]        += rowSums(delta) * (epsilon * layers[i].factor_bias);
+  }
+  // the stored activations are outdated
+  input = Matrix();
+}
+
+void MultiLayerFFNN::copyWeightsFrom(const MultiLayerFFNN& other){
+  assert(other.weights.size() == weights.size() && other.useBypass == useBypass);
+  weights = other.weights;
+  bias    = other.bias;
+  if(useBypass)
+    bypassWeights = other.bypassWeights;
+}
+
 const Matrix MultiLayerFFNN::inversion(const matrix::Matrix& input, const matrix::Matrix& xsi) const {
   assert(initialised);
   int layernum  = (int)layers.size();
@@ -204,7 +287,7 @@ void MultiLayerFFNN::damp(double damping){
 
 
 bool MultiLayerFFNN::store(FILE* f) const {
-        fprintf(f,"%g\n", eps);
+        fprintf(f,"%.17g\n", eps);
         int layernum = layers.size();
         fprintf(f,"%i\n", layernum);
         for(int i=0; i<layernum; i++){
@@ -63,6 +63,23 @@ public:
                                       const matrix::Matrix& nom_output,
                                       double learnRateFactor = 1);
 
+  /** passive processing of many inputs at once.
+      @param inputs the input vectors as columns (inputDim x N)
+      @return the outputs as columns (outputDim x N)
+      The internal state (e.g. for response()) is not changed.
+   */
+  virtual matrix::Matrix processBatch (const matrix::Matrix& inputs) const;
+
+  /** mini-batch learning: performs one gradient step with the mean
+      gradient of all given samples (columns). For one sample this is
+      the same as learn().
+      @param inputs the input vectors as columns (inputDim x N)
+      @param nom_outputs the nominal outputs as columns (outputDim x N)
+   */
+  virtual void learnBatch (const matrix::Matrix& inputs,
+                           const matrix::Matrix& nom_outputs,
+                           double learnRateFactor = 1);
+
   /** response matrix of neural network at given input
 
   \f[  J_ij = \frac{\partial y_i}{\partial x_j} \f]
@@ -101,6 +118,15 @@ public:
   /// damps the weights and the biases by multiplying (1-damping)
   virtual void damp(double damping);
 
+  /** copies weights, biases and bypass weights of the given network
+      (which must have the same structure), e.g. to install weights that
+      were trained elsewhere (@see ReplayTrainer)
+   */
+  virtual void copyWeightsFrom(const MultiLayerFFNN& other);
+
+  /// returns true if the input is connected directly to the output layer
+  virtual bool hasBypass() const { return useBypass; }
+
   // total number of layers (1 means no hidden units)
   virtual unsigned int getLayerNum() const {
     return layers.size();
@@ -183,6 +209,10 @@ public:
 
 
 protected:
+  /// batch version of process: stores potentials and activations (columnwise) of all layers
+  void processBatch(const matrix::Matrix& inputs,
+                    std::vector<matrix::Matrix>& zsBatch, std::vector<matrix::Matrix>& ysBatch) const;
+
   std::vector<Layer> layers;
   std::vector<matrix::Matrix> weights;
   std::vector<matrix::Matrix> bias;
@@ -70,9 +70,9 @@ void MutualInformationController::init(int sensornumber, int motornumber, RandGe
   list<matrix::Matrix*>::const_iterator P = probMatrixList.begin();
   for (int i = 0; i < sensorNumber; i++) {
     if (showF)
-      addInspectableMatrix("F" + itos(i), *F, false, "frequency matrix");
+      addInspectableMatrix("F" + itos(i), *F++, false, "frequency matrix");
     if (showP)
-      addInspectableMatrix("P" + itos(i), *P, false, "probability matrix");
+      addInspectableMatrix("P" + itos(i), *P++, false, "probability matrix");
   }
   if (useXsiCalculation && showXsiF) {
     list<matrix::Matrix*>::const_iterator F_xsi = xsiFreqMatrixList.begin();
@@ -92,11 +92,15 @@ void MutualInformationController::internalInit(int sensornumber, int motornumber
     // the sum of the rows and columns, so
     // freqMatrixList[sensorIntervalCount,sensorIntervalCount]
     // is equal to t
-    matrix::Matrix* F = new matrix::Matrix(sensorIntervalCount + 1, sensorIntervalCount + 1);
-    matrix::Matrix* P = new matrix::Matrix(sensorIntervalCount + 1, sensorIntervalCount + 1);
-    this->freqMatrixList.push_back(F);
-    this->probMatrixList.push_back(P);
+    // (the dense matrices are only needed for displaying them)
+    if (showF || showP)
+      this->freqMatrixList.push_back(new matrix::Matrix(sensorIntervalCount + 1, sensorIntervalCount + 1));
+    if (showP)
+      this->probMatrixList.push_back(new matrix::Matrix(sensorIntervalCount + 1, sensorIntervalCount + 1));
   }
+  jointHist.assign(sensorNumber, HashedHistogram());
+  oldHist.assign(sensorNumber, HashedHistogram(sensorIntervalCount));
+  newHist.assign(sensorNumber, HashedHistogram(sensorIntervalCount));
   // allocate memory for oldSensors
   this->oldSensorStates = (double*) malloc(sizeof(double) * sensorNumber);
   // allocate memory for MI
@@ -155,7 +159,7 @@ void MutualInformationController::step(const sensor* sensors, int sensornumber,
   assert(motornumber==motorNumber);
   t++;
   this->updateMIs(sensors);
-  // update sensor frequency and probability matrices
+  // update sensor frequency and probability matrices (only needed for displaying them)
   int i = 0;
 
   list<matrix::Matrix*>::iterator pIt = probMatrixList.begin();
@@ -174,14 +178,14 @@ void MutualInformationController::step(const sensor* sensors, int sensornumber,
     (*freqMatrix)->val(sensorIntervalCount, sensorIntervalCount)++;
 
     // set probabilities
-    for (int row = 0; row <= sensorIntervalCount; row++) {
-      for (int col = 0; col <= sensorIntervalCount; col++) {
-        (*pIt)->val(row, col) = (*freqMatrix)->val(row, col) / (double) t;
+    if (showP) {
+      for (int row = 0; row <= sensorIntervalCount; row++) {
+        for (int col = 0; col <= sensorIntervalCount; col++) {
+          (*pIt)->val(row, col) = (*freqMatrix)->val(row, col) / (double) t;
+        }
       }
+      pIt++;
     }
-
-    oldSensorStates[i] = sensors[i]; // update old sensor state
-    pIt++;
     i++;
   }
 
@@ -193,9 +197,8 @@ void MutualInformationController::step(const sensor* sensors, int sensornumber,
     this->updateXsiFreqMatrixList(sensors);
     this->calculateH_Xsi(this->H_Xsi);
   }
-  i = 0;
   // store the old sensor state before leaving this method
-  for (list<matrix::Matrix*>::iterator freqMatrix = freqMatrixList.begin(); freqMatrix != freqMatrixList.end(); freqMatrix++) {
+  for (i = 0; i < sensorNumber; i++) {
     oldSensorStates[i] = sensors[i]; // update old sensor state
   }
 
@@ -221,50 +224,20 @@ int MutualInformationController::getState(double sensorValue) {
 
 void MutualInformationController::updateMIs(const sensor* sensors) {
   /*
-   NEW: calculate MIs with O(1), needs to have the old value!
-   IMPORTANT: This calculation needs the OLD F matrix, so update the MI
-   with this function first before updating the F matrix!
-   calculation formula:
+   calculate MIs with O(1):
+   MI(t) = H(X_{t-1}) + H(X_t) - H(X_{t-1},X_t)
+   where the histograms update sum F log F with every new entry,
+   so that each entropy is log t - 1/t sum F log F.
+   This is the same as the former difference term
    MI(t) = 1/t ((t-1) (MI(t-1)-log(t-1)) +dS) + log t
-   where t = number of timer_ticks
-   where dS = +F[n,newState] * log(F[n,newState])
-   +F[oldState,n] * log(F[oldState,n])
-   +(F[oldState,newState]+1) * log(F[oldState,newState]+1)
-   -(F[n,newState]+1) * log(F[n,newState]+1)
-   -(F[oldState,n]+1) * log(F[oldState,n]+1)
-   -F[oldState,newState] * log(F[oldState,newState])
-   where n = sensorIntervalCount
    */
-  int i = 0;
-  for (list<matrix::Matrix*>::iterator F = freqMatrixList.begin(); F != freqMatrixList.end(); F++) {
+  for (int i = 0; i < sensorNumber; i++) {
     int newState = getState(sensors[i]);
-    int oldState = this->getState(oldSensorStates[i]);
-    // calculate dS
-    int n = sensorIntervalCount; // use only for more compact formula
-    double dS = 0.0;
-    if (((*F)->val(n, newState)) > 0.0)
-      dS = ((*F)->val(n, newState)) * log(((*F)->val(n, newState)));
-    if (((*F)->val(oldState, n)) > 0.0)
-      dS += ((*F)->val(oldState, n)) * log(((*F)->val(oldState, n)));
-    if (((*F)->val(oldState, newState)) > 0.0)
-      dS -= ((*F)->val(oldState, newState)) * log(((*F)->val(oldState, newState)));
-    dS += (((*F)->val(oldState, newState)) + 1) * log(((*F)->val(oldState, newState)) + 1) - (((*F)->val(n, newState))
-        + 1) * log(((*F)->val(n, newState)) + 1) - (((*F)->val(oldState, n)) + 1) * log(((*F)->val(oldState, n)) + 1);
-    // updateMI with old MI and dS
-    double t = (double) (this->t);
-    double tminus1 = (double) (t - 1);
-    if ((this->t) == 1) {
-      // log(t-1) is infinite, use more simple formula
-      MI[i] = dS / t + log(t);
-    } else {
-      MI[i] = ((tminus1) * (MI[i] - log(tminus1)) + dS) / t + log(t);
-    }
-
-    /*if (t<=10) {
-     calculateMIs(MI);
-     }*/
-
-    i++;
+    int oldState = getState(oldSensorStates[i]);
+    jointHist[i].add((uint64_t) oldState * sensorIntervalCount + newState);
+    oldHist[i].add(oldState);
+    newHist[i].add(newState);
+    MI[i] = oldHist[i].getEntropy() + newHist[i].getEntropy() - jointHist[i].getEntropy();
   }
 
 }
@@ -307,34 +280,15 @@ void MutualInformationController::calculateH_Xsi(double* H_Xsi) {
 }
 
 void MutualInformationController::calculateH_x(double* H) {
-  int i = 0;
-  for (list<matrix::Matrix*>::iterator F = freqMatrixList.begin(); F != freqMatrixList.end(); F++) {
-    H[i] = 0.0;
-    for (int x = 0; x < sensorIntervalCount; x++) {
-      if (((*F)->val(x, sensorIntervalCount)) != 0) { // to avoid log(0)
-        double val = ((*F)->val(x, sensorIntervalCount) / ((double) t)) * log((*F)->val(x, sensorIntervalCount)
-            / ((double) t));
-        (H_x[i]) -= val;
-      }
-    }
-    i++;
+  for (int i = 0; i < sensorNumber; i++) {
+    H[i] = oldHist[i].getEntropy();
   }
 }
 
 void MutualInformationController::calculateH_yx(double* H_yx) {
-  //
-  int i = 0;
-  for (list<matrix::Matrix*>::iterator F = freqMatrixList.begin(); F != freqMatrixList.end(); F++) {
-    H_yx[i] = 0.0;
-    for (int x = 0; x < sensorIntervalCount; x++) {
-      for (int y = 0; y < sensorIntervalCount; y++) {
-        if (((*F)->val(x, y)) != 0) {
-          double val = (*F)->val(x, y) * log(((*F)->val(x, y)) / ((*F)->val(x, sensorIntervalCount)));
-          (H_yx[i]) -= val / ((double) t);
-        }
-      }
-    }
-    i++;
+  // H(y|x) = H(x,y) - H(x)
+  for (int i = 0; i < sensorNumber; i++) {
+    H_yx[i] = jointHist[i].getEntropy() - oldHist[i].getEntropy();
   }
 }
 
@@ -343,24 +297,11 @@ void MutualInformationController::calculateMIs(double* MI) {
   /*
    old formula: I = sum(over t-1) p(t-1) sum(over t) p(t|t-1) ln (p(t|t-1)/p(t))
    = sum(over t-1, t) p(t-1,t) ln (p(t-1,t)/p(t))
-   p(t-1,t) = #{s_t-1 --> s_t}/t = F[t-1,t]/t
-   p(t-1) = P[t-1,sensorIntervalCount];
-   p(t) = P[sensorIntervalCount,t];
-   old formula update: we use completely F for calculating MI
+   = H(t-1) + H(t) - H(t-1,t)
+   the entropies are recomputed from all occupied bins
    */
-  int i = 0;
-  for (list<matrix::Matrix*>::iterator F = freqMatrixList.begin(); F != freqMatrixList.end(); F++) {
-    MI[i] = 0.0;
-    for (int x = 0; x < sensorIntervalCount; x++) {
-      for (int y = 0; y < sensorIntervalCount; y++) {
-        if (((*F)->val(x, y)) != 0) {
-          double val = (*F)->val(x, y) * log(((*F)->val(x, y) * ((double) t)) / ((*F)->val(sensorIntervalCount, y)
-              * (*F)->val(x, sensorIntervalCount)));
-          (MI[i]) += val / ((double) t);
-        }
-      }
-    }
-    i++;
+  for (int i = 0; i < sensorNumber; i++) {
+    MI[i] = oldHist[i].computeEntropy() + newHist[i].computeEntropy() - jointHist[i].computeEntropy();
   }
 }
 
@@ -26,12 +26,18 @@
 
 #include "abstractcontroller.h"
 #include "matrix.h"
+#include "hashedhistogram.h"
+#include <vector>
 
 /**
  * This is a controller who is passive at the moment, that means, he will not
  * generate any motor values. This controller calculates the mutual information
  * from one to the next time step. Note that many steps are necessary for a good
  * prediction of the mutual information.
+ * The frequencies are stored in hashed histograms (@see HashedHistogram),
+ * such that the memory scales with the observed transitions and
+ * all entropies are updated in O(1). The dense frequency and probability
+ * matrices are only maintained if they are shown (showF, showP).
  */
 class MutualInformationController : public AbstractController
 {
@@ -191,8 +197,11 @@ protected:
   int sensorIntervalCount;
   int sensorNumber;
   int motorNumber;
-  std::list<matrix::Matrix*> freqMatrixList; // stores the number of occurances of t-1 to t (frequency)
-  std::list<matrix::Matrix*> probMatrixList; // stores the probability of state to state occurances of t-1 to t
+  std::list<matrix::Matrix*> freqMatrixList; // stores the number of occurances of t-1 to t (frequency), only if showF
+  std::list<matrix::Matrix*> probMatrixList; // stores the probability of state to state occurances of t-1 to t, only if showP
+  std::vector<HashedHistogram> jointHist; // frequencies of (X_{t-1},X_t) for each sensor
+  std::vector<HashedHistogram> oldHist;   // frequencies of X_{t-1} for each sensor
+  std::vector<HashedHistogram> newHist;   // frequencies of X_t for each sensor
   std::list<matrix::Matrix*> xsiFreqMatrixList; // stores the number of occurances of xsi(x) (frequency)
 
   double* oldSensorStates; // stores the sensor states for previous step (t-1)
@@ -210,22 +219,20 @@ protected:
   /**
    * Calculates the mutual information
    * This is made by normal formula, which
-   * needs O(n^2) costs.
+   * needs O(occupied bins) costs.
    */
   virtual void calculateMIs(double* MI);
 
     /**
    * Calculates the entropy of x
-   * This is made by normal formula, which
-   * needs O(n) costs.
+   * (taken from the histogram of x, O(1))
    */
   virtual void calculateH_x(double* H);
 
 
   /**
-   * Calculates the conditional entropy of y|x
-   * This is made by normal formula, which
-   * needs O(n²) costs.
+   * Calculates the conditional entropy of y|x = H(x,y) - H(x)
+   * (taken from the histograms, O(1))
    */
   virtual void calculateH_yx(double* H_yx);
 
@@ -245,12 +252,9 @@ protected:
 
 
   /**
-   * Updates the mutual information
-   * This is made by a difference term, which
-   * is added to the old MI(t-1).
-   * This function needs the OLD MI(t-1) AND
-   * the OLD F matrix, so update the MI with this
-   * function first before updating the F matrix!
+   * Updates the histograms and the mutual information
+   * MI = H(X_{t-1}) + H(X_t) - H(X_{t-1},X_t).
+   * The histograms keep their entropies up to date,
    * calculation costs: O(1)
    */
   virtual void updateMIs(const sensor* sensors);
@@ -148,8 +148,8 @@ void NeuralGas::updateCellSizes(){
 }
 
 bool NeuralGas::store(FILE* f) const{
-  fprintf(f,"%g\n", eps);
-  fprintf(f,"%g\n", lambda);
+  fprintf(f,"%.17g\n", eps);
+  fprintf(f,"%.17g\n", lambda);
   fprintf(f,"%i\n", maxTime);
   fprintf(f,"%i\n", t);
   fprintf(f,"%i\n", getOutputDim());
@@ -51,22 +51,26 @@ void OneActiveMultiPassiveController::init(const int sensornumber, const int mot
 
 void OneActiveMultiPassiveController::step(const sensor* sensors, int sensornumber, motor* motors, int motornumber) {
         assert(controller);
-        // make normal step of the active controller
-        // then make step of all passive controllers
-        controller->step(sensors,sensornumber,motors,motornumber);
+        // make normal step of the active controller (its motor values are held if not due)
+        // then make step of all passive controllers that are due
+        long s = adapterStep;
+        stepController(sensors,sensornumber,motors,motornumber,true);
 
         for(std::list<AbstractController*>::iterator i=controllerList.begin(); i != controllerList.end(); i++){
-                (*i)->step(sensors,sensornumber,passiveMotors,motornumber);
+                if((*i)->isDue(s))
+                        (*i)->step(sensors,sensornumber,passiveMotors,motornumber);
         }
 }
 
 void OneActiveMultiPassiveController::stepNoLearning(const sensor* sensors , int sensornumber, motor* motors, int motornumber){
         assert(controller);
-        // make normal step of the active controller
-        // then make step of all passive controllers
-        controller->stepNoLearning(sensors,sensornumber,motors,motornumber);
+        // make normal step of the active controller (its motor values are held if not due)
+        // then make step of all passive controllers that are due
+        long s = adapterStep;
+        stepController(sensors,sensornumber,motors,motornumber,false);
         for(std::list<AbstractController*>::iterator i=controllerList.begin(); i != controllerList.end(); i++){
-                (*i)->stepNoLearning(sensors,sensornumber,passiveMotors,motornumber);
+                if((*i)->isDue(s))
+                        (*i)->stepNoLearning(sensors,sensornumber,passiveMotors,motornumber);
         }
 }
 
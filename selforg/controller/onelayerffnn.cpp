@@ -39,7 +39,7 @@ const Matrix OneLayerFFNN::learn (const Matrix& input,
 
 
 bool OneLayerFFNN::store(FILE* f) const {
-        fprintf(f,"%g\n", eps);
+        fprintf(f,"%.17g\n", eps);
         weights.store(f);
         bias.store(f);
         return true;
@@ -31,16 +31,12 @@ QLearning::QLearning(double eps, double discount, double exploration, int eligib
   : Configurable("QLearning", "$Id$"),
     eps(eps), discount(discount),  exploration(exploration),
     eligibility(eligibility), random_initQ(random_initQ), useSARSA(useSARSA), tau(tau){
-  if(eligibility<1) eligibility=1;
-  ringbuffersize = eligibility+1;
-  actions  = new int[ringbuffersize];
-  states   = new int[ringbuffersize];
-  rewards  = new double[ringbuffersize];
+  if(eligibility<1) this->eligibility=1;
   longrewards = new double[tau];
-  memset(actions,0,sizeof(int)*ringbuffersize);
-  memset(states,0,sizeof(int)*ringbuffersize);
-  memset(rewards,0,sizeof(double)*ringbuffersize);
   memset(longrewards,0,sizeof(double)*tau);
+  lastState  = 0;
+  lastAction = 0;
+  lastReward = 0;
   t=0;
   collectedReward = 0;
   initialised=false;
@@ -52,48 +48,76 @@ QLearning::QLearning(double eps, double discount, double exploration, int eligib
 }
 
 QLearning::~QLearning(){
-  if(actions) delete[] actions;
-  if(states) delete[] states;
-  if(rewards) delete[] rewards;
   if(longrewards) delete[] longrewards;
 };
 
 void QLearning::init(unsigned  int stateDim, unsigned int actionDim, RandGen* randGen){
   if(!randGen) randGen = new RandGen(); // this gives a small memory leak
  this->randGen=randGen;
-  Q.set(stateDim,actionDim);
-  if(random_initQ){
-    Q= Q.mapP(randGen, random_minusone_to_one)*0.01;
-  }
+  // rows are created (and randomly initialised) when a state is visited
+  Q.init(stateDim, actionDim, random_initQ ? 0.01 : 0, randGen);
+  traceOffsets.clear();
+  traces.clear();
   initialised=true;
 }
 
 unsigned int QLearning::select (unsigned int state){
   assert(initialised);
-  assert(state < Q.getM());
+  assert(state < Q.getStateDim());
 
-  matrix::Matrix as = Q.row(state);
-  as += as.mapP(randGen, random_minusone_to_one)*0.001; // this is like random
-                                              // walk if we know nothing
-  int a= argmax(as);
+  const double* q = Q.row(state);
+  unsigned int n  = Q.getActionDim();
+  int a=0;
+  double m=0;
+  for(unsigned int i=0; i<n; i++){
+    // small noise: this is like random walk if we know nothing
+    double v = q[i] + random_minusone_to_one(randGen, 0)*0.001;
+    if(i==0 || v>m){
+      m = v;
+      a = i;
+    }
+  }
   // exploration
   double r = randGen->rand();
   if(r<exploration){
-    a = (int)(randGen->rand()*(double)Q.getN());
+    a = (int)(randGen->rand()*(double)n);
   }
   return a;
 }
 
+unsigned int QLearning::select_softmax (unsigned int state, double temperature){
+  assert(initialised);
+  assert(state < Q.getStateDim());
+  assert(temperature > 0);
+
+  const double* q = Q.row(state);
+  unsigned int n  = Q.getActionDim();
+  double m = q[0];
+  for(unsigned int i=1; i<n; i++)
+    if(q[i]>m) m=q[i];
+  // probabilities are exp((q-m)/T)/Z, sampled without storing them
+  double z = 0;
+  for(unsigned int i=0; i<n; i++)
+    z += exp((q[i]-m)/temperature);
+  double x = randGen->rand()*z;
+  double s = 0;
+  for(unsigned int i=0; i<n; i++){
+    s += exp((q[i]-m)/temperature);
+    if(s>=x) return i;
+  }
+  return n-1;
+}
+
 unsigned int QLearning::select_sample (unsigned int state){
   assert(initialised);
-  assert(state < Q.getM());
-  matrix::Matrix vals = Q.row(state);
+  assert(state < Q.getStateDim());
+  matrix::Matrix vals = getActionValues(state);
   std::cout << "****\n" << vals << std::endl;
   // subtract mean
   double m = - vals.elementSum() / vals.size();
   vals.toMapP(m,plus_);
   // add bias to old action
-  vals.val(0,  actions[(t-1)%ringbuffersize])+=m/2.0;
+  vals.val(0,  lastAction)+=m/2.0;
   // cut below mean
   double theta=0;
   vals.toMapP(&theta,lowercutof);
@@ -110,23 +134,23 @@ unsigned int QLearning::select_sample (unsigned int state){
 
 unsigned int QLearning::select_keepold (unsigned int state){
   assert(initialised);
-  assert(state < Q.getM());
+  assert(state < Q.getStateDim());
 
   // exploration
   double r = randGen->rand();
   if(r<exploration){
     std::cout << "explore\n";
-    return int(randGen->rand()*(double)Q.getN());
+    return int(randGen->rand()*(double)Q.getActionDim());
   }
-  matrix::Matrix vals = Q.row(state);
+  matrix::Matrix vals = getActionValues(state);
   vals += vals.mapP(randGen, random_minusone_to_one)*0.001; // this is like random
                                                   // walk if we know nothing
   double m = vals.elementSum() / vals.size();
   r = randGen->rand();
   // keep to 80% old if acceptable
-  if(vals.val(0,  actions[(t-1)%ringbuffersize])>m && r<0.8){
+  if(vals.val(0,  lastAction)>m && r<0.8){
     std::cout << "keepold\n";
-    return actions[(t-1)%ringbuffersize];
+    return lastAction;
   }else {
     int a = argmax(vals);
     // select to 30% second best
@@ -145,7 +169,12 @@ unsigned int QLearning::select_keepold (unsigned int state){
 
 
 matrix::Matrix QLearning::getActionValues(unsigned int state){
-  return Q.row(state);
+  return matrix::Matrix(1, Q.getActionDim(), Q.row(state));
+}
+
+const matrix::Matrix& QLearning::getQ() const {
+  Qdense = Q.toMatrix();
+  return Qdense;
 }
 
 
@@ -154,43 +183,69 @@ double QLearning::learn (unsigned int state,
                          double reward,
                          double learnRateFactor){
   assert(initialised);
-  actions[t%ringbuffersize] = action;
-  states[t%ringbuffersize]  = state;
-  rewards[t%ringbuffersize] = reward;
   collectedReward -= longrewards[t%tau];
   longrewards[t%tau] = reward;
   collectedReward += reward;
-  // Todo: eligibility traces are wrong! see the book of sutton how to do it!
-  // learn for previous eligibility steps
-  double e_factor = 1; // learning factor for eligibility
-  for(int i=1; i<=eligibility; i++){
-    if(t-i <0) break;
-    int a_t     = actions[(t-i)   %ringbuffersize];
-    int a_tp1   = actions[(t-i+1) %ringbuffersize];
-    int s_t     = states [(t-i)   %ringbuffersize];
-    int s_tp1   = states [(t-i+1) %ringbuffersize];
-    double r_t  = rewards[(t-i)   %ringbuffersize];
-    double e    = eps*e_factor * learnRateFactor;  // local learning rate
+
+  size_t o_tp1 = Q.rowOffset(state); // may create the row, so before taking pointers
+  if(t>0){
+    size_t o_t  = Q.rowOffset(lastState) + lastAction;
+    double* q   = Q.data();
+    // temporal difference error of the last transition
+    double next;
     if(useSARSA)
-      Q.val(s_t,a_t) += e*(r_t + discount*Q.val(s_tp1,a_tp1) - Q.val(s_t,a_t));
-    else
-      Q.val(s_t,a_t) += e*(r_t + discount*max(Q.row(s_tp1)) - Q.val(s_t,a_t));
-    e_factor -= 1.0/eligibility;
+      next = q[o_tp1 + action];
+    else {
+      next = q[o_tp1];
+      for(unsigned int a=1; a<Q.getActionDim(); a++)
+        next = std::max(next, q[o_tp1 + a]);
+    }
+    double delta = lastReward + discount*next - q[o_t];
+
+    // replacing trace for the last (state,action) pair
+    unsigned int k=0;
+    while(k<traceOffsets.size() && traceOffsets[k]!=o_t) k++;
+    if(k==traceOffsets.size()){
+      traceOffsets.push_back(o_t);
+      traces.push_back(1);
+    } else
+      traces[k] = 1;
+
+    // update all pairs with trace, decay and drop the expired ones in one pass
+    double e     = eps*learnRateFactor*delta;  // local learning rate
+    double decay = 1.0/std::max(eligibility,1.0);
+    size_t n=0;
+    for(size_t i=0; i<traces.size(); i++){
+      q[traceOffsets[i]] += e*traces[i];
+      double tr = traces[i] - decay;
+      if(tr > 1e-9){
+        traceOffsets[n] = traceOffsets[i];
+        traces[n]       = tr;
+        n++;
+      }
+    }
+    traceOffsets.resize(n);
+    traces.resize(n);
   }
+  lastState  = state;
+  lastAction = action;
+  lastReward = reward;
   t++;
-  return Q.val(state,action);
+  return Q.data()[o_tp1 + action];
 }
 
 void QLearning::reset(){
   t=0;
+  traceOffsets.clear();
+  traces.clear();
 }
 
 unsigned int QLearning::getStateDim() const{
-  return Q.getM();
+  return Q.getStateDim();
 }
 
 unsigned int QLearning::getActionDim() const{
-  return Q.getN();
+  return Q.getActionDim();
 }
 
 /// returns the collectedReward reward
@@ -211,6 +266,17 @@ int QLearning::valInCrossProd(const std::list<std::pair<int,int> >& vals){
   return val;
 }
 
+unsigned int QLearning::valInCrossProd(const int* vals, const int* ranges, int n){
+  unsigned int fac = 1;
+  unsigned int val = 0;
+  for(int i=0; i<n; i++){
+    assert(vals[i]>=0 && vals[i]<ranges[i]);
+    val+=vals[i]*fac;
+    fac*=ranges[i];
+  }
+  return val;
+}
+
 std::list<int> QLearning::ConfInCrossProd(const std::list<int>& ranges, int val){
   std::list<int> cfg;
 
@@ -233,6 +299,8 @@ bool QLearning::restore(FILE* f) {
   Q.restore(f);
   Configurable::parse(f);
   t=0;
+  traceOffsets.clear();
+  traces.clear();
   collectedReward = 0;
   initialised=true;
   return true;
@@ -24,12 +24,24 @@
 #ifndef __QLEARNING_H
 #define __QLEARNING_H
 
+#include <vector>
+#include <cstddef>
+
 #include "matrix.h"
+#include "qtable.h"
 #include "configurable.h"
 #include "storeable.h"
 #include "randomgenerator.h"
 
-/// implements QLearning
+/**
+ * implements QLearning (and SARSA) with eligibility traces.
+ * The Q-table only stores the visited states (@see QTable), so that large
+ * discretised state spaces can be used. The traces are kept as a sparse
+ * set of the recently visited (state,action) pairs: each step the
+ * temporal difference error of the last transition is applied to all of
+ * them in one pass. The trace of a pair starts at 1 and decays linearly
+ * to 0 within eligibility steps (replacing traces).
+ */
 class QLearning : public Configurable, public Storeable {
 public:
   /**
@@ -60,6 +72,11 @@ public:
   */
   virtual unsigned int select (unsigned int state);
 
+  /** selection of action given current state by sampling from the
+      softmax (Boltzmann) distribution of the action values with the given temperature
+  */
+  virtual unsigned int select_softmax (unsigned int state, double temperature);
+
   /** selection of action given current state.
       The policy is to sample from the above average actions, with bias
       to the old action (also exploration included).
@@ -104,11 +121,19 @@ public:
   /// expects a list of value,range and returns the associated state
   static int valInCrossProd(const std::list<std::pair<int,int> >& vals);
 
+  /// same as above for n values and their ranges given as arrays (no allocations)
+  static unsigned int valInCrossProd(const int* vals, const int* ranges, int n);
+
   /// expects a list of ranges and a state/action and return the configuration
   static std::list<int> ConfInCrossProd(const std::list<int>& ranges, int val);
 
-  /// returns q table (mxn) == (states x actions)
-  virtual const matrix::Matrix& getQ() const {return Q;} ;
+  /** returns q table (mxn) == (states x actions) as a dense matrix
+      (only for small state spaces, @see getQTable())
+   */
+  virtual const matrix::Matrix& getQ() const;
+
+  /// returns the q table
+  virtual const QTable& getQTable() const { return Q; }
 
   virtual bool store(FILE* f) const;
 
@@ -125,13 +150,14 @@ public:
   bool useSARSA; ///< if true, use SARSA strategy otherwise qlearning
 protected:
   int tau;       ///< time horizont for averaging the reward
-  matrix::Matrix Q; /// < Q table (mxn) == (states x actions)
-
-
-  int* actions;    // ring buffer for actions
-  int* states;     // ring buffer for states
-  double* rewards; // ring buffer for rewards
-  int ringbuffersize; // size of ring buffers, eligibility + 1
+  QTable Q;      ///< Q table (mxn) == (states x actions)
+  mutable matrix::Matrix Qdense; // dense copy for getQ()
+
+  unsigned int lastState;  // state, action and reward of the last step
+  unsigned int lastAction;
+  double lastReward;
+  std::vector<size_t> traceOffsets; // entries of Q with nonzero eligibility trace
+  std::vector<double> traces;       // their traces
   double* longrewards; // long ring buffer for rewards for collectedReward
   int t; // time for ring buffers
   bool initialised;
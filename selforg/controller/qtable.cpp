@@ -0,0 +1,249 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qtable.h"
+#include "controller_misc.h"
+
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+
+using namespace matrix;
+
+/// identifier of the binary format written by QTable::store
+static const char qtableBinaryId[4] = { 'L', 'P', 'Z', 'Q' };
+
+/** header of the binary format (as in Matrix::store),
+    followed by the states of the rows (uint32) and the rows */
+struct QTableBinaryHeader {
+  uint16_t byteorder; // 0x0102 in the byte order of the writer
+  uint8_t  version;
+  uint8_t  elemsize;  // sizeof(double) or sizeof(float)
+  uint32_t stateDim;
+  uint32_t actionDim;
+  uint32_t rows;
+  uint32_t checksum;  // of the values, as stored
+  uint32_t reserved;
+};
+
+static uint32_t swap32(uint32_t v){
+  return (v>>24) | ((v>>8)&0xff00) | ((v<<8)&0xff0000) | (v<<24);
+}
+
+static void swapBytes(char* p, size_t elemsize, size_t num){
+  for(size_t i=0; i<num; i++, p+=elemsize){
+    std::reverse(p, p+elemsize);
+  }
+}
+
+QTable::QTable()
+  : stateDim(0), actionDim(0), randomInit(0), randGen(0) {
+}
+
+void QTable::init(unsigned int stateDim, unsigned int actionDim,
+                  double randomInit, RandGen* randGen){
+  this->stateDim   = stateDim;
+  this->actionDim  = actionDim;
+  this->randomInit = randomInit;
+  this->randGen    = randGen;
+  clear();
+}
+
+void QTable::clear(){
+  values.clear();
+  rowStates.clear();
+  hashIndex.clear();
+  denseIndex.clear();
+  if(stateDim <= denseLimit)
+    denseIndex.resize(stateDim, -1);
+}
+
+size_t QTable::rowOffset(unsigned int state){
+  assert(state < stateDim);
+  int r;
+  if(stateDim <= denseLimit){
+    r = denseIndex[state];
+    if(r >= 0) return (size_t)r * actionDim;
+    r = denseIndex[state] = rowStates.size();
+  } else {
+    std::unordered_map<unsigned int, unsigned int>::iterator it = hashIndex.find(state);
+    if(it != hashIndex.end()) return (size_t)it->second * actionDim;
+    r = hashIndex[state] = rowStates.size();
+  }
+  rowStates.push_back(state);
+  values.resize(values.size() + actionDim, 0.0);
+  size_t offset = (size_t)r * actionDim;
+  if(randomInit > 0 && randGen){
+    double* v = &values[offset];
+    randGen->fillUniform(v, actionDim, -1, 1);
+    for(unsigned int a = 0; a < actionDim; a++)
+      v[a] *= randomInit;
+  }
+  return offset;
+}
+
+const double* QTable::findRow(unsigned int state) const {
+  if(state >= stateDim) return 0;
+  if(stateDim <= denseLimit){
+    int r = denseIndex[state];
+    return r >= 0 ? &values[(size_t)r * actionDim] : 0;
+  } else {
+    std::unordered_map<unsigned int, unsigned int>::const_iterator it = hashIndex.find(state);
+    return it != hashIndex.end() ? &values[(size_t)it->second * actionDim] : 0;
+  }
+}
+
+Matrix QTable::toMatrix() const {
+  Matrix q(stateDim, actionDim);
+  for(unsigned int r = 0; r < rowStates.size(); r++){
+    const double* v = &values[(size_t)r * actionDim];
+    for(unsigned int a = 0; a < actionDim; a++)
+      q.val(rowStates[r], a) = v[a];
+  }
+  return q;
+}
+
+void QTable::fromMatrix(const Matrix& q){
+  stateDim  = q.getM();
+  actionDim = q.getN();
+  clear();
+  double keep = randomInit;
+  randomInit = 0;
+  for(unsigned int s = 0; s < stateDim; s++){
+    bool nonzero = false;
+    for(unsigned int a = 0; a < actionDim; a++)
+      nonzero |= q.val(s,a) != 0;
+    if(!nonzero) continue;
+    double* v = row(s);
+    for(unsigned int a = 0; a < actionDim; a++)
+      v[a] = q.val(s,a);
+  }
+  randomInit = keep;
+}
+
+bool QTable::store(FILE* f) const {
+  QTableBinaryHeader h;
+  h.byteorder = 0x0102;
+  h.version   = 1;
+  h.elemsize  = sizeof(double);
+  h.stateDim  = stateDim;
+  h.actionDim = actionDim;
+  h.rows      = rowStates.size();
+  h.checksum  = Storeable::checksum(data(), values.size() * sizeof(double));
+  h.reserved  = 0;
+  if(fwrite(qtableBinaryId, 4, 1, f) != 1 || fwrite(&h, sizeof(h), 1, f) != 1)
+    return false;
+  if(h.rows > 0){
+    std::vector<uint32_t> states(rowStates.begin(), rowStates.end());
+    if(fwrite(&states[0], sizeof(uint32_t), h.rows, f) != h.rows) return false;
+    if(fwrite(&values[0], sizeof(double), values.size(), f) != values.size()) return false;
+  }
+  return true;
+}
+
+bool QTable::restore(FILE* f){
+  char id[4];
+  if(fread(id, 4, 1, f) != 1) return false;
+  if(memcmp(id, qtableBinaryId, 4) != 0){
+    // dense matrix as written by older versions
+    fseek(f, -4, SEEK_CUR);
+    Matrix q;
+    if(!q.restore(f)) return false;
+    fromMatrix(q);
+    return true;
+  }
+  QTableBinaryHeader h;
+  if(fread(&h, sizeof(h), 1, f) != 1){
+    fprintf(stderr, "QTable::restore: cannot read header\n");
+    return false;
+  }
+  bool swap = h.byteorder == 0x0201;
+  if((h.byteorder != 0x0102 && !swap) || h.version != 1
+     || (h.elemsize != sizeof(double) && h.elemsize != sizeof(float))){
+    fprintf(stderr, "QTable::restore: unsupported format\n");
+    return false;
+  }
+  if(swap){
+    h.stateDim  = swap32(h.stateDim);
+    h.actionDim = swap32(h.actionDim);
+    h.rows      = swap32(h.rows);
+    h.checksum  = swap32(h.checksum);
+  }
+  if(h.actionDim == 0 || h.rows > h.stateDim){
+    fprintf(stderr, "QTable::restore: invalid dimensions\n");
+    return false;
+  }
+  size_t num = (size_t)h.rows * h.actionDim;
+  // do not allocate more than the stream contains (if it can tell)
+  long pos = ftell(f);
+  if(pos >= 0 && fseek(f, 0, SEEK_END) == 0){
+    long end = ftell(f);
+    fseek(f, pos, SEEK_SET);
+    if(end < pos || (uint64_t)(end - pos) < (uint64_t)h.rows * 4 + (uint64_t)num * h.elemsize){
+      fprintf(stderr, "QTable::restore: file too short\n");
+      return false;
+    }
+  }
+  std::vector<uint32_t> states(h.rows);
+  std::vector<char> vals(num * h.elemsize);
+  if(h.rows > 0 &&
+     (fread(&states[0], sizeof(uint32_t), h.rows, f) != h.rows ||
+      fread(&vals[0], h.elemsize, num, f) != num)){
+    fprintf(stderr, "QTable::restore: cannot read rows\n");
+    return false;
+  }
+  if(Storeable::checksum(vals.empty() ? 0 : &vals[0], vals.size()) != h.checksum){
+    fprintf(stderr, "QTable::restore: checksum mismatch\n");
+    return false;
+  }
+  if(swap){
+    for(unsigned int r = 0; r < h.rows; r++) states[r] = swap32(states[r]);
+    if(num > 0) swapBytes(&vals[0], h.elemsize, num);
+  }
+  // every state has to be valid and appear only once
+  std::vector<uint32_t> sorted(states);
+  std::sort(sorted.begin(), sorted.end());
+  if((!sorted.empty() && sorted.back() >= h.stateDim)
+     || std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()){
+    fprintf(stderr, "QTable::restore: invalid states\n");
+    return false;
+  }
+
+  stateDim  = h.stateDim;
+  actionDim = h.actionDim;
+  clear();
+  double keep = randomInit;
+  randomInit = 0;
+  for(unsigned int r = 0; r < h.rows; r++){
+    double* v = row(states[r]);
+    if(h.elemsize == sizeof(double)){
+      memcpy(v, &vals[(size_t)r * actionDim * sizeof(double)], actionDim * sizeof(double));
+    } else {
+      const float* fs = (const float*)&vals[0] + (size_t)r * actionDim;
+      for(unsigned int a = 0; a < actionDim; a++) v[a] = fs[a];
+    }
+  }
+  randomInit = keep;
+  return true;
+}
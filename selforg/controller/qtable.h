@@ -0,0 +1,105 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __QTABLE_H
+#define __QTABLE_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+#include "matrix.h"
+#include "storeable.h"
+#include "randomgenerator.h"
+
+/**
+ * Table of action values (states x actions) for QLearning.
+ *
+ * A row is only created when its state is accessed the first time,
+ * so the number of states may be huge (e.g. the cross product of
+ * several discretised sensors, @see QLearning::valInCrossProd()),
+ * as long as the number of visited states is moderate.
+ * Up to denseLimit states the rows are found by direct indexing,
+ * above through a hash map.
+ * All rows are kept in one contiguous array, such that an entry is
+ * addressed by a stable offset (as used by the eligibility traces).
+ * Note that pointers into data() become invalid when a row is created.
+ */
+class QTable : public Storeable {
+public:
+  QTable();
+
+  /** @param randomInit if >0 new rows are filled with random numbers in [-randomInit,randomInit]
+      @param randGen random generator for randomInit
+   */
+  void init(unsigned int stateDim, unsigned int actionDim,
+            double randomInit = 0, RandGen* randGen = 0);
+
+  unsigned int getStateDim() const  { return stateDim; }
+  unsigned int getActionDim() const { return actionDim; }
+  /// number of states that have a row
+  unsigned int getStoredStates() const { return rowStates.size(); }
+
+  /// offset of the row of the state in data(), the row is created if needed
+  size_t rowOffset(unsigned int state);
+
+  /// values of all actions in the state, the row is created if needed
+  double* row(unsigned int state) { return &values[rowOffset(state)]; }
+
+  /// values of all actions in the state or 0 if the state has no row
+  const double* findRow(unsigned int state) const;
+
+  double* data() { return values.empty() ? 0 : &values[0]; }
+  const double* data() const { return values.empty() ? 0 : &values[0]; }
+
+  /// dense (states x actions) matrix, states without row are 0 (only for small state spaces)
+  matrix::Matrix toMatrix() const;
+  /// replaces the content with the nonzero rows of a dense (states x actions) matrix
+  void fromMatrix(const matrix::Matrix& q);
+
+  /// removes all rows
+  void clear();
+
+  /// stores the visited rows (binary, with byte order and element size as Matrix::store)
+  virtual bool store(FILE* f) const;
+  /** restores the table, also reads a dense matrix as stored by older versions.
+      Returns false (and keeps the table) if the data is inconsistent.
+   */
+  virtual bool restore(FILE* f);
+
+  /// up to this number of states the rows are indexed directly
+  static const unsigned int denseLimit = 1 << 20;
+
+protected:
+  unsigned int stateDim;
+  unsigned int actionDim;
+  double randomInit;
+  RandGen* randGen;
+
+  std::vector<double> values;          // rows one after another
+  std::vector<unsigned int> rowStates; // state of each row
+  std::vector<int> denseIndex;         // row of each state or -1 (small state spaces)
+  std::unordered_map<unsigned int, unsigned int> hashIndex; // row of each state (large state spaces)
+};
+
+#endif
@@ -25,27 +25,32 @@
 #define __REPLAYCONTROLLER_H
 
 #include "abstractcontroller.h"
+#include "replaylog.h"
+#include <assert.h>
 
 /**
- * Controller that replays a file
+ * Controller that replays a file.
+ * The log is indexed once (@see ReplayLog), such that the playback can be
+ * done at any speed (parameter "speed": lines per step, can be fractional
+ * or negative) and the position can be changed with seek().
  */
 class ReplayController : public AbstractController {
 public:
   ReplayController(const char* filename, bool repeat=false)
-    : AbstractController("ReplayController", "1.0"),
-      filename(filename), repeat(repeat) {
+    : AbstractController("ReplayController", "1.1"),
+      filename(filename), repeat(repeat), position(0), warned(false) {
 
-    f=fopen(filename,"r");
-    if(!f){
-      std::cerr<< "ReplayController: error while opening file " << filename << std::endl;
+    log = ReplayLog::open(filename);
+    if(!log){
+      std::cerr<< "ReplayController: error while opening file or seaching for header in file "
+               << filename << std::endl;
       exit(1);
     }
-    if(!parseDataFileForHeader(f)){
-      std::cerr<< "ReplayController: error while seaching for header in file " << filename << std::endl;
-      exit(1);
-    }
-    printf("ReplayController: columns: Senors [%i, %i], Motors [%i, %i]\n",
-           sensorStart, sensorEnd, motorStart, motorEnd);
+    log->getColumnRange("x[", sensorStart, sensorEnd);
+    log->getColumnRange("y[", motorStart, motorEnd);
+    addParameterDef("speed", &speed, 1.0, -100, 100, "playback speed (lines per step)");
+    printf("ReplayController: columns: Senors [%i, %i], Motors [%i, %i], %i lines\n",
+           sensorStart, sensorEnd, motorStart, motorEnd, log->getLineNumber());
   }
 
   virtual void init(int sensornumber, int motornumber, RandGen* randGen = 0){
@@ -64,19 +69,26 @@ public:
 
   virtual void stepNoLearning(const sensor* , int number_sensors,
                               motor* motors, int number_motors){
-
-    if(!parseDataLine(m,f)){
-      if(repeat){
-        std::cout << "ReplayController: rewind" << std::endl;
-        rewind(f);
-      }else
-        std::cout << "ReplayController: no datafile in file" << filename << std::endl;
-    }else{
-      m=m.rows(motorStart, motorEnd);
+    if(!repeat && (position >= log->getLineNumber() || position < 0) && !warned){
+      std::cout << "ReplayController: end of data in file " << filename << std::endl;
+      warned=true;
     }
-    m.convertToBuffer(motors, motorEnd-motorStart + 1);
+    int line = log->getLine(position, repeat);
+    if(line >= 0)
+      log->getColumns(line, motorStart, motorEnd, motors);
+    position += speed;
   }
 
+  /// sets the playback position (line of the log)
+  virtual void seek(double line){
+    position = line;
+    warned   = false;
+  }
+
+  virtual double getPosition() const { return position; }
+
+  const ReplayLog& getLog() const { return *log; }
+
   /**** STOREABLE ****/
   /** stores the controller values to a given file (binary).  */
   virtual bool store(FILE* f) const {return false;}
@@ -87,97 +99,17 @@ public:
   virtual std::list<iparamkey> getInternalParamNames()const  { return std::list<iparamkey>(); }
   virtual std::list<iparamval> getInternalParams() const { return std::list<iparamval>(); }
 
-protected:
-
-  bool parseDataFileForHeader(FILE* f){
-    char buffer[1024];
-    int i;
-    sensorStart=-1;
-    sensorEnd=-1;
-    motorStart=-1;
-    motorEnd=-1;
-
-    while(fgets(buffer, 1024, f)) {
-      if(buffer[0]=='#' && buffer[1]=='C'){
-        // scan line and return
-        i=0;
-        char* p;
-        p=strtok(buffer," ");
-        if(!p) return false; // frist one is #C
-        while((p=strtok(NULL," "))!=NULL )  {
-          if(p[0]=='x' && p[1]=='['){
-            if(sensorStart==-1) sensorStart=i;
-            sensorEnd=i;
-          }
-          if(p[0]=='y' && p[1]=='['){
-            if(motorStart==-1) motorStart=i;
-            motorEnd=i;
-          }
-          i++;
-        }
-        return true;
-      }
-    }
-    return false;
-  }
-
-  static bool isEmpty(const char* c){
-    const char* p = c;
-    bool foundsomething = false;
-    while(*p != 0){
-      if(*p > ' ') foundsomething = true;
-      p++;
-    }
-    return !foundsomething;
-  }
-
-
-  static bool check4Number(const char* c){
-    const char* p = c;
-    while(*p != 0){
-      if(*p >= '0' && *p <= '9') return true;
-      p++;
-    }
-    return false;
-  }
-
-  static bool parseDataLine(matrix::Matrix& data, FILE* f){
-    char buffer[1024];
-    int i;
-    double dat[1024];
-    while(fgets(buffer, 1024, f)){
-      if(buffer[0]=='#' || isEmpty(buffer)){
-        continue;
-      }else{
-        i=0;
-        char* p;
-        p=strtok(buffer," ");
-        if(!p) return false;
-        dat[i] = atof(p);
-        i++;
-        while((p=strtok(NULL," "))!=NULL )  {
-          if(!check4Number(p)) continue;
-          dat[i] = atof(p);
-          i++;
-        };
-        data.set(i,1,dat);
-        return true;
-      }
-    };
-    return false;
-  }
-
-
-
 protected:
   int sensorStart;
   int sensorEnd;
   int motorStart;
   int motorEnd;
-  matrix::Matrix m;
   const char* filename;
-  FILE* f;
+  std::shared_ptr<ReplayLog> log;
   bool repeat;
+  double position;
+  paramval speed;
+  bool warned;
 
 };
 
@@ -0,0 +1,134 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "replaytrainer.h"
+
+using namespace matrix;
+using namespace std;
+
+ReplayTrainer::ReplayTrainer(MultiLayerFFNN* net, ReplayBuffer* buffer, int batchSize,
+                             bool useMotors, bool background)
+  : net(net), buffer(buffer), batchSize(batchSize), useMotors(useMotors),
+    background(background), batchesPerStep(1),
+    quit(false), requested(0), fresh(false), trained(0) {
+  assert(net && buffer && batchSize > 0);
+  randGen.init(1);
+  vector<Layer> layers;
+  for(unsigned int i = 0; i < net->getLayerNum(); i++)
+    layers.push_back(net->getLayer(i));
+  shadow = new MultiLayerFFNN(net->eps, layers, net->hasBypass());
+  staged = new MultiLayerFFNN(net->eps, layers, net->hasBypass());
+  shadow->init(net->getInputDim(), net->getOutputDim(), 0, &randGen);
+  staged->init(net->getInputDim(), net->getOutputDim(), 0, &randGen);
+  shadow->copyWeightsFrom(*net);
+  eps = net->eps;
+
+  pthread_mutex_init(&mutex, 0);
+  pthread_cond_init(&cond, 0);
+  if(background)
+    this->background = pthread_create(&thread, 0, run, this) == 0;
+}
+
+ReplayTrainer::~ReplayTrainer(){
+  if(background){
+    pthread_mutex_lock(&mutex);
+    quit = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+    pthread_join(thread, 0);
+  }
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+  delete shadow;
+  delete staged;
+}
+
+bool ReplayTrainer::step(){
+  if(!background){
+    shadow->eps = net->eps;
+    bool ok = false;
+    for(int i = 0; i < batchesPerStep; i++)
+      ok |= trainBatch();
+    if(ok) net->copyWeightsFrom(*shadow);
+    return ok;
+  }
+  bool installed = false;
+  pthread_mutex_lock(&mutex);
+  if(fresh){ // swap in the weights between two uses of the network
+    net->copyWeightsFrom(*staged);
+    fresh = false;
+    installed = true;
+  }
+  eps = net->eps;
+  requested += batchesPerStep;
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+  return installed;
+}
+
+void ReplayTrainer::wait(){
+  if(!background) return;
+  pthread_mutex_lock(&mutex);
+  while(requested > 0)
+    pthread_cond_wait(&cond, &mutex);
+  pthread_mutex_unlock(&mutex);
+}
+
+bool ReplayTrainer::trainBatch(){
+  if(!buffer->sample(batchSize, x, y, xnext, &randGen))
+    return false;
+  shadow->learnBatch(useMotors ? x.above(y) : x, xnext);
+  trained++;
+  return true;
+}
+
+void* ReplayTrainer::run(void* trainer){
+  ((ReplayTrainer*)trainer)->work();
+  return 0;
+}
+
+void ReplayTrainer::work(){
+  pthread_mutex_lock(&mutex);
+  while(true){
+    while(requested == 0 && !quit)
+      pthread_cond_wait(&cond, &mutex);
+    if(quit) break;
+    int n = requested;
+    shadow->eps = eps;
+    pthread_mutex_unlock(&mutex);
+
+    bool ok = false;
+    for(int i = 0; i < n; i++)
+      ok |= trainBatch();
+
+    pthread_mutex_lock(&mutex);
+    if(ok){
+      staged->copyWeightsFrom(*shadow);
+      fresh = true;
+    }
+    requested -= n;
+    pthread_cond_broadcast(&cond);
+  }
+  pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __REPLAYTRAINER_H
+#define __REPLAYTRAINER_H
+
+#include <pthread.h>
+#include <atomic>
+#include "multilayerffnn.h"
+#include "replaybuffer.h"
+#include "randomgenerator.h"
+
+/**
+ * Trains a MultiLayerFFNN as forward model from a ReplayBuffer with mini-batches.
+ * The input of the network is x_t (and y_t below it if useMotors) and the
+ * nominal output is x_t+1.
+ *
+ * The training is done on a copy of the network, optionally in a background
+ * thread. The trained weights are installed into the network in step(),
+ * which has to be called from the thread that uses the network (e.g. in the
+ * controller step), such that the network never sees partially updated weights.
+ * While a trainer is active, the network should not learn otherwise.
+ */
+class ReplayTrainer {
+public:
+  /** @param net the network to train (initialised, input dimension must fit)
+      @param buffer the replay buffer to sample from
+      @param batchSize number of transitions per mini-batch
+      @param useMotors if true the motor values are part of the network input
+      @param background if true the training runs in its own thread
+   */
+  ReplayTrainer(MultiLayerFFNN* net, ReplayBuffer* buffer, int batchSize = 32,
+                bool useMotors = true, bool background = true);
+  ~ReplayTrainer();
+
+  /** requests batchesPerStep mini-batches to be trained and installs the
+      latest trained weights into the network (if any).
+      @return true if new weights were installed
+   */
+  bool step();
+
+  /// number of mini-batches trained per call of step() (default 1)
+  void setBatchesPerStep(int n) { batchesPerStep = n; }
+
+  /// total number of trained mini-batches
+  long getTrainedBatches() const { return trained; }
+
+  /// blocks until all requested mini-batches are trained (background mode)
+  void wait();
+
+protected:
+  static void* run(void* trainer);
+  void work();
+  /// trains one mini-batch on the shadow network, returns false if no data
+  bool trainBatch();
+
+  MultiLayerFFNN* net;
+  MultiLayerFFNN* shadow;  // network that is trained
+  MultiLayerFFNN* staged;  // latest trained weights (protected by mutex)
+  ReplayBuffer* buffer;
+  RandGen randGen;
+  int batchSize;
+  bool useMotors;
+  bool background;
+  int batchesPerStep;
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  bool quit;
+  int requested;  // batches requested but not trained yet
+  bool fresh;     // staged contains weights not installed yet
+  double eps;     // learning rate of net (copied in step)
+  std::atomic<long> trained; // written by the training thread, read by the caller
+
+  matrix::Matrix x, y, xnext; // samples
+
+private:
+  ReplayTrainer(const ReplayTrainer&);
+  ReplayTrainer& operator=(const ReplayTrainer&);
+};
+
+#endif
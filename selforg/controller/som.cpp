@@ -186,10 +186,10 @@ const Matrix SOM::learn (const Matrix& input,
 }
 
 bool SOM::store(FILE* f) const{
-  fprintf(f,"%g\n", eps);
+  fprintf(f,"%.17g\n", eps);
   fprintf(f,"%i\n", dimensions);
-  fprintf(f,"%g\n", sigma);
-  fprintf(f,"%g\n", rbfsize);
+  fprintf(f,"%.17g\n", sigma);
+  fprintf(f,"%.17g\n", rbfsize);
   fprintf(f,"%i\n", size);
   fprintf(f,"%i\n", getOutputDim());
 
@@ -18,9 +18,123 @@
  ***************************************************************************/
 
 #include "sox.h"
+#include <selforg/asynclearner.h>
 using namespace matrix;
 using namespace std;
 
+/// upper bound of the maxstaleness parameter
+static const int maxStalenessLimit = 100;
+
+/// what the learner thread gets from one control step
+struct SoxSample {
+  Matrix x;          // smoothed sensor values
+  Matrix y;          // motor values that were sent
+  bool teaching;
+  Matrix y_teaching;
+  // parameters in effect at this step
+  SoxConf conf;
+  bool loga;
+  double creativity, sense, harmony, causeaware, epsC, epsA, damping, gamma;
+  int pseudo;
+};
+
+/// parameter version published by the learner thread
+struct SoxVersion {
+  Matrix A, C, S, h, b, L, R, v_avg;
+};
+
+/**
+ * Learner thread of Sox (conf.asyncLearning):
+ * a private synchronous Sox learns from the samples of the control thread
+ * exactly like Sox::step() would, only the motor values come from the
+ * (possibly older) parameters of the control thread.
+ */
+class SoxLearner : public AsyncLearner<SoxSample, SoxVersion> {
+public:
+  SoxLearner(const SoxConf& conf, int sensornumber, int motornumber, RandGen* randGen)
+    : AsyncLearner<SoxSample, SoxVersion>(maxStalenessLimit+1), sox(learnerConf(conf)) {
+    sox.init(sensornumber, motornumber, randGen);
+  }
+
+  virtual ~SoxLearner(){
+    stop();
+  }
+
+  /// waits for the learner and gives it the state of the control side
+  void reset(const Sox& f){
+    wait();
+    fetch(); // versions published before are dropped
+    sox.A = f.A;  sox.C = f.C;  sox.S = f.S;  sox.h = f.h; sox.b = f.b;
+    sox.L = f.L;  sox.R = f.R;  sox.v_avg = f.v_avg;
+    sox.A_native = f.A_native;  sox.C_native = f.C_native;
+    for(unsigned int k = 0; k < Sox::buffersize; k++){
+      sox.x_buffer[k] = f.x_buffer[k];
+      sox.y_buffer[k] = f.y_buffer[k];
+    }
+    sox.t = f.t;
+  }
+
+  /// takes over the latest published version (if new)
+  void update(Sox& f){
+    if(!fetch()) return;
+    const SoxVersion& v = current();
+    f.A = v.A;  f.C = v.C;  f.S = v.S;  f.h = v.h; f.b = v.b;
+    f.L = v.L;  f.R = v.R;  f.v_avg = v.v_avg;
+  }
+
+  /// hands over the last step of the control side
+  void submit(Sox& f){
+    SoxSample& s = nextSample();
+    s.x = f.x_smooth;
+    s.y = f.y_buffer[(f.t - 1 + Sox::buffersize) % Sox::buffersize];
+    s.teaching = f.intern_isTeaching;
+    if(s.teaching) s.y_teaching = f.y_teaching;
+    f.intern_isTeaching = false; // the learner keeps it until it is used
+    s.conf       = f.conf;
+    s.loga       = f.loga;
+    s.creativity = f.creativity;
+    s.sense      = f.sense;
+    s.harmony    = f.harmony;
+    s.causeaware = f.causeaware;
+    s.epsC       = f.epsC;
+    s.epsA       = f.epsA;
+    s.damping    = f.damping;
+    s.gamma      = f.gamma;
+    s.pseudo     = f.pseudo;
+    AsyncLearner<SoxSample, SoxVersion>::submit(max(f.maxStaleness, 0));
+  }
+
+protected:
+  virtual void learn(const SoxSample& s, SoxVersion& v){
+    sox.conf       = s.conf;
+    sox.loga       = s.loga;
+    sox.creativity = s.creativity;
+    sox.sense      = s.sense;
+    sox.harmony    = s.harmony;
+    sox.causeaware = s.causeaware;
+    sox.epsC       = s.epsC;
+    sox.epsA       = s.epsA;
+    sox.damping    = s.damping;
+    sox.gamma      = s.gamma;
+    sox.pseudo     = s.pseudo;
+    if(s.teaching){
+      sox.y_teaching = s.y_teaching;
+      sox.intern_isTeaching = true;
+    }
+    sox.learnFrom(s.x, s.y);
+    v.A = sox.A;  v.C = sox.C;  v.S = sox.S;  v.h = sox.h; v.b = sox.b;
+    v.L = sox.L;  v.R = sox.R;  v.v_avg = sox.v_avg;
+  }
+
+  static SoxConf learnerConf(SoxConf conf){
+    conf.asyncLearning = false;
+    return conf;
+  }
+
+  Sox sox;
+};
+
+
 Sox::Sox(const SoxConf& conf)
   : AbstractController("Sox", "1.1"),
     conf(conf)
@@ -41,6 +155,11 @@ Sox::Sox(double init_feedback_strength, bool useExtendedModel, bool useTeaching
 
 void Sox::constructor(){
   t=0;
+  asyncLearner = 0;
+  asyncReset   = false;
+  maxStaleness = 0;
+  learnerLag   = 0;
+  staleness    = 0;
 
   addParameterDef("Logarithmic", &loga, false, "whether to use logarithmic error");
   addParameterDef("epsC", &epsC, 0.1,     0,5, "learning rate of the controller");
@@ -85,11 +204,20 @@ void Sox::constructor(){
 
   addInspectableMatrix("v_avg", &v_avg, "input shift (averaged)");
 
+  if(conf.asyncLearning){
+    addParameterDef("maxstaleness", &maxStaleness, 2, 0, maxStalenessLimit,
+                    "maximal number of steps the learner may lag behind (0: synchronous)");
+    addInspectableValue("learnerlag", &learnerLag, "number of steps not yet learned");
+    addInspectableValue("staleness",  &staleness,
+                        "number of steps the used controller parameters are behind");
+  }
+
   intern_isTeaching = false;
 
 };
 
 Sox::~Sox(){
+  if(asyncLearner) delete asyncLearner;
 }
 
 
@@ -131,6 +259,12 @@ void Sox::init(int sensornumber, int motornumber, RandGen* randGen){
     y_buffer[k].set(number_motors,1);
 
   }
+
+  if(conf.asyncLearning){
+    if(asyncLearner) delete asyncLearner;
+    asyncLearner = new SoxLearner(conf, number_sensors, number_motors, randGen);
+    asyncReset   = true;
+  }
 }
 
 matrix::Matrix Sox::getA(){
@@ -140,6 +274,7 @@ matrix::Matrix Sox::getA(){
 void Sox::setA(const matrix::Matrix& _A){
   assert(A.getM() == _A.getM() && A.getN() == _A.getN());
   A=_A;
+  asyncReset=true;
 }
 
 matrix::Matrix Sox::getC(){
@@ -149,6 +284,7 @@ matrix::Matrix Sox::getC(){
 void Sox::setC(const matrix::Matrix& _C){
   assert(C.getM() == _C.getM() && C.getN() == _C.getN());
   C=_C;
+  asyncReset=true;
 }
 
 matrix::Matrix Sox::geth(){
@@ -158,11 +294,26 @@ matrix::Matrix Sox::geth(){
 void Sox::seth(const matrix::Matrix& _h){
   assert(h.getM() == _h.getM() && h.getN() == _h.getN());
   h=_h;
+  asyncReset=true;
 }
 
 // performs one step (includes learning). Calculates motor commands from sensor inputs.
 void Sox::step(const sensor* x_, int number_sensors,
                        motor* y_, int number_motors){
+  if(asyncLearner){
+    // the motor values are computed with the latest published C,h
+    if(asyncReset){
+      asyncLearner->reset(*this);
+      asyncReset = false;
+    } else
+      asyncLearner->update(*this);
+    stepNoLearning(x_, number_sensors, y_, number_motors);
+    staleness  = asyncLearner->getSubmitted() - asyncLearner->currentStamp();
+    asyncLearner->submit(*this);
+    learnerLag = asyncLearner->getLag();
+    return;
+  }
+
   stepNoLearning(x_, number_sensors, y_, number_motors);
   if(t<=buffersize) return;
   t--; // stepNoLearning increases the time by one - undo here
@@ -240,6 +391,7 @@ void Sox::motorBabblingStep(const sensor* x_, int number_sensors,
   C_native = C;
   A_native = A;
   t++;
+  asyncReset = true;
 }
 
 
@@ -254,6 +406,17 @@ Matrix Sox::pseudoInvL(const Matrix& L, const Matrix& A, const Matrix& C){
 }
 
 
+void Sox::learnFrom(const Matrix& x_smooth, const Matrix& y){
+  x_buffer[t%buffersize] = x_smooth;
+  y_buffer[t%buffersize] = y;
+  t++;
+  if(t<=buffersize) return;
+  t--; // as in step()
+  if(epsC!=0 || epsA!=0)
+    learn();
+  t++;
+}
+
 // learn values h,C,A,b,S
 void Sox::learn(){
 
@@ -363,6 +526,7 @@ int Sox::setParameters(const list<Matrix>& params){
     const Matrix& hN = *(++i);
     if(h.hasSameSizeAs(hN)) h=hN;
     else return false;
+    asyncReset=true;
   } else {
     fprintf(stderr,"setParameters wrong len %i!=2\n", (int)params.size());
     return false;
@@ -392,6 +556,7 @@ bool Sox::restore(FILE* f){
   S.restore(f);
   Configurable::parse(f);
   t=0; // set time to zero to ensure proper filling of buffers
+  asyncReset=true;
   return true;
 }
 
@@ -46,8 +46,15 @@ struct SoxConf {
   double factorS;             ///< factor for learning rate of S
   double factorb;             ///< factor for learning rate of b
   double factorh;             ///< factor for learning rate of h
+
+  /** if true the learning runs in a background thread and the control step
+      uses the latest published C,h (at most maxstaleness steps old)
+   */
+  bool   asyncLearning;
 };
 
+class SoxLearner;
+
 
 /**
  * This controller implements the standard algorihm described the the Chapter 5 (Homeokinesis)
@@ -80,6 +87,8 @@ public:
     conf.factorS              = 1;
     conf.factorb              = 1;
     conf.factorh              = 1;
+
+    conf.asyncLearning        = false;
     return conf;
   }
 
@@ -127,6 +136,8 @@ public:
   virtual int setParameters(const std::list<matrix::Matrix>& params) override;
 
 protected:
+  friend class SoxLearner;
+
   unsigned short number_sensors;
   unsigned short number_motors;
   static const unsigned short buffersize = 10;
@@ -164,6 +175,12 @@ protected:
   paramval damping;
   paramval gamma;          // teaching strength
 
+  SoxLearner* asyncLearner; // learner thread (only with conf.asyncLearning)
+  bool asyncReset;          // state was changed from outside, learner needs it
+  paramint maxStaleness;    // max. number of steps the learner may lag behind
+  double learnerLag;        // number of samples not yet learned
+  double staleness;         // age (in steps) of the C,h used for the motor values
+
   void constructor();
 
   // calculates the pseudo inverse of L in different ways, depending on pseudo
@@ -172,6 +189,11 @@ protected:
   /// learn values model and controller (A,b,C,h)
   virtual void learn();
 
+  /** puts the smoothed sensor values and the actually used motor values
+      into the buffers and learns (used by the learner thread)
+   */
+  void learnFrom(const matrix::Matrix& x_smooth, const matrix::Matrix& y);
+
   /// neuron transfer function
   static double g(double z)
   {
@@ -28,7 +28,7 @@
 
 SwitchController::SwitchController(const std::list<AbstractController*>& controllers,
                                    const std::string& name, const std::string& revision)
-  : AbstractController(name, revision), controllers(controllers) {
+  : AbstractController(name, revision), controllers(controllers), switchStep(0) {
 
   addParameterDef("activecontroller",&activecontroller,0,0,10,"index of active controller");
   assert(controllers.size()>0);
@@ -45,35 +45,40 @@ void SwitchController::init(const int sensornumber, const int motornumber,
   for(auto &c: controllers){
     c->init(sensornumber, motornumber, randGen);
   }
+  heldMotors.assign(controllers.size(), std::vector<motor>(motornumber, 0));
 }
 
 void SwitchController::step(const sensor* sensors, int sensornumber, motor* motors, int motornumber) {
-  motor* dummy = (motor*) malloc(sizeof(motor) * motornumber);
-
-  activecontroller = std::max(0,std::min(activecontroller,(int)controllers.size()-1));
-
-  FOREACHIa(controllers, c, i){
-    if(activecontroller==i){
-      (*c)->step(sensors,sensornumber,motors,motornumber);
-    }else{
-      (*c)->step(sensors,sensornumber,dummy,motornumber);
-    }
-  }
-  free(dummy);
+  stepControllers(sensors, sensornumber, motors, motornumber, true);
 }
 
 void SwitchController::stepNoLearning(const sensor* sensors , int sensornumber, motor* motors, int motornumber){
+  stepControllers(sensors, sensornumber, motors, motornumber, false);
+}
+
+void SwitchController::stepControllers(const sensor* sensors, int sensornumber,
+                                       motor* motors, int motornumber, bool learning){
   motor* dummy = (motor*) malloc(sizeof(motor) * motornumber);
 
   activecontroller = std::max(0,std::min(activecontroller,(int)controllers.size()-1));
+  heldMotors.resize(controllers.size());
 
   FOREACHIa(controllers, c, i){
-    if(activecontroller==i){
-      (*c)->stepNoLearning(sensors,sensornumber,motors,motornumber);
-    }else{
-      (*c)->stepNoLearning(sensors,sensornumber,dummy,motornumber);
+    motor* out = activecontroller==i ? motors : dummy;
+    std::vector<motor>& held = heldMotors[i];
+    if((*c)->isDue(switchStep)){
+      if(learning)
+        (*c)->step(sensors,sensornumber,out,motornumber);
+      else
+        (*c)->stepNoLearning(sensors,sensornumber,out,motornumber);
+      if((*c)->getRate() > 1)
+        held.assign(out, out + motornumber);
+    }else if(activecontroller==i){
+      held.resize(motornumber, 0);
+      for(int k = 0; k < motornumber; k++)
+        motors[k] = held[k];
     }
   }
+  switchStep++;
   free(dummy);
 }
-
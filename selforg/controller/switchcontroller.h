@@ -25,10 +25,13 @@
 #define __SWITCHCONTROLLER_H
 
 #include "abstractcontroller.h"
+#include <vector>
 
 /**
  * meta controller for switching control between
  * different subcontrollers.
+ * Subcontrollers with a lower rate (AbstractController::setRate())
+ * are only stepped when they are due, their last motor values are held in between.
  */
 class SwitchController : public AbstractController {
 public:
@@ -43,6 +46,9 @@ public:
   virtual void stepNoLearning(const sensor* sensors , int sensornumber,
                               motor* motors, int motornumber);
 
+  /// all subcontrollers (active or not)
+  virtual std::list<AbstractController*> getSubControllers() { return controllers; }
+
   virtual int getSensorNumber() const { return controllers.front()->getSensorNumber();};
 
   virtual int getMotorNumber() const { return controllers.front()->getMotorNumber();};
@@ -52,8 +58,14 @@ public:
   virtual bool restore(FILE* f)     { return controllers.front()->restore(f);};
 
 protected:
+  /// steps all subcontrollers that are due and holds the motor values of the others
+  void stepControllers(const sensor* sensors, int sensornumber,
+                       motor* motors, int motornumber, bool learning);
+
   int activecontroller;
   std::list<AbstractController*> controllers;
+  long switchStep; // number of steps of this controller
+  std::vector<std::vector<motor> > heldMotors; // last motor values of each subcontroller
 };
 
 #endif
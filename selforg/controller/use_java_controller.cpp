@@ -26,6 +26,7 @@ use_java_controller::~use_java_controller()
         printf("\nSimulation wird beendet!\n");
         close(server_controller);
         close(server_internalParams);
+        if(sendbuffer) free(sendbuffer);
 
 }
 
@@ -36,7 +37,7 @@ use_java_controller::~use_java_controller()
 */
 use_java_controller::use_java_controller ( const char* port_controller, const char* port_internalParams, const char* name )
   : AbstractController ( "Javacontroller", "$Id: use_java_controller.cpp,Rocco Gwizdziel" ),
-    name(name)
+    name(name), sendbuffer(0), sendbuffer_size(0)
 {
         addController();
         char* port_iP;
@@ -99,6 +100,8 @@ use_java_controller::use_java_controller ( const char* port_controller, const ch
         client_controller = accept ( server_controller, ( struct sockaddr* ) &client_controller_addr, &client_controller_size );
 
         if ( client_controller == -1 ) {perror ( "accept() failed" );}
+        int nodelay = 1; // send the small step messages immediately
+        setsockopt ( client_controller, IPPROTO_TCP, TCP_NODELAY, ( char* ) &nodelay, sizeof ( int ) );
         printf ( "ControllerServer gestartet (%s: %s)\nStatus: listen ...\n\n",inet_ntoa ( client_controller_addr.sin_addr ) ,port_controller );
 
 
@@ -291,6 +294,10 @@ void use_java_controller::init ( int sensornumber, int motornumber, RandGen* ran
 
 
 
+        // large enough for all values printed with %f
+        sendbuffer_size = 64 + 32 * ( sensornumber + motornumber );
+        sendbuffer = ( char* ) malloc ( sendbuffer_size );
+
         motor_values_alt = ( double* ) malloc ( motornumber*sizeof ( double ) );
         for ( int i=0;  i < motornumber; i++ ) {motor_values_alt[i] = 0;}
 
@@ -323,48 +330,28 @@ void use_java_controller::stepNoLearning ( const sensor* sensors, int number_sen
         if ( serverOK )
         {
 
-                char *temp;
-            char *temp1;
-
-            temp =  ( char* )  malloc ( BUFFER_SIZE );
-            temp1 = ( char* )  malloc ( BUFFER_SIZE );
-
-
-                sprintf ( temp,"N#%d#%d#%d#",t++,number_sensors,number_motors );
-                strcpy ( temp1,temp );
-
-                //sammeln der zusendenden daten
-                //sensoren
-                for ( int i= 0; i < number_sensors-1; i++ )
+                // message is written in place into the preallocated send buffer
+                // (one pass, no temporary strings)
+                char* buf = sendbuffer;
+                char* end = sendbuffer + sendbuffer_size;
+                buf += snprintf ( buf, end-buf, "N#%d#%d#%d#",t++,number_sensors,number_motors );
+                for ( int i= 0; i < number_sensors && buf < end; i++ )
                 {
-                        sprintf ( temp,"%f&",sensors[i] );
-                        strcat ( temp1,temp );
+                        buf += snprintf ( buf, end-buf, i < number_sensors-1 ? "%f&" : "%f#", sensors[i] );
                 }
-                sprintf ( temp,"%f#",sensors[number_sensors-1] );
-                strcat ( temp1,temp );
-
-                //motoren
-                for ( int i= 0; i < number_motors-1; i++ )
+                for ( int i= 0; i < number_motors && buf < end; i++ )
                 {
-                        sprintf ( temp,"%f&",motors[i] );
-                        strcat ( temp1,temp );
+                        buf += snprintf ( buf, end-buf, i < number_motors-1 ? "%f&" : "%f", motors[i] );
                 }
-                sprintf ( temp,"%f",motors[number_motors-1] );
-                strcat ( temp1,temp );
-
-                sprintf ( temp,"\n" );
-                strcat ( temp1,temp );
+                if ( buf < end ) buf += snprintf ( buf, end-buf, "\n" );
 
         //verschicken
-                if(can_send) sendToJava ( temp1,true);
-                free ( temp );
-                free ( temp1 );
+                if(can_send) sendToJava ( sendbuffer,true);
 
 
                 //daten empfangen********************************************************************
                 char recvData_controller[BUFFER_SIZE];
-                   //recv() blockiert nicht
-            fcntl (client_controller,F_SETFL,O_NONBLOCK );
+                   //recv() blockiert nicht (O_NONBLOCK, see init)
                 int bytes = recv ( client_controller, recvData_controller, sizeof ( recvData_controller ) - 1, 0 );
                 //if ( bytes == -1 ) { printf ( "Fehler beim Empfangen der Daten vom Java-Controller(stepNoLearning)\nProgramm beendet!\n" );exit ( 1 );}
                 recvData_controller[bytes] = '\0';
@@ -384,31 +371,19 @@ void use_java_controller::stepNoLearning ( const sensor* sensors, int number_sen
                 {
                         can_send = true;
 
-                        //speichert motorwerte und im letzten feld anzahl von configParam
-                        char values[number_motors][100];
-                        //splitten (anhand von #)
-                        int m = 0;
-                        int counter=2;
-                        int counter_help = 0;
-
-                        while ( 1 )
-                        {
-                                if ( recvData_controller[counter]=='#' )
-                                        { values[m][counter_help]='\0'; m++; counter_help=0; counter++;}
-                                values[m][counter_help++]= recvData_controller[counter];
-                                if ( recvData_controller[counter++]=='\0' ) break;
-                        }
-
-                        //übergeben der Motorwerte an den Robot
+                        //motorwerte direkt aus dem Puffer lesen (getrennt durch #)
+                        const char* p = recvData_controller + 2;
                         for ( int i=0;  i < number_motors; i++ )
                         {
-                                //nach float casten
-                                double floatval;
-                                floatval = atof ( values[i] );
-                                motors[i] = floatval;
+                                char* next;
+                                double val = strtod ( p, &next );
+                                if ( next == p ) break;
+                                motors[i] = val;
+                                p = next;
+                                if ( *p == '#' ) p++;
                         }
 
-                        motor_values_alt = motors;
+                        memcpy ( motor_values_alt, motors, sizeof ( motor ) * number_motors );
                         isFirst = false;
 
                 }
@@ -418,7 +393,7 @@ void use_java_controller::stepNoLearning ( const sensor* sensors, int number_sen
                 {
                         //printf("%d",bytes);
                         if(!isFirst) can_send = false;
-                        motors = motor_values_alt;
+                        memcpy ( motors, motor_values_alt, sizeof ( motor ) * number_motors );
                 }
 
 
@@ -430,8 +405,7 @@ void use_java_controller::stepNoLearning ( const sensor* sensors, int number_sen
         internal_vallist =  std::list<iparamval>();
 
         char recvData_internalParams[BUFFER_SIZE];
-        //recv() blockiert nicht
-    fcntl ( client_internalParams,F_SETFL,O_NONBLOCK );
+        //recv() blockiert nicht (O_NONBLOCK, see init)
         int bytes1 = recv ( client_internalParams, recvData_internalParams, sizeof ( recvData_internalParams )-1 , 0 );
         recvData_internalParams[bytes1] = '\0';
 
@@ -444,27 +418,16 @@ void use_java_controller::stepNoLearning ( const sensor* sensors, int number_sen
 
         if ( bytes1 > 0 && strlen ( recvData_internalParams ) != 0 && recvData_internalParams[0] == 'G' && recvData_internalParams[1] == 'D' )
         {
-                //speichert die configParams
-                char values_param[MAX_INTERNAL_PARAM][20];
-
-                //splitten (anhand von #)
-                int m = 0;
-                int counter=3;
-                int counter_help = 0;
-
-                while ( 1 )
-                {
-
-                        if ( recvData_internalParams[counter]=='#' )
-                                { values_param[m][counter_help]='\0'; m++; counter_help=0; counter++;}
-                        values_param[m][counter_help++]= recvData_internalParams[counter];
-                        if ( recvData_internalParams[counter++]=='\0' ) break;
-                }
-
-
+                //werte direkt aus dem Puffer lesen (getrennt durch #)
+                const char* p = recvData_internalParams + 3;
                 for ( int ip=0; ip <= anz_internal_param; ip ++ )
                 {
-                        internal_vallist += atof ( values_param[ip] );
+                        char* next;
+                        double val = strtod ( p, &next );
+                        if ( next == p ) break;
+                        internal_vallist += val;
+                        p = next;
+                        if ( *p == '#' ) p++;
                 }
 
                 internal_vallist_alt = internal_vallist;
@@ -37,6 +37,7 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -182,6 +183,9 @@ class use_java_controller : public AbstractController
 
                 double *motor_values_alt;
 
+                char* sendbuffer;       ///< preallocated buffer for the step messages
+                int   sendbuffer_size;
+
 };
 
 #endif // win32
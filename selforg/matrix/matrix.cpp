@@ -12,6 +12,7 @@
 #include <string.h>
 #include <cmath>
 #include <algorithm>
+#include <stdint.h>
 
 namespace matrix {
 
@@ -203,25 +204,96 @@ namespace matrix {
     return true;
   }
 
-  /** stores the Matrix into the given file stream ASCII
+  /// header of the binary storage format (after the 4 byte identifier)
+  struct MatrixBinaryHeader {
+    uint16_t byteorder; // 0x0102 in the byte order of the writer
+    uint8_t  version;
+    uint8_t  elemsize;  // sizeof(double) or sizeof(float)
+    uint32_t m;
+    uint32_t n;
+    uint32_t checksum;  // of the data, as stored
+    uint32_t reserved;
+  };
+
+  static const char* matrixBinaryId = "LPZM";
+
+  static uint32_t swap32(uint32_t v){
+    return (v>>24) | ((v>>8)&0xff00) | ((v<<8)&0xff0000) | (v<<24);
+  }
+
+  static void swapBytes(char* p, size_t elemsize, size_t num){
+    for(size_t i=0; i<num; i++, p+=elemsize){
+      std::reverse(p, p+elemsize);
+    }
+  }
+
+  /** stores the Matrix into the given file stream (binary)
    */
   bool Matrix::store ( FILE* f ) const {
-    return write(f);
-    // I dim[2] = { m, n };
-    // I len = m * n;
-    // bool rval = false;
-    // if ( fwrite ( dim, sizeof ( I ), 2, f ) == 2 )
-    //   if ( fwrite ( data, sizeof ( D ), len, f ) == len )
-    //     rval = true;
-    // return rval;
+    MatrixBinaryHeader h;
+    h.byteorder = 0x0102;
+    h.version   = 1;
+    h.elemsize  = sizeof ( D );
+    h.m         = m;
+    h.n         = n;
+    h.checksum  = Storeable::checksum ( data, sizeof ( D ) * m * n );
+    h.reserved  = 0;
+    I len = m * n;
+    return fwrite ( matrixBinaryId, 4, 1, f ) == 1
+      && fwrite ( &h, sizeof ( h ), 1, f ) == 1
+      && ( len == 0 || fwrite ( data, sizeof ( D ), len, f ) == len );
+  }
+
+  bool Matrix::restoreBinary ( FILE* f ) {
+    MatrixBinaryHeader h;
+    if ( fread ( &h, sizeof ( h ), 1, f ) != 1 ) {
+      fprintf ( stderr, "Matrix::restore: (binary) cannot read header\n" );
+      return false;
+    }
+    bool swap = h.byteorder == 0x0201;
+    if ( ( h.byteorder != 0x0102 && !swap ) || h.version != 1
+         || ( h.elemsize != sizeof ( double ) && h.elemsize != sizeof ( float ) ) ) {
+      fprintf ( stderr, "Matrix::restore: (binary) unsupported format\n" );
+      return false;
+    }
+    if ( swap ) {
+      h.m = swap32 ( h.m );
+      h.n = swap32 ( h.n );
+      h.checksum = swap32 ( h.checksum );
+    }
+    size_t len = ( size_t ) h.m * h.n;
+    std::vector<char> buffer ( len * h.elemsize );
+    if ( len > 0 && fread ( &buffer[0], h.elemsize, len, f ) != len ) {
+      fprintf ( stderr, "Matrix::restore: (binary) cannot read matrix data\n" );
+      return false;
+    }
+    if ( len > 0 && Storeable::checksum ( &buffer[0], buffer.size() ) != h.checksum ) {
+      fprintf ( stderr, "Matrix::restore: (binary) checksum mismatch\n" );
+      return false;
+    }
+    m = h.m;
+    n = h.n;
+    allocate();
+    if ( len == 0 ) return true;
+    if ( swap ) swapBytes ( &buffer[0], h.elemsize, len );
+    if ( h.elemsize == sizeof ( D ) ) {
+      memcpy ( data, &buffer[0], len * sizeof ( D ) );
+    } else {
+      const float* fs = ( const float* ) &buffer[0];
+      for ( size_t i = 0; i < len; i++ ) data[i] = fs[i];
+    }
+    return true;
   }
 
-  /** reads a Matrix from the given file stream ASCII (can load old binary format)
+  /** reads a Matrix from the given file stream (binary, ASCII or old binary format)
    */
   bool Matrix::restore ( FILE* f ) {
     char buffer[7];
     bool rval = false;
-    if ( fread ( buffer, 7, 1, f ) == 1 ) {
+    if ( fread ( buffer, 4, 1, f ) == 1 && memcmp ( buffer, matrixBinaryId, 4 ) == 0 ) {
+      return restoreBinary ( f );
+    }
+    if ( fread ( buffer+4, 3, 1, f ) == 1 ) {
       if ( buffer[0] == 'M' && buffer[1] == 'A' && buffer[2] == 'T'
            && buffer[3] == 'R' && buffer[4] == 'I' && buffer[5] == 'X' ) {
         return read ( f, true );
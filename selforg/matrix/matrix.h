@@ -153,12 +153,16 @@ namespace matrix{
     const D* unsafeGetData() const{return data;}
 
     /*       STOREABLE       */
-    /** stores the Matrix into the given file stream (same as write)
+    /** stores the Matrix into the given file stream (binary, full precision).
+        The data is preceded by a header with the identifier "LPZM",
+        a byte order mark, the element size, the dimensions and a checksum.
+        Use write() for ASCII output.
      */
     bool store(FILE* f) const;
 
-    /** reads a Matrix from the given file stream
-        uses read (or old binary format)
+    /** reads a Matrix from the given file stream.
+        Supports the binary format (of any byte order),
+        the ASCII format (see read()) and the old binary format (dimensions + data)
      */
     bool restore(FILE* f);
 
@@ -455,6 +459,7 @@ namespace matrix{
 
   private: // internals
     void allocate();  //internal allocation
+    bool restoreBinary(FILE* f); // reads binary format after the identifier
     /*inplace matrix invertation:
         Matrix must be SQARE, in addition, all DIAGONAL ELEMENTS MUST BE NONZERO
         (positive definite)
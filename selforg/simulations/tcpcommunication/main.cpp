@@ -251,12 +251,21 @@ int main(int argc, char** argv){
   index = contains(argv,argc,"-d");
   if(index >0 && argc>index)
     dim=atoi(argv[index]);
+  TcpController::Protocol protocol = TcpController::Text;
+  index = contains(argv,argc,"-p");
+  if(index >0 && argc>index) {
+    if(strcasecmp(argv[index],"text")==0) protocol = TcpController::Text;
+    else if(strcasecmp(argv[index],"binary")==0) protocol = TcpController::Binary;
+    else if(strcasecmp(argv[index],"shm")==0) protocol = TcpController::SharedMemory;
+    else { fprintf(stderr, "Unknown protocol! See help -h\n"); exit(1);}
+  }
   if(contains(argv,argc,"-h")!=0) {
-    printf("Usage: %s [-g N] [-f] [-n] [-m MODE] [d DIM]\n",argv[0]);
+    printf("Usage: %s [-g N] [-f] [-n] [-m MODE] [d DIM] [-p PROTOCOL]\n",argv[0]);
     printf("\t-g N\tstart guilogger with interval N\n\t-f\twrite logfile\n");
     printf("\t-n\tstart neuronviz\n");
     printf("\t-m MODE\t system properties: normal (def), swing, extrasine\n");
     printf("\t-d DIM\t dimensionality, default 2\n");
+    printf("\t-p PROTOCOL\t remote controller protocol: text (def), binary, shm\n");
     printf("\t-h\tdisplay this help\n");
     exit(0);
   }
@@ -304,7 +313,7 @@ int main(int argc, char** argv){
   //AbstractController* controller = new Homeokinesis();
 
   //AbstractController* controller = new MotorBabbler();
-  AbstractController* controller = new TcpController("Test", 4000);
+  AbstractController* controller = new TcpController("Test", 4000, 0, protocol);
 
 
   controller->setParam("epsC",     0.1);
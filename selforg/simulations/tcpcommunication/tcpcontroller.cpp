@@ -27,12 +27,14 @@
 #include <assert.h>
 #include "tcpcontroller.h"
 #include <sstream>
+#include <string.h>
 
 using namespace std;
 
-TcpController::TcpController(const string& robotname, int port, AbstractController* teacher)
+TcpController::TcpController(const string& robotname, int port, AbstractController* teacher,
+                             Protocol protocol)
   : AbstractController("tcpcontroller (" + robotname + ")", "0.1"),
-    port(port), robotname(robotname),teacher(teacher) {
+    port(port), robotname(robotname),teacher(teacher), protocol(protocol), wire(0) {
   addParameter("port", &port,"Port to listen for TCP connections (immutable after initialisation)");
 
   commands["MOTORS"       ] = MOTORS;
@@ -46,16 +48,46 @@ TcpController::TcpController(const string& robotname, int port, AbstractControll
   number_sensors=0;
   number_motors=0;
   quit=false;
+  t=0;
 };
 
 TcpController::~TcpController(){
   socket.close();
+  if(wire){
+    frameOut.begin(WireFrame::CLOSE, t);
+    wire->send(frameOut);
+    delete wire;
+  }
 }
 
 void TcpController::init(int sensornumber, int motornumber, RandGen* randGen){
   number_sensors=sensornumber;
   number_motors=motornumber;
-  socket.accept(port);
+  switch(protocol){
+  case Binary: {
+    TcpWireTransport* tcp = new TcpWireTransport();
+    cout << "  --> on port " << port << endl;
+    if(!tcp->listen(port)) quit=true;
+    wire = tcp;
+    break;
+  }
+  case SharedMemory: {
+    stringstream name;
+    name << "/lpzrobots-" << port;
+    ShmWireTransport* shm = new ShmWireTransport(name.str(), true);
+    cout << "  --> shared memory " << name.str() << endl;
+    if(!shm->isOpen()) quit=true;
+    wire = shm;
+    break;
+  }
+  default:
+    socket.accept(port);
+  }
+  if(wire && !quit){
+    frameOut.begin(WireFrame::HELLO, 0);
+    frameOut.setHello(sensornumber, motornumber, robotname);
+    quit = !wire->send(frameOut);
+  }
   if(teacher) teacher->init(sensornumber,motornumber,randGen);
 };
 
@@ -66,6 +98,10 @@ void TcpController::step(const sensor* sensors, int sensornumber,
     cout << "TcpController::step() remote controller quit!" << endl;
     return;
   }
+  if(wire){
+    stepBinary(sensors, sensornumber, motors, motornumber);
+    return;
+  }
 
   string s;
   bool gotMotors=false;
@@ -117,6 +153,59 @@ void TcpController::step(const sensor* sensors, int sensornumber,
 
 };
 
+void TcpController::stepBinary(const sensor* sensors, int sensornumber,
+                               motor* motors, int motornumber) {
+  frameOut.begin(WireFrame::SENSORS, t++);
+  frameOut.addAgent(0, sensors, sensornumber);
+  if(!wire->send(frameOut)){
+    quit=true;
+    return;
+  }
+  bool gotMotors=false;
+  bool observing=false;
+  while(!gotMotors && !quit){
+    if(!wire->receive(frameIn)){
+      cout << "TcpController::step: connection lost" << endl;
+      quit=true;
+      break;
+    }
+    switch(frameIn.getType()){
+    case WireFrame::MOTORS: {
+      uint32_t n;
+      const double* ms = frameIn.findAgent(0, n);
+      if(ms && n>0){
+        if((int)n!=motornumber)
+          cout << "TcpController::motorcommands() did not get enough motor values!"
+               << "Expect " << motornumber << " but got " << n << endl;
+        memcpy(motors, ms, sizeof(motor)*min((int)n, motornumber));
+      } else if(teacher){ // empty answer: remote side observes the teacher
+        teacher->step(sensors,sensornumber, motors, motornumber);
+        frameOut.begin(WireFrame::MOTORS, t-1);
+        frameOut.addAgent(0, motors, motornumber);
+        wire->send(frameOut);
+        observing=true;
+      }
+      gotMotors=true;
+      break;
+    }
+    case WireFrame::PARAM: {
+      string key;
+      double val;
+      if(frameIn.getParam(key, val)) setParam(key, val);
+      break;
+    }
+    case WireFrame::CLOSE:
+      wire->close();
+      quit=true;
+      break;
+    default:
+      cout << "TcpController::step: unexpected frame " << frameIn.getType() << endl;
+    }
+  }
+  if(!observing && teacher) // teacher sees sensor inputs to fill buffers
+    teacher->stepNoLearning(sensors,sensornumber,motors,motornumber);
+}
+
 void TcpController::stepNoLearning(const sensor* sensors, int number_sensors,
                                     motor* motors, int number_motors) {
 
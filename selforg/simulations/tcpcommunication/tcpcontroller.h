@@ -26,12 +26,27 @@
 
 #include <stdio.h>
 #include <selforg/abstractcontroller.h>
+#include <selforg/wireprotocol.h>
 #include "Socket.h"
 
 /**
  * class for robot control via a remote tcp controller
  *
- * Todo add protocol description
+ * With the Text protocol the remote side sends commands (strings) like
+ * SENSORS, MOTORS, STATUS... and the values are exchanged as vectors
+ * (@see Socket).
+ * With the Binary and SharedMemory protocols the values are exchanged
+ * as WireFrames (@see WireFrame): after a HELLO frame (sensor and motor
+ * number, robot name) the controller sends one SENSORS frame per step
+ * and waits for the MOTORS frame of the remote side. PARAM frames set
+ * parameters and a CLOSE frame ends the connection. If a teacher is given
+ * and the remote side answers with an empty MOTORS frame the motor values
+ * of the teacher are used and sent back (observing).
+ * The shared memory object is called "/lpzrobots-<port>".
+ * Every TcpController serves one agent over its own connection, so its
+ * frames contain a single agent record. Batching the records of several
+ * agents into one frame is only done where one side owns all agents
+ * (see simulations/wire_benchmark), it is not done here.
  */
 class TcpController : public AbstractController {
 public:
@@ -39,12 +54,16 @@ public:
 
   typedef std::map<std::string, CommandID> CommandList;
 
+  enum Protocol {Text, Binary, SharedMemory};
+
 
   /**
      @param port Port number to listen for controller
      @param robotname name of robot to send to controller
+     @param protocol Text, Binary (over TCP) or SharedMemory (same host)
    */
-  TcpController(const string& robotname, int port = 4000, AbstractController* teacher = 0);
+  TcpController(const string& robotname, int port = 4000, AbstractController* teacher = 0,
+                Protocol protocol = Text);
 
   virtual ~TcpController();
 
@@ -90,6 +109,8 @@ protected:
   void sendSensorValues(const sensor* sensors, int sensornumber);
   void sendMotorValues(const motor* motors, int motornumber);
   void configuration();
+  void stepBinary(const sensor* sensors, int sensornumber,
+                  motor* motors, int motornumber);
 
 protected:
   int number_sensors;
@@ -101,6 +122,12 @@ protected:
 
   Socket      socket;
   CommandList commands;
+
+  Protocol       protocol;
+  WireTransport* wire;
+  WireFrame      frameOut;
+  WireFrame      frameIn;
+  uint32_t       t;
 };
 
 #endif
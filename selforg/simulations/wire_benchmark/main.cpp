@@ -0,0 +1,281 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Loopback benchmark of the remote controller protocols.
+   A child process acts as remote controller (motors = 0.5*sensors) and the
+   parent exchanges the channels of several agents per step with
+    - text:    printf formatted "N#t#..#v&v&..\n" messages split at '#'
+               (as done by use_java_controller before)
+    - binary:  one WireFrame per agent over TCP
+    - batched: one WireFrame for all agents over TCP
+    - shm:     one WireFrame for all agents via shared memory
+   Usage: start [-a AGENTS] [-c CHANNELS] [-s STEPS] [-p PORT]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <string>
+#include <vector>
+
+#include <selforg/wireprotocol.h>
+
+using namespace std;
+
+enum Mode { TEXT, BINARY, BATCHED, SHM };
+const char* modenames[] = { "text", "binary", "batched", "shm" };
+
+static double timeInUs(){
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec*1e6 + t.tv_usec;
+}
+
+/************ text protocol (line based, values separated by '&'/'#') ************/
+
+static bool sendLine(int sock, const string& line){
+  size_t sent = 0;
+  while(sent < line.size()){
+    ssize_t r = send(sock, line.data()+sent, line.size()-sent, 0);
+    if(r <= 0) return false;
+    sent += r;
+  }
+  return true;
+}
+
+/// reads up to '\n' (byte wise buffered)
+class LineReader {
+public:
+  LineReader(int sock) : sock(sock), pos(0), len(0) {}
+  bool readLine(string& line){
+    line.clear();
+    while(true){
+      if(pos == len){
+        ssize_t r = recv(sock, buf, sizeof(buf), 0);
+        if(r <= 0) return false;
+        pos = 0; len = r;
+      }
+      char c = buf[pos++];
+      if(c == '\n') return true;
+      line += c;
+    }
+  }
+protected:
+  int sock;
+  char buf[65536];
+  int pos, len;
+};
+
+static void splitValues(const string& s, size_t start, vector<double>& values){
+  values.clear();
+  const char* p = s.c_str() + start;
+  while(*p){
+    char* next;
+    double v = strtod(p, &next);
+    if(next == p) break;
+    values.push_back(v);
+    p = next;
+    if(*p == '&' || *p == '#') p++;
+  }
+}
+
+/// position of the values in "N#t#n#v&v&.."
+static size_t valueStart(const string& s){
+  return s.find('#', s.find('#', 2) + 1) + 1;
+}
+
+static string formatValues(char tag, int t, const double* v, int n){
+  string s;
+  char tmp[64];
+  snprintf(tmp, sizeof(tmp), "%c#%d#%d#", tag, t, n);
+  s = tmp;
+  for(int i=0; i<n; i++){
+    snprintf(tmp, sizeof(tmp), i<n-1 ? "%f&" : "%f", v[i]);
+    s += tmp;
+  }
+  s += '\n';
+  return s;
+}
+
+/// exposes the socket of the transport for the text protocol
+class RawTcp : public TcpWireTransport {
+public:
+  int getSocket() const { return sock; }
+};
+
+/************************** remote controller (child) *************************/
+
+static void remote(Mode mode, int port, int agents){
+  WireFrame in, out;
+  if(mode == SHM){
+    char name[64];
+    snprintf(name, sizeof(name), "/lpzrobots-bench-%i", port);
+    ShmWireTransport shm(name, false);
+    while(shm.receive(in) && in.getType() == WireFrame::SENSORS){
+      out.begin(WireFrame::MOTORS, in.getStep());
+      for(int a=0; a<in.getAgentNumber(); a++){
+        uint32_t id, n;
+        const double* x = in.getAgent(a, id, n);
+        double* y = out.addAgent(id, n);
+        for(uint32_t i=0; i<n; i++) y[i] = 0.5*x[i];
+      }
+      if(!shm.send(out)) break;
+    }
+    return;
+  }
+  RawTcp tcp;
+  while(!tcp.connect("127.0.0.1", port)) usleep(10000);
+  if(mode == TEXT){
+    LineReader reader(tcp.getSocket());
+    string line;
+    vector<double> values;
+    while(reader.readLine(line) && line[0] == 'N'){
+      splitValues(line, valueStart(line), values);
+      for(size_t i=0; i<values.size(); i++) values[i] *= 0.5;
+      if(!sendLine(tcp.getSocket(), formatValues('N', 0, values.data(), values.size())))
+        break;
+    }
+    return;
+  }
+  while(tcp.receive(in) && in.getType() == WireFrame::SENSORS){
+    out.begin(WireFrame::MOTORS, in.getStep());
+    for(int a=0; a<in.getAgentNumber(); a++){
+      uint32_t id, n;
+      const double* x = in.getAgent(a, id, n);
+      double* y = out.addAgent(id, n);
+      for(uint32_t i=0; i<n; i++) y[i] = 0.5*x[i];
+    }
+    if(!tcp.send(out)) break;
+  }
+}
+
+/************************** simulation side (parent) *************************/
+
+static bool run(Mode mode, int port, int agents, int channels, int steps){
+  pid_t child = fork();
+  if(child == 0){
+    remote(mode, port, agents);
+    _exit(0);
+  }
+  vector<vector<double> > sensors(agents, vector<double>(channels));
+  vector<vector<double> > motors(agents, vector<double>(channels));
+  WireFrame in, out;
+  RawTcp tcp;
+  ShmWireTransport* shm = 0;
+  if(mode == SHM){
+    char name[64];
+    snprintf(name, sizeof(name), "/lpzrobots-bench-%i", port);
+    shm = new ShmWireTransport(name, true);
+  } else {
+    tcp.listen(port);
+  }
+  WireTransport* wire = shm ? (WireTransport*)shm : (WireTransport*)&tcp;
+  LineReader* reader = mode == TEXT ? new LineReader(tcp.getSocket()) : 0;
+  string line;
+  vector<double> values;
+  double maxerr = 0;
+  bool ok = true;
+
+  double start = timeInUs();
+  for(int t=0; t<steps && ok; t++){
+    for(int a=0; a<agents; a++)
+      for(int i=0; i<channels; i++)
+        sensors[a][i] = sin(0.01*t + a + 0.1*i);
+
+    switch(mode){
+    case TEXT:
+      for(int a=0; a<agents && ok; a++){
+        ok = sendLine(tcp.getSocket(), formatValues('N', t, sensors[a].data(), channels))
+          && reader->readLine(line);
+        splitValues(line, valueStart(line), values);
+        for(int i=0; i<channels && i<(int)values.size(); i++) motors[a][i] = values[i];
+      }
+      break;
+    case BINARY:
+      for(int a=0; a<agents && ok; a++){
+        out.begin(WireFrame::SENSORS, t);
+        out.addAgent(a, sensors[a].data(), channels);
+        ok = wire->send(out) && wire->receive(in);
+        uint32_t n;
+        const double* y = in.findAgent(a, n);
+        if(y) memcpy(motors[a].data(), y, sizeof(double)*n);
+      }
+      break;
+    case BATCHED:
+    case SHM:
+      out.begin(WireFrame::SENSORS, t);
+      for(int a=0; a<agents; a++)
+        out.addAgent(a, sensors[a].data(), channels);
+      ok = wire->send(out) && wire->receive(in);
+      for(int a=0; a<agents && ok; a++){
+        uint32_t n;
+        const double* y = in.findAgent(a, n);
+        if(y) memcpy(motors[a].data(), y, sizeof(double)*n);
+      }
+      break;
+    }
+    for(int a=0; a<agents; a++)
+      for(int i=0; i<channels; i++)
+        maxerr = max(maxerr, fabs(motors[a][i] - 0.5*sensors[a][i]));
+  }
+  double time = timeInUs() - start;
+
+  if(shm){
+    shm->close();
+    delete shm;
+  }
+  tcp.close();
+  if(reader) delete reader;
+  waitpid(child, 0, 0);
+
+  double bytes = 2.0 * steps * agents * channels * sizeof(double);
+  printf("%-8s %4i agents %5i channels: %9.2f us/step %9.1f MB/s (payload)  max. error %g %s\n",
+         modenames[mode], agents, channels, time/steps, bytes/time,
+         maxerr, ok && maxerr < 1e-5 ? "" : "FAILED");
+  return ok && maxerr < 1e-5;
+}
+
+int main(int argc, char** argv){
+  int agents   = 4;
+  int channels = 100;
+  int steps    = 2000;
+  int port     = 4700;
+  for(int i=1; i<argc-1; i++){
+    if(strcmp(argv[i],"-a")==0) agents   = atoi(argv[i+1]);
+    if(strcmp(argv[i],"-c")==0) channels = atoi(argv[i+1]);
+    if(strcmp(argv[i],"-s")==0) steps    = atoi(argv[i+1]);
+    if(strcmp(argv[i],"-p")==0) port     = atoi(argv[i+1]);
+  }
+  signal(SIGPIPE, SIG_IGN);
+  bool ok = true;
+  for(int m=TEXT; m<=SHM; m++){
+    ok &= run((Mode)m, port+m, agents, channels, steps);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,301 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Benchmark of the sensor/motor wiring pipeline.
+   A WiringSequence of a DerivativeWiring (id, first and second derivative,
+   white uniform noise) and a One2OneWiring (white normal noise) is stepped
+   with the current implementation and with a reference copy of the previous
+   one (per step buffer allocation in the sequence, one malloc per history
+   row, separate smoothing/derivative/noise passes and one virtual generate()
+   call per noise channel). Both get the same seeds, so the outputs must be
+   identical. The current sequence is flattened: the One2OneWiring works in
+   place on the output of the DerivativeWiring. Every size is run without
+   noise (pure wiring overhead), with noise from the 48 bit generator
+   (dominated by the random number generation) and with uniform noise from
+   the counter based generator, which the noise generators fill in bulk
+   (vectorised, compile with -O3).
+   Usage: start [-s STEPS] [-c CHANNELS]  (without -c: 10 20 50 100 200 500)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <sys/time.h>
+#include <list>
+#include <vector>
+
+#include <selforg/wiringsequence.h>
+#include <selforg/derivativewiring.h>
+#include <selforg/one2onewiring.h>
+#include <selforg/noisegenerator.h>
+
+using namespace std;
+
+static double timeInUs(){
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec*1e6 + t.tv_usec;
+}
+
+/************ reference implementation of the previous pipeline ************/
+
+/// noise with the generic (virtual generate() per channel) add
+class LegacyUniformNoise : public NoiseGenerator {
+public:
+  virtual double generate() { return uniform(-1,1); }
+};
+
+class LegacyNoNoise : public NoiseGenerator {
+public:
+  virtual double generate() { return 0; }
+};
+
+class LegacyNormalNoise : public NoiseGenerator {
+public:
+  virtual double generate() {
+    double x1=uniform01();
+    double x2=uniform01();
+    return( (sqrt(-2*log(x1)) *cos(2*M_PI*x2)));
+  }
+};
+
+class LegacyDerivativeWiring : public AbstractWiring {
+public:
+  LegacyDerivativeWiring(const DerivativeWiringConf& conf, NoiseGenerator* noise)
+    : AbstractWiring(noise, Controller, "LegacyDerivativeWiring"), conf(conf) {
+    time = buffersize;
+    first = 0; second = 0;
+    for(int i=0; i<buffersize; i++) sensorbuffer[i]=0;
+  }
+  virtual ~LegacyDerivativeWiring(){
+    for(int i=0 ; i<buffersize; i++) if(sensorbuffer[i]) free(sensorbuffer[i]);
+    if(first) free(first);
+    if(second) free(second);
+  }
+protected:
+  virtual bool initIntern(){
+    csensornumber = rsensornumber*((int)conf.useId+(int)conf.useFirstD+(int)conf.useSecondD);
+    cmotornumber  = rmotornumber;
+    for(int i=0; i<buffersize; i++){
+      sensorbuffer[i] = (sensor*) malloc(sizeof(sensor) * rsensornumber);
+      for(int k=0; k < rsensornumber; k++) sensorbuffer[i][k]=0;
+    }
+    if(conf.useFirstD)  first  = (sensor*) malloc(sizeof(sensor) * rsensornumber);
+    if(conf.useSecondD) second = (sensor*) malloc(sizeof(sensor) * rsensornumber);
+    return true;
+  }
+  virtual bool wireSensorsIntern(const sensor* rsensors, int rsensornumber,
+                                 sensor* csensors, int csensornumber, double noise){
+    int index = (time) % buffersize;
+    int lastIndex = (time-1) % buffersize;
+    if(conf.useFirstD || conf.useSecondD){
+      for(int i=0; i < rsensornumber; i++ ){
+        sensorbuffer[index][i] = (1-conf.eps)*sensorbuffer[lastIndex][i] + conf.eps*rsensors[i];
+      }
+    }
+    if(conf.useId) memcpy(csensors, rsensors, sizeof(sensor) * rsensornumber);
+    if(conf.useFirstD) {
+      sensor* t   = sensorbuffer[time%buffersize];
+      sensor* tm1 = sensorbuffer[(time-1)%buffersize];
+      for(int i=0; i < rsensornumber; i++) first[i] = conf.derivativeScale*(t[i] - tm1[i]);
+      memcpy(csensors+conf.useId*rsensornumber, first, sizeof(sensor) * rsensornumber);
+    }
+    if(conf.useSecondD) {
+      sensor* t   = sensorbuffer[time%buffersize];
+      sensor* tm1 = sensorbuffer[(time-1)%buffersize];
+      sensor* tm2 = sensorbuffer[(time-2)%buffersize];
+      for(int i=0; i < rsensornumber; i++)
+        second[i] = (t[i] - 2*tm1[i] + tm2[i])*conf.derivativeScale*conf.derivativeScale;
+      memcpy(csensors+(conf.useId + conf.useFirstD)*rsensornumber, second,
+             sizeof(sensor) * rsensornumber);
+    }
+    for(int i=0; i< rsensornumber; i++) csensors[i] = csensors[i] + noisevals[i];
+    time++;
+    return true;
+  }
+  virtual bool wireMotorsIntern(motor* rmotors, int rmotornumber,
+                                const motor* cmotors, int cmotornumber){
+    memcpy(rmotors, cmotors, sizeof(motor)*rmotornumber);
+    return true;
+  }
+
+  DerivativeWiringConf conf;
+  static const int buffersize=40;
+  int time;
+  sensor* sensorbuffer[buffersize];
+  sensor* first;
+  sensor* second;
+};
+
+/// sequence that allocates the intermediate buffers in every step
+class LegacyWiringSequence : public AbstractWiring {
+public:
+  LegacyWiringSequence(AbstractWiring* w1, AbstractWiring* w2) : AbstractWiring(0) {
+    wirings.push_back(w1);
+    wirings.push_back(w2);
+  }
+  virtual ~LegacyWiringSequence(){
+    for(size_t i=0; i<wirings.size(); i++) delete wirings[i];
+  }
+protected:
+  virtual bool initIntern(){
+    int snum = rsensornumber;
+    int mnum = rmotornumber;
+    for(size_t i=0; i<wirings.size(); i++){
+      wirings[i]->init(snum,mnum, randGen);
+      snum  = wirings[i]->getControllerSensornumber();
+      mnum  = wirings[i]->getControllerMotornumber();
+    }
+    csensornumber = snum;
+    cmotornumber  = mnum;
+    return true;
+  }
+  virtual bool wireSensorsIntern(const sensor* rsensors, int rsensornumber,
+                                 sensor* csensors, int csensornumber, double noiseStrength){
+    const sensor* inp = rsensors;
+    int inp_s = rsensornumber;
+    int num = wirings.size();
+    for(int i=0; i< num; i++){
+      int d = wirings[i]->getControllerSensornumber();
+      sensor* sensorbuf = (i==num-1) ? csensors : new sensor[d];
+      wirings[i]->wireSensors(inp, inp_s, sensorbuf, d, noiseStrength);
+      if(i!=0) delete[] inp;
+      inp   = sensorbuf;
+      inp_s = d;
+    }
+    return true;
+  }
+  virtual bool wireMotorsIntern(motor* rmotors, int rmotornumber,
+                                const motor* cmotors, int cmotornumber){
+    const motor* inp = cmotors;
+    int inp_s = cmotornumber;
+    int num = wirings.size();
+    for(int i=num-1; i>=0; i--){
+      int d = wirings[i]->getRobotMotornumber();
+      motor* motorbuf = (i==0) ? rmotors : new motor[d];
+      wirings[i]->wireMotors(motorbuf, d, inp, inp_s);
+      if(i!=num-1) delete[] inp;
+      inp   = motorbuf;
+      inp_s = d;
+    }
+    return true;
+  }
+  vector<AbstractWiring*> wirings;
+};
+
+/************ benchmark ************/
+
+static DerivativeWiringConf benchConf(){
+  DerivativeWiringConf c = DerivativeWiring::getDefaultConf();
+  c.useFirstD  = true;
+  c.useSecondD = true;
+  c.eps = 0.5;
+  c.derivativeScale = 5;
+  return c;
+}
+
+/// steps the wiring and returns the time per step in us; fills the outputs of all steps
+static double run(AbstractWiring* w, RandGen* randGen, int channels, int steps,
+                  vector<double>& out){
+  w->init(channels, channels, randGen);
+  int cs = w->getControllerSensornumber();
+  int cm = w->getControllerMotornumber();
+  // input patterns are precomputed to time only the wiring
+  const int patterns = 64;
+  vector<sensor> x((size_t)patterns*channels);
+  for(int p=0; p<patterns; p++)
+    for(int i=0; i<channels; i++) x[p*channels+i] = sin(0.1*p + i);
+  vector<sensor> xc(cs);
+  vector<motor>  yc(cm);
+  vector<motor>  y(channels);
+  out.resize((size_t)steps*(cs+channels));
+  double start = timeInUs();
+  for(int t=0; t<steps; t++){
+    w->wireSensors(&x[(t%patterns)*channels], channels, xc.data(), cs, 0.05);
+    for(int i=0; i<cm; i++) yc[i] = 0.5*xc[i];
+    w->wireMotors(y.data(), channels, yc.data(), cm);
+    memcpy(&out[(size_t)t*(cs+channels)], xc.data(), sizeof(double)*cs);
+    memcpy(&out[(size_t)t*(cs+channels)+cs], y.data(), sizeof(double)*channels);
+  }
+  return (timeInUs()-start)/steps;
+}
+
+enum NoiseMode { NoNoiseMode, Noise48, NoisePhilox };
+static const char* modeNames[] = { "no noise", "noise", "philox" };
+
+static bool bench(int channels, int steps, NoiseMode mode){
+  RandGen r1, r2;
+  if(mode == NoisePhilox){
+    r1.initCounterBased(1234);
+    r2.initCounterBased(1234);
+  }else{
+    r1.init(1234);
+    r2.init(1234);
+  }
+  bool noise = mode != NoNoiseMode;
+  // the counter based generator fills normal noise with both Box-Muller
+  //  branches, so only uniform noise is comparable to the previous version
+  AbstractWiring* legacy = new LegacyWiringSequence(
+      new LegacyDerivativeWiring(benchConf(), noise ? (NoiseGenerator*)new LegacyUniformNoise()
+                                                     : new LegacyNoNoise()),
+      new One2OneWiring(!noise ? (NoiseGenerator*)new LegacyNoNoise()
+                        : mode == NoisePhilox ? (NoiseGenerator*)new LegacyUniformNoise()
+                        : new LegacyNormalNoise()));
+  AbstractWiring* current = new WiringSequence(
+      new DerivativeWiring(benchConf(), noise ? (NoiseGenerator*)new WhiteUniformNoise()
+                                               : new NoNoise()),
+      new One2OneWiring(!noise ? (NoiseGenerator*)new NoNoise()
+                        : mode == NoisePhilox ? (NoiseGenerator*)new WhiteUniformNoise()
+                        : new WhiteNormalNoise()));
+  vector<double> outL, outC;
+  double tl = run(legacy,  &r1, channels, steps, outL);
+  double tc = run(current, &r2, channels, steps, outC);
+  bool same = outL == outC;
+  printf("%5i channels %-8s: previous %8.2f us/step  flattened %8.2f us/step  speedup %5.2f  %s\n",
+         channels, modeNames[mode], tl, tc, tl/tc, same ? "identical" : "MISMATCH");
+  delete legacy;
+  delete current;
+  return same;
+}
+
+int main(int argc, char** argv){
+  int steps    = 20000;
+  int channels = 0;
+  for(int i=1; i<argc-1; i++){
+    if(strcmp(argv[i],"-s")==0) steps    = atoi(argv[i+1]);
+    if(strcmp(argv[i],"-c")==0) channels = atoi(argv[i+1]);
+  }
+  bool ok = true;
+  int cs[] = {10, 20, 50, 100, 200, 500};
+  int n = sizeof(cs)/sizeof(int);
+  if(channels>0){
+    cs[0] = channels;
+    n = 1;
+  }
+  for(int m=NoNoiseMode; m<=NoisePhilox; m++)
+    for(int i=0; i<n; i++)
+      ok &= bench(cs[i], steps, (NoiseMode)m);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "selectionanalysation.h"
+#include <algorithm>
+
+SelectionAnalysation::SelectionAnalysation()
+  : selected(0), analysed(false),
+    avg(0), min(0), max(0), median(0), q1(0), q3(0), w1(0), w3(0), best(0) {
+}
+
+void SelectionAnalysation::setValues(const std::vector<double>& values){
+  buffer.assign(values.begin(), values.end());
+  analysed = false;
+}
+
+void SelectionAnalysation::setValues(const double* values, int len){
+  buffer.assign(values, values + len);
+  analysed = false;
+}
+
+void SelectionAnalysation::clear(){
+  buffer.clear();
+  analysed = false;
+}
+
+double SelectionAnalysation::select(int k){
+  // elements [0,selected) are already in place, so we only need to look behind
+  std::nth_element(buffer.begin() + selected, buffer.begin() + k, buffer.end());
+  selected = k;
+  return buffer[k];
+}
+
+double SelectionAnalysation::orderStatistic(int k, bool even){
+  if(even && k > 0){
+    // the element below k is the maximum of the left partition
+    double upper = select(k);
+    double lower = *std::max_element(buffer.begin(), buffer.begin() + k);
+    return (upper + lower) * 0.5;
+  }
+  return select(k);
+}
+
+void SelectionAnalysation::analyse(double factor){
+  int n = buffer.size();
+  if(n == 0){
+    avg = min = max = median = q1 = q3 = w1 = w3 = best = 0;
+    analysed = true;
+    return;
+  }
+
+  // linear pass: min, max, avg
+  double sum = 0;
+  min = max = buffer[0];
+  for(int i = 0; i < n; i++){
+    double v = buffer[i];
+    sum += v;
+    if(v < min) min = v;
+    if(v > max) max = v;
+  }
+  avg = sum / n;
+
+  // quartils and median with the same index rules as TemplateValueAnalysation
+  selected = 0;
+  q1     = orderStatistic(n/4,   n % 4 == 0);
+  median = orderStatistic(n/2,   n % 2 == 0);
+  q3     = orderStatistic(n*3/4, n % 4 == 0);
+
+  // whiskers and best: linear passes
+  double dW     = (q3 - q1) * factor;
+  double border1 = q1 - dW;
+  double border3 = q3 + dW;
+  bool found1 = false, found3 = false, foundPos = false, foundNeg = false;
+  double h = 0, l = 0;
+  for(int i = 0; i < n; i++){
+    double v = buffer[i];
+    if(!(v < border1) && (!found1 || v < w1)) { w1 = v; found1 = true; }
+    if(v < border3 && (!found3 || v > w3))   { w3 = v; found3 = true; }
+    if(!(v < 0) && (!foundPos || v < h))     { h = v;  foundPos = true; }
+    if(v < 0 && (!foundNeg || v > l))        { l = v;  foundNeg = true; }
+  }
+  if(!found1) w1 = 0;
+  if(!found3) w3 = min;
+  if(!foundPos) h = max;
+  if(!foundNeg) l = min;
+  best = (h < -l) ? h : l;
+
+  analysed = true;
+}
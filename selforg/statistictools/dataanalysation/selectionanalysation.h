@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SELECTIONANALYSATION_H_
+#define SELECTIONANALYSATION_H_
+
+#include <vector>
+
+/**
+ * Calculates the same statistical values like DOUBLE_ANALYSATION_CONTEXT
+ * (TemplateValueAnalysation<double>) for a set of doubles, but without sorting
+ * the whole set. The needed order statistics are found with selection
+ * (std::nth_element), everything else with linear passes, so one update is O(n).
+ * The internal buffer is reused, so there is no allocation if the size of the set
+ * does not grow.
+ *
+ * Usage: fill the set with setValues() or clear()/add() and call analyse() once,
+ * then read the values with the getters.
+ */
+class SelectionAnalysation {
+public:
+  SelectionAnalysation();
+
+  /// replaces the set by the given values
+  void setValues(const std::vector<double>& values);
+  /// replaces the set by the given values
+  void setValues(const double* values, int len);
+  /// removes all values (keeps the memory)
+  void clear();
+  /// adds a value to the set
+  void add(double value) { buffer.push_back(value); analysed = false; }
+  /// number of values in the set
+  int size() const { return buffer.size(); }
+
+  /** calculates all values.
+      @param factor the factor for the whisker distance (normally 1.5)
+   */
+  void analyse(double factor = 1.5);
+
+  double getAvg() const     { return avg; }
+  double getMin() const     { return min; }
+  double getMax() const     { return max; }
+  double getRange() const   { return max - min; }
+  double getMedian() const  { return median; }
+  double getQuartil1() const { return q1; }
+  double getQuartil3() const { return q3; }
+  double getIQR() const     { return q3 - q1; }
+  /// lowest value inside the whisker distance below Q1
+  double getWhisker1() const { return w1; }
+  /// highest value inside the whisker distance above Q3
+  double getWhisker3() const { return w3; }
+  /// the value which is next to zero
+  double getBest() const    { return best; }
+
+protected:
+  /// the element of rank k (0-based) in the sorted set; ranks must be requested ascending
+  double select(int k);
+  /// value at position k of the sorted set, or the mean of positions k and k-1 if even
+  double orderStatistic(int k, bool even);
+
+  std::vector<double> buffer;
+  int selected; ///< all ranks below are already partitioned
+  bool analysed;
+
+  double avg, min, max, median, q1, q3, w1, w3, best;
+};
+
+#endif /* SELECTIONANALYSATION_H_ */
@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "hashedhistogram.h"
+#include <cmath>
+#include <assert.h>
+
+// table of c*log(c) for small counts, which are by far the most frequent
+#define CLOGC_TABLE 1024
+struct CLogCTable {
+  CLogCTable(){
+    values[0] = 0;
+    for(int c = 1; c < CLOGC_TABLE; c++) values[c] = c * log((double)c);
+  }
+  double values[CLOGC_TABLE];
+};
+
+double HashedHistogram::cLogC(long c){
+  static const CLogCTable table;
+  if(c >= 0 && c < CLOGC_TABLE) return table.values[c];
+  return c * log((double)c);
+}
+
+const uint64_t HashedHistogram::Empty;
+
+// mixing function (finalizer of MurmurHash3), bins are usually consecutive numbers
+static inline size_t hashBin(uint64_t k){
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return (size_t)k;
+}
+
+HashedHistogram::HashedHistogram(size_t initialCapacity){
+  size_t cap = 16;
+  while(cap < 2*initialCapacity) cap *= 2;
+  keys.assign(cap, Empty);
+  counts.assign(cap, 0);
+  mask     = cap - 1;
+  occupied = 0;
+  total    = 0;
+  sumCLogC = 0;
+}
+
+void HashedHistogram::clear(){
+  keys.assign(keys.size(), Empty);
+  counts.assign(counts.size(), 0);
+  occupied = 0;
+  total    = 0;
+  sumCLogC = 0;
+}
+
+size_t HashedHistogram::find(uint64_t bin) const {
+  size_t i = hashBin(bin) & mask;
+  while(keys[i] != bin && keys[i] != Empty){
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+void HashedHistogram::grow(){
+  std::vector<uint64_t> oldkeys;
+  std::vector<long> oldcounts;
+  oldkeys.swap(keys);
+  oldcounts.swap(counts);
+  keys.assign(2*oldkeys.size(), Empty);
+  counts.assign(2*oldkeys.size(), 0);
+  mask = keys.size() - 1;
+  for(size_t j = 0; j < oldkeys.size(); j++){
+    if(oldkeys[j] == Empty) continue;
+    size_t i = find(oldkeys[j]);
+    keys[i]   = oldkeys[j];
+    counts[i] = oldcounts[j];
+  }
+}
+
+long HashedHistogram::add(uint64_t bin, long inc){
+  assert(bin != Empty);
+  size_t i = find(bin);
+  if(keys[i] == Empty){
+    if(2*(occupied + 1) > keys.size()){ // keep load factor below 1/2
+      grow();
+      i = find(bin);
+    }
+    keys[i] = bin;
+    occupied++;
+  }
+  long c = counts[i];
+  assert(c + inc >= 0);
+  sumCLogC += cLogC(c + inc) - cLogC(c);
+  counts[i] = c + inc;
+  total    += inc;
+  return c + inc;
+}
+
+long HashedHistogram::get(uint64_t bin) const {
+  size_t i = find(bin);
+  return keys[i] == Empty ? 0 : counts[i];
+}
+
+size_t HashedHistogram::getMemory() const {
+  return sizeof(*this) + keys.capacity()*sizeof(uint64_t) + counts.capacity()*sizeof(long);
+}
+
+double HashedHistogram::getEntropy() const {
+  if(total <= 0) return 0;
+  // H = - sum c/N log(c/N) = log(N) - 1/N sum c log(c)
+  return log((double)total) - sumCLogC / total;
+}
+
+double HashedHistogram::computeEntropy(){
+  sumCLogC = 0;
+  for(size_t i = 0; i < keys.size(); i++){
+    if(keys[i] != Empty) sumCLogC += cLogC(counts[i]);
+  }
+  return getEntropy();
+}
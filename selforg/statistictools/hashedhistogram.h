@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __HASHEDHISTOGRAM_H
+#define __HASHEDHISTOGRAM_H
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Histogram (frequency table) over a large, sparsely occupied space of bins.
+ * The counts are stored in an open addressing hash table (linear probing),
+ * so the memory scales with the number of occupied bins and not with
+ * the number of possible bins (e.g. numberBins^historysize).
+ *
+ * The sum over c*log(c) of all counts c is updated with every add(),
+ * which gives the entropy of the histogram in O(1) (@see getEntropy()).
+ */
+class HashedHistogram {
+public:
+  /// @param initialCapacity expected number of occupied bins
+  HashedHistogram(size_t initialCapacity = 64);
+
+  /// removes all counts (the memory is kept)
+  void clear();
+
+  /** increases the count of the bin by inc (which may be negative, the
+      count must not become negative).
+      @return the new count */
+  long add(uint64_t bin, long inc = 1);
+
+  /// count of the given bin (0 if not occupied)
+  long get(uint64_t bin) const;
+
+  /// sum of all counts
+  long getTotal() const { return total; }
+  /// number of occupied bins (a bin keeps its slot if its count drops to 0)
+  size_t getOccupied() const { return occupied; }
+  /// memory used by the table in bytes
+  size_t getMemory() const;
+
+  /// Shannon entropy (in nats) of the distribution given by the counts
+  double getEntropy() const;
+  /// sum over c*log(c) of all counts c
+  double getSumCLogC() const { return sumCLogC; }
+
+  /// calls f(bin, count) for all occupied bins (in no particular order)
+  template<typename F> void forEach(F f) const {
+    for(size_t i = 0; i < keys.size(); i++){
+      if(keys[i] != Empty) f(keys[i], counts[i]);
+    }
+  }
+
+  /// recomputes the entropy from all bins (to check or to remove rounding errors)
+  double computeEntropy();
+
+  /// c*log(c) with 0*log(0) = 0
+  static double cLogC(long c);
+
+protected:
+  static const uint64_t Empty = ~uint64_t(0);
+
+  size_t find(uint64_t bin) const;
+  void grow();
+
+  std::vector<uint64_t> keys;
+  std::vector<long> counts;
+  size_t mask;
+  size_t occupied;
+  long total;
+  double sumCLogC;
+};
+
+#endif
@@ -25,18 +25,18 @@
 
 
 #include "discretisizer.h"
-#include "sparsearray.h"
 #include <cmath>
 #include "stl_adds.h"
 #include <assert.h>
 #include <cstdlib>
 
 
-ComplexMeasure::ComplexMeasure( const char* measureName, ComplexMeasureMode mode, int numberBins ) : AbstractMeasure( measureName ), mode( mode ), numberBins( numberBins ), historyIndexList(0), F(0)
+ComplexMeasure::ComplexMeasure( const char* measureName, ComplexMeasureMode mode, int numberBins ) : AbstractMeasure( measureName ), mode( mode ), numberBins( numberBins ), historyIndexList(0)
 {
   historySize=2;
   historyIndex=-1;
-  binNumberHistory = ( int* ) malloc( sizeof( double ) * historySize );
+  fSize=0;
+  binNumberHistory = ( uint64_t* ) malloc( sizeof( uint64_t ) * historySize );
 }
 
 
@@ -58,13 +58,13 @@ void ComplexMeasure::step()
 {
   /*if (actualStep%1000==0)
   {
-    std::cout << "Size of F = " << (float)F.getRealSize() /1024 << " kbytes";
-    std::cout << " (instead of " << sizeof(int) * F.size() / 1024 << " kbytes for an array of size " << F.size() << ")" << std::endl;
+    std::cout << "Size of F = " << (float)F.getMemory() /1024 << " kbytes";
+    std::cout << " (instead of " << sizeof(int) * fSize / 1024 << " kbytes for an array of size " << fSize << ")" << std::endl;
   }*/
   if (observedValueList.size()==0)
     return;
-  int valNumber = 0;
-  int binNumber=0;
+  uint64_t binFactor = 1;
+  uint64_t binNumber = 0;
   std::list<Discretisizer*>::iterator di = discretisizerList.begin();
   std::list<int> binList;
   switch (mode)
@@ -82,7 +82,8 @@ void ComplexMeasure::step()
   default: // ENT, ENTSLOW
     FOREACH( std::list<double*>, observedValueList, oValue )
     {
-      binNumber += (int) pow( numberBins,valNumber++)* ( *di ) ->getBinNumber( *(*oValue));
+      binNumber += binFactor * ( *di ) ->getBinNumber( *(*oValue));
+      binFactor *= numberBins;
       di++;
     }
     break;
@@ -93,12 +94,10 @@ void ComplexMeasure::step()
   {
   case ENT:
     updateEntropy( binNumber );
-    // now make update of F
-    F[ binNumber ] = F[ binNumber ] +1;
     break;
   case ENTSLOW:
     //  case ENT:
-    F[ binNumber ] = F[binNumber]+1;
+    F.add( binNumber );
     computeEntropy();
     break;
   case MI:
@@ -131,13 +130,11 @@ void ComplexMeasure::calculatePInf()
 {
   // calculate PI
   double val = 0.0;
-  for ( int i = 0; i < fSize;i++ )
-  {
-    if ( F[ i ] > 0 )
-    {
-      val += (((double)F[ i ])/((double)actualStep)) * log(((double) F[ i ]) /((double)actualStep));
-    }
-  }
+  double t   = actualStep;
+  F.forEach([&val, t](uint64_t, long f){
+      if ( f > 0 )
+        val += (f / t) * log(f / t);
+    });
   value = -val;
 }
 
@@ -150,46 +147,30 @@ void ComplexMeasure::addObservable(double& observedValue,double minValue, double
 }
 
 
-void ComplexMeasure::updateEntropy( int binNumber )
+void ComplexMeasure::updateEntropy( uint64_t binNumber )
 {
-  // calculate dS
-  double dS = 0;
-  double val = F[ binNumber ];
-  double t = actualStep;
-  if ( val > 0 )
-  { // calculating log(0) is not smart ;)
-    dS = (- val * log(val)) + ((val+1) * log(val+1));
-  }
-  // update Entropy with old Entropy and dS
-  if (actualStep>1)
-  {
-    value= - ((1./t) * (((value - log(t-1.))*(t-1.)) + dS)) + log(t);
-  }
+  // F keeps sum F[i] log F[i] up to date (dS = (val+1) log(val+1) - val log(val)),
+  // so the entropy log(t) - 1/t sum F[i] log F[i] is available in O(1)
+  F.add( binNumber );
+  value = F.getEntropy();
 }
 
 
 void ComplexMeasure::computeEntropy()
 {
-  // calculate Entropy = - sum {from forall i in F} log F[i]
-  double val = 0.0;
-  for ( int i = 0; i < fSize;i++ )
-  {
-    if ( F[ i ] > 0 )
-    {
-      val += (((double)F[ i ])/((double)actualStep)) * log(((double) F[ i ]) /((double)actualStep));
-    }
-  }
-  value = -val;
+  // calculate Entropy = - sum {from forall i in F} log F[i] (only occupied bins)
+  value = F.computeEntropy();
 }
 
 
 void ComplexMeasure::initF()
 {
-  // determine fSize
+  // determine fSize (only informative, F grows with the occupied bins)
+  fSize = 1;
+  for (unsigned int i = 0; i < observedValueList.size(); i++)
+    fSize *= numberBins;
   if (mode==MI)
-    fSize = (int) pow( numberBins, observedValueList.size() ) + (historyIndexNumber+1) * numberBins;
-  else
-    fSize = (int) pow( numberBins, observedValueList.size() );
-  F.reallocate(fSize);
+    fSize += (historyIndexNumber+1) * numberBins;
+  F.clear();
 }
 
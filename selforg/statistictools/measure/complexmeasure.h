@@ -27,7 +27,7 @@
 #include "abstractmeasure.h"
 #include <list>
 
-#include "sparsearray.h"
+#include "hashedhistogram.h"
 
 /** measure modes of complex measures.
  */
@@ -87,17 +87,17 @@ ComplexMeasure( const char* measureName, ComplexMeasureMode mode, int numberBins
   std::list<Discretisizer*> discretisizerList; // stores the Discretisizer
   ComplexMeasureMode mode;
   int numberBins;
-  long fSize; // size of F
+  long fSize; // number of possible bins of F
   int historySize; // size of binNumberHistory
 //  int *F; // stores the frequencies as a linear vector
-  int *binNumberHistory; // holds the binNumbers as an history, for predictive information 2 values are enough
+  uint64_t *binNumberHistory; // holds the binNumbers as an history, for predictive information 2 values are enough
   int historyIndex; // index of last stored value
   int *historyIndexList; // indexes of relevant stored values
   int historyIndexNumber; // number of indexes stored in historyIndexList
   int historyInterval; // interval between two different histoy indexes
 
-  // new: use SparseArray backed by HashMap instead of normal array
-  matrix::SparseArray<long, int> F;
+  // hashed histogram: memory scales with the occupied bins, not with fSize
+  HashedHistogram F;
     // calculation methods
 
       /**
@@ -107,13 +107,13 @@ ComplexMeasure( const char* measureName, ComplexMeasureMode mode, int numberBins
 
 
     /**
-     * updates the entropy. uses update rule with O(1) costs
+     * updates F and the entropy. uses update rule with O(1) costs
      * @param binNumber the bin number
      */
-    void updateEntropy( int binNumber);
+    void updateEntropy( uint64_t binNumber);
 
     /**
-     * computes the entropy. uses the normal rule with O(m*n*o) costs
+     * computes the entropy. uses the normal rule with O(occupied bins) costs
      */
     void computeEntropy();
 
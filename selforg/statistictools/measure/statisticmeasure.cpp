@@ -23,15 +23,15 @@
  ***************************************************************************/
 
 #include "statisticmeasure.h"
+#include "statisticsengine.h"
 #include <iostream>
-#include "stl_adds.h"
-#include "assert.h"
-#include <cmath>
 #include <cstdlib>
 
-StatisticMeasure::StatisticMeasure(double& observedValue, const char* measureName, MeasureMode mode, long stepSpan, double additionalParam) : AbstractMeasure(measureName), observedValue(observedValue), mode(mode), stepSpan(stepSpan), additionalParam(additionalParam)
+StatisticMeasure::StatisticMeasure(double& observedValue, const char* measureName, MeasureMode mode, long stepSpan, double additionalParam,
+                                   StatisticsEngine* engine)
+  : AbstractMeasure(measureName), observedValue(observedValue), mode(mode), stepSpan(stepSpan), additionalParam(additionalParam),
+    engine(engine), ownEngine(engine==0)
 {
-  internInit();
   /// use this section for defining individual constructor commands
   switch(mode)
   {
@@ -43,158 +43,27 @@ StatisticMeasure::StatisticMeasure(double& observedValue, const char* measureNam
       std::cout << "Program terminated. Please correct this error in main.cpp (or wherever) first." << std::endl;
       exit(-1);
     }
-    this->stepsReached=0;
     break;
   default: // not defined
     break;
   }
+  if (ownEngine)
+    this->engine = new StatisticsEngine();
+  // the engine advances actualStep and honours the step size
+  this->engine->add(&observedValue, &value, mode, stepSpan, additionalParam, &actualStep, &stepSize);
 }
 
-void StatisticMeasure::internInit() {
-  oldestStepIndex=0;
-  newestStepIndex=stepSpan-1;
-  if (stepSpan>0)
-  {
-    this->valueHistory = (double*) malloc(sizeof(double) * stepSpan);
-    // set all values to 0
-    for (int i=0;i<stepSpan;i++)
-      this->valueHistory[i]=0;
-  }
-}
-
-
-
-void StatisticMeasure::step()
-{
-  // update the variable value from observedValue
-  switch(mode)
-  {
-  case ID: // return observed value itself
-    value=observedValue;
-    break;
-  case AVG:
-    value=calculateAverageValue();
-    break;
-  case MOVAVG:
-    value=calculateMovingAverageValue();
-    break;
-  case PEAK:
-    if (observedValue>additionalParam)
-      value=observedValue-additionalParam;
-    else
-      value=0;
-    break;
-  case MAX:
-    if (observedValue>value) // TODO: include history
-      value=observedValue;
-    break;
-  case MIN:
-    if (observedValue<value) // TODO: include history
-      value=observedValue;
-    break;
-  case SUM:
-    value=calculateSumValue();
-    break;
-  case CONV:
-    value=testConvergence();
-    break;
-  case STEPDIFF:
-    value=calculateStepDifference();
-    break;
-  case NORMSTEPDIFF:
-    value=calculateNormalizedStepDifference();
-    break;    
-  default: // not defined
-    break;
-  }
-  if (stepSpan>0)
-  {
-    // store new value in history, the position is oldestStepIndex
-    valueHistory[oldestStepIndex]=observedValue;
-    newestStepIndex=oldestStepIndex;
-    if (oldestStepIndex==(stepSpan-1))
-      oldestStepIndex=0;
-    else
-      oldestStepIndex++;
-  }
-  actualStep++;
-}
-
-double StatisticMeasure::testConvergence() {
-  if ((fabs(observedValue-valueHistory[newestStepIndex])<additionalParam) &&
-      (fabs(observedValue-valueHistory[oldestStepIndex])<additionalParam)) {
-    if (stepsReached<stepSpan)
-      stepsReached++;
-    if (stepsReached==stepSpan)
-      return 1.0;
-  } else {
-    stepsReached=0;
-  }
-  return 0.0;
-}
-
-
-double StatisticMeasure::calculateSumValue()
-{
-  double newsum=this->value;
-  if (stepSpan==0)
-  {
-    value+=observedValue;
-  }
-  else
-  {
-    // first: subtrate oldestVal from value
-    newsum -= valueHistory[oldestStepIndex];
-    // add observedValue to value
-    newsum += observedValue;
-  }
-  return newsum;
-}
-
-
-double StatisticMeasure::calculateAverageValue()
-{
-  double newavg=this->value;
-  if (stepSpan==0) {
-    // use update rule
-  }
-  else
-  {
-    // first: subtrate 1/stepSpan*oldestVal from value
-    newavg -= valueHistory[oldestStepIndex]/stepSpan;
-    // add 1/stepSpan*observedValue to value
-    newavg += observedValue/stepSpan;
-  }
-  return newavg;
-}
-
-double StatisticMeasure::calculateMovingAverageValue()
+StatisticMeasure::~StatisticMeasure()
 {
-  double newavg=this->value;
-  if (stepSpan==0) {
-    //
-  }
+  if (ownEngine)
+    delete engine;
   else
-  {
-    newavg += (observedValue - newavg)/stepSpan;
-  }
-  return newavg;
-}
-
-double StatisticMeasure::calculateStepDifference()
-{
-  if (actualStep>0) {
-    return (observedValue - valueHistory[newestStepIndex]);
-  } else
-    return 0;
+    engine->remove(&value);
 }
 
-double StatisticMeasure::calculateNormalizedStepDifference()
+void StatisticMeasure::step()
 {
-  if (actualStep>0) {
-    return (observedValue - valueHistory[newestStepIndex])*actualStep;
-  } else
-    return 0;
+  // a shared engine is stepped by its owner (e.g. StatisticTools)
+  if (ownEngine)
+    engine->step();
 }
-
-
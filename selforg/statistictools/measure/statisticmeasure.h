@@ -27,56 +27,37 @@
 #include "abstractmeasure.h"
 #include "measuremodes.h"
 
+class StatisticsEngine;
+
 /**
  * Class used by StatisticTools.
- * Provides
+ * Provides the statistic of one observed value (@see MeasureMode).
+ * The calculation is done by a StatisticsEngine, which is either shared
+ * (e.g. the one of StatisticTools, which steps all its measures at once)
+ * or owned by the measure, in which case step() updates the value.
  */
 class StatisticMeasure : public AbstractMeasure
 {
 
 public:
-  StatisticMeasure(double& observedValue, const char* measureName, MeasureMode mode, long stepSpan, double additionalParam);
+  StatisticMeasure(double& observedValue, const char* measureName, MeasureMode mode, long stepSpan, double additionalParam,
+                   StatisticsEngine* engine = 0);
 
-  virtual ~StatisticMeasure() {}
+  virtual ~StatisticMeasure();
 
   virtual void step();
 
+  /// returns the engine which calculates the value of this measure
+  virtual StatisticsEngine* getEngine() const { return engine; }
+
 protected:
   double& observedValue; // the observed value from which the statistic is made
   MeasureMode mode; // the MeasureMode, e.g. ID, AVG, MED, PEAK, CONV,...
-  long stepSpan; // determines the size of valueHistory
+  long stepSpan; // window size of the statistic (0: all steps)
   double additionalParam;
-  long oldestStepIndex; // indicates the index number in the valueHistory, which was the oldest step
-  long newestStepIndex; // indicates the index number with the newest value, this is the oldestStepIndex one step before
-
-  double* valueHistory;
-
-  void internInit();
-
-
-  /**************************************************************************************************/
-  /* all the functions for calculating the values are below this line, add new variables if needed  */
-
-  virtual double calculateSumValue();
-
-  virtual double calculateAverageValue();
-
-  virtual double calculateMovingAverageValue();
-
-  virtual double calculateStepDifference();
-
-  virtual double calculateNormalizedStepDifference();
-
-  /* BEGIN convergence SECTION */
-  virtual double testConvergence();
-  // stores how much steps the convergence is reached,
-  // if stepsReached==stepSpan, convergence criteria is 1, otherwise 0
-  long stepsReached;
-  /* END convergence SECTION */
-
-
-
 
+  StatisticsEngine* engine;
+  bool ownEngine; // true if engine was created by this measure
 };
 
 #endif
@@ -47,8 +47,8 @@
 
 
 /** measure modes of statistical types. If you add a measure mode, you have
- *  naturally to implement this measuremode in statisticmeasure.cpp -
- *  see method StatisticMeasure::step() !
+ *  naturally to implement this measuremode in statisticsengine.cpp -
+ *  see method StatisticsEngine::stepGroup() !
  */
 enum MeasureMode {
          /// returns the value to observe itself
@@ -59,9 +59,9 @@ enum MeasureMode {
                 MOVAVG,
         /// returns the median value
                 MED,
-        /// returns the minimum value
+        /// returns the minimum value (over all steps or the last stepSpan steps)
                 MIN,
-        /// returns the maximum value
+        /// returns the maximum value (over all steps or the last stepSpan steps)
                 MAX,
         /// returns only values above defined limit
                 PEAK,
@@ -74,7 +74,11 @@ enum MeasureMode {
     /// returns the difference between two successive steps
         STEPDIFF,
     /// returns the difference between two successive steps, normalized with number of steps
-    NORMSTEPDIFF
+    NORMSTEPDIFF,
+    /// returns the variance (over all steps or the last stepSpan steps)
+    VAR,
+    /// returns the standard deviation (over all steps or the last stepSpan steps)
+    STD
 };
 
 #endif
@@ -0,0 +1,242 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "statisticsengine.h"
+#include <cmath>
+#include <algorithm>
+
+StatisticsEngine::StatisticsEngine() {
+}
+
+void StatisticsEngine::add(const double* observed, double* result, MeasureMode mode, long stepSpan,
+                           double additionalParam, long* actualStep, const int* stepSize) {
+  Column c;
+  c.observed = observed;
+  c.result   = result;
+  c.span     = std::max(stepSpan, 0l);
+  c.param    = additionalParam;
+  c.actualStep = actualStep;
+  c.stepSize = stepSize;
+  c.n        = 0;
+  c.prev     = 0;
+  c.mean     = 0;
+  c.m2       = 0;
+  c.count    = 0;
+  c.hist     = history.size();
+  c.dq       = deque.size();
+  c.dqHead   = 0;
+  c.dqSize   = 0;
+  history.resize(history.size() + c.span, 0.0);
+  if(mode == MIN || mode == MAX)
+    deque.resize(deque.size() + c.span, 0);
+  *result = 0;
+  groups[mode].push_back(c);
+}
+
+void StatisticsEngine::remove(const double* result) {
+  for(int m = 0; m < NumberModes; m++){
+    for(std::vector<Column>::iterator c = groups[m].begin(); c != groups[m].end(); c++){
+      if(c->result == result){
+        // free the window and the deque, the columns behind them move down
+        size_t hist = c->hist, histLen = c->span;
+        size_t dq = c->dq, dqLen = (m == MIN || m == MAX) ? c->span : 0;
+        groups[m].erase(c);
+        history.erase(history.begin() + hist, history.begin() + hist + histLen);
+        deque.erase(deque.begin() + dq, deque.begin() + dq + dqLen);
+        for(int k = 0; k < NumberModes; k++){
+          for(std::vector<Column>::iterator o = groups[k].begin(); o != groups[k].end(); o++){
+            if(o->hist > hist) o->hist -= histLen;
+            if(o->dq > dq) o->dq -= dqLen;
+          }
+        }
+        return;
+      }
+    }
+  }
+}
+
+int StatisticsEngine::size() const {
+  int s = 0;
+  for(int m = 0; m < NumberModes; m++) s += groups[m].size();
+  return s;
+}
+
+void StatisticsEngine::step() {
+  for(int m = 0; m < NumberModes; m++){
+    if(!groups[m].empty())
+      stepGroup((MeasureMode)m, groups[m]);
+  }
+}
+
+bool StatisticsEngine::advance(Column& c) {
+  if(!c.actualStep)
+    return true;
+  long step = (*c.actualStep)++;
+  return !c.stepSize || *c.stepSize <= 1 || step % *c.stepSize == 0;
+}
+
+// pushes step n with value x to a monotonic deque (front holds the extremum)
+template <bool isMax>
+static inline double updateExtremum(long* dq, long& head, long& size, long span,
+                                    const double* window, long n, double x) {
+  // drop the step that leaves the window
+  if(size > 0 && dq[head] <= n - span){
+    head = (head + 1) % span;
+    size--;
+  }
+  while(size > 0){
+    double back = window[dq[(head + size - 1) % span] % span];
+    if(isMax ? back > x : back < x) break;
+    size--;
+  }
+  dq[(head + size) % span] = n;
+  size++;
+  return window[dq[head] % span];
+}
+
+void StatisticsEngine::stepGroup(MeasureMode mode, std::vector<Column>& columns) {
+  double* h = history.data();
+  long* dqs = deque.data();
+  const size_t num = columns.size();
+  Column* cs = columns.data();
+
+  switch(mode){
+  case ID:
+    for(size_t i = 0; i < num; i++){
+      if(!advance(cs[i])) continue;
+      *cs[i].result = *cs[i].observed;
+    }
+    break;
+  case PEAK:
+    for(size_t i = 0; i < num; i++){
+      if(!advance(cs[i])) continue;
+      double x = *cs[i].observed;
+      *cs[i].result = x > cs[i].param ? x - cs[i].param : 0;
+    }
+    break;
+  case AVG:
+  case SUM:
+    for(size_t i = 0; i < num; i++){
+      Column& c = cs[i];
+      if(!advance(c)) continue;
+      double x = *c.observed;
+      if(c.span == 0){
+        c.mean += (x - c.mean) / (c.n + 1);
+        *c.result = mode == AVG ? c.mean : c.mean * (c.n + 1);
+      } else { // window initialised with zeros, sum over window (/ stepSpan)
+        double* w = h + c.hist + c.n % c.span;
+        *c.result += mode == AVG ? (x - *w) / c.span : x - *w;
+        *w = x;
+      }
+      c.n++;
+    }
+    break;
+  case MOVAVG:
+    for(size_t i = 0; i < num; i++){
+      Column& c = cs[i];
+      if(!advance(c)) continue;
+      if(c.span > 0)
+        *c.result += (*c.observed - *c.result) / c.span;
+    }
+    break;
+  case MIN:
+  case MAX:
+    for(size_t i = 0; i < num; i++){
+      Column& c = cs[i];
+      if(!advance(c)) continue;
+      double x = *c.observed;
+      if(c.span == 0){
+        if(c.n == 0 || (mode == MAX ? x > *c.result : x < *c.result))
+          *c.result = x;
+      } else {
+        const double* window = h + c.hist;
+        h[c.hist + c.n % c.span] = x;
+        if(mode == MAX)
+          *c.result = updateExtremum<true>(dqs + c.dq, c.dqHead, c.dqSize, c.span, window, c.n, x);
+        else
+          *c.result = updateExtremum<false>(dqs + c.dq, c.dqHead, c.dqSize, c.span, window, c.n, x);
+      }
+      c.n++;
+    }
+    break;
+  case CONV:
+    for(size_t i = 0; i < num; i++){
+      Column& c = cs[i];
+      if(!advance(c)) continue;
+      double x = *c.observed;
+      double* w = h + c.hist + c.n % c.span; // oldest value of the window
+      if(fabs(x - c.prev) < c.param && fabs(x - *w) < c.param){
+        if(c.count < c.span) c.count++;
+      } else {
+        c.count = 0;
+      }
+      *c.result = c.count == c.span ? 1.0 : 0.0;
+      *w = x;
+      c.prev = x;
+      c.n++;
+    }
+    break;
+  case STEPDIFF:
+  case NORMSTEPDIFF:
+    for(size_t i = 0; i < num; i++){
+      Column& c = cs[i];
+      if(!advance(c)) continue;
+      double x = *c.observed;
+      if(c.n > 0)
+        *c.result = mode == STEPDIFF ? x - c.prev : (x - c.prev) * c.n;
+      c.prev = x;
+      c.n++;
+    }
+    break;
+  case VAR:
+  case STD:
+    for(size_t i = 0; i < num; i++){
+      Column& c = cs[i];
+      if(!advance(c)) continue;
+      double x = *c.observed;
+      long k;
+      if(c.span == 0 || c.n < c.span){ // Welford: add x
+        k = c.n + 1;
+        double delta = x - c.mean;
+        c.mean += delta / k;
+        c.m2   += delta * (x - c.mean);
+      } else { // replace the oldest value of the window by x
+        k = c.span;
+        double old     = h[c.hist + c.n % c.span];
+        double oldmean = c.mean;
+        c.mean += (x - old) / k;
+        c.m2   += (x - old) * (x - c.mean + old - oldmean);
+        if(c.m2 < 0) c.m2 = 0;
+      }
+      if(c.span > 0) h[c.hist + c.n % c.span] = x;
+      double var = k > 1 ? c.m2 / (k - 1) : 0;
+      *c.result = mode == VAR ? var : sqrt(var);
+      c.n++;
+    }
+    break;
+  default: // MED is not implemented
+    for(size_t i = 0; i < num; i++) advance(cs[i]);
+    break;
+  }
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef _STATISTICS_ENGINE_H
+#define _STATISTICS_ENGINE_H
+
+#include <vector>
+#include <cstddef>
+#include "measuremodes.h"
+
+/**
+ * Updates many statistic measures (@see MeasureMode) at once.
+ * The measures are stored as columns grouped by their mode, such that one
+ * step is a tight loop over all columns of a mode instead of one virtual
+ * call per measure. The windows of all measures share one history buffer.
+ *
+ * Windowed MIN and MAX use monotonic deques (O(1) amortised per step),
+ * VAR and STD use Welford's update (with removal of the oldest value for
+ * a window).
+ * The results are written directly to the given addresses, which are
+ * usually registered at an Inspectable (@see StatisticTools).
+ * A measure can have a step counter and a step size (@see AbstractMeasure):
+ * the counter is advanced in every step and the measure is only updated
+ * if the counter is a multiple of the step size.
+ */
+class StatisticsEngine {
+public:
+  StatisticsEngine();
+
+  /**
+   * adds a measure
+   * @param observed the observed value (read in every step)
+   * @param result where the measured value is written to
+   * @param mode the measure mode
+   * @param stepSpan size of the window (0: all steps)
+   * @param additionalParam limit for PEAK, epsilon for CONV
+   * @param actualStep step counter of the measure, advanced in every step (or 0)
+   * @param stepSize the measure is updated every stepSize steps (or 0 for every step)
+   */
+  void add(const double* observed, double* result, MeasureMode mode, long stepSpan,
+           double additionalParam = 0, long* actualStep = 0, const int* stepSize = 0);
+
+  /// removes the measure with the given result address and frees its window
+  void remove(const double* result);
+
+  /// updates all measures
+  void step();
+
+  /// number of measures
+  int size() const;
+
+protected:
+  struct Column {
+    const double* observed;
+    double* result;
+    long   span;
+    double param;
+    long*  actualStep; // step counter of the measure (or 0)
+    const int* stepSize; // step size of the measure (or 0)
+    long   n;      // number of observed steps
+    double prev;   // observed value of the previous step
+    double mean;   // (cumulative) mean
+    double m2;     // sum of squared differences from the mean (Welford)
+    long   count;  // CONV: number of steps the criterion is fulfilled
+    size_t hist;   // offset of the window in history
+    size_t dq;     // offset of the deque in deque
+    long   dqHead;
+    long   dqSize;
+  };
+
+  static const int NumberModes = STD + 1;
+
+  void stepGroup(MeasureMode mode, std::vector<Column>& columns);
+  /// advances the step counter, returns whether the column is updated in this step
+  static bool advance(Column& c);
+
+  std::vector<Column> groups[NumberModes];
+  std::vector<double> history; ///< windows (last stepSpan values) of all measures
+  std::vector<long> deque;     ///< monotonic deques (step numbers) of windowed MIN/MAX
+};
+
+#endif
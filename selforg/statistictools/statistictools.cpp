@@ -30,11 +30,14 @@ void StatisticTools::doOnCallBack(BackCaller* source, BackCaller::CallbackableTy
     // update all statistic measures
     if (beginMeasureCounter>0)
         beginMeasureCounter--;
-    else
-        for (std::list<AbstractMeasure*>::iterator i=activeMeasures.begin();i!=activeMeasures.end();i++) {
+    else {
+        engine.step();
+        for (std::list<AbstractMeasure*>::iterator i=steppedMeasures.begin();i!=steppedMeasures.end();i++) {
           if (((*i)->getActualStep())%((*i)->getStepSize())==0)
             (*i)->step();
         }
+        updates++;
+    }
 }
 
 double& StatisticTools::addMeasure(double& observedValue, const char* measureName, MeasureMode mode, long stepSpan, double additionalParam) {
@@ -43,7 +46,7 @@ double& StatisticTools::addMeasure(double& observedValue, const char* measureNam
 }
 
 StatisticMeasure* StatisticTools::getMeasure(double& observedValue, const char* measureName, MeasureMode mode, long stepSpan, double additionalParam) {
-    StatisticMeasure* newMeasure = new StatisticMeasure(observedValue, measureName, mode, stepSpan, additionalParam);
+    StatisticMeasure* newMeasure = new StatisticMeasure(observedValue, measureName, mode, stepSpan, additionalParam, &engine);
     this->activeMeasures.push_back(newMeasure);
           addInspectableValue(newMeasure->getName(),&newMeasure->getValueAddress(), "measure registered at "+ getNameOfInspectable());
   return newMeasure;
@@ -60,6 +63,10 @@ AbstractMeasure* StatisticTools::getMeasure(const std::string& measureName) cons
 
 double& StatisticTools::addMeasure(AbstractMeasure* measure) {
   this->activeMeasures.push_back(measure);
+  // measures of our engine are already updated by engine.step()
+  StatisticMeasure* sm = dynamic_cast<StatisticMeasure*>(measure);
+  if (!sm || sm->getEngine()!=&engine)
+    this->steppedMeasures.push_back(measure);
   addInspectableValue(measure->getName(),&measure->getValueAddress(), "measure registered at "+ getNameOfInspectable());
   return  measure->getValueAddress();
 }
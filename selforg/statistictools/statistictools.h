@@ -37,6 +37,8 @@ class ComplexMeasure;
 #include "measuremodes.h"
 #include "analysationmodes.h"
 #include "templatevalueanalysation.h"
+#include "selectionanalysation.h"
+#include "statisticsengine.h"
 
 #define GET_TYPE_ANALYSATION(type) getAnalysation<type,defaultZero,defaultLower<type>,defaultHigher<type>,defaultDoubleDiv<type>,defaultDoubleMul<type>,defaultAdd<type>,defaultSub<type>,defaultMul<type>,defaultDiv<type> >
 #define GET_DOUBLE_ANALYSATION GET_TYPE_ANALYSATION(double)
@@ -45,7 +47,7 @@ class ComplexMeasure;
 class StatisticTools : public Inspectable, public Callbackable {
 
 public:
-  StatisticTools(const std::string& name = "StatisticTools") : Inspectable(name), beginMeasureCounter(0) { }
+  StatisticTools(const std::string& name = "StatisticTools") : Inspectable(name), beginMeasureCounter(0), updates(0) { }
 
         /**
          * adds a variable to observe and measure the value
@@ -66,7 +68,9 @@ public:
 
   /**
    * Same as the method above, but instead of getting the calculated value back (the adress), you get
-   * the StatisticMeasure itself
+   * the StatisticMeasure itself.
+   * The measure is calculated by the StatisticsEngine of this object, which
+   * updates all such measures at once in doOnCallBack.
    */
   virtual StatisticMeasure* getMeasure(double& observedValue,const char* measureName, MeasureMode mode, long stepSpan, double additionalParam=0);
 
@@ -125,6 +129,12 @@ public:
    */
   virtual bool measureStarted() { return (beginMeasureCounter==0?true:false); }
 
+  /**
+   * Number of steps in which the measures were updated. Displays can compare
+   * it with the value of their last refresh and skip it if nothing changed.
+   */
+  long getUpdateCount() const { return updates; }
+
 
         /**
          * CALLBACKABLE INTERFACE
@@ -136,8 +146,11 @@ public:
 
 
 protected:
-        std::list<AbstractMeasure*> activeMeasures;
+        std::list<AbstractMeasure*> activeMeasures;  // all measures (for lookup)
+        std::list<AbstractMeasure*> steppedMeasures; // measures not calculated by engine
+        StatisticsEngine engine;
         long beginMeasureCounter;
+        long updates;
 };
 
 
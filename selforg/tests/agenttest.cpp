@@ -0,0 +1,160 @@
+/***************************************************************************
+                          agenttest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the sensor queue (latency) of the Agent
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/agent.h>
+#include <selforg/abstractrobot.h>
+#include <selforg/abstractcontroller.h>
+#include <selforg/one2onewiring.h>
+
+#include <vector>
+
+using namespace std;
+
+/// robot whose first sensor value is the number of the sensor frame (starting with 1)
+class CountingRobot : public AbstractRobot {
+public:
+  CountingRobot() : AbstractRobot("CountingRobot", "1.0"), frames(0) {}
+  virtual int getSensors(sensor* sensors, int sensornumber){
+    frames++;
+    for(int i = 0; i < sensornumber; i++) sensors[i] = frames * (i+1);
+    return sensornumber;
+  }
+  virtual void setMotors(const motor* motors, int motornumber) {}
+  virtual int getSensorNumber() { return 2; }
+  virtual int getMotorNumber() { return 1; }
+  virtual Position getPosition() const { return Position(0,0,0); }
+  virtual Position getSpeed() const { return Position(0,0,0); }
+  virtual Position getAngularSpeed() const { return Position(0,0,0); }
+  virtual matrix::Matrix getOrientation() const { return matrix::Matrix(3,3); }
+
+  int frames;
+};
+
+/// remembers the sensor frame it got in the last step
+class RecordingController : public AbstractController {
+public:
+  RecordingController() : AbstractController("Recording", "1.0"), seen(-1), consistent(true) {}
+  virtual void init(int sensornumber, int motornumber, RandGen* randGen = 0) {}
+  virtual int getSensorNumber() const { return 2; }
+  virtual int getMotorNumber() const { return 1; }
+  virtual void step(const sensor* sensors, int sensornumber, motor* motors, int motornumber){
+    stepNoLearning(sensors, sensornumber, motors, motornumber);
+  }
+  virtual void stepNoLearning(const sensor* sensors, int sensornumber, motor* motors, int motornumber){
+    seen = sensors[0];
+    // all sensors are from the same frame
+    consistent &= sensors[1] == 2*sensors[0];
+    motors[0] = 0;
+  }
+  virtual bool store(FILE* f) const { return true; }
+  virtual bool restore(FILE* f) { return true; }
+
+  double seen;
+  bool consistent;
+};
+
+/// agent with a counting robot and a recording controller
+Agent* createAgent(RecordingController*& controller, CountingRobot*& robot){
+  controller = new RecordingController();
+  robot = new CountingRobot();
+  Agent* agent = new Agent();
+  agent->init(controller, robot, new One2OneWiring(0), 1);
+  return agent;
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckLatency ) {
+  cout << "\n -[ Check sensor latency ]-\n";
+  for(int latency = 0; latency < 4; latency++){
+    RecordingController* c;
+    CountingRobot* r;
+    Agent* agent = createAgent(c, r);
+    agent->setLatency(latency);
+    unit_assert( "latency", agent->getLatency() == latency );
+    bool ok = true;
+    for(int t = 1; t <= 10; t++){
+      agent->step(0);
+      // the frames before the first one are the initial sensor values (0)
+      ok &= r->frames == t && c->seen == (t > latency ? t - latency : 0);
+    }
+    unit_assert( "frame from latency steps before", ok );
+    // pipelined: control before sense of the same step
+    for(int t = 11; t <= 15; t++){
+      agent->control(0);
+      agent->sense();
+      ok &= c->seen == (latency > 0 ? t - latency : t - 1);
+    }
+    unit_assert( "control before sense", ok && c->consistent );
+    delete agent;
+  }
+  unit_pass();
+}
+
+DEFINE_TEST( CheckDropOldest ) {
+  cout << "\n -[ Check bounded sensor queue ]-\n";
+  RecordingController* c;
+  CountingRobot* r;
+  Agent* agent = createAgent(c, r);
+  agent->setLatency(1);
+  // queue: initial frame, 1, 2 -> the initial frame is dropped
+  agent->sense();
+  agent->sense();
+  agent->control(0);
+  unit_assert( "oldest dropped", c->seen == 1 );
+  agent->control(0);
+  unit_assert( "next frame", c->seen == 2 );
+  // an empty queue uses the last frame again
+  agent->control(0);
+  unit_assert( "empty queue", c->seen == 2 );
+
+  agent->setLatency(0);
+  agent->sense();
+  agent->sense();
+  agent->sense();
+  agent->control(0);
+  unit_assert( "no latency: newest frame", c->seen == 5 && c->consistent );
+  delete agent;
+  unit_pass();
+}
+
+DEFINE_TEST( CheckSetLatency ) {
+  cout << "\n -[ Check changing the latency during a run ]-\n";
+  RecordingController* c;
+  CountingRobot* r;
+  Agent* agent = createAgent(c, r);
+  for(int t = 0; t < 5; t++) agent->step(0);
+  unit_assert( "no latency", c->seen == 5 );
+  // the queue is refilled with the last values
+  agent->setLatency(2);
+  vector<double> seen;
+  for(int t = 0; t < 4; t++){
+    agent->step(0);
+    seen.push_back(c->seen);
+  }
+  unit_assert( "refilled", seen[0] == 5 && seen[1] == 5 && seen[2] == 6 && seen[3] == 7 );
+  // reducing the latency starts with the last values as well
+  agent->setLatency(1);
+  agent->step(0);
+  unit_assert( "reduced", c->seen == 7 );
+  agent->step(0);
+  unit_assert( "reduced next", c->seen == 10 && c->consistent );
+  delete agent;
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Agent Tests" )
+  ADD_TEST( CheckLatency )
+  ADD_TEST( CheckDropOldest )
+  ADD_TEST( CheckSetLatency )
+
+  UNIT_TEST_END
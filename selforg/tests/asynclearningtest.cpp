@@ -0,0 +1,80 @@
+/***************************************************************************
+                          asynclearningtest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the asynchronous learning of Sox and DEP
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/sox.h>
+#include <selforg/dep.h>
+
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+/// runs the controller in a simple closed loop and records the motor values
+template <class Controller>
+vector<double> runLoop(Controller& c, int steps, int n){
+  vector<double> x(n), y(n, 0.0), outputs;
+  for(int i = 0; i < n; i++) x[i] = 0.1*(i+1);
+  for(int s = 0; s < steps; s++){
+    c.step(&x[0], n, &y[0], n);
+    for(int i = 0; i < n; i++) x[i] = 0.8*y[(i+1)%n] + 0.3*sin(0.01*s*(i+1));
+    outputs.insert(outputs.end(), y.begin(), y.end());
+  }
+  return outputs;
+}
+
+/// gives access to the EigenWorker of the control side
+class TestDEP : public DEP {
+public:
+  TestDEP(const DEPConf& conf) : DEP(conf) {}
+  bool hasEigenWorker() const { return evWorker != 0; }
+};
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckSoxStaleness0 ) {
+  cout << "\n -[ Check Sox with maxstaleness 0 ]-\n";
+  const int n = 10, steps = 500;
+  SoxConf conf = Sox::getDefaultConf();
+  Sox sync(conf);
+  conf.asyncLearning = true;
+  Sox async(conf);
+  sync.init(n, n);
+  async.init(n, n);
+  async.setParam("maxstaleness", 0);
+  vector<double> ys = runLoop(sync, steps, n);
+  vector<double> ya = runLoop(async, steps, n);
+  unit_assert( "same motor values", ys == ya );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckDEPEigenWorker ) {
+  cout << "\n -[ Check DEP EigenWorker with async learning ]-\n";
+  const int n = 6;
+  DEPConf conf = DEP::getDefaultConf();
+  conf.calcEigenvalues = true;
+  TestDEP sync(conf);
+  conf.asyncLearning = true;
+  TestDEP async(conf);
+  sync.init(n, n);
+  async.init(n, n);
+  runLoop(sync, 50, n);
+  runLoop(async, 50, n);
+  unit_assert( "synchronous has worker", sync.hasEigenWorker() );
+  unit_assert( "control side has no worker", !async.hasEigenWorker() );
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Asynchronous Learning Tests" )
+  ADD_TEST( CheckSoxStaleness0 )
+  ADD_TEST( CheckDEPEigenWorker )
+
+  UNIT_TEST_END
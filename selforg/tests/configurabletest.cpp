@@ -10,9 +10,11 @@
 #include "unit_test.hpp"
 
 #include <selforg/configurable.h>
+#include <selforg/callbackable.h>
 
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 
 
 using namespace std;
@@ -92,6 +94,124 @@ DEFINE_TEST( store_restore ) {
   unit_pass();  
 }
 
+/// overloads setParam to derive a value from the parameter (like the robots do)
+class Derived : public Configurable {
+public:
+  Derived(bool callBase) : Configurable("derived","0"), callBase(callBase), calls(0), k(1), twice(2) {
+    addParameter("k", &k);
+  }
+  virtual bool setParam(const paramkey& key, paramval val, bool traverseChildren = true){
+    calls++;
+    bool rv;
+    if(callBase) rv = Configurable::setParam(key, val, traverseChildren);
+    else { k = val; rv = true; }
+    twice = 2*k;
+    return rv;
+  }
+  bool callBase;
+  int calls;
+  double k;
+  double twice;
+};
+
+/// counts the change notifications
+class ChangeCounter : public Callbackable {
+public:
+  ChangeCounter() : count(0) {}
+  virtual void doOnCallBack(BackCaller* source, BackCaller::CallbackableType type){
+    if(type == Configurable::CALLBACK_PARAM_CHANGED) count++;
+  }
+  int count;
+};
+
+DEFINE_TEST( CheckHandles ) {
+  cout << "\n -[ Check Handles ]-\n";
+  Dat d;
+  Configurable c = setupConfigable(d,"c");
+  unit_assert( "count      ", c.getParamCount() == 4 );
+  unit_assert( "handles    ", c.getParamHandle("d") == 0 && c.getParamHandle("i") == 1
+               && c.getParamHandle("b") == 2 && c.getParamHandle("pla") == 3 );
+  unit_assert( "unknown    ", c.getParamHandle("xyz") == -1 );
+  unit_assert( "key        ", c.getParamKey(3) == "pla" );
+  unit_assert( "set double ", c.setParamByHandle(c.getParamHandle("d"), 0.25) && d.d == 0.25 );
+  unit_assert( "set int    ", c.setParamByHandle(c.getParamHandle("i"), 7.8) && d.i == 7 );
+  unit_assert( "set bool   ", c.setParamByHandle(c.getParamHandle("b"), 1) && d.b == true );
+  unit_assert( "get        ", c.getParamByHandle(0) == 0.25 && c.getParamByHandle(1) == 7
+               && c.getParamByHandle(2) == 1 );
+  unit_assert( "same as key", c.getParamByHandle(3) == c.getParam("pla") );
+  unit_assert( "invalid    ", !c.setParamByHandle(-1, 1) && !c.setParamByHandle(4, 1) );
+
+  // the overloaded setParam sees changes done by handle
+  Derived o(true);
+  unit_assert( "overload   ", o.setParamByHandle(o.getParamHandle("k"), 3) );
+  unit_assert( "overload called", o.calls == 1 && o.k == 3 && o.twice == 6 );
+  Derived n(false);
+  Configurable::paramversion v = Configurable::getParamLogVersion();
+  unit_assert( "without base", n.setParamByHandle(0, 4) && n.k == 4 && n.twice == 8 );
+  unit_assert( "without base logged", n.getParamVersion(0) > v );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckChangeLog ) {
+  cout << "\n -[ Check Change Log ]-\n";
+  Dat d;
+  Configurable c = setupConfigable(d,"c");
+  vector<Configurable::paramhandle> changed;
+  Configurable::paramversion v0 = Configurable::getParamLogVersion();
+  Configurable::paramversion v = c.getChangedParams(v0, changed);
+  unit_assert( "nothing    ", changed.empty() && v == v0 );
+
+  c.setParam("i", 5);
+  c.setParamByHandle(c.getParamHandle("pla"), 2.5);
+  c.setParam("unknown", 1);
+  v = c.getChangedParams(v0, changed);
+  unit_assert( "version    ", v == Configurable::getParamLogVersion() && v > v0 );
+  unit_assert( "changed    ", changed.size() == 2 && changed[0] == c.getParamHandle("i")
+               && changed[1] == c.getParamHandle("pla") );
+  unit_assert( "last change", c.getLastChangeVersion() == v );
+
+  // only the new changes since the returned version
+  changed.clear();
+  unit_assert( "up to date ", c.getChangedParams(v, changed) == v && changed.empty() );
+  c.setParam("i", 6);
+  c.getChangedParams(v, changed);
+  unit_assert( "next change", changed.size() == 1 && changed[0] == c.getParamHandle("i") );
+  unit_assert( "unchanged  ", c.getParamVersion(c.getParamHandle("d")) == 0 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckSubtreeVersion ) {
+  cout << "\n -[ Check Subtree Version ]-\n";
+  Dat d,d1,d2;
+  Configurable c  = setupConfigable(d,"c");
+  Configurable c1 = setupConfigable(d1,"c1");
+  Configurable c2 = setupConfigable(d2,"c2");
+  c.addConfigurable(&c1);
+  c.addConfigurable(&c2);
+  ChangeCounter counter;
+  c.addCallbackable(&counter, Configurable::CALLBACK_PARAM_CHANGED);
+
+  Configurable::paramversion v0 = Configurable::getParamLogVersion();
+  c1.setParam("d", 1.5);
+  unit_assert( "child      ", c1.getLastChangeVersion() > v0 );
+  unit_assert( "parent     ", c.getLastChangeVersion() == c1.getLastChangeVersion() );
+  unit_assert( "sibling    ", c2.getLastChangeVersion() <= v0 );
+  unit_assert( "notified   ", counter.count == 1 );
+  // the parent's own parameters did not change
+  vector<Configurable::paramhandle> changed;
+  c.getChangedParams(v0, changed);
+  unit_assert( "own params ", changed.empty() );
+
+  // setting through the parent reaches the child (same key in all three)
+  Configurable::paramversion v1 = Configurable::getParamLogVersion();
+  c.setParam("i", 3);
+  unit_assert( "traverse   ", d.i == 3 && d1.i == 3 && d2.i == 3 );
+  unit_assert( "all changed", c.getLastChangeVersion() > v1 && c1.getLastChangeVersion() > v1
+               && c2.getLastChangeVersion() > v1 );
+  unit_assert( "notified 3x", counter.count == 4 );
+  unit_pass();
+}
+
 // DEFINE_TEST( store_restore ) {  
 //   cout << "\n -[ Store and Restore ]-\n";  
 
@@ -104,6 +224,9 @@ DEFINE_TEST( store_restore ) {
 UNIT_TEST_RUN( "Configurable Tests" )
   ADD_TEST( CheckSetGet )
   ADD_TEST( store_restore )
+  ADD_TEST( CheckHandles )
+  ADD_TEST( CheckChangeLog )
+  ADD_TEST( CheckSubtreeVersion )
 
   UNIT_TEST_END
 
@@ -0,0 +1,185 @@
+/***************************************************************************
+                          invertmotornsteptest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the InvertMotorNStep controller
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/invertmotornstep.h>
+#include <selforg/regularisation.h>
+#include <selforg/randomgenerator.h>
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace matrix;
+
+/// gives access to the updates and holds the former per step implementation
+class Reference : public InvertMotorNStep {
+public:
+  Reference(const InvertMotorNStepConf& conf) : InvertMotorNStep(conf) {}
+  /// the updates as calculated by the controller
+  void calcUpdates(Matrix& C_update, Matrix& H_update, int delay){
+    calcCandHUpdates(C_update, H_update, delay);
+  }
+  /// the updates calculated step by step over the horizon (implementation before the batching)
+  void calcCandHUpdatesReference(Matrix& C_update, Matrix& H_update, int delay);
+};
+
+void Reference::calcCandHUpdatesReference(Matrix& C_update, Matrix& H_update, int delay)
+{
+  assert( steps + delay < buffersize);
+  // Matrix& eta = zero_eta;
+  // Matrix v_old = (eta_buffer[t%buffersize]).map(g);
+  bool teaching = (modelCompliant!=0) || useTeaching || (continuity!=0);
+  Matrix C_updateTeaching;
+  Matrix H_updateTeaching;
+  if(teaching)
+  {
+    C_updateTeaching.set(C.getM(), C.getN());
+    H_updateTeaching.set(H.getM(), H.getN());
+  }
+  v = zero_eta;
+  double shiftlimit = 1; //maximal size of vector components in shifts
+  //and other intermediate vectors calculated with the inverse or pseudoinverse
+  for(unsigned int s = 1; s <= steps; s++)
+  {
+    const Matrix& eta = eta_buffer[(t-s)%buffersize].map(g);
+
+    //const Matrix& x      = A * z.map(g) + xsi;
+    //    z                    = R * z.map(g) + H + C*xsi; // z is a dynamic itself (not successful)
+    const Matrix& x          = x_buffer[(t-s)%buffersize];
+    const Matrix& z          = C * x + H;
+    const Matrix shift       = (eta + v).mapP(&shiftlimit,squash); // limit shift by shiftlimit (arbitrary choice)
+    const Matrix g_prime     = Matrix::map2(g_s, z, shift);
+    const Matrix g_prime_inv = g_prime.map(one_over);
+    const Matrix g_2p_div_p  = Matrix::map2(g_ss_div_s, z, shift);
+
+    const Matrix zeta = shift.multrowwise(g_prime_inv); // G'(Z)^-1 * (eta+v)
+    R                 = C * A;
+    // Georg 09.10.2008: consider to use different pseudoinverse: (R+\lambda I)^-1
+    const Matrix chi  = (((R.multMT()+SmallID)^-1) * zeta);
+    v                 = ((R^T) * chi).mapP(&shiftlimit,squash);// limit by shiftlimit // New Georg 10.2007;
+    const Matrix rho  = g_2p_div_p.multrowwise(chi.multrowwise(zeta)) * -1;
+
+    // calculate updates of H,C
+    // delta C += eps * (zeta * v^T * A^T + beta * x^T)
+    //  q_prime_inv.elementProduct is the correction of negled terms
+    //   (LL^T)^-1 from learning rule, which drive the system out of saturation. (important)
+    // double q_prime_invers = q_prime_inv.elementProduct();
+    C_update += ( chi*(v^T)*(A^T) - rho*(x^T) ) * epsC;
+    H_update += rho * -epsC;
+
+    Matrix LLT_I;
+    if(teaching){
+      // scale of the additional terms
+      LLT_I = ((R & g_prime).multMT()+SmallID)^-1;
+    }
+
+    if(modelCompliant!=0 && s==1)
+    {  // learning of the forward task:
+      // eta is difference between last y and reconstructed one
+      //    -> used as forward error signal
+      // The question is which delta to use: eta (linearised), zeta (neuron
+      // inverse) or eta*g' (Backprop) !
+      // Also: we need to make sure that z+delta is not in the saturation region
+      Matrix delta = eta.multrowwise(g_prime);// eta; // zeta; //eta.multrowwise(g_prime);
+      double cutat = 3;
+      delta = (delta + z).mapP(&cutat, squash)-delta; // this not quite clean
+      C_updateTeaching += ( delta*(x^T) ) * (modelCompliant * epsC);
+      H_updateTeaching += delta * (modelCompliant * epsC);
+
+    }
+    if(continuity!=0 && s==1)
+    {  // learning to keep motorcommands smooth
+      // the teaching signal is the previous motor command
+      const Matrix& y_tm1 = y_buffer[(t-1-delay)% buffersize];
+      const Matrix& y_tm2 = y_buffer[(t-2-delay)% buffersize];
+      const Matrix& xsi = y_tm2 - y_tm1;
+      const Matrix& delta = xsi.multrowwise(g_prime);
+      // we scale the update with the size of the TLE
+      //   in order to keep the influence of this update low
+//       double v_size = v.multTM().val(0,0);
+//       C_updateTeaching += ( delta*(x^T) ) * (continuity * epsC * v_size);
+//       H_updateTeaching += delta * (continuity * epsC * v_size);
+      C_updateTeaching += (LLT_I*( delta*(x^T) )) * (continuity * epsC);
+      H_updateTeaching += (LLT_I*delta) * (continuity * epsC);
+      // cerr << v.multTM().val(0,0) << "\t" << xsi.multTM().val(0,0) << "\n";
+    }
+    if(useTeaching && s==1)
+    {
+      const Matrix& y = y_buffer[(t-1-delay)% buffersize]; // eventuell t-1
+      //      printf("Learn: %i\n", t-1-delay);
+      const Matrix& xsi = y_teaching - y;
+      const Matrix& delta = xsi.multrowwise(g_prime);
+//       double v_size = v.multTM().val(0,0);
+//       C_updateTeaching += ( delta*(x^T) ) * (teacher * epsC * v_size);
+//       H_updateTeaching += delta * (teacher * epsC * v_size);
+      C_updateTeaching += (LLT_I * delta*(x^T) ) * (teacher * epsC);
+      H_updateTeaching += (LLT_I * delta) * (teacher * epsC);
+      useTeaching=false; // after we applied teaching signal it is switched off until new signal is given
+    }
+  }
+  // we are just using the last shift here! Is this of any problem.
+  double error_factor = calcErrorFactor(v, (logaE & 1) !=0, (rootE & 1) !=0);
+  // apply reinforcement factor
+  error_factor *= reinforcefactor;
+  reinforcefactor=1; // only use it in one timestep (next has to be given by setReinforcement())
+
+  C_update *= error_factor;
+  H_update *= error_factor;
+  if(teaching)
+  {
+    C_update+=C_updateTeaching;
+    H_update+=H_updateTeaching;
+  }
+};
+
+/// maximal relative deviation of the batched updates from the reference
+double maxDeviation(int sensors, int motors, int steps){
+  InvertMotorNStepConf conf = InvertMotorNStep::getDefaultConf();
+  conf.buffersize = 60;
+  Reference c(conf);
+  RandGen rand;
+  rand.init(3);
+  c.init(sensors, motors, &rand);
+  c.setParam("steps", steps);
+  c.setParam("continuity", 0.1);
+  c.setParam("modelcompl", 0.1);
+  double x[100], y[100];
+  double maxd = 0;
+  for(int k = 0; k < 100; k++){
+    for(int i = 0; i < sensors; i++) x[i] = sin(k*0.1*(i+1)) + 0.1*rand.rand();
+    c.step(x, sensors, y, motors);
+    if(k > 20){
+      Matrix C1(motors, sensors), H1(motors, 1), C2(motors, sensors), H2(motors, 1);
+      c.calcCandHUpdatesReference(C1, H1, 0);
+      c.calcUpdates(C2, H2, 0);
+      double d = sqrt(((C1-C2).norm_sqr() + (H1-H2).norm_sqr())
+                      / (C1.norm_sqr() + H1.norm_sqr() + 1e-300));
+      maxd = max(maxd, d);
+    }
+  }
+  return maxd;
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckBatchedUpdates ) {
+  cout << "\n -[ Check batched calcCandHUpdates ]-\n";
+  unit_assert( "8x6, 5 steps", maxDeviation(8, 6, 5) < 1e-14 );
+  unit_assert( "30x20, 10 steps", maxDeviation(30, 20, 10) < 1e-14 );
+  unit_assert( "4x4, 1 step", maxDeviation(4, 4, 1) < 1e-14 );
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "InvertMotorNStep Tests" )
+  ADD_TEST( CheckBatchedUpdates )
+
+  UNIT_TEST_END
@@ -0,0 +1,99 @@
+/***************************************************************************
+                          lyapunovtest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the lyapunov exponents
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/lyapunov.h>
+#include <selforg/matrix.h>
+
+#include <list>
+#include <cmath>
+
+using namespace std;
+using namespace matrix;
+
+/// returns true if all elements of a and b differ less than eps
+bool nearlyEqual(const Matrix& a, const Matrix& b, double eps){
+  if(a.getM() != b.getM() || a.getN() != b.getN()) return false;
+  for(unsigned int i = 0; i < a.getM(); i++)
+    for(unsigned int j = 0; j < a.getN(); j++)
+      if(fabs(a.val(i,j) - b.val(i,j)) > eps) return false;
+  return true;
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckExponents ) {
+  cout << "\n -[ Check Lyapunov exponents ]-\n";
+  list<int> horizons;
+  horizons.push_back(0);
+  horizons.push_back(10);
+  Lyapunov l;
+  l.init(horizons, 2, true);
+
+  // triangular: the exponents are the logs of the diagonal
+  Matrix J(2,2);
+  J.val(0,0) = 2; J.val(0,1) = 1;
+  J.val(1,0) = 0; J.val(1,1) = 0.5;
+  for(int i = 0; i < 200; i++)
+    l.step(J);
+  Matrix expected(2,1);
+  expected.val(0,0) = log(2.0);
+  expected.val(1,0) = log(0.5);
+  unit_assert( "infinite horizon", nearlyEqual(l.getLyapunovExp(0), expected, 1e-2) );
+  unit_assert( "horizon 10", nearlyEqual(l.getLyapunovExp(10), expected, 1e-2) );
+
+  // the product of the Jacobians over the window
+  Matrix P(2,2);
+  P.toId();
+  for(int i = 0; i < 10; i++)
+    P = J * P;
+  unit_assert( "lyapunov matrix", nearlyEqual(l.getLyapunovMatrix(10), P, 1e-9*P.val(0,0)) );
+
+  // scaled rotation: both exponents are the log of the scale,
+  //  the window forgets the old Jacobian
+  double s = 0.8, phi = 0.3;
+  J.val(0,0) = s*cos(phi); J.val(0,1) = -s*sin(phi);
+  J.val(1,0) = s*sin(phi); J.val(1,1) = s*cos(phi);
+  for(int i = 0; i < 10; i++)
+    l.step(J);
+  expected.val(0,0) = log(s);
+  expected.val(1,0) = log(s);
+  unit_assert( "window after change", nearlyEqual(l.getLyapunovExp(10), expected, 1e-9) );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckWithoutMatrices ) {
+  cout << "\n -[ Check Lyapunov without matrices ]-\n";
+  list<int> horizons;
+  horizons.push_back(0);
+  horizons.push_back(5);
+  Lyapunov a, b;
+  a.init(horizons, 3, true);
+  b.init(horizons, 3, false);
+  Matrix J(3,3);
+  for(int t = 0; t < 50; t++){
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 3; j++)
+        J.val(i,j) = sin(t + 3*i + j) + (i == j ? 1.0 : 0.0);
+    a.step(J);
+    b.step(J);
+  }
+  // the exponents do not depend on the accumulation of the matrices
+  unit_assert( "same exponents 0", nearlyEqual(a.getLyapunovExp(0), b.getLyapunovExp(0), 1e-12) );
+  unit_assert( "same exponents 5", nearlyEqual(a.getLyapunovExp(5), b.getLyapunovExp(5), 1e-12) );
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Lyapunov Tests" )
+  ADD_TEST( CheckExponents )
+  ADD_TEST( CheckWithoutMatrices )
+
+  UNIT_TEST_END
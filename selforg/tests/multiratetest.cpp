@@ -0,0 +1,99 @@
+/***************************************************************************
+                          multiratetest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for controllers running at a lower rate inside of other controllers
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/abstractcontroller.h>
+#include <selforg/oneactivemultipassivecontroller.h>
+#include <selforg/switchcontroller.h>
+
+#include <list>
+
+using namespace std;
+
+/// counts its steps and outputs the count as motor value
+class CountingController : public AbstractController {
+public:
+  CountingController() : AbstractController("Counting", "1.0"), steps(0), motornumber(0) {}
+  virtual void init(int sensornumber, int motornumber, RandGen* randGen = 0){
+    this->motornumber = motornumber;
+  }
+  virtual int getSensorNumber() const { return 1; }
+  virtual int getMotorNumber() const { return motornumber; }
+  virtual void step(const sensor* sensors, int sensornumber, motor* motors, int motornumber){
+    stepNoLearning(sensors, sensornumber, motors, motornumber);
+  }
+  virtual void stepNoLearning(const sensor* , int , motor* motors, int motornumber){
+    steps++;
+    for(int i = 0; i < motornumber; i++) motors[i] = steps;
+  }
+  virtual bool store(FILE* f) const { return true; }
+  virtual bool restore(FILE* f) { return true; }
+
+  int steps;
+  int motornumber;
+};
+
+/** steps the controller 9 times and checks that the child (rate 3, phase 1)
+    is stepped in the steps 1,4,7 and its output is held in between */
+bool checkRate3(AbstractController& parent, CountingController& child){
+  sensor x[1] = { 0 };
+  motor y[2];
+  // expected output after each step
+  const double expected[9] = { 0, 1, 1, 1, 2, 2, 2, 3, 3 };
+  const int expectedSteps[9] = { 0, 1, 1, 1, 2, 2, 2, 3, 3 };
+  bool ok = true;
+  for(int s = 0; s < 9; s++){
+    y[0] = y[1] = -1;
+    parent.step(x, 1, y, 2);
+    ok &= child.steps == expectedSteps[s];
+    ok &= y[0] == expected[s] && y[1] == expected[s];
+  }
+  return ok;
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckOneActiveMultiPassive ) {
+  cout << "\n -[ Check OneActiveMultiPassiveController ]-\n";
+  CountingController* active = new CountingController();
+  CountingController* passive = new CountingController();
+  active->setRate(3, 1);
+  passive->setRate(2, 0);
+  OneActiveMultiPassiveController multi(active);
+  multi.addPassiveController(passive);
+  multi.init(1, 2);
+  unit_assert( "subcontrollers", multi.getSubControllers().size() == 2 );
+  unit_assert( "active rate 3", checkRate3(multi, *active) );
+  unit_assert( "passive rate 2", passive->steps == 5 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckSwitchController ) {
+  cout << "\n -[ Check SwitchController ]-\n";
+  CountingController* slow = new CountingController();
+  CountingController* other = new CountingController();
+  slow->setRate(3, 1);
+  list<AbstractController*> controllers;
+  controllers.push_back(slow);
+  controllers.push_back(other);
+  SwitchController sc(controllers);
+  sc.init(1, 2);
+  unit_assert( "subcontrollers", sc.getSubControllers().size() == 2 );
+  unit_assert( "active rate 3", checkRate3(sc, *slow) );
+  unit_assert( "inactive rate 1", other->steps == 9 );
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Multi-rate Controller Tests" )
+  ADD_TEST( CheckOneActiveMultiPassive )
+  ADD_TEST( CheckSwitchController )
+
+  UNIT_TEST_END
@@ -0,0 +1,159 @@
+/***************************************************************************
+                          philoxtest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the counter based random generator
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/philox.h>
+#include <selforg/randomgenerator.h>
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+/// returns true if the block of ctr and key is the expected one
+bool checkBlock(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+                uint32_t k0, uint32_t k1, const uint32_t expected[4]){
+  uint32_t ctr[4] = {c0, c1, c2, c3};
+  uint32_t key[2] = {k0, k1};
+  uint32_t out[4];
+  Philox::block(ctr, key, out);
+  for(int i = 0; i < 4; i++)
+    if(out[i] != expected[i]) return false;
+  return true;
+}
+
+/// the i-th double of the given stream computed from a single block
+double nthValue(uint64_t seed, uint64_t stream, uint64_t i){
+  uint64_t c = i/2;
+  uint32_t ctr[4] = {(uint32_t)c, (uint32_t)(c >> 32), (uint32_t)stream, (uint32_t)(stream >> 32)};
+  uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+  uint32_t out[4];
+  Philox::block(ctr, key, out);
+  uint64_t bits = (i%2 == 0) ? (out[0] | ((uint64_t)out[1] << 32))
+                             : (out[2] | ((uint64_t)out[3] << 32));
+  return Philox::toDouble(bits);
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckKnownAnswers ) {
+  cout << "\n -[ Check Philox4x32-10 known answers ]-\n";
+  // known answer vectors of the reference implementation (Random123)
+  const uint32_t zeros[4]  = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+  const uint32_t ones[4]   = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+  const uint32_t digits[4] = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+  unit_assert( "zero key and counter", checkBlock(0, 0, 0, 0, 0, 0, zeros) );
+  unit_assert( "all ones", checkBlock(0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+                                      0xffffffff, 0xffffffff, ones) );
+  unit_assert( "pi digits", checkBlock(0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344,
+                                       0xa4093822, 0x299f31d0, digits) );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckStream ) {
+  cout << "\n -[ Check stream layout ]-\n";
+  // the vectorised lanes compute the same blocks as the scalar version
+  const uint64_t seed = 0x0123456789abcdefULL;
+  const uint64_t stream = 0xfedcba9876543210ULL;
+  Philox p(seed, stream);
+  bool same = true;
+  for(uint64_t i = 0; i < 5*Philox::lanes; i++)
+    same &= p.rand() == nthValue(seed, stream, i);
+  unit_assert( "rand == block", same );
+  unit_assert( "tell", p.tell() == 5*Philox::lanes );
+  unit_assert( "range", Philox::toDouble(0) == 0.0 && Philox::toDouble(~0ULL) < 1.0 );
+
+  Philox q(seed, stream+1);
+  unit_assert( "streams differ", q.rand() != nthValue(seed, stream, 0) );
+  q.init(seed+1, stream);
+  unit_assert( "seeds differ", q.rand() != nthValue(seed, stream, 0) );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckFillSeek ) {
+  cout << "\n -[ Check rand, fillUniform and seek ]-\n";
+  const size_t n = 1000;
+  Philox a(42, 3), b(42, 3);
+  vector<double> r(n), f(n);
+  for(size_t i = 0; i < n; i++) r[i] = a.rand();
+  b.fillUniform(&f[0], n);
+  unit_assert( "fillUniform == rand", r == f );
+
+  // mixed calls of odd sizes stay in sequence
+  Philox c(42, 3);
+  vector<double> m(n);
+  size_t i = 0, len = 1;
+  while(i < n){
+    if(len > n-i) len = n-i;
+    if(len%2) { for(size_t j = 0; j < len; j++) m[i+j] = c.rand(); }
+    else c.fillUniform(&m[i], len);
+    i += len;
+    len = len*3+1;
+  }
+  unit_assert( "mixed == rand", m == r );
+  unit_assert( "tell after fill", b.tell() == n && c.tell() == n );
+
+  // scaled to [min,max)
+  Philox d(42, 3);
+  vector<double> s(n);
+  d.fillUniform(&s[0], n, -1, 3);
+  bool scaled = true;
+  for(size_t j = 0; j < n; j++) scaled &= s[j] == r[j]*4-1 && s[j] >= -1 && s[j] < 3;
+  unit_assert( "min max", scaled );
+
+  // random access
+  Philox e(42, 3);
+  bool seeked = true;
+  const uint64_t idx[] = {0, 1, 31, 32, 33, 999, 500, 2};
+  for(unsigned int j = 0; j < sizeof(idx)/sizeof(uint64_t); j++){
+    e.seek(idx[j]);
+    seeked &= e.tell() == idx[j] && e.rand() == r[idx[j]];
+  }
+  unit_assert( "seek", seeked );
+  e.seek(101);
+  e.fillUniform(&f[0], 200);
+  unit_assert( "seek and fill", equal(f.begin(), f.begin()+200, r.begin()+101) );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckRandGen ) {
+  cout << "\n -[ Check counter based RandGen ]-\n";
+  const size_t n = 777;
+  RandGen a, b;
+  a.initCounterBased(7, 1);
+  b.initCounterBased(7, 1);
+  unit_assert( "counter based", a.isCounterBased() );
+  vector<double> r(n), f(n);
+  for(size_t i = 0; i < n; i++) r[i] = a.rand()*2-1;
+  b.fillUniform(&f[0], n, -1, 1);
+  unit_assert( "fillUniform == rand", r == f );
+
+  // normal values (odd number): mean and variance
+  const size_t m = 10001;
+  vector<double> v(m);
+  a.fillNormal(&v[0], m, 2, 3);
+  double sum = 0, sum2 = 0;
+  for(size_t i = 0; i < m; i++) { sum += v[i]; sum2 += v[i]*v[i]; }
+  double mean = sum/m;
+  double var  = sum2/m - mean*mean;
+  unit_assert( "normal mean", fabs(mean - 2) < 0.1 );
+  unit_assert( "normal variance", fabs(var - 9) < 0.5 );
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Philox Tests" )
+  ADD_TEST( CheckKnownAnswers )
+  ADD_TEST( CheckStream )
+  ADD_TEST( CheckFillSeek )
+  ADD_TEST( CheckRandGen )
+
+  UNIT_TEST_END
@@ -0,0 +1,263 @@
+/***************************************************************************
+                          qlearningtest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for QLearning and the sparse QTable
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/qlearning.h>
+#include <selforg/qtable.h>
+#include <selforg/matrix.h>
+#include <selforg/controller_misc.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace matrix;
+
+/// gives access to the table and the traces
+class TestQLearning : public QLearning {
+public:
+  TestQLearning(double eps, double discount, int eligibility, bool useSARSA)
+    : QLearning(eps, discount, 0, eligibility, false, useSARSA) {}
+  QTable& table() { return Q; }
+  size_t traceCount() const { return traces.size(); }
+};
+
+/// gives access to the index of the rows
+class TestQTable : public QTable {
+public:
+  bool hashed() const { return denseIndex.empty() && hashIndex.size() == rowStates.size(); }
+};
+
+/// the previous one step update for eligibility 1 (dense table)
+void referenceLearn(Matrix& Q, int t, unsigned int s, unsigned int a,
+                    unsigned int& ls, unsigned int& la, double& lr,
+                    double r, double eps, double discount, bool sarsa){
+  if(t > 0){
+    double next = sarsa ? Q.val(s,a) : max(Q.row(s));
+    Q.val(ls,la) += eps*(lr + discount*next - Q.val(ls,la));
+  }
+  ls = s; la = a; lr = r;
+}
+
+/// the bytes written by store()
+vector<char> storeBytes(const Storeable& s){
+  FILE* f = tmpfile();
+  s.store(f);
+  vector<char> bytes(ftell(f));
+  rewind(f);
+  if(!bytes.empty() && fread(&bytes[0], 1, bytes.size(), f) != bytes.size()) bytes.clear();
+  fclose(f);
+  return bytes;
+}
+
+/// restores from the given bytes
+bool restoreBytes(Storeable& s, const vector<char>& bytes){
+  FILE* f = tmpfile();
+  if(!bytes.empty()) fwrite(&bytes[0], 1, bytes.size(), f);
+  rewind(f);
+  bool rv = s.restore(f);
+  fclose(f);
+  return rv;
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckOneStep ) {
+  cout << "\n -[ Check one step update (eligibility 1) ]-\n";
+  for(int sarsa = 0; sarsa < 2; sarsa++){
+    RandGen r;
+    r.init(5);
+    TestQLearning q(0.1, 0.9, 1, sarsa);
+    q.init(5, 3, &r);
+    Matrix Q(5,3);
+    unsigned int ls = 0, la = 0;
+    double lr = 0;
+    for(int t = 0; t < 300; t++){
+      unsigned int s = (t*7 + t/5) % 5;
+      unsigned int a = (t*t) % 3;
+      double rew = sin(0.3*t);
+      q.learn(s, a, rew);
+      referenceLearn(Q, t, s, a, ls, la, lr, rew, 0.1, 0.9, sarsa);
+    }
+    unit_assert( "same as one step", (q.getQ() - Q).map(fabs).elementSum() < 1e-12 );
+    unit_assert( "no traces kept", q.traceCount() == 0 );
+  }
+  unit_pass();
+}
+
+DEFINE_TEST( CheckTraces ) {
+  cout << "\n -[ Check eligibility traces ]-\n";
+  RandGen r;
+  r.init(1);
+  const double eps = 0.1;
+  // no discount and only new states: the TD error of every transition is its reward 1
+  TestQLearning q(eps, 0, 3, false);
+  q.init(10, 2, &r);
+  vector<double> changes;
+  double last = 0;
+  for(unsigned int t = 0; t < 6; t++){
+    q.learn(t, 0, 1);
+    double now = q.getQTable().findRow(0)[0];
+    if(t > 0) changes.push_back((now - last)/eps);
+    last = now;
+  }
+  unit_assert( "trace 1",   fabs(changes[0] - 1) < 1e-12 );
+  unit_assert( "trace 2/3", fabs(changes[1] - 2.0/3) < 1e-12 );
+  unit_assert( "trace 1/3", fabs(changes[2] - 1.0/3) < 1e-12 );
+  unit_assert( "dropped",   changes[3] == 0 && changes[4] == 0 );
+  unit_assert( "trace count", q.traceCount() == 2 );
+
+  // a revisited pair gets the trace 1 again (replacing traces)
+  q.reset();
+  q.learn(7, 1, 1);
+  q.learn(8, 1, 1);
+  q.learn(7, 1, 1);
+  q.learn(9, 1, 1);
+  unit_assert( "replaced", q.traceCount() == 2 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckStoreRestore ) {
+  cout << "\n -[ Check store and restore ]-\n";
+  RandGen r;
+  r.init(3);
+  TestQLearning q(0.2, 0.8, 2, false);
+  q.init(20, 4, &r);
+  for(int t = 0; t < 100; t++)
+    q.learn((t*3) % 17, t % 4, cos(t));
+  TestQLearning p(0.5, 0.5, 1, false);
+  p.init(1, 1, &r);
+  unit_assert( "round trip", restoreBytes(p, storeBytes(q)) );
+  unit_assert( "same table", p.getQ() == q.getQ() );
+  unit_assert( "same rows", p.getQTable().getStoredStates() == q.getQTable().getStoredStates() );
+  unit_assert( "parameters", p.getParam("eps") == 0.2 && p.getParam("discount") == 0.8 );
+
+  // dense matrix of older versions
+  Matrix dense(6,2);
+  dense.val(1,0) = 0.5; dense.val(4,1) = -2;
+  QTable t;
+  unit_assert( "dense", restoreBytes(t, storeBytes(dense)) );
+  unit_assert( "dense values", t.toMatrix() == dense && t.getStoredStates() == 2 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckInvalidTable ) {
+  cout << "\n -[ Check invalid tables ]-\n";
+  QTable t;
+  t.init(8, 2);
+  t.row(3)[1] = 1.5;
+  t.row(6)[0] = -1;
+  vector<char> bytes = storeBytes(t);
+  // layout: id(4) byteorder(2) version(1) elemsize(1) stateDim actionDim rows checksum reserved
+  const size_t states = 4 + 24;
+
+  QTable u;
+  unit_assert( "valid", restoreBytes(u, bytes) && u.toMatrix() == t.toMatrix() );
+
+  // the same table written with the other byte order
+  vector<char> swapped(bytes);
+  reverse(swapped.begin()+4, swapped.begin()+6);
+  for(size_t o = 8; o < states; o += 4) reverse(swapped.begin()+o, swapped.begin()+o+4);
+  for(size_t o = states; o < states+8; o += 4) reverse(swapped.begin()+o, swapped.begin()+o+4);
+  for(size_t o = states+8; o < swapped.size(); o += 8) reverse(swapped.begin()+o, swapped.begin()+o+8);
+  // the checksum is over the values as stored
+  uint32_t cs = Storeable::checksum(&swapped[states+8], swapped.size()-states-8);
+  memcpy(&swapped[20], &cs, 4);
+  reverse(swapped.begin()+20, swapped.begin()+24);
+  QTable w;
+  unit_assert( "byte swapped", restoreBytes(w, swapped) && w.toMatrix() == t.toMatrix() );
+
+  uint32_t big = 8;
+  vector<char> bad(bytes);
+  memcpy(&bad[states+4], &big, 4);   // state 8 >= stateDim
+  unit_assert( "state out of range", !restoreBytes(u, bad) );
+  unit_assert( "table kept", u.toMatrix() == t.toMatrix() );
+  uint32_t three = 3;
+  bad = bytes;
+  memcpy(&bad[states+4], &three, 4); // state 3 twice
+  unit_assert( "duplicate state", !restoreBytes(u, bad) );
+  uint32_t zero = 0;
+  bad = bytes;
+  memcpy(&bad[12], &zero, 4);        // actionDim 0
+  unit_assert( "no actions", !restoreBytes(u, bad) );
+  uint32_t many = 9;
+  bad = bytes;
+  memcpy(&bad[16], &many, 4);        // more rows than states
+  unit_assert( "too many rows", !restoreBytes(u, bad) );
+  uint32_t huge = 0xffffffff;
+  bad = bytes;
+  memcpy(&bad[8], &huge, 4);
+  memcpy(&bad[12], &huge, 4);
+  memcpy(&bad[16], &huge, 4);        // would not fit into the file
+  unit_assert( "oversized", !restoreBytes(u, bad) );
+  bad = vector<char>(bytes.begin(), bytes.end()-3);
+  unit_assert( "truncated", !restoreBytes(u, bad) );
+  unit_assert( "table still kept", u.toMatrix() == t.toMatrix() );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckLargeStateSpace ) {
+  cout << "\n -[ Check large state space ]-\n";
+  TestQTable t;
+  const unsigned int stateDim = (1u << 20) * 16;
+  t.init(stateDim, 4);
+  const unsigned int visited[] = {0, 5, 1u << 20, 12345678, stateDim-1};
+  const int n = sizeof(visited)/sizeof(unsigned int);
+  for(int i = 0; i < n; i++)
+    t.row(visited[i])[i % 4] = i + 1;
+  unit_assert( "hashed index", t.hashed() );
+  unit_assert( "visited rows", t.getStoredStates() == (unsigned int)n );
+  unit_assert( "unvisited", t.findRow(7) == 0 && t.findRow(stateDim) == 0 );
+  vector<char> bytes = storeBytes(t);
+  unit_assert( "stored size", bytes.size() == 4 + 24 + n*4 + n*4*sizeof(double) );
+  TestQTable u;
+  unit_assert( "restore", restoreBytes(u, bytes) );
+  bool same = u.hashed() && u.getStoredStates() == (unsigned int)n;
+  for(int i = 0; i < n; i++)
+    same &= u.findRow(visited[i]) && u.findRow(visited[i])[i % 4] == i + 1;
+  unit_assert( "restored rows", same );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckSoftmax ) {
+  cout << "\n -[ Check softmax selection ]-\n";
+  RandGen r;
+  r.init(11);
+  TestQLearning q(0.1, 0.9, 1, false);
+  q.init(2, 3, &r);
+  double* v = q.table().row(1);
+  v[0] = 0; v[1] = 1; v[2] = 2;
+  const double temperature = 1.5;
+  const int samples = 200000;
+  vector<int> counts(3, 0);
+  for(int i = 0; i < samples; i++)
+    counts[q.select_softmax(1, temperature)]++;
+  double z = 0;
+  for(int a = 0; a < 3; a++) z += exp(v[a]/temperature);
+  bool ok = true;
+  for(int a = 0; a < 3; a++)
+    ok &= fabs((double)counts[a]/samples - exp(v[a]/temperature)/z) < 0.01;
+  unit_assert( "boltzmann", ok );
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "QLearning Tests" )
+  ADD_TEST( CheckOneStep )
+  ADD_TEST( CheckTraces )
+  ADD_TEST( CheckStoreRestore )
+  ADD_TEST( CheckInvalidTable )
+  ADD_TEST( CheckLargeStateSpace )
+  ADD_TEST( CheckSoftmax )
+
+  UNIT_TEST_END
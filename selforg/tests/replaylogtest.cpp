@@ -0,0 +1,179 @@
+/***************************************************************************
+                          replaylogtest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the memory mapped replay logs
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/replaylog.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+const char* textname   = "replaylogtest.log";
+const char* binaryname = "replaylogtest.bin";
+const char* badname    = "replaylogtest_bad.bin";
+const int lines   = 20;
+const int columns = 5;
+
+double value(int line, int column){
+  return line*0.5 - column*1.25;
+}
+
+/// writes a log as the File PlotOption does
+void writeTextLog(){
+  FILE* f = fopen(textname, "w");
+  fprintf(f, "# Start 2026-10-19\n#IN x[0] first sensor\n");
+  fprintf(f, "#C t x[0] x[1] y[0] y[1]\n");
+  for(int l = 0; l < lines; l++){
+    if(l == 7) fprintf(f, "# comment within the data\n\n");
+    for(int c = 0; c < columns; c++) fprintf(f, "%g ", value(l, c));
+    fprintf(f, "\n");
+  }
+  fclose(f);
+}
+
+vector<char> readFile(const char* name){
+  vector<char> bytes;
+  FILE* f = fopen(name, "rb");
+  if(!f) return bytes;
+  int c;
+  while((c = fgetc(f)) != EOF) bytes.push_back((char)c);
+  fclose(f);
+  return bytes;
+}
+
+void writeFile(const char* name, const vector<char>& bytes){
+  FILE* f = fopen(name, "wb");
+  if(!bytes.empty()) fwrite(&bytes[0], 1, bytes.size(), f);
+  fclose(f);
+}
+
+/// layout of the header of the binary log (see replaylog.cpp)
+struct Header {
+  char     magic[8];
+  uint32_t columns;
+  uint32_t reserved;
+  uint64_t lines;
+  uint64_t namesbytes;
+};
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckTextAndBinary ) {
+  cout << "\n -[ Check text and binary logs ]-\n";
+  writeTextLog();
+  shared_ptr<ReplayLog> text = ReplayLog::open(textname);
+  unit_assert( "open text", text.get() != 0 );
+  unit_assert( "text size", text->getLineNumber() == lines && text->getColumnNumber() == columns );
+  unit_assert( "shared", ReplayLog::open(textname) == text );
+  unit_assert( "write binary", text->writeBinary(binaryname) );
+  shared_ptr<ReplayLog> bin = ReplayLog::open(binaryname);
+  unit_assert( "open binary", bin.get() != 0 );
+
+  unit_assert( "same names", text->getColumnNames() == bin->getColumnNames() );
+  unit_assert( "column", text->getColumn("y[0]") == 3 && bin->getColumn("y[0]") == 3
+               && bin->getColumn("z") == -1 );
+  int f1, l1, f2, l2;
+  unit_assert( "range", text->getColumnRange("x[", f1, l1) && bin->getColumnRange("x[", f2, l2)
+               && f1 == 1 && l1 == 2 && f2 == f1 && l2 == l1 );
+
+  bool same = bin->getLineNumber() == lines;
+  vector<double> a(columns), b(columns);
+  for(int l = 0; l < lines; l++){
+    text->getColumns(l, 0, columns - 1, a.data());
+    bin->getColumns(l, 0, columns - 1, b.data());
+    for(int c = 0; c < columns; c++)
+      same &= a[c] == value(l, c) && b[c] == a[c];
+  }
+  unit_assert( "same values", same );
+
+  // columns beyond the log are 0
+  double d[3];
+  unit_assert( "beyond", text->getColumns(2, 3, 5, d) && d[0] == value(2,3) && d[2] == 0
+               && bin->getColumns(2, 3, 5, d) && d[0] == value(2,3) && d[2] == 0 );
+  unit_assert( "out of range", !text->getColumns(lines, 0, 1, d) && !bin->getColumns(-1, 0, 1, d) );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckSeek ) {
+  cout << "\n -[ Check seeking ]-\n";
+  shared_ptr<ReplayLog> text = ReplayLog::open(textname);
+  shared_ptr<ReplayLog> bin  = ReplayLog::open(binaryname);
+  unit_assert( "open", text && bin );
+  unit_assert( "repeat", text->getLine(lines + 3.7, true) == 3 && bin->getLine(-1, true) == lines - 1 );
+  unit_assert( "clamp", text->getLine(lines + 3.7, false) == lines - 1 && bin->getLine(-5, false) == 0 );
+  // random access backwards and forwards
+  const int order[] = {13, 2, 19, 0, 7, 8};
+  bool ok = true;
+  for(unsigned int i = 0; i < sizeof(order)/sizeof(int); i++){
+    double x[2], y[2];
+    text->getColumns(order[i], 1, 2, x);
+    bin->getColumns(order[i], 1, 2, y);
+    ok &= x[0] == value(order[i], 1) && x[1] == value(order[i], 2) && y[0] == x[0] && y[1] == x[1];
+  }
+  unit_assert( "random access", ok );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckInvalidBinary ) {
+  cout << "\n -[ Check invalid binary logs ]-\n";
+  const vector<char> bytes = readFile(binaryname);
+  unit_assert( "read", bytes.size() > sizeof(Header) );
+  Header h;
+  memcpy(&h, &bytes[0], sizeof(h));
+  vector<char> bad;
+
+  bad = vector<char>(bytes.begin(), bytes.end() - 8);
+  writeFile(badname, bad);
+  unit_assert( "truncated values", !ReplayLog::open(badname) );
+
+  bad = vector<char>(bytes.begin(), bytes.begin() + sizeof(h) + 5);
+  writeFile(badname, bad);
+  unit_assert( "truncated names", !ReplayLog::open(badname) );
+
+  // the names block ends within the last name (no terminator)
+  bad = bytes;
+  Header b = h;
+  b.namesbytes = h.namesbytes - 1;
+  memcpy(&bad[0], &b, sizeof(b));
+  writeFile(badname, bad);
+  unit_assert( "unterminated name", !ReplayLog::open(badname) );
+
+  // sizes that overflow
+  bad = bytes;
+  b = h;
+  b.namesbytes = ~(uint64_t)0 - 8;
+  memcpy(&bad[0], &b, sizeof(b));
+  writeFile(badname, bad);
+  unit_assert( "huge names", !ReplayLog::open(badname) );
+  bad = bytes;
+  b = h;
+  b.lines = (uint64_t)1 << 40;
+  memcpy(&bad[0], &b, sizeof(b));
+  writeFile(badname, bad);
+  unit_assert( "huge lines", !ReplayLog::open(badname) );
+
+  unit_assert( "missing file", !ReplayLog::open("replaylogtest_missing.log") );
+  unlink(badname);
+  unlink(binaryname);
+  unlink(textname);
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "ReplayLog Tests" )
+  ADD_TEST( CheckTextAndBinary )
+  ADD_TEST( CheckSeek )
+  ADD_TEST( CheckInvalidBinary )
+
+  UNIT_TEST_END
@@ -0,0 +1,147 @@
+/***************************************************************************
+                          replaytrainertest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the batch learning of MultiLayerFFNN and the ReplayTrainer
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/multilayerffnn.h>
+#include <selforg/replaybuffer.h>
+#include <selforg/replaytrainer.h>
+#include <selforg/randomgenerator.h>
+
+#include <vector>
+#include <cmath>
+
+using namespace std;
+using namespace matrix;
+
+/// returns true if all elements of a and b differ less than eps
+bool nearlyEqual(const Matrix& a, const Matrix& b, double eps){
+  if(a.getM() != b.getM() || a.getN() != b.getN()) return false;
+  for(unsigned int i = 0; i < a.getM(); i++)
+    for(unsigned int j = 0; j < a.getN(); j++)
+      if(fabs(a.val(i,j) - b.val(i,j)) > eps) return false;
+  return true;
+}
+
+/// returns true if the weights and biases of both networks are nearly equal
+bool sameWeights(const MultiLayerFFNN& a, const MultiLayerFFNN& b, double eps){
+  for(unsigned int i = 0; i < a.getLayerNum(); i++){
+    if(!nearlyEqual(a.getWeights(i), b.getWeights(i), eps)) return false;
+    if(!nearlyEqual(a.getBias(i), b.getBias(i), eps)) return false;
+  }
+  return true;
+}
+
+/// creates an initialised network (with hidden layer if hidden>0)
+MultiLayerFFNN* createNet(int in, int hidden, int out, bool bypass){
+  RandGen rand;
+  rand.init(5);
+  vector<Layer> layers;
+  if(hidden > 0) layers.push_back(Layer(hidden, 0.5, FeedForwardNN::tanh));
+  layers.push_back(Layer(out, 0.5));
+  MultiLayerFFNN* net = new MultiLayerFFNN(0.1, layers, bypass);
+  net->init(in, out, 0, &rand);
+  return net;
+}
+
+/// random matrix (m x n)
+Matrix randomMatrix(int m, int n, RandGen& rand){
+  Matrix r(m, n);
+  for(int i = 0; i < m; i++)
+    for(int j = 0; j < n; j++)
+      r.val(i,j) = rand.rand()*2 - 1;
+  return r;
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckLearnBatch ) {
+  cout << "\n -[ Check learnBatch ]-\n";
+  RandGen rand;
+  rand.init(1);
+  const int in = 4, hidden = 6, out = 3, n = 8;
+  Matrix inputs  = randomMatrix(in, n, rand);
+  Matrix targets = randomMatrix(out, n, rand);
+
+  // processBatch gives the same outputs as process for every column
+  MultiLayerFFNN* a = createNet(in, hidden, out, true);
+  Matrix outputs = a->processBatch(inputs);
+  bool same = true;
+  for(int k = 0; k < n; k++)
+    same &= nearlyEqual(outputs.column(k), a->process(inputs.column(k)), 1e-12);
+  unit_assert( "processBatch equals process", same );
+
+  // a batch of one sample learns like learn()
+  MultiLayerFFNN* b = createNet(in, hidden, out, true);
+  a->learnBatch(inputs.column(0), targets.column(0));
+  b->learn(inputs.column(0), targets.column(0));
+  unit_assert( "one sample equals learn", sameWeights(*a, *b, 1e-12) );
+  delete a;
+  delete b;
+
+  // without hidden layer the batch update is the mean of the single updates
+  //  (each calculated from the same starting weights)
+  MultiLayerFFNN* batch = createNet(in, 0, out, false);
+  MultiLayerFFNN* single = createNet(in, 0, out, false);
+  Matrix W0 = batch->getWeights(0);
+  Matrix b0 = batch->getBias(0);
+  Matrix dW(out, in), db(out, 1);
+  for(int k = 0; k < n; k++){
+    single->getWeights(0) = W0;
+    single->getBias(0) = b0;
+    single->learn(inputs.column(k), targets.column(k));
+    dW += single->getWeights(0) - W0;
+    db += single->getBias(0) - b0;
+  }
+  batch->learnBatch(inputs, targets);
+  unit_assert( "batch weights are mean of single updates",
+               nearlyEqual(batch->getWeights(0), W0 + dW*(1.0/n), 1e-12) );
+  unit_assert( "batch bias is mean of single updates",
+               nearlyEqual(batch->getBias(0), b0 + db*(1.0/n), 1e-12) );
+  delete batch;
+  delete single;
+  unit_pass();
+}
+
+DEFINE_TEST( CheckReplayTrainer ) {
+  cout << "\n -[ Check ReplayTrainer ]-\n";
+  const int sensors = 3, motors = 2;
+  ReplayBuffer buffer(100);
+  double x[sensors], y[motors];
+  for(int t = 0; t < 50; t++){
+    for(int i = 0; i < sensors; i++) x[i] = sin(0.1*t*(i+1));
+    for(int i = 0; i < motors; i++) y[i] = cos(0.2*t*(i+1));
+    buffer.add(x, sensors, y, motors);
+  }
+  MultiLayerFFNN* fg = createNet(sensors + motors, 4, sensors, false);
+  MultiLayerFFNN* bg = createNet(sensors + motors, 4, sensors, false);
+  // the trainers draw the same batches, so both have to end with the same weights
+  ReplayTrainer foreground(fg, &buffer, 8, true, false);
+  ReplayTrainer background(bg, &buffer, 8, true, true);
+  for(int i = 0; i < 10; i++){
+    foreground.step();
+    background.step();
+    background.wait();
+  }
+  background.step(); // installs the weights of the last batches
+  unit_assert( "background equals foreground", sameWeights(*fg, *bg, 1e-12) );
+  background.wait();
+  unit_assert( "trained batches", foreground.getTrainedBatches() == 10
+               && background.getTrainedBatches() == 11 );
+  delete fg;
+  delete bg;
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "ReplayTrainer Tests" )
+  ADD_TEST( CheckLearnBatch )
+  ADD_TEST( CheckReplayTrainer )
+
+  UNIT_TEST_END
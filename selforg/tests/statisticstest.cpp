@@ -0,0 +1,256 @@
+/***************************************************************************
+                          statisticstest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the statistical tools
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/statistictools.h>
+#include <selforg/randomgenerator.h>
+#include <selforg/statisticsengine.h>
+#include <selforg/statisticmeasure.h>
+#include <selforg/hashedhistogram.h>
+#include <selforg/complexmeasure.h>
+#include <selforg/discretisizer.h>
+#include <selforg/mutualinformationcontroller.h>
+
+#include <vector>
+#include <string.h>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+/// compares all values of SelectionAnalysation with the sorting analysation
+bool compareAnalysation(vector<double>& values, double factor){
+  SelectionAnalysation s;
+  s.setValues(values);
+  s.analyse(factor);
+  DOUBLE_ANALYSATION_CONTEXT c(values);
+  return s.getMin() == c.getMin() && s.getMax() == c.getMax()
+    && s.getAvg() == c.getAvg() && s.getMedian() == c.getMedian()
+    && s.getQuartil1() == c.getQuartil1() && s.getQuartil3() == c.getQuartil3()
+    && s.getWhisker1() == c.getWhisker1(factor) && s.getWhisker3() == c.getWhisker3(factor)
+    && s.getBest() == c.getBest();
+}
+
+/// entropy (in nats) of the distribution given by the dense counts (0 for unseen bins)
+double denseEntropy(const vector<long>& counts){
+  double total = 0, h = 0;
+  for(size_t i = 0; i < counts.size(); i++) total += counts[i];
+  for(size_t i = 0; i < counts.size(); i++)
+    if(counts[i] > 0) h -= counts[i]/total * log(counts[i]/total);
+  return h;
+}
+
+/// fixed sequence in [-1,1] that leaves some of the bins unseen
+double sequence(int t){
+  return 0.5*sin(0.37*t) + 0.25*sin(1.3*t*t) - 0.1;
+}
+
+/// the state of MutualInformationController::getState() (values within [-1,1])
+int stateOf(double x, int intervals){
+  return min(max((int)((intervals - 1) * ((x + 1.0) / 2) + 0.5), 0), intervals - 1);
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckSelectionAnalysation ) {
+  cout << "\n -[ Check SelectionAnalysation ]-\n";
+  RandGen rand;
+  rand.init(1);
+  vector<double> values;
+  bool ok = true;
+  for(int n = 1; n < 60; n++){
+    values.clear();
+    for(int i = 0; i < n; i++){
+      values.push_back(rand.rand()*10-3);
+    }
+    ok &= compareAnalysation(values, 1.5);
+    ok &= compareAnalysation(values, 0.1);
+  }
+  unit_assert( "random sets", ok );
+
+  // duplicates, only positive and only negative values
+  double dup[] = { 2, 2, 1, 1, 5, 5, 5, 3};
+  values.assign(dup, dup + 8);
+  unit_assert( "duplicates", compareAnalysation(values, 1.5) );
+  for(int i = 0; i < 8; i++) values[i] = -values[i];
+  unit_assert( "negative", compareAnalysation(values, 1.5) );
+
+  SelectionAnalysation s;
+  s.analyse();
+  unit_assert( "empty set", s.getMin() == 0 && s.getMedian() == 0 && s.getBest() == 0 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckStatisticsEngine ) {
+  cout << "\n -[ Check StatisticsEngine ]-\n";
+  RandGen rand;
+  rand.init(2);
+  const long span = 7;
+  double x = 0;
+  double min, max, var, sum, allmax;
+  StatisticsEngine e;
+  e.add(&x, &min, MIN, span);
+  e.add(&x, &max, MAX, span);
+  e.add(&x, &var, VAR, span);
+  e.add(&x, &sum, SUM, span);
+  e.add(&x, &allmax, MAX, 0);
+  vector<double> values;
+  bool okMin = true, okMax = true, okVar = true, okSum = true, okAll = true;
+  for(int n = 0; n < 300; n++){
+    if(n == 200){ // the windows of the other measures move down
+      e.remove(&max);
+      unit_assert( "remove", e.size() == 4 );
+    }
+    x = (n % 50 < 25) ? rand.rand()*10-3 : -n; // random and decreasing phases
+    values.push_back(x);
+    e.step();
+    // brute force over the last span values
+    size_t first = values.size() > (size_t)span ? values.size() - span : 0;
+    double bmin = values[first], bmax = values[first], bsum = 0, bmean = 0, bvar = 0;
+    for(size_t i = first; i < values.size(); i++){
+      bmin = std::min(bmin, values[i]);
+      bmax = std::max(bmax, values[i]);
+      bsum += values[i];
+    }
+    size_t k = values.size() - first;
+    bmean = bsum / k;
+    for(size_t i = first; i < values.size(); i++) bvar += (values[i] - bmean)*(values[i] - bmean);
+    bvar = k > 1 ? bvar / (k - 1) : 0;
+    okMin &= min == bmin;
+    okMax &= n >= 200 || max == bmax;
+    okVar &= fabs(var - bvar) < 1e-9;
+    okSum &= fabs(sum - bsum) < 1e-9;
+    okAll &= allmax == *std::max_element(values.begin(), values.end());
+  }
+  unit_assert( "windowed MIN", okMin );
+  unit_assert( "windowed MAX", okMax );
+  unit_assert( "windowed VAR", okVar );
+  unit_assert( "windowed SUM", okSum );
+  unit_assert( "MAX over all steps", okAll );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckStatisticMeasureStepSize ) {
+  cout << "\n -[ Check StatisticMeasure step size ]-\n";
+  double x = 0;
+  StatisticTools tools;
+  StatisticMeasure* id = tools.getMeasure(x, "id", ID, 0, 0);
+  StatisticMeasure* sum = tools.getMeasure(x, "sum", SUM, 0, 0);
+  sum->setStepSize(3);
+  bool okId = true, okSum = true;
+  double bsum = 0;
+  for(int n = 0; n < 10; n++){
+    x = n + 1;
+    if(n % 3 == 0) bsum += x;
+    tools.doOnCallBack(0);
+    okId &= id->getValue() == x;
+    okSum &= sum->getValue() == bsum;
+  }
+  unit_assert( "step size 1", okId );
+  unit_assert( "step size 3", okSum );
+  unit_assert( "actual step", id->getActualStep() == 10 && sum->getActualStep() == 10 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckHashedHistogram ) {
+  cout << "\n -[ Check HashedHistogram against dense counts ]-\n";
+  const int bins = 300;
+  vector<long> dense(bins, 0);
+  HashedHistogram h(4); // has to grow several times
+  for(int t = 0; t < 5000; t++){
+    // only every third bin is used
+    int bin = 3 * ((t*t + 7*t) % (bins/3));
+    dense[bin]++;
+    h.add(bin);
+  }
+  bool same = true;
+  size_t occupied = 0;
+  for(int b = 0; b < bins; b++){
+    same &= h.get(b) == dense[b];
+    if(dense[b] > 0) occupied++;
+  }
+  unit_assert( "counts", same && h.get(bins) == 0 && h.get(~uint64_t(0) - 1) == 0 );
+  unit_assert( "unseen bins", dense[1] == 0 && h.get(1) == 0 );
+  unit_assert( "occupied", h.getOccupied() == occupied && h.getTotal() == 5000 );
+  unit_assert( "entropy", fabs(h.getEntropy() - denseEntropy(dense)) < 1e-10 );
+  unit_assert( "recomputed", fabs(h.computeEntropy() - denseEntropy(dense)) < 1e-12 );
+
+  // removing counts (a bin becomes unseen again)
+  long c = dense[0];
+  h.add(0, -c);
+  dense[0] = 0;
+  unit_assert( "removed", h.get(0) == 0 && h.getTotal() == 5000 - c );
+  unit_assert( "entropy after removal", fabs(h.getEntropy() - denseEntropy(dense)) < 1e-10 );
+  h.clear();
+  unit_assert( "clear", h.getTotal() == 0 && h.getOccupied() == 0 && h.getEntropy() == 0 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckHashedMutualInformation ) {
+  cout << "\n -[ Check MI and entropy with hashed histograms ]-\n";
+  const int intervals = 20;
+  MutualInformationController mic(intervals);
+  mic.init(1, 1);
+  vector<long> joint(intervals*intervals, 0), prev(intervals, 0), next(intervals, 0);
+  // the controller starts with the old sensor value intervals/2
+  int oldState = stateOf(intervals/2.0, intervals);
+  sensor x[1];
+  motor y[1];
+  bool same = true;
+  for(int t = 0; t < 2000; t++){
+    x[0] = sequence(t);
+    mic.step(x, 1, y, 1);
+    int state = stateOf(x[0], intervals);
+    joint[oldState*intervals + state]++;
+    prev[oldState]++;
+    next[state]++;
+    oldState = state;
+    if(t % 100 == 99){
+      double mi = denseEntropy(prev) + denseEntropy(next) - denseEntropy(joint);
+      same &= fabs(mic.getMI(0) - mi) < 1e-9;
+    }
+  }
+  unit_assert( "unseen states", next[0] == 0 && next[intervals-1] == 0 );
+  unit_assert( "MI == dense MI", same );
+
+  // entropy of two observables
+  double a, b;
+  ComplexMeasure ent("ent", ENT, 8);
+  ComplexMeasure slow("entslow", ENTSLOW, 8);
+  ent.addObservable(a, -1, 1);
+  ent.addObservable(b, -1, 1);
+  slow.addObservable(a, -1, 1);
+  slow.addObservable(b, -1, 1);
+  Discretisizer da(8, -1, 1, false), db(8, -1, 1, false);
+  vector<long> counts(64, 0);
+  same = true;
+  for(int t = 0; t < 1000; t++){
+    a = sequence(t);
+    b = sequence(t + 3) * 0.5;
+    counts[da.getBinNumber(a) + 8*db.getBinNumber(b)]++;
+    ent.step();
+    slow.step();
+    double h = denseEntropy(counts);
+    same &= fabs(ent.getValue() - h) < 1e-9 && fabs(slow.getValue() - h) < 1e-12;
+  }
+  unit_assert( "unseen bins", count(counts.begin(), counts.end(), 0) > 32 );
+  unit_assert( "entropy == dense entropy", same );
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Statistics Tests" )
+  ADD_TEST( CheckSelectionAnalysation )
+  ADD_TEST( CheckStatisticsEngine )
+  ADD_TEST( CheckStatisticMeasureStepSize )
+  ADD_TEST( CheckHashedHistogram )
+  ADD_TEST( CheckHashedMutualInformation )
+
+  UNIT_TEST_END
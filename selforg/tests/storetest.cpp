@@ -0,0 +1,213 @@
+/***************************************************************************
+                          storetest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the binary matrix format and checkpoint sets
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/matrix.h>
+#include <selforg/checkpointset.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace matrix;
+
+/// matrix with values that are not representable in short decimal form
+Matrix testMatrix(int m, int n){
+  Matrix M(m,n);
+  for(int i = 0; i < m; i++)
+    for(int j = 0; j < n; j++)
+      M.val(i,j) = sin(1.0 + i*n + j)/3.0 + (i == j ? 1e-17 : 0);
+  return M;
+}
+
+/// true if both matrices have the same size and bit identical values
+bool bitEqual(const Matrix& a, const Matrix& b){
+  if(a.getM() != b.getM() || a.getN() != b.getN()) return false;
+  return a.size() == 0 || memcmp(a.unsafeGetData(), b.unsafeGetData(), sizeof(double)*a.size()) == 0;
+}
+
+/// reads the whole file into bytes
+vector<char> readAll(FILE* f){
+  vector<char> bytes;
+  rewind(f);
+  int c;
+  while((c = fgetc(f)) != EOF) bytes.push_back((char)c);
+  return bytes;
+}
+
+/// writes the bytes into a new temporary file, positioned at the start
+FILE* fromBytes(const vector<char>& bytes){
+  FILE* f = tmpfile();
+  if(!bytes.empty()) fwrite(&bytes[0], 1, bytes.size(), f);
+  rewind(f);
+  return f;
+}
+
+/// layout of the binary matrix header after the identifier (see matrix.cpp)
+struct Header {
+  uint16_t byteorder;
+  uint8_t  version;
+  uint8_t  elemsize;
+  uint32_t m;
+  uint32_t n;
+  uint32_t checksum;
+  uint32_t reserved;
+};
+
+uint32_t swap32(uint32_t v){
+  return (v>>24) | ((v>>8)&0xff00) | ((v<<8)&0xff0000) | (v<<24);
+}
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckBinaryRoundTrip ) {
+  cout << "\n -[ Check binary round trip ]-\n";
+  Matrix M = testMatrix(5,7);
+  FILE* f = tmpfile();
+  unit_assert( "store", M.store(f) );
+  rewind(f);
+  Matrix R;
+  unit_assert( "restore", R.restore(f) );
+  unit_assert( "bit exact", bitEqual(M, R) );
+  fclose(f);
+
+  // empty matrix
+  Matrix E(0,0);
+  f = tmpfile();
+  unit_assert( "store empty", E.store(f) );
+  rewind(f);
+  Matrix RE = testMatrix(2,2);
+  unit_assert( "restore empty", RE.restore(f) && RE.getM() == 0 && RE.getN() == 0 );
+  fclose(f);
+  unit_pass();
+}
+
+DEFINE_TEST( CheckAsciiFormat ) {
+  cout << "\n -[ Check reading the ASCII format ]-\n";
+  Matrix M(3,2);
+  M.val(0,0) = 1.5;   M.val(0,1) = -2;
+  M.val(1,0) = 0.25;  M.val(1,1) = 1000;
+  M.val(2,0) = -0.125; M.val(2,1) = 3;
+  FILE* f = tmpfile();
+  unit_assert( "write", M.write(f) );
+  rewind(f);
+  Matrix R;
+  unit_assert( "restore", R.restore(f) );
+  unit_assert( "values", R == M );
+  fclose(f);
+  unit_pass();
+}
+
+DEFINE_TEST( CheckByteSwapped ) {
+  cout << "\n -[ Check byte swapped header ]-\n";
+  Matrix M = testMatrix(4,3);
+  // what a writer with the other byte order produces
+  vector<char> payload(sizeof(double)*M.size());
+  memcpy(&payload[0], M.unsafeGetData(), payload.size());
+  for(size_t i = 0; i < M.size(); i++)
+    reverse(payload.begin()+i*sizeof(double), payload.begin()+(i+1)*sizeof(double));
+  Header h;
+  h.byteorder = 0x0201;
+  h.version   = 1;
+  h.elemsize  = sizeof(double);
+  h.m         = swap32(4);
+  h.n         = swap32(3);
+  h.checksum  = swap32(Storeable::checksum(&payload[0], payload.size()));
+  h.reserved  = 0;
+  vector<char> bytes(4 + sizeof(h));
+  memcpy(&bytes[0], "LPZM", 4);
+  memcpy(&bytes[4], &h, sizeof(h));
+  bytes.insert(bytes.end(), payload.begin(), payload.end());
+
+  FILE* f = fromBytes(bytes);
+  Matrix R;
+  unit_assert( "restore", R.restore(f) );
+  unit_assert( "bit exact", bitEqual(M, R) );
+  fclose(f);
+
+  // an unknown byte order mark is rejected
+  h.byteorder = 0x0303;
+  memcpy(&bytes[4], &h, sizeof(h));
+  f = fromBytes(bytes);
+  unit_assert( "bad byte order", !R.restore(f) );
+  fclose(f);
+  unit_pass();
+}
+
+DEFINE_TEST( CheckCorruption ) {
+  cout << "\n -[ Check corrupted data ]-\n";
+  Matrix M = testMatrix(6,6);
+  FILE* f = tmpfile();
+  M.store(f);
+  vector<char> bytes = readAll(f);
+  fclose(f);
+
+  vector<char> corrupt(bytes);
+  corrupt[corrupt.size()-3] ^= 0x10;
+  f = fromBytes(corrupt);
+  Matrix R;
+  unit_assert( "corrupted payload", !R.restore(f) );
+  fclose(f);
+
+  vector<char> truncated(bytes.begin(), bytes.end()-5);
+  f = fromBytes(truncated);
+  unit_assert( "truncated payload", !R.restore(f) );
+  fclose(f);
+  unit_pass();
+}
+
+DEFINE_TEST( CheckCheckpointSet ) {
+  cout << "\n -[ Check CheckpointSet ]-\n";
+  const char* filename = "storetest.chk";
+  Matrix A = testMatrix(3,4);
+  Matrix B = testMatrix(1,9);
+  CheckpointSet s;
+  s.add("A", &A);
+  s.add("B", &B);
+  unit_assert( "save", s.save(filename) );
+  vector<string> names = CheckpointSet::getNames(filename);
+  unit_assert( "names", names.size() == 2 && names[0] == "A" && names[1] == "B" );
+
+  Matrix A2, B2;
+  CheckpointSet l;
+  l.add("B", &B2);
+  l.add("A", &A2);
+  unit_assert( "load", l.load(filename) );
+  unit_assert( "restored", bitEqual(A, A2) && bitEqual(B, B2) );
+
+  // an object that is not in the file
+  Matrix A3, C;
+  CheckpointSet m;
+  m.add("A", &A3);
+  m.add("C", &C);
+  unit_assert( "missing", !m.load(filename) );
+  A3 = Matrix();
+  unit_assert( "missing ok", m.load(filename, true) );
+  unit_assert( "others restored", bitEqual(A, A3) && C.getM() == 0 );
+
+  unit_assert( "no file", !l.load("storetest_missing.chk") );
+  unlink(filename);
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Store Tests" )
+  ADD_TEST( CheckBinaryRoundTrip )
+  ADD_TEST( CheckAsciiFormat )
+  ADD_TEST( CheckByteSwapped )
+  ADD_TEST( CheckCorruption )
+  ADD_TEST( CheckCheckpointSet )
+
+  UNIT_TEST_END
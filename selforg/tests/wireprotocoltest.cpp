@@ -0,0 +1,224 @@
+/***************************************************************************
+                          wireprotocoltest.cpp  -  description
+                             -------------------
+    email                : georg.martius@web.de
+***************************************************************************/
+// Tests for the binary protocol of remote controllers
+//
+/***************************************************************************/
+
+#include "unit_test.hpp"
+
+#include <selforg/wireprotocol.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <vector>
+#include <sstream>
+
+using namespace std;
+
+/** receives a frame from the given bytes as the transports do.
+    Only bytes.size() bytes are available, a frame that needs more is truncated.
+ */
+bool receiveFrom(WireFrame& frame, const vector<char>& bytes){
+  if(bytes.size() < sizeof(WireFrame::Header)) return false;
+  memcpy(frame.prepareHeader(), &bytes[0], sizeof(WireFrame::Header));
+  char* payload = frame.preparePayload();
+  if(!payload) return false;
+  size_t len = frame.size() - sizeof(WireFrame::Header);
+  if(bytes.size() - sizeof(WireFrame::Header) < len) return false;
+  memcpy(payload, &bytes[sizeof(WireFrame::Header)], len);
+  return frame.finishReceive();
+}
+
+vector<char> bytesOf(const WireFrame& frame){
+  return vector<char>(frame.data(), frame.data() + frame.size());
+}
+
+/// sensor frame with three agents of different sizes
+void fillFrame(WireFrame& frame){
+  frame.begin(WireFrame::SENSORS, 42);
+  for(uint32_t a = 0; a < 3; a++){
+    vector<double> v(2 + 3*a);
+    for(size_t i = 0; i < v.size(); i++) v[i] = a + 0.1*i;
+    frame.addAgent(10 + a, v.data(), v.size());
+  }
+}
+
+bool checkFrame(const WireFrame& frame){
+  if(frame.getType() != WireFrame::SENSORS || frame.getStep() != 42 || frame.getAgentNumber() != 3)
+    return false;
+  for(int a = 0; a < 3; a++){
+    uint32_t agent, n;
+    const double* v = frame.getAgent(a, agent, n);
+    if(agent != (uint32_t)(10 + a) || n != (uint32_t)(2 + 3*a)) return false;
+    for(uint32_t i = 0; i < n; i++)
+      if(v[i] != a + 0.1*i) return false;
+  }
+  uint32_t n;
+  return frame.findAgent(11, n) && n == 5 && !frame.findAgent(13, n) && n == 0;
+}
+
+/// writes a 32 bit number at the given offset into the raw frame
+void setUint32(vector<char>& bytes, size_t offset, uint32_t value){
+  memcpy(&bytes[offset], &value, sizeof(uint32_t));
+}
+
+const size_t lengthOffset  = 12;
+const size_t versionOffset = 4;
+const size_t payloadOffset = sizeof(WireFrame::Header);
+
+/// gives access to the socket
+class TestTcpTransport : public TcpWireTransport {
+public:
+  void setSocket(int s) { sock = s; }
+};
+
+/// gives access to the raw ring buffer
+class TestShmTransport : public ShmWireTransport {
+public:
+  TestShmTransport(const string& name, bool create) : ShmWireTransport(name, create, 4096) {}
+  bool writeRaw(const char* buf, size_t len) { return write(buf, len); }
+};
+
+UNIT_TEST_DEFINES
+
+DEFINE_TEST( CheckValidFrame ) {
+  cout << "\n -[ Check multi agent frame ]-\n";
+  WireFrame frame;
+  fillFrame(frame);
+  unit_assert( "created", checkFrame(frame) );
+  WireFrame received;
+  unit_assert( "received", receiveFrom(received, bytesOf(frame)) );
+  unit_assert( "records", checkFrame(received) );
+
+  WireFrame hello, rhello;
+  hello.begin(WireFrame::HELLO, 0);
+  hello.setHello(7, 3, "robot");
+  uint32_t s, m;
+  string name;
+  unit_assert( "hello", receiveFrom(rhello, bytesOf(hello))
+               && rhello.getHello(s, m, name) && s == 7 && m == 3 && name == "robot" );
+  WireFrame param, rparam;
+  param.begin(WireFrame::PARAM, 0);
+  param.setParam("eps", 0.25);
+  double val;
+  unit_assert( "param", receiveFrom(rparam, bytesOf(param))
+               && rparam.getParam(name, val) && name == "eps" && val == 0.25 );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckInvalidFrames ) {
+  cout << "\n -[ Check invalid frames ]-\n";
+  WireFrame frame, received;
+  fillFrame(frame);
+  const vector<char> bytes = bytesOf(frame);
+  vector<char> bad;
+
+  // the length ends within the last record
+  bad = bytes;
+  setUint32(bad, lengthOffset, frame.size() - payloadOffset - 8);
+  unit_assert( "short length", !receiveFrom(received, bad) );
+  // the length ends within a record header
+  bad = bytes;
+  setUint32(bad, lengthOffset, 4);
+  unit_assert( "short record header", !receiveFrom(received, bad) );
+
+  bad = bytes;
+  bad[versionOffset] = WireFrame::Version + 1;
+  unit_assert( "bad version", !receiveFrom(received, bad) );
+  bad = bytes;
+  bad[0] ^= 0xff;
+  unit_assert( "bad magic", !receiveFrom(received, bad) );
+
+  bad = vector<char>(bytes.begin(), bytes.end() - 1);
+  unit_assert( "truncated payload", !receiveFrom(received, bad) );
+  bad = vector<char>(bytes.begin(), bytes.begin() + 10);
+  unit_assert( "truncated header", !receiveFrom(received, bad) );
+
+  // channel numbers that do not fit into the payload
+  bad = bytes;
+  setUint32(bad, payloadOffset + 4, 0xffffffff);
+  unit_assert( "oversized channels", !receiveFrom(received, bad) );
+  bad = bytes;
+  setUint32(bad, payloadOffset + 4, 0x20000000); // n*8 does not fit into 32 bit
+  unit_assert( "overflowing channels", !receiveFrom(received, bad) );
+  bad = bytes;
+  setUint32(bad, lengthOffset, 0xfffffff8);
+  unit_assert( "oversized length", !receiveFrom(received, bad) );
+
+  // strings longer than the payload
+  WireFrame hello;
+  hello.begin(WireFrame::HELLO, 0);
+  hello.setHello(1, 1, "abc");
+  bad = bytesOf(hello);
+  setUint32(bad, payloadOffset + 8, 1000);
+  uint32_t s, m;
+  string name;
+  unit_assert( "hello name", receiveFrom(received, bad) && !received.getHello(s, m, name) );
+  unit_pass();
+}
+
+DEFINE_TEST( CheckTcpTransport ) {
+  cout << "\n -[ Check TCP transport ]-\n";
+  int sv[2];
+  unit_assert( "socketpair", socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0 );
+  TestTcpTransport a, b;
+  a.setSocket(sv[0]);
+  b.setSocket(sv[1]);
+  WireFrame frame, received;
+  fillFrame(frame);
+  unit_assert( "send", a.send(frame) );
+  unit_assert( "receive", b.receive(received) && checkFrame(received) );
+  // the peer closes within the payload
+  vector<char> bytes = bytesOf(frame);
+  unit_assert( "partial", ::write(sv[0], &bytes[0], bytes.size() - 12) == (ssize_t)(bytes.size() - 12) );
+  a.close();
+  unit_assert( "truncated", !b.receive(received) );
+  b.close();
+  unit_pass();
+}
+
+DEFINE_TEST( CheckShmTransport ) {
+  cout << "\n -[ Check shared memory transport ]-\n";
+  ostringstream name;
+  name << "/lpzwiretest-" << getpid();
+  WireFrame frame, received;
+  fillFrame(frame);
+  {
+    TestShmTransport a(name.str(), true);
+    TestShmTransport b(name.str(), false);
+    unit_assert( "open", a.isOpen() && b.isOpen() );
+    // several frames wrap around the ring buffer
+    bool ok = true;
+    for(int i = 0; i < 20; i++){
+      ok &= a.send(frame);
+      ok &= b.receive(received) && checkFrame(received);
+    }
+    unit_assert( "send and receive", ok );
+    vector<char> bytes = bytesOf(frame);
+    bytes[versionOffset] = 7;
+    unit_assert( "bad version", a.writeRaw(&bytes[0], bytes.size()) && !b.receive(received) );
+  }
+  {
+    // the peer closes within the payload
+    TestShmTransport a(name.str() + "b", true);
+    TestShmTransport b(name.str() + "b", false);
+    vector<char> bytes = bytesOf(frame);
+    unit_assert( "partial", a.writeRaw(&bytes[0], bytes.size() - 12) );
+    a.close();
+    unit_assert( "truncated", !b.receive(received) );
+  }
+  unit_pass();
+}
+
+
+UNIT_TEST_RUN( "Wire Protocol Tests" )
+  ADD_TEST( CheckValidFrame )
+  ADD_TEST( CheckInvalidFrames )
+  ADD_TEST( CheckTcpTransport )
+  ADD_TEST( CheckShmTransport )
+
+  UNIT_TEST_END
@@ -0,0 +1,219 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __ASYNCLEARNER_H
+#define __ASYNCLEARNER_H
+
+#include <pthread.h>
+#include <atomic>
+#include <vector>
+#include <assert.h>
+
+/**
+ * Runs the learning of a controller in a background thread.
+ *
+ * The control thread hands over one sample per step (nextSample(), submit())
+ * and computes its actions from the latest published parameter version
+ * (fetch(), current()). The learner thread consumes the samples in order
+ * (learn()) and publishes a new parameter version after each one.
+ *
+ * Both directions are lock-free: the samples are kept in a single-producer/
+ * single-consumer ring and the versions are exchanged with a triple buffer
+ * (the learner writes into the back slot and swaps it with the middle one,
+ * the reader swaps the middle slot to the front only if it is new), so
+ * neither side ever reads a slot the other one writes.
+ * The mutex is only used to sleep: the learner when there is nothing to do,
+ * the control thread when the learner lags more than the allowed staleness.
+ *
+ * Sample and Params are copied by assignment into preallocated slots,
+ * so matrices of constant size cause no allocations after the first round.
+ * Derived classes have to call stop() in their destructor,
+ * because the thread calls the virtual learn().
+ */
+template <class Sample, class Params>
+class AsyncLearner {
+public:
+  /** @param capacity maximal number of samples in flight
+      (the staleness passed to submit() is limited to capacity-1)
+   */
+  AsyncLearner(unsigned int capacity)
+    : samples(capacity > 1 ? capacity : 2), submitted(0), learned(0),
+      middle(1), back(2), front(0),
+      started(false), quit(false), learnerSleeping(false), controlWaiting(false),
+      waits(0) {
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&cond, 0);
+    for(int i=0; i<3; i++) stamps[i]=0;
+  }
+
+  virtual ~AsyncLearner(){
+    stop();
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&mutex);
+  }
+
+  /// control thread: slot for the next sample, fill it and call submit()
+  Sample& nextSample(){
+    unsigned long s = submitted.load();
+    if(s - learned.load() >= samples.size())
+      waitForLag(samples.size()-1);
+    return samples[s % samples.size()];
+  }
+
+  /** control thread: hands the sample from nextSample() over to the learner
+      and blocks while more than maxStaleness samples are not learned yet
+      (0 means that every sample is learned before submit() returns).
+   */
+  void submit(unsigned int maxStaleness){
+    if(!started){
+      started = pthread_create(&thread, 0, run, this) == 0;
+      assert(started);
+    }
+    submitted.fetch_add(1);
+    if(learnerSleeping.load()){
+      pthread_mutex_lock(&mutex);
+      pthread_cond_broadcast(&cond);
+      pthread_mutex_unlock(&mutex);
+    }
+    if(maxStaleness >= samples.size()) maxStaleness = samples.size()-1;
+    if(submitted.load() - learned.load() > maxStaleness){
+      waits++;
+      waitForLag(maxStaleness);
+    }
+  }
+
+  /** control thread: switches to the latest published version.
+      @return true if it is a new one (then current() changed)
+   */
+  bool fetch(){
+    if(!(middle.load() & NEW)) return false;
+    front = middle.exchange(front) & ~NEW;
+    return true;
+  }
+
+  /// control thread: the parameter version obtained by the last fetch()
+  const Params& current() const { return versions[front]; }
+
+  /// control thread: number of samples that went into current()
+  unsigned long currentStamp() const { return stamps[front]; }
+
+  /// number of submitted samples
+  unsigned long getSubmitted() const { return submitted.load(); }
+
+  /// number of submitted samples that are not learned yet
+  unsigned long getLag() const { return submitted.load() - learned.load(); }
+
+  /// number of times submit() had to wait for the learner
+  unsigned long getWaits() const { return waits; }
+
+  /// control thread: blocks until all submitted samples are learned
+  void wait(){
+    waitForLag(0);
+  }
+
+  /// terminates the learner thread (pending samples are dropped)
+  void stop(){
+    if(!started) return;
+    pthread_mutex_lock(&mutex);
+    quit = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+    pthread_join(thread, 0);
+    started = false;
+    quit    = false;
+  }
+
+protected:
+  /** learner thread: learns from the sample and
+      writes the resulting parameter version into params
+   */
+  virtual void learn(const Sample& sample, Params& params) = 0;
+
+  static void* run(void* learner){
+    ((AsyncLearner*)learner)->work();
+    return 0;
+  }
+
+  void work(){
+    while(!quit){
+      unsigned long l = learned.load();
+      if(l == submitted.load()){
+        pthread_mutex_lock(&mutex);
+        learnerSleeping = true;
+        while(l == submitted.load() && !quit)
+          pthread_cond_wait(&cond, &mutex);
+        learnerSleeping = false;
+        pthread_mutex_unlock(&mutex);
+        if(quit) return;
+        continue;
+      }
+      learn(samples[l % samples.size()], versions[back]);
+      stamps[back] = l+1;
+      back = middle.exchange(back | NEW) & ~NEW;
+      learned.store(l+1);
+      if(controlWaiting.load()){
+        pthread_mutex_lock(&mutex);
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mutex);
+      }
+    }
+  }
+
+  void waitForLag(unsigned long lag){
+    if(!started) return;
+    pthread_mutex_lock(&mutex);
+    controlWaiting = true;
+    while(submitted.load() - learned.load() > lag)
+      pthread_cond_wait(&cond, &mutex);
+    controlWaiting = false;
+    pthread_mutex_unlock(&mutex);
+  }
+
+  static const int NEW = 4; // flag in middle: slot contains an unread version
+
+  std::vector<Sample> samples;    // ring, sample i is in slot i%capacity
+  std::atomic<unsigned long> submitted;
+  std::atomic<unsigned long> learned;
+
+  Params versions[3];
+  unsigned long stamps[3];        // number of learned samples per version
+  std::atomic<int> middle;        // slot index (| NEW)
+  int back;                       // owned by the learner
+  int front;                      // owned by the control thread
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;            // signals new samples, learned samples and quit
+  bool started;
+  std::atomic<bool> quit;
+  std::atomic<bool> learnerSleeping;
+  std::atomic<bool> controlWaiting;
+  unsigned long waits;
+
+private:
+  // the thread refers to this object, so it cannot be copied
+  AsyncLearner(const AsyncLearner&);
+  AsyncLearner& operator=(const AsyncLearner&);
+};
+
+#endif
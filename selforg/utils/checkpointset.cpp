@@ -0,0 +1,228 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "checkpointset.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <map>
+
+using namespace std;
+
+const int CheckpointSet::MaxNameLength;
+
+static const char* checkpointId = "LPZCKPT1";
+
+/// file header of a checkpoint
+struct CheckpointHeader {
+  char     id[8];
+  uint16_t byteorder; // 0x0102 in the byte order of the writer
+  uint16_t reserved;
+  uint32_t count;     // number of entries in the index
+};
+
+/// index entry of a checkpoint
+struct CheckpointEntry {
+  char     name[CheckpointSet::MaxNameLength+1];
+  uint64_t offset;   // from the beginning of the file
+  uint64_t length;
+  uint32_t checksum;
+  uint32_t reserved;
+};
+
+/// read-only mapping of a checkpoint file with a validated index
+class CheckpointMapping {
+public:
+  CheckpointMapping() : data(0), size(0), index(0), count(0) {}
+  ~CheckpointMapping(){ if(data) munmap(data, size); }
+
+  bool open(const string& filename){
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+      fprintf(stderr, "CheckpointSet: cannot open %s\n", filename.c_str());
+      return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(CheckpointHeader)){
+      void* p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(p != MAP_FAILED){
+        data = (char*)p;
+        size = st.st_size;
+      }
+    }
+    close(fd);
+    if(!data){
+      fprintf(stderr, "CheckpointSet: cannot map %s\n", filename.c_str());
+      return false;
+    }
+    const CheckpointHeader* h = (const CheckpointHeader*)data;
+    if(memcmp(h->id, checkpointId, 8) != 0 || h->byteorder != 0x0102){
+      fprintf(stderr, "CheckpointSet: %s is no checkpoint (of this byte order)\n", filename.c_str());
+      return false;
+    }
+    count = h->count;
+    if(sizeof(CheckpointHeader) + count*sizeof(CheckpointEntry) > size){
+      fprintf(stderr, "CheckpointSet: %s is truncated\n", filename.c_str());
+      return false;
+    }
+    index = (const CheckpointEntry*)(data + sizeof(CheckpointHeader));
+    for(uint32_t i=0; i<count; i++){
+      if(index[i].offset > size || index[i].length > size - index[i].offset
+         || index[i].name[CheckpointSet::MaxNameLength] != 0){
+        fprintf(stderr, "CheckpointSet: %s has an invalid index\n", filename.c_str());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  char* data;
+  size_t size;
+  const CheckpointEntry* index;
+  uint32_t count;
+};
+
+
+CheckpointSet::CheckpointSet(){
+}
+
+void CheckpointSet::add(const string& name, Storeable* object){
+  if((int)name.size() > MaxNameLength){
+    fprintf(stderr, "CheckpointSet: name %s is too long (truncated)\n", name.c_str());
+  }
+  Entry e;
+  e.name   = name.substr(0, MaxNameLength);
+  e.object = object;
+  entries.push_back(e);
+}
+
+void CheckpointSet::clear(){
+  entries.clear();
+}
+
+bool CheckpointSet::save(const string& filename) const {
+  // let all objects store themselves into memory
+  vector<char*> blobs(entries.size(), (char*)0);
+  vector<size_t> lengths(entries.size(), 0);
+  bool ok = true;
+  for(size_t i=0; i<entries.size() && ok; i++){
+    FILE* mem = open_memstream(&blobs[i], &lengths[i]);
+    if(!mem) { ok = false; break; }
+    ok = entries[i].object->store(mem);
+    fclose(mem);
+  }
+
+  CheckpointHeader h;
+  memcpy(h.id, checkpointId, 8);
+  h.byteorder = 0x0102;
+  h.reserved  = 0;
+  h.count     = entries.size();
+  vector<CheckpointEntry> index(entries.size());
+  uint64_t offset = sizeof(h) + index.size()*sizeof(CheckpointEntry);
+  for(size_t i=0; i<entries.size() && ok; i++){
+    memset(&index[i], 0, sizeof(CheckpointEntry));
+    strncpy(index[i].name, entries[i].name.c_str(), MaxNameLength);
+    offset = (offset + 7) & ~(uint64_t)7;
+    index[i].offset   = offset;
+    index[i].length   = lengths[i];
+    index[i].checksum = Storeable::checksum(blobs[i], lengths[i]);
+    offset += lengths[i];
+  }
+
+  string tmpname = filename + ".tmp";
+  FILE* f = ok ? fopen(tmpname.c_str(), "wb") : 0;
+  if(f){
+    static const char zeros[8] = {0};
+    long pos = sizeof(h) + index.size()*sizeof(CheckpointEntry);
+    ok = fwrite(&h, sizeof(h), 1, f) == 1
+      && (index.empty() || fwrite(&index[0], sizeof(CheckpointEntry), index.size(), f) == index.size());
+    for(size_t i=0; i<entries.size() && ok; i++){
+      long pad = index[i].offset - pos;
+      ok = (pad == 0 || fwrite(zeros, pad, 1, f) == 1)
+        && (lengths[i] == 0 || fwrite(blobs[i], lengths[i], 1, f) == 1);
+      pos = index[i].offset + lengths[i];
+    }
+    ok = (fclose(f) == 0) && ok;
+    if(ok) ok = rename(tmpname.c_str(), filename.c_str()) == 0;
+    if(!ok) unlink(tmpname.c_str());
+  } else {
+    ok = false;
+  }
+  for(size_t i=0; i<blobs.size(); i++) free(blobs[i]);
+  if(!ok)
+    fprintf(stderr, "CheckpointSet: cannot save %s\n", filename.c_str());
+  return ok;
+}
+
+bool CheckpointSet::load(const string& filename, bool missingOk){
+  CheckpointMapping map;
+  if(!map.open(filename)) return false;
+  std::map<string, const CheckpointEntry*> byName;
+  for(uint32_t i=0; i<map.count; i++){
+    byName[map.index[i].name] = &map.index[i];
+  }
+  bool ok = true;
+  for(size_t i=0; i<entries.size(); i++){
+    std::map<string, const CheckpointEntry*>::const_iterator it = byName.find(entries[i].name);
+    if(it == byName.end()){
+      if(!missingOk){
+        fprintf(stderr, "CheckpointSet: %s not found in %s\n", entries[i].name.c_str(), filename.c_str());
+        ok = false;
+      }
+      continue;
+    }
+    const CheckpointEntry* e = it->second;
+    char* blob = map.data + e->offset;
+    if(Storeable::checksum(blob, e->length) != e->checksum){
+      fprintf(stderr, "CheckpointSet: checksum mismatch for %s\n", e->name);
+      ok = false;
+      continue;
+    }
+    // the object reads directly from the mapping, an empty entry
+    //  gets an empty stream (fmemopen does not accept a size of 0)
+    FILE* mem = e->length > 0 ? fmemopen(blob, e->length, "rb") : tmpfile();
+    if(!mem || !entries[i].object->restore(mem)){
+      fprintf(stderr, "CheckpointSet: cannot restore %s\n", e->name);
+      ok = false;
+    }
+    if(mem) fclose(mem);
+  }
+  return ok;
+}
+
+vector<string> CheckpointSet::getNames(const string& filename){
+  vector<string> names;
+  CheckpointMapping map;
+  if(map.open(filename)){
+    for(uint32_t i=0; i<map.count; i++)
+      names.push_back(map.index[i].name);
+  }
+  return names;
+}
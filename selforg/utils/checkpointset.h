@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __CHECKPOINTSET_H
+#define __CHECKPOINTSET_H
+
+#include <string>
+#include <vector>
+#include "storeable.h"
+
+/**
+ * Stores many Storeable objects (e.g. the controllers of all agents or
+ * of a whole population) into one checkpoint file and restores them.
+ *
+ * The file consists of a header, an index with name, offset, length and
+ * checksum of each object and the objects as written by their store()
+ * (aligned to 8 bytes). For loading, the file is mapped into memory and
+ * each object is restored directly from its part of the mapping.
+ * Saving writes to a temporary file which is renamed at the end,
+ * such that an existing checkpoint is never left half written.
+ */
+class CheckpointSet {
+public:
+  /// maximal length of the names of the entries
+  static const int MaxNameLength = 63;
+
+  CheckpointSet();
+
+  /** registers an object under the given (unique) name.
+      The object is not owned by the set.
+   */
+  void add(const std::string& name, Storeable* object);
+
+  /// removes all registered objects
+  void clear();
+
+  /// number of registered objects
+  int size() const { return (int)entries.size(); }
+
+  /// stores all registered objects into the given file
+  bool save(const std::string& filename) const;
+
+  /** restores the registered objects from the given file (matched by name).
+      @param missingOk if true objects that are not in the file are skipped,
+        otherwise this is an error
+      @return false if the file is invalid or an object could not be restored
+  */
+  bool load(const std::string& filename, bool missingOk = false);
+
+  /// returns the names of the objects stored in the given file
+  static std::vector<std::string> getNames(const std::string& filename);
+
+protected:
+  struct Entry {
+    std::string name;
+    Storeable* object;
+  };
+  std::vector<Entry> entries;
+};
+
+#endif
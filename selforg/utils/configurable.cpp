@@ -33,6 +33,10 @@
 using namespace std;
 
 #ifndef AVR
+#include <atomic>
+
+/// global version counter of the parameter change log
+static std::atomic<unsigned long> paramLogVersion(0);
 
 bool Configurable::storeCfg(const char* filenamestem,
                 const std::list< std::string>& comments){
@@ -129,7 +133,10 @@ bool Configurable::setParam(const paramkey& key, paramval val, bool traverseChil
       }
     }
   }
-  if(valueSet) notifyOnChange(key);
+  if(valueSet) {
+    notifyOnChange(key);
+    logChange(getParamHandle(key));
+  }
   // search in all configurable children
   if (traverseChildren) {
     FOREACHC(configurableList, ListOfConfigurableChildren, conf) {
@@ -192,6 +199,65 @@ bool Configurable::hasParamDescr(const paramkey& key, bool traverseChildren) con
   return false;
 }
 
+void Configurable::registerParam(const paramkey& key, ParamType type, void* ptr){
+  map<paramkey, paramhandle>::const_iterator it = mapOfHandles.find(key);
+  if(it != mapOfHandles.end()){
+    params[it->second].type = type;
+    params[it->second].ptr  = ptr;
+  } else {
+    ParamEntry e;
+    e.key     = key;
+    e.type    = type;
+    e.ptr     = ptr;
+    e.version = 0;
+    mapOfHandles[key] = params.size();
+    params.push_back(e);
+  }
+}
+
+Configurable::paramhandle Configurable::getParamHandle(const paramkey& key) const {
+  map<paramkey, paramhandle>::const_iterator it = mapOfHandles.find(key);
+  return it != mapOfHandles.end() ? it->second : -1;
+}
+
+bool Configurable::setParamByHandle(paramhandle h, paramval val){
+  if(h < 0 || h >= (int)params.size()) return false;
+  // dispatch through setParam, such that overloaded versions (which e.g.
+  //  apply the new value to the robot) are called as well
+  paramversion before = params[h].version;
+  bool rv = setParam(params[h].key, val, false);
+  // an overloaded setParam that does not call the base version is not logged there
+  if(rv && params[h].version == before){
+    logChange(h);
+  }
+  return rv;
+}
+
+Configurable::paramversion Configurable::getParamLogVersion(){
+  return paramLogVersion.load();
+}
+
+void Configurable::logChange(paramhandle h){
+  if(h < 0) return;
+  paramversion v = ++paramLogVersion;
+  params[h].version = v;
+  // the subtree version of all parents changes as well
+  for(Configurable* c = this; c; c = c->parent){
+    c->lastChange = v;
+    c->callBack(CALLBACK_PARAM_CHANGED);
+  }
+}
+
+Configurable::paramversion Configurable::getChangedParams(paramversion since,
+                                                           std::vector<paramhandle>& changed) const {
+  paramversion now = paramLogVersion.load();
+  if(lastChange <= since) return now;
+  for(int h = 0; h < (int)params.size(); h++){
+    if(params[h].version > since) changed.push_back(h);
+  }
+  return now;
+}
+
 // copies the internal params of the given configurable
 void Configurable::copyParameters(const Configurable& c, bool traverseChildren){
   mapOfValues  = c.mapOfValues;
@@ -201,6 +267,8 @@ void Configurable::copyParameters(const Configurable& c, bool traverseChildren){
 
   mapOfValBounds = c.mapOfValBounds;
   mapOfIntBounds = c.mapOfIntBounds;
+  params         = c.params;
+  mapOfHandles   = c.mapOfHandles;
   if (traverseChildren) {
     ListOfConfigurableChildren = c.ListOfConfigurableChildren;
     parent = c.parent;
@@ -32,6 +32,7 @@
 #include <utility>
 #include <string>
 #include <map>
+#include <vector>
 #include "stl_adds.h"
 #include "backcaller.h"
 
@@ -76,6 +77,17 @@
  \code
  #Something I don\'t care
  \endcode
+
+ * Handles and change log:
+ Every parameter added with addParameter() gets a stable integer handle
+ (its registration index, see getParamHandle()), which allows to read and write
+ it without string lookups. All changes done with setParam(), setParamByHandle()
+ or parse() are recorded with a global, increasing version number.
+ Consumers remember the version they have seen (getParamLogVersion()),
+ subscribe with addCallbackable(..., CALLBACK_PARAM_CHANGED) if they want to
+ be woken up, and fetch only the changed parameters with getChangedParams().
+ getLastChangeVersion() also covers all children, so unchanged subtrees can be skipped.
+ Direct writes to the parameter variables are not recorded.
  */
 
 class Configurable : public BackCaller
@@ -118,6 +130,13 @@ class Configurable : public BackCaller
 
     typedef std::vector<Configurable*> configurableList;
 
+    /// stable handle of a parameter (index in registration order, -1: unknown)
+    typedef int paramhandle;
+    /// version number of the parameter change log
+    typedef unsigned long paramversion;
+    /// type of a registered parameter
+    enum ParamType { PARAM_VAL, PARAM_INT, PARAM_BOOL };
+
     /// nice predicate function for finding by ID
     struct matchId
     {
@@ -138,12 +157,16 @@ class Configurable : public BackCaller
     Configurable()
     {
       id = rand();
+      lastChange = 0;
+      parent = 0;
     }
     /// intialise with name and revision (use "$ID$")
     Configurable(const std::string& name, const std::string& revision) :
       name(name), revision(revision)
     {
       id = rand();
+      lastChange = 0;
+      parent = 0;
     }
 
 //   Configurable(const Configurable& copy)
@@ -176,6 +199,7 @@ class Configurable : public BackCaller
                               paramval minBound, paramval maxBound,
                               const paramdescr& descr = paramdescr() ) {
       mapOfValues[key] = val;
+      registerParam(key, PARAM_VAL, val);
       if (minBound>*val) minBound = (*val)>0 ? 0 : (*val)*2;
       if (maxBound<*val) maxBound = (*val)>0 ? (*val)*2 : 0;
       if(!descr.empty()) mapOfDescr[key] = descr;
@@ -195,6 +219,7 @@ class Configurable : public BackCaller
     virtual void addParameter(const paramkey& key, parambool* val,
                             const paramdescr& descr = paramdescr()) {
       mapOfBoolean[key] = val;
+      registerParam(key, PARAM_BOOL, val);
       if(!descr.empty()) mapOfDescr[key] = descr;
     }
 
@@ -205,6 +230,7 @@ class Configurable : public BackCaller
                               paramint minBound, paramint maxBound,
                               const paramdescr& descr = paramdescr()) {
       mapOfInteger[key] = val;
+      registerParam(key, PARAM_INT, val);
       if (minBound>*val) minBound = (*val)>0 ? 0 : (*val)*2;
       if (maxBound<*val) maxBound = (*val)>0 ? (*val)*2 : 0;
       if(!descr.empty()) mapOfDescr[key] = descr;
@@ -303,6 +329,49 @@ class Configurable : public BackCaller
      */
     virtual bool setParam(const paramkey& key, paramval val, bool traverseChildren = true);
 
+    /// returns the handle of the given parameter of this object (not of the children) or -1
+    paramhandle getParamHandle(const paramkey& key) const;
+
+    /// number of parameters added with addParameter(), their handles are 0..getParamCount()-1
+    int getParamCount() const { return params.size(); }
+
+    /// key of the parameter with the given handle
+    const paramkey& getParamKey(paramhandle h) const { return params[h].key; }
+
+    /// type of the parameter with the given handle
+    ParamType getParamType(paramhandle h) const { return params[h].type; }
+
+    /// value of the parameter with the given handle (no lookup)
+    paramval getParamByHandle(paramhandle h) const {
+      const ParamEntry& p = params[h];
+      switch(p.type){
+      case PARAM_INT:  return *(paramint*)p.ptr;
+      case PARAM_BOOL: return *(parambool*)p.ptr;
+      default:         return *(paramval*)p.ptr;
+      }
+    }
+
+    /** sets the parameter with the given handle (of this object) and records the change.
+        Calls setParam(getParamKey(h), val, false), so overloaded versions of setParam
+        and notifyOnChange() see the change as well.
+     */
+    virtual bool setParamByHandle(paramhandle h, paramval val);
+
+    /// the current version of the (global) change log
+    static paramversion getParamLogVersion();
+
+    /// version of the last recorded change of the given parameter (0: never changed)
+    paramversion getParamVersion(paramhandle h) const { return params[h].version; }
+
+    /// version of the last recorded change of this object or any of its children
+    paramversion getLastChangeVersion() const { return lastChange; }
+
+    /** appends the handles of all parameters of this object (not of the children)
+        that changed after the given version to changed.
+        @return the current version of the change log, to be passed as since next time
+     */
+    paramversion getChangedParams(paramversion since, std::vector<paramhandle>& changed) const;
+
     /**
      * Sets the bounds (minBound and maxBound) of the given parameter.
      * Not useful for parambool.
@@ -393,6 +462,10 @@ class Configurable : public BackCaller
     virtual void configurableChanged();
 
     static const CallbackableType CALLBACK_CONFIGURABLE_CHANGED = 11;
+    /** called (via the callbackable interface) after a parameter of this object
+        or of one of its children was changed and recorded in the change log
+     */
+    static const CallbackableType CALLBACK_PARAM_CHANGED = 12;
 
   protected:
     /// copies the internal params of the given configurable
@@ -418,6 +491,22 @@ class Configurable : public BackCaller
 
     void initParamBounds(const paramkey& key);
 
+    /// registry entry of a parameter
+    struct ParamEntry {
+      paramkey key;
+      ParamType type;
+      void* ptr;
+      paramversion version;
+    };
+    std::vector<ParamEntry> params;
+    std::map<paramkey, paramhandle> mapOfHandles;
+    paramversion lastChange;
+
+    /// adds the parameter to the registry (or updates it if the key is known)
+    void registerParam(const paramkey& key, ParamType type, void* ptr);
+    /// records the change of the parameter in the log and notifies the subscribers
+    void logChange(paramhandle h);
+
     configurableList ListOfConfigurableChildren;
     Configurable* parent;
 };
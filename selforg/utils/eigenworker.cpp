@@ -0,0 +1,133 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#include "eigenworker.h"
+#include "matrixutils.h"
+
+using namespace matrix;
+
+EigenWorker::EigenWorker(bool vectors, bool normalizeVectors)
+  : vectors(vectors), normalizeVectors(normalizeVectors),
+    started(false), quit(false), pending(false), running(false), fresh(false) {
+  pthread_mutex_init(&mutex, 0);
+  pthread_cond_init(&cond, 0);
+}
+
+EigenWorker::~EigenWorker(){
+  pthread_mutex_lock(&mutex);
+  quit = true;
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+  if(started)
+    pthread_join(thread, 0);
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+}
+
+void EigenWorker::submit(const Matrix& m){
+  pthread_mutex_lock(&mutex);
+  input   = m;
+  pending = true;
+  if(!started){
+    started = pthread_create(&thread, 0, run, this) == 0;
+  }
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+}
+
+bool EigenWorker::fetch(Matrix& vals_real, Matrix& vals_imag,
+                        Matrix& vecs_real, Matrix& vecs_imag){
+  // we do not wait for the lock, if the worker publishes right now we get it next time
+  if(pthread_mutex_trylock(&mutex) != 0) return false;
+  bool res = fresh;
+  if(fresh){
+    vals_real = valsRe;
+    vals_imag = valsIm;
+    if(vectors){
+      vecs_real = vecsRe;
+      vecs_imag = vecsIm;
+    }
+    fresh = false;
+  }
+  pthread_mutex_unlock(&mutex);
+  return res;
+}
+
+bool EigenWorker::isBusy(){
+  pthread_mutex_lock(&mutex);
+  bool busy = pending || running;
+  pthread_mutex_unlock(&mutex);
+  return busy;
+}
+
+void EigenWorker::wait(){
+  pthread_mutex_lock(&mutex);
+  while((pending || running) && started)
+    pthread_cond_wait(&cond, &mutex);
+  pthread_mutex_unlock(&mutex);
+}
+
+void* EigenWorker::run(void* worker){
+  ((EigenWorker*)worker)->work();
+  return 0;
+}
+
+void EigenWorker::work(){
+  Matrix m, re, im, vre, vim;
+  pthread_mutex_lock(&mutex);
+  while(true){
+    while(!pending && !quit)
+      pthread_cond_wait(&cond, &mutex);
+    if(quit) break;
+    m = input;
+    pending = false;
+    running = true;
+    pthread_mutex_unlock(&mutex);
+
+    // the decomposition runs without holding the lock
+    bool ok;
+    if(vectors){
+      ok = eigenValuesVectors(m, re, im, vre, vim);
+      if(ok && normalizeVectors){
+        toPositiveSignEigenVectors(vre, vim);
+        scaleEigenVectorsWithValue(re, im, vre, vim);
+      }
+    } else {
+      ok = eigenValues(m, re, im);
+    }
+
+    pthread_mutex_lock(&mutex);
+    if(ok){
+      valsRe = re;
+      valsIm = im;
+      if(vectors){
+        vecsRe = vre;
+        vecsIm = vim;
+      }
+      fresh = true;
+    }
+    running = false;
+    pthread_cond_broadcast(&cond);
+  }
+  pthread_mutex_unlock(&mutex);
+}
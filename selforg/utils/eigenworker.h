@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __EIGENWORKER_H
+#define __EIGENWORKER_H
+
+#include <pthread.h>
+#include "matrix.h"
+
+/**
+ * Computes eigenvalues (and eigenvectors) of a matrix in a background thread.
+ * The control thread submits a matrix with submit() (without waiting) and
+ * collects the latest decomposition with fetch() a few steps later.
+ * If a new matrix is submitted while the last one is still waiting,
+ * the waiting one is replaced (the newest matrix wins).
+ * The thread is started with the first submit.
+ */
+class EigenWorker {
+public:
+  /** @param vectors if true the eigenvectors are calculated as well
+      @param normalizeVectors if true the eigenvectors get a positive sign
+       and are scaled with the absolute value of their eigenvalue
+       (@see matrix::toPositiveSignEigenVectors, matrix::scaleEigenVectorsWithValue)
+   */
+  EigenWorker(bool vectors = true, bool normalizeVectors = false);
+  ~EigenWorker();
+
+  /// hands the matrix (square) over for decomposition (does not block)
+  void submit(const matrix::Matrix& m);
+
+  /** copies the latest decomposition if there was a new one since the last call.
+      The vectors are only set if calculated (@see EigenWorker()).
+      @return true if the results are new
+   */
+  bool fetch(matrix::Matrix& vals_real, matrix::Matrix& vals_imag,
+             matrix::Matrix& vecs_real, matrix::Matrix& vecs_imag);
+
+  /// returns true if a decomposition is waiting or running
+  bool isBusy();
+
+  /// blocks until all submitted matrices are decomposed
+  void wait();
+
+protected:
+  static void* run(void* worker);
+  void work();
+
+  bool vectors;
+  bool normalizeVectors;
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond; // signals new input, finished work and quit
+  bool started;
+  bool quit;
+  bool pending;  // input waits to be processed
+  bool running;  // input is being processed
+  bool fresh;    // result not fetched yet
+
+  matrix::Matrix input;
+  matrix::Matrix valsRe, valsIm, vecsRe, vecsIm; // latest results
+
+private:
+  // the thread refers to this object, so it cannot be copied
+  EigenWorker(const EigenWorker&);
+  EigenWorker& operator=(const EigenWorker&);
+};
+
+#endif
@@ -24,10 +24,21 @@
 #include "inspectable.h"
 #include "controller_misc.h"
 #include "stl_adds.h"
+#include <atomic>
+
+/// global counter for the structure versions
+static std::atomic<unsigned long> inspectableVersion(0);
 
 Inspectable::~Inspectable(){}
 
-Inspectable::Inspectable(const iparamkey& name) : name(name), parent(0) {}
+Inspectable::Inspectable(const iparamkey& name) : name(name), parent(0), version(0) {}
+
+void Inspectable::inspectableStructureChanged(){
+  unsigned long v = ++inspectableVersion;
+  for(Inspectable* i = this; i; i = i->parent){
+    i->version = v;
+  }
+}
 
 
 Inspectable::iparamkeylist Inspectable::getInternalParamNames() const {
@@ -74,6 +85,52 @@ Inspectable::iparamvalptrlist Inspectable::getInternalParamsPtr() const {
 }
 
 
+bool Inspectable::getInternalParamRefs(iparamreflist& refs) const {
+  // overloaded names (e.g. additional custom values) cannot be served from the registry
+  if(getInternalParamNames() != Inspectable::getInternalParamNames())
+    return false;
+  IParamRef r;
+  FOREACHC(imatrixpairlist, mapOfMatrices, m){
+    const matrix::Matrix* mat = m->second.first;
+    r.val = 0;
+    r.m   = mat;
+    if(mat->isVector() || !m->second.second){
+      for(int k = 0; k < (int)mat->size(); k++){
+        r.index = k;
+        refs.push_back(r);
+      }
+    } else { // same order as store4x4AndDiagonal
+      int n = mat->getN();
+      int smalldimM  = std::min(mat->getM(), (matrix::I)4);
+      int smalldimN  = std::min(mat->getN(), (matrix::I)4);
+      int smallerdim = std::min(mat->getM(), mat->getN());
+      for(int i = 0; i < smalldimM; i++){
+        for(int j = 0; j < smalldimN; j++){
+          r.index = i*n + j;
+          refs.push_back(r);
+        }
+      }
+      for(int i = 4; i < smallerdim; i++){
+        r.index = i*n + i;
+        refs.push_back(r);
+      }
+    }
+  }
+  r.m = 0;
+  r.index = 0;
+  FOREACHC(iparampairlist, mapOfValues, it){
+    r.val = it->second;
+    refs.push_back(r);
+  }
+  return true;
+}
+
+Inspectable::iparamval Inspectable::getParamRefValue(const IParamRef& ref){
+  if(ref.m) // the structure must not change after the names are queried, but be safe
+    return ref.index < (int)ref.m->size() ? ref.m->unsafeGetData()[ref.index] : 0;
+  return *ref.val;
+}
+
 Inspectable::ilayerlist Inspectable::getStructuralLayers() const {
   return std::list<ILayer>();
 }
@@ -85,6 +142,7 @@ Inspectable::iconnectionlist Inspectable::getStructuralConnections() const {
 void Inspectable::addInspectableValue(const iparamkey& key, iparamval const* val,
                                       const std::string& descr) {
   mapOfValues+=iparampair(key,val);
+  inspectableStructureChanged();
   if(!descr.empty())
     addInspectableDescription(key, descr);
 }
@@ -92,6 +150,7 @@ void Inspectable::addInspectableValue(const iparamkey& key, iparamval const* val
 void Inspectable::addInspectableMatrix(const iparamkey& key, const matrix::Matrix* m,
                                        bool only4x4AndDiag, const std::string& descr) {
   mapOfMatrices+=imatrixpair(key, std::pair<const matrix::Matrix*, bool>(m, only4x4AndDiag) );
+  inspectableStructureChanged();
   if(!descr.empty())
     addInspectableDescription(key+"_", descr);
 }
@@ -128,11 +187,13 @@ void Inspectable::removeInfoLines() {
 void Inspectable::addInspectable(Inspectable* insp) {
   listOfInspectableChildren.push_back(insp);
   insp->parent=this;
+  inspectableStructureChanged();
 }
 
 void Inspectable::removeInspectable(Inspectable* insp) {
   removeElement(listOfInspectableChildren, insp);
   insp->parent=0;
+  inspectableStructureChanged();
 }
 
 void Inspectable::setNameOfInspectable(const iparamkey& _name) {
@@ -27,6 +27,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <utility>
 #include <string>
 #include "stl_adds.h"
@@ -99,6 +100,17 @@ public:
 
   typedef std::list<const Inspectable*> inspectableList;
 
+  /** reference to one value registered with addInspectableValue() or to one
+      element of a matrix registered with addInspectableMatrix().
+      Matrix elements are referenced by index, because the matrix may
+      reallocate its data.
+   */
+  typedef struct IParamRef {
+    iparamval const* val;      ///< the value (0 for matrix elements)
+    const matrix::Matrix* m;   ///< the matrix (0 for single values)
+    int index;                 ///< index into the (row-major) data of m
+  } IParamRef;
+  typedef std::vector<IParamRef> iparamreflist;
 
 
   /// TYPEDEFS END
@@ -129,6 +141,25 @@ public:
    */
   virtual iparamvalptrlist getInternalParamsPtr() const;
 
+  /** Appends references to all internal parameters in the order of
+      getInternalParamNames() to refs. The position in refs serves as a
+      stable handle as long as getInspectableVersion() does not change.
+      Consumers can then read the values with getParamRefValue() without
+      building lists.
+      Returns false (and leaves refs unchanged) if the inspectable overloads
+      getInternalParamNames() such that its parameters are not the registered
+      ones; then getInternalParams() has to be used.
+   */
+  virtual bool getInternalParamRefs(iparamreflist& refs) const;
+
+  /// the current value of the referenced parameter
+  static iparamval getParamRefValue(const IParamRef& ref);
+
+  /** version of the structure of this inspectable and its children.
+      It increases whenever values, matrices or children are added or removed.
+   */
+  unsigned long getInspectableVersion() const { return version; }
+
   /** Specifies which parameter vector forms a structural layer (in terms of a neural network)
       The ordering is important. The first entry is the input layer and so on.
       @return: list of layer names with dimension
@@ -251,6 +282,9 @@ public:
   */
 
 protected:
+  /// to be called when the registered values change, updates the version of all parents
+  void inspectableStructureChanged();
+
   iparamkey name;
 
   iparampairlist mapOfValues;
@@ -262,6 +296,7 @@ private:
   inspectableList listOfInspectableChildren;
   bool printParentName;
   Inspectable* parent;
+  unsigned long version;
 
 
 };
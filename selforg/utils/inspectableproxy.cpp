@@ -24,6 +24,7 @@
 
 #include "inspectableproxy.h"
 #include <string>
+#include <map>
 
 InspectableProxy::InspectableProxy(const iparamkey& name) : Inspectable(name) {
         // nothing
@@ -93,21 +94,27 @@ bool InspectableProxy::replaceList(const std::list<Inspectable*>& list) {
                 }
         }*/
 
+        // index the own values once instead of searching the list for every name
+        std::map<std::string, Inspectable::iparampairlist::iterator> index;
+        FOREACH(Inspectable::iparampairlist,mapOfValues,k) {
+                index.insert(std::make_pair(k->first, k));
+        }
         FOREACHC(std::list<Inspectable*>,list,i) {
                 std::list<std::string> names = (*i)->getInternalParamNames();
                 std::list<double const *> values = (*i)->getInternalParamsPtr();
                 std::list<double const*>::iterator l = values.begin();
 
                 FOREACH(std::list<std::string>,names,j) {
-                        FOREACH(Inspectable::iparampairlist,mapOfValues,k) {
-                                if(!k->first.compare(*j)){
-                                        k->second = *l;
-                                        break;
-                                }
-                        }
+                        if(l == values.end()) break;
+                        std::map<std::string, Inspectable::iparampairlist::iterator>::iterator k
+                          = index.find(*j);
+                        if(k != index.end())
+                                k->second->second = *l;
                         l++;
                 }
         }
+        // references to the old values held by consumers are invalid now
+        inspectableStructureChanged();
 
         return true;
 }
@@ -26,6 +26,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace matrix;
@@ -36,58 +37,108 @@ Lyapunov::Lyapunov(){
   buffersize = 0;
   buffer = 0;
   invbuffer = 0;
+  logbuffer = 0;
+  calcMatrices = false;
 }
 
 Lyapunov::~Lyapunov(){
   if(buffer) delete[] buffer;
   if(invbuffer) delete[] invbuffer;
+  if(logbuffer) delete[] logbuffer;
   FOREACH(Horizons, horizons, h){
     delete (h->second);
   }
 }
 
-void Lyapunov::init(const std::list<int>& hs, int dim){
+void Lyapunov::init(const std::list<int>& hs, int dim, bool calcMatrices){
+  this->calcMatrices = calcMatrices;
   list<int> myhs = hs;
   if(myhs.empty()) myhs += 0; // add infinit horizon
   list<int>::const_iterator it = max_element(myhs.begin(), myhs.end());
-  buffersize = *it;
+  // the value leaving the longest window must still be in the buffer
+  buffersize = *it + 1;
   if(buffersize < 1) buffersize = 1;
-  buffer = new Matrix[buffersize];
-  invbuffer = new Matrix[buffersize];
+  logbuffer = new Matrix[buffersize];
+  if(calcMatrices){
+    buffer = new Matrix[buffersize];
+    invbuffer = new Matrix[buffersize];
+  }
   FOREACHC(list<int>, myhs, h){
     horizons[*h]= new SlidingMatrix(dim, *h);
   }
-
+  Q.set(dim,dim);
+  Q.toId();
+  logR.set(dim,1);
 }
 
 void Lyapunov::step(const Matrix& jacobi){
-  buffer[t%buffersize]=jacobi;
-  invbuffer[t%buffersize]=jacobi^(-1);
+  int i = t%buffersize;
+  if(calcMatrices){
+    buffer[i]=jacobi;
+    invbuffer[i]=jacobi^(-1);
+  }
+  // propagate the frame: Q_t R_t = J_t Q_{t-1}
+  Matrix Z = jacobi*Q;
+  orthonormalize(Z, Q, logR);
+  Q = Z;
   FOREACH(Horizons, horizons, h){
-    h->second->step(t, buffer, invbuffer, buffersize);
+    h->second->step(t, logR, logbuffer, buffer, invbuffer, buffersize, calcMatrices);
   }
+  logbuffer[i]=logR;
   t++;
 }
 
+void Lyapunov::orthonormalize(Matrix& Z, const Matrix& Qold, Matrix& logR){
+  const unsigned int dim = Z.getM();
+  for(unsigned int j=0; j<Z.getN(); j++){
+    for(unsigned int k=0; k<j; k++){
+      double r=0;
+      for(unsigned int l=0; l<dim; l++) r+=Z.val(l,k)*Z.val(l,j);
+      for(unsigned int l=0; l<dim; l++) Z.val(l,j)-=r*Z.val(l,k);
+    }
+    double norm=0;
+    for(unsigned int l=0; l<dim; l++) norm+=Z.val(l,j)*Z.val(l,j);
+    norm=sqrt(norm);
+    if(norm < 1e-150){ // collapsed direction: keep the old one
+      norm = 1e-150;
+      for(unsigned int l=0; l<dim; l++) Z.val(l,j)=Qold.val(l,j);
+    }else{
+      for(unsigned int l=0; l<dim; l++) Z.val(l,j)/=norm;
+    }
+    logR.val(j,0)=log(norm);
+  }
+}
+
 Lyapunov::SlidingMatrix::SlidingMatrix(int dim, int horizon)
-      : horizon(horizon), M(dim,dim), Exp(dim,1) {
+  : horizon(horizon), M(dim,dim), Exp(dim,1), Sum(dim,1) {
   M.toId();
 };
 
-void Lyapunov::SlidingMatrix::step(int t, const matrix::Matrix* buffer,
-                                   const matrix::Matrix* invbuffer, int buffersize){
+void Lyapunov::SlidingMatrix::step(int t, const Matrix& logR, const Matrix* logbuffer,
+                                   const Matrix* buffer, const Matrix* invbuffer,
+                                   int buffersize, bool calcMatrix){
+  Sum+=logR;
+  int len;
   if(horizon <= 0) { // infinite horizon, we count the length negatively
     horizon--;
-  }else{             // for a finite horizon we have to divide by the old matrix
+    len = -horizon;
+  }else{             // for a finite horizon we remove the step leaving the window
     int h = t-horizon;
     if(h>=0){
-      M=invbuffer[h%buffersize]*M; // from leftside with inverse at beginning of window
+      Sum-=logbuffer[h%buffersize];
+      if(calcMatrix)
+        M=invbuffer[h%buffersize]*M; // from leftside with inverse at beginning of window
     }
+    len = min(t+1, horizon);
   }
-  M=M*buffer[t%buffersize]; // current matrix
+  Exp=Sum*(1.0/len);
+  if(calcMatrix)
+    M=M*buffer[t%buffersize]; // current matrix
 }
 
 const Matrix& Lyapunov::getLyapunovMatrix(int horizon){
+  if(!calcMatrices)
+    cerr << "Lyapunov: matrices are not calculated (see init)" << endl;
   Horizons::iterator h = horizons.find(horizon);
   if(h != horizons.end()){
     return h->second->M;
@@ -29,23 +29,34 @@
 
 /**
  *  Class for calculating lyapunov exponents
- *   online, over several time horizons, from given Jacobi matrices
+ *   online, over several time horizons, from given Jacobi matrices.
+ *  The exponents are obtained incrementally by the QR method:
+ *   the orthonormal frame Q is propagated by the Jacobian (Q_t R_t = J_t Q_{t-1})
+ *   and the logarithms of the diagonal of R_t are averaged over each horizon.
+ *   This costs O(dim^3) per step independent of the horizons and needs no matrix inverse.
+ *  The product of the Jacobians (Lyapunov matrix) is only accumulated on request
+ *   (see init()).
 */
 class Lyapunov {
 public:
-  /// holds a matrix that is the result of a sliding window multiplication
+  /// holds the results for one time horizon (sliding window)
   struct SlidingMatrix {
     /** @param dim dimension of the system (matrix is (dim x dim))
         @param horizon for sliding window
      */
     SlidingMatrix(int dim, int horizon);
-    void step(int t, const matrix::Matrix* buffer,
-              const matrix::Matrix* invbuffer, int buffersize);
+    /** updates the window with the local growth rates logR of step t.
+        buffer and invbuffer are only used (and required) if calcMatrix is true
+     */
+    void step(int t, const matrix::Matrix& logR, const matrix::Matrix* logbuffer,
+              const matrix::Matrix* buffer, const matrix::Matrix* invbuffer,
+              int buffersize, bool calcMatrix);
     /** nominal size of sliding window
         (if <=0 then infinite and absolute value stands for the size so far) */
     int horizon;
-    matrix::Matrix M;   ///<  accumulated Matrix
+    matrix::Matrix M;   ///<  accumulated Matrix (only if calculated)
     matrix::Matrix Exp; ///< Lyapunov exponents
+    matrix::Matrix Sum; ///< sum of log growth rates in the window
   };
 
   typedef HashMap< int, SlidingMatrix* > Horizons;
@@ -57,31 +68,44 @@ public:
   /** initializes with a set of horizons.
       @param horizons for each horizon # in steps. 0 means infinite
       @param dim # of dimensions (expect a (dim x dim) matrix in step)
+      @param calcMatrices if true the products of the Jacobians are
+        accumulated as well (@see getLyapunovMatrix()), which requires
+        an inverse per step
    */
-  void init(const std::list<int>& horizons, int dim);
+  void init(const std::list<int>& horizons, int dim, bool calcMatrices = false);
 
   /** provides the current Jacobi matrix.
-      Internally the sliding windows and the exponents are generated
+      Internally the exponents (and the sliding windows) are updated
    */
   void step(const matrix::Matrix& jacobi);
 
   /** returns the lyapunov matrix at the given horizon
+      (only available if initialized with calcMatrices)
    */
   const matrix::Matrix& getLyapunovMatrix(int horizon);
 
   /** returns the lyapunov exponents at the given horizon
+      (in the order of the QR decomposition, usually descending)
    */
   const matrix::Matrix& getLyapunovExp(int horizon);
 
 protected:
+  /** orthonormalizes the columns of Z in place (modified Gram-Schmidt)
+      and stores the log of the diagonal of R in logR */
+  static void orthonormalize(matrix::Matrix& Z, const matrix::Matrix& Qold, matrix::Matrix& logR);
+
   matrix::Matrix* buffer;
   matrix::Matrix* invbuffer; // buffer for inverses
+  matrix::Matrix* logbuffer; // buffer for log of diagonal of R
   int buffersize;
   long int t;
+  bool calcMatrices;
+
+  matrix::Matrix Q;    // current orthonormal frame
+  matrix::Matrix logR; // local growth rates of the current step
 
   Horizons horizons;
 };
 
 
 #endif
-
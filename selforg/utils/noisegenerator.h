@@ -28,6 +28,7 @@
 #include <time.h>
 #include <cmath>
 #include <assert.h>
+#include <vector>
 
 #include "randomgenerator.h"
 
@@ -61,6 +62,7 @@ public:
   virtual void init(unsigned int dimension, RandGen* randGen=0)
   {
     this->dimension = dimension;
+    randomBuffer.resize(dimension);
     if(randGen)
       this->randGen=randGen;
 
@@ -112,6 +114,8 @@ protected:
   unsigned int dimension;
   RandGen* randGen;
   bool ownRandGen;
+  /// random values of one step, filled in bulk by subclasses in add()
+  std::vector<double> randomBuffer;
 };
 
 /// generates no noise
@@ -122,6 +126,9 @@ public:
   virtual double generate() {
     return 0;
   };
+  /// nothing to add
+  virtual void add(double *value, double noiseStrength){
+  }
 };
 
 
@@ -133,6 +140,15 @@ public:
   virtual double generate() {
     return uniform(-1,1);
   };
+  /// same as the generic version but draws all channels at once
+  virtual void add(double *value, double noiseStrength){
+    assert(randGen);
+    double* r = randomBuffer.data();
+    randGen->fillUniform(r, dimension, -1, 1);
+    for (unsigned int i = 0; i < dimension; i++){
+      value[i]+=r[i]*noiseStrength;
+    }
+  }
 
 };
 
@@ -147,6 +163,15 @@ public:
     double x2=uniform01();
     return( (sqrt(-2*log(x1)) *cos(2*M_PI*x2)));
   };
+  /// same as the generic version but draws all channels at once
+  virtual void add(double *value, double noiseStrength){
+    assert(randGen);
+    double* r = randomBuffer.data();
+    randGen->fillNormal(r, dimension);
+    for (unsigned int i = 0; i < dimension; i++){
+      value[i]+=r[i]*noiseStrength;
+    }
+  }
   // original version
   //  virtual double generate(double mean, double stddev) {
   //    double x1=uniform(0, 1);
@@ -188,8 +213,11 @@ public:
       @param max upper bound of interval
    */
   virtual void add(double *value, double noiseStrength){
+    assert(randGen);
+    double* r = randomBuffer.data();
+    randGen->fillUniform(r, dimension, -1, 1);
     for (unsigned int i = 0; i < dimension; i++){
-      mean[i]+= sqrttau * uniform(-1,  +1)*noiseStrength - tau *  mean[i];
+      mean[i]+= sqrttau * r[i]*noiseStrength - tau *  mean[i];
       value[i]+=mean[i];
     }
   }
@@ -235,8 +263,11 @@ public:
   }
 
   virtual void add(double *value, double noiseStrength) {
+    assert(randGen);
+    double* r = randomBuffer.data();
+    randGen->fillNormal(r, dimension);
     for (unsigned int i = 0; i < dimension; i++){
-      mean[i]+=sqrttau * WhiteNormalNoise::generate()*noiseStrength - tau*mean[i];
+      mean[i]+=sqrttau * r[i]*noiseStrength - tau*mean[i];
       value[i]+=mean[i];
     }
   }
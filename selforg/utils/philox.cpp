@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#include "philox.h"
+#include <cmath>
+
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+void Philox::init(uint64_t seed, uint64_t stream){
+  key[0] = (uint32_t)seed;
+  key[1] = (uint32_t)(seed >> 32);
+  this->stream = stream;
+  counter = 0;
+  pos = 2*lanes;
+}
+
+void Philox::seek(uint64_t index){
+  counter = index/2;
+  refill();
+  pos = index%2;
+}
+
+void Philox::block(const uint32_t ctr[4], const uint32_t k[2], uint32_t out[4]){
+  uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+  uint32_t k0 = k[0], k1 = k[1];
+  for(int r=0; r<10; r++){
+    uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+    uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+    c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+    c1 = (uint32_t)p1;
+    c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+    c3 = (uint32_t)p0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+void Philox::refill(){
+  blocks(buffer, lanes);
+  pos = 0;
+}
+
+void Philox::blocks(uint64_t* out, int nblocks){
+  // structure of arrays: every round is one loop over independent lanes
+  uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+  for(int j=0; j<nblocks; j++){
+    c0[j] = (uint32_t)(counter + j);
+    c1[j] = (uint32_t)((counter + j) >> 32);
+    c2[j] = (uint32_t)stream;
+    c3[j] = (uint32_t)(stream >> 32);
+  }
+  uint32_t k0 = key[0], k1 = key[1];
+  for(int r=0; r<10; r++){
+    for(int j=0; j<nblocks; j++){
+      uint64_t p0 = (uint64_t)PHILOX_M0 * c0[j];
+      uint64_t p1 = (uint64_t)PHILOX_M1 * c2[j];
+      uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1[j] ^ k0;
+      uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3[j] ^ k1;
+      c1[j] = (uint32_t)p1;
+      c3[j] = (uint32_t)p0;
+      c0[j] = n0;
+      c2[j] = n2;
+    }
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  for(int j=0; j<nblocks; j++){
+    out[2*j]   = c0[j] | ((uint64_t)c1[j] << 32);
+    out[2*j+1] = c2[j] | ((uint64_t)c3[j] << 32);
+  }
+  counter += nblocks;
+}
+
+void Philox::fillUniform(double* out, size_t n, double min, double max){
+  const double range = max-min;
+  size_t i=0;
+  // use up the buffered values to stay in sequence with rand()
+  while(i<n && pos<2*lanes) out[i++] = toDouble(buffer[pos++])*range+min;
+  uint64_t bits[2*lanes];
+  while(n-i >= 2*lanes){
+    blocks(bits, lanes);
+    for(int j=0; j<2*lanes; j++) out[i+j] = toDouble(bits[j])*range+min;
+    i += 2*lanes;
+  }
+  if(i<n){
+    refill();
+    while(i<n) out[i++] = toDouble(buffer[pos++])*range+min;
+  }
+}
+
+void Philox::fillNormal(double* out, size_t n, double mean, double stddev){
+  double u[2*lanes];
+  size_t i=0;
+  while(i<n){
+    size_t pairs = (n-i+1)/2;
+    if(pairs > (size_t)lanes) pairs = lanes;
+    fillUniform(u, 2*pairs);
+    for(size_t j=0; j<pairs; j++){
+      // 1-u is in (0,1], so the log is finite
+      double r   = sqrt(-2*log(1.0-u[2*j]));
+      double phi = 2*M_PI*u[2*j+1];
+      double a = r*cos(phi)*stddev+mean;
+      double b = r*sin(phi)*stddev+mean;
+      out[i++] = a;
+      if(i<n) out[i++] = b;
+    }
+  }
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __PHILOX_H
+#define __PHILOX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/** Counter based random generator Philox4x32-10
+    (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11).
+
+    The n-th output of a stream is a pure function of (seed, stream, n):
+    the 64 bit seed is the key and the block counter together with the
+    64 bit stream id form the 128 bit counter. Every agent or thread can
+    therefore derive its own stream from a common seed, and the results do
+    not depend on how the work is distributed over threads.
+    Each block yields 4x32 bits, i.e. two doubles with 52 random bits.
+
+    rand() and the bulk functions draw from the same sequence and can be
+    mixed freely. Blocks are always computed several at once in plain loops
+    over independent lanes, which the compiler vectorises (use -O3).
+ */
+class Philox {
+public:
+  Philox(uint64_t seed=0, uint64_t stream=0) { init(seed, stream); }
+
+  /// restarts the given stream at its beginning
+  void init(uint64_t seed, uint64_t stream=0);
+
+  /// sets the position in the stream to the i-th double
+  void seek(uint64_t index);
+
+  /// index of the next double that is returned
+  uint64_t tell() const { return 2*counter - (2*lanes-pos); }
+
+  /// returns a value in [0,1)
+  double rand(){
+    if(pos==2*lanes) refill();
+    return toDouble(buffer[pos++]);
+  }
+
+  /// fills out with n uniformly distributed values in [min,max)
+  void fillUniform(double* out, size_t n, double min=0, double max=1);
+
+  /** fills out with n normally distributed values (Box-Muller, both branches).
+      Every pair of values consumes two uniform values; for odd n the last
+      partner is discarded.
+   */
+  void fillNormal(double* out, size_t n, double mean=0, double stddev=1);
+
+  /** the bijection of Philox4x32-10: encrypts the counter ctr with key
+      and writes the 4 words to out.
+   */
+  static void block(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]);
+
+  /** converts 64 random bits to a double in [0,1): the upper 52 bits
+      become the mantissa of a number in [1,2). Unlike an integer
+      conversion this only needs bit operations and vectorises.
+   */
+  static double toDouble(uint64_t x){
+    uint64_t bits = (x >> 12) | 0x3FF0000000000000ULL;
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+  }
+
+  static const int lanes = 16;
+
+protected:
+  /// computes the next lanes blocks into buffer
+  void refill();
+  /** computes nblocks consecutive blocks starting at counter and stores
+      2 x 64 bit per block into out (nblocks <= lanes)
+   */
+  void blocks(uint64_t* out, int nblocks);
+
+  uint32_t key[2];
+  uint64_t stream;
+  uint64_t counter;  ///< next block to be computed
+  uint64_t buffer[2*lanes];
+  int pos;           ///< next unused entry of buffer (2*lanes: empty)
+};
+
+#endif
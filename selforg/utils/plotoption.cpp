@@ -269,15 +269,46 @@ bool PlotOption::useChannel(const string& name){
   return rv;
 }
 
+unsigned long PlotOption::inspectablesVersion(const list<const Inspectable*>& inspectables){
+  unsigned long v = 0;
+  FOREACHC(list<const Inspectable*>, inspectables, insp){
+    if(*insp) v = max(v, (*insp)->getInspectableVersion());
+  }
+  return v;
+}
+
+bool PlotOption::cacheValid(const list<const Inspectable*>& inspectables) const {
+  if(cacheRoots.size() != inspectables.size()) return false;
+  int k = 0;
+  FOREACHC(list<const Inspectable*>, inspectables, insp){
+    if(cacheRoots[k++] != *insp) return false;
+  }
+  return inspectablesVersion(inspectables) == cacheVersion;
+}
+
 int PlotOption::printInspectableNames(const list<const Inspectable*>& inspectables, int cnt) {
   if (!pipe)
     return cnt;
+  if(namesDepth==0){ // start a new cache
+    segments.clear();
+    refs.clear();
+    cacheRoots.assign(inspectables.begin(), inspectables.end());
+    cacheVersion = inspectablesVersion(inspectables);
+  }
+  namesDepth++;
   // here we also set the mask array
   FOREACHC(list<const Inspectable*>, inspectables, insp){
     if(*insp){
       // then the internal parameters
       list<Inspectable::iparamkey> l = (*insp)->getInternalParamNames();
-      for(list<Inspectable::iparamkey>::iterator i = l.begin(); i != l.end(); ++i){
+      Inspectable::iparamreflist r;
+      bool useRefs = (*insp)->getInternalParamRefs(r) && r.size() == l.size();
+      PlotSegment s;
+      s.legacy    = useRefs ? 0 : *insp;
+      s.maskStart = cnt;
+      s.refBegin  = refs.size();
+      int k = 0;
+      for(list<Inspectable::iparamkey>::iterator i = l.begin(); i != l.end(); ++i, ++k){
         const string& str = (*i);
         if((int)mask.size()<=cnt) {
           mask.resize(cnt*2);
@@ -285,13 +316,18 @@ int PlotOption::printInspectableNames(const list<const Inspectable*>& inspectabl
         if(useChannel(str)){
           fprintf(pipe, " %s", str.c_str());
           mask[cnt]=true;
+          if(useRefs) refs.push_back(r[k]);
         }else
           mask[cnt]=false;
         cnt++;
       }
+      s.refEnd = refs.size();
+      segments.push_back(s);
       cnt += printInspectableNames((*insp)->getInspectables(),cnt);
     }
   }
+  namesDepth--;
+  if(namesDepth==0) cacheCount = cnt;
   return cnt;
 }
 
@@ -300,6 +336,25 @@ int PlotOption::printInspectables(const std::list<const Inspectable*>& inspectab
   if (!pipe)
     return cnt;
 
+  if(cnt==0 && cacheValid(inspectables)){
+    FOREACHC(vector<PlotSegment>, segments, s){
+      if(s->legacy){
+        Inspectable::iparamvallist l = s->legacy->getInternalParams();
+        int c = s->maskStart;
+        FOREACHC(Inspectable::iparamvallist, l, i){
+          if(c < (int)mask.size() && mask[c])
+            fprintf(pipe, " %f", (*i));
+          c++;
+        }
+      } else {
+        for(size_t k = s->refBegin; k < s->refEnd; k++){
+          fprintf(pipe, " %f", Inspectable::getParamRefValue(refs[k]));
+        }
+      }
+    }
+    return cacheCount;
+  }
+
   // internal parameters ( we allocate one place more to be able to realise when the number raises)
   Inspectable::iparamvallist l;
   FOREACHC(list<const Inspectable*>, inspectables, insp)
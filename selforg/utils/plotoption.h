@@ -32,8 +32,9 @@
 #include <string>
 #include <vector>
 
+#include "inspectable.h"
+
 class Configurable;
-class Inspectable;
 
 /** Output mode for agent.
  */
@@ -69,7 +70,7 @@ public:
   friend class PlotOptionEngine;
 
   PlotOption()
-    : pipe(0), interval(1), mode(NoPlot),  parameter("")
+    : pipe(0), interval(1), mode(NoPlot),  parameter(""), namesDepth(0), cacheVersion(0), cacheCount(0)
   {
     mask.resize(256);
   }
@@ -84,7 +85,7 @@ public:
      Note: the argument whichSensor is removed. You can adjust this in the wirings now.
    */
   PlotOption( PlotMode mode, int interval = 1, std::string parameter=std::string(), std::string filter=std::string())
-    : pipe(0), interval(interval), mode(mode), parameter(parameter)
+    : pipe(0), interval(interval), mode(mode), parameter(parameter), namesDepth(0), cacheVersion(0), cacheCount(0)
   {
     if(!filter.empty()){
       setFilter(filter);
@@ -124,8 +125,14 @@ public:
 
   virtual bool useChannel(const std::string& name);
 
+  /** prints the values of all inspectables (and their children).
+      When called with the list given to printInspectableNames() before and
+      the structure did not change, the values are read through the parameter
+      references collected there (no lists, no name lookups).
+   */
   virtual int printInspectables(const std::list<const Inspectable*>& inspectables, int cnt=0);
 
+  /// prints the names of all inspectables (and their children) and sets up the channel mask
   virtual int printInspectableNames(const std::list<const Inspectable*>& inspectables, int cnt=0);
 
   virtual void printInspectableInfoLines( const std::list<const Inspectable*>& inspectables);
@@ -163,6 +170,26 @@ private:
   std::list<std::string> accept; ///< channels to accept (use) (empty means all)
   std::list<std::string> ignore; ///< channels not ignore      (empty means ignore non)
   std::vector<bool> mask; ///< mask for accepting channels (calculated from accept and ignore)
+
+  /** part of the cached output: either the accepted references of one inspectable
+      or an inspectable that has to be asked with getInternalParams()
+   */
+  struct PlotSegment {
+    const Inspectable* legacy; ///< inspectable without references (or 0)
+    int maskStart;             ///< mask index of its first value (for legacy)
+    size_t refBegin, refEnd;   ///< range in refs (otherwise)
+  };
+  std::vector<PlotSegment> segments;
+  Inspectable::iparamreflist refs;     ///< references of all accepted channels
+  std::vector<const Inspectable*> cacheRoots; ///< inspectables the cache was built for
+  int namesDepth;                      ///< recursion depth in printInspectableNames
+  unsigned long cacheVersion;          ///< structure version at cache construction
+  int cacheCount;                      ///< number of channels counted by printInspectableNames
+
+  /// maximal structure version of the inspectables (their children are included)
+  static unsigned long inspectablesVersion(const std::list<const Inspectable*>& inspectables);
+  /// whether segments and refs can be used for printing the given inspectables
+  bool cacheValid(const std::list<const Inspectable*>& inspectables) const;
 };
 
 #endif /* PLOTOPTION_H_ */
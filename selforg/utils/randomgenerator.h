@@ -25,25 +25,72 @@
 #define __RANDOMGENERATOR_H
 
 #include <stdlib.h>
+#include <cmath>
 #ifndef _GNU_SOURCE
 #include "mac_drand48r.h"
 #endif
+#include "philox.h"
 
 
-/// random generator with 48bit integer arithmentic
+/** random generator with 48bit integer arithmentic.
+    Alternatively it can be switched to the counter based generator
+    Philox (see initCounterBased()), which is faster, supports bulk generation
+    and independent streams derived from one seed.
+ */
 typedef struct _RandGen {
   _RandGen(){
     init(::rand());
   }
   void init(long int seedval){
+    counterBased = false;
     srand48_r(seedval, &buffer);
   }
+  /** uses the counter based generator with the given seed and stream.
+      Different streams (e.g. one per agent) are independent and reproducible
+      regardless of the order or thread in which they are used.
+   */
+  void initCounterBased(uint64_t seed, uint64_t stream=0){
+    counterBased = true;
+    philox.init(seed, stream);
+  }
+  bool isCounterBased() const { return counterBased; }
+
   /// returns a value in [0,1)
   double rand(){
+    if(counterBased) return philox.rand();
     double r;
     drand48_r(&buffer,&r);
     return r;
   }
+
+  /** fills out with n uniformly distributed values in [min,max).
+      Gives the same values as n calls of rand()*(max-min)+min.
+   */
+  void fillUniform(double* out, size_t n, double min=0, double max=1){
+    if(counterBased) {
+      philox.fillUniform(out, n, min, max);
+    } else {
+      for(size_t i=0; i<n; i++) out[i] = rand()*(max-min)+min;
+    }
+  }
+
+  /** fills out with n normally distributed values.
+      With the 48bit generator every value consumes two uniform values
+      (as WhiteNormalNoise always did), the counter based generator uses
+      both branches of the Box-Muller transform.
+   */
+  void fillNormal(double* out, size_t n, double mean=0, double stddev=1){
+    if(counterBased) {
+      philox.fillNormal(out, n, mean, stddev);
+    } else {
+      for(size_t i=0; i<n; i++){
+        double x1=rand();
+        double x2=rand();
+        out[i] = (sqrt(-2*log(x1)) *cos(2*M_PI*x2))*stddev+mean;
+      }
+    }
+  }
+
   // See drand48_data structure:
   //  struct drand48_data
   //  {
@@ -67,6 +114,8 @@ typedef struct _RandGen {
           struct drand48_data buffer;
           char dummy[24];
   };
+  bool counterBased;
+  Philox philox;
 } RandGen;
 
 
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "replaybuffer.h"
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+
+using namespace matrix;
+
+ReplayBuffer::ReplayBuffer(int capacity)
+  : capacity(std::max(capacity, 2)), sensornumber(0), motornumber(0), stride(0), added(0) {
+  pthread_mutex_init(&mutex, 0);
+}
+
+ReplayBuffer::~ReplayBuffer(){
+  pthread_mutex_destroy(&mutex);
+}
+
+void ReplayBuffer::add(const double* sensors, int sensornumber, const double* motors, int motornumber){
+  pthread_mutex_lock(&mutex);
+  if(stride == 0){
+    this->sensornumber = sensornumber;
+    this->motornumber  = motornumber;
+    stride = sensornumber + motornumber;
+    data.resize((size_t)stride * capacity);
+  }
+  if(sensornumber == this->sensornumber && motornumber == this->motornumber){
+    double* p = &data[(size_t)(added % capacity) * stride];
+    memcpy(p, sensors, sizeof(double) * sensornumber);
+    memcpy(p + sensornumber, motors, sizeof(double) * motornumber);
+    added++;
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+int ReplayBuffer::getTransitionNumber(){
+  pthread_mutex_lock(&mutex);
+  int n = (int)std::min(added, (long)capacity) - 1;
+  pthread_mutex_unlock(&mutex);
+  return std::max(n, 0);
+}
+
+bool ReplayBuffer::sample(int n, Matrix& sensors, Matrix& motors, Matrix& nextSensors,
+                          RandGen* randGen){
+  assert(randGen);
+  pthread_mutex_lock(&mutex);
+  long stored = std::min(added, (long)capacity);
+  if(stored < 2 || n < 1){
+    pthread_mutex_unlock(&mutex);
+    return false;
+  }
+  long oldest = added - stored;
+  sensors.set(sensornumber, n);
+  motors.set(motornumber, n);
+  nextSensors.set(sensornumber, n);
+  for(int j = 0; j < n; j++){
+    long s = oldest + std::min((long)(randGen->rand() * (stored - 1)), stored - 2);
+    const double* p  = &data[(size_t)(s % capacity) * stride];
+    const double* pn = &data[(size_t)((s + 1) % capacity) * stride];
+    for(int i = 0; i < sensornumber; i++){
+      sensors.val(i,j)     = p[i];
+      nextSensors.val(i,j) = pn[i];
+    }
+    for(int i = 0; i < motornumber; i++)
+      motors.val(i,j) = p[sensornumber + i];
+  }
+  pthread_mutex_unlock(&mutex);
+  return true;
+}
+
+void ReplayBuffer::clear(){
+  pthread_mutex_lock(&mutex);
+  added = 0;
+  pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __REPLAYBUFFER_H
+#define __REPLAYBUFFER_H
+
+#include <vector>
+#include <pthread.h>
+#include "matrix.h"
+#include "randomgenerator.h"
+
+/**
+ * Experience replay buffer for the sensorimotor stream of a controller.
+ * Stores the last capacity time steps (sensor and motor values) in one
+ * contiguous ring and draws random mini-batches of transitions
+ * (x_t, y_t, x_t+1) as column blocks, e.g. for MultiLayerFFNN::learnBatch.
+ * It can be fed by WiredController::setReplayBuffer and is thread safe,
+ * such that the training can run in another thread (@see ReplayTrainer).
+ */
+class ReplayBuffer {
+public:
+  /// @param capacity maximal number of stored time steps (the oldest are overwritten)
+  ReplayBuffer(int capacity);
+  ~ReplayBuffer();
+
+  /** adds the values of one time step.
+      The first call determines the dimensions, later calls with other dimensions are ignored.
+   */
+  void add(const double* sensors, int sensornumber, const double* motors, int motornumber);
+
+  /// number of stored transitions (x_t, y_t, x_t+1)
+  int getTransitionNumber();
+
+  int getSensorNumber() const { return sensornumber; }
+  int getMotorNumber() const { return motornumber; }
+
+  /** draws n transitions at random (with replacement).
+      @param sensors x_t as columns (sensornumber x n)
+      @param motors y_t as columns (motornumber x n)
+      @param nextSensors x_t+1 as columns (sensornumber x n)
+      @return false if there are no transitions yet
+   */
+  bool sample(int n, matrix::Matrix& sensors, matrix::Matrix& motors,
+              matrix::Matrix& nextSensors, RandGen* randGen);
+
+  /// removes all stored steps (e.g. at the start of a new episode)
+  void clear();
+
+protected:
+  pthread_mutex_t mutex;
+  int capacity;
+  int sensornumber;
+  int motornumber;
+  int stride;               // sensornumber + motornumber
+  long added;               // number of steps added since the last clear
+  std::vector<double> data; // ring of time steps (sensors followed by motors)
+
+private:
+  ReplayBuffer(const ReplayBuffer&);
+  ReplayBuffer& operator=(const ReplayBuffer&);
+};
+
+#endif
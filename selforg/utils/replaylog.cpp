@@ -0,0 +1,244 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "replaylog.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <algorithm>
+
+using namespace std;
+
+// binary log: header, '\0' separated column names (padded to 8 bytes), values
+#define REPLAYLOG_MAGIC "LPZRPLY1"
+struct ReplayLogBinaryHeader {
+  char     magic[8];
+  uint32_t columns;
+  uint32_t reserved;
+  uint64_t lines;
+  uint64_t namesbytes;
+};
+
+static pthread_mutex_t replayLogsMutex = PTHREAD_MUTEX_INITIALIZER;
+static map<string, weak_ptr<ReplayLog> > replayLogs;
+
+shared_ptr<ReplayLog> ReplayLog::open(const string& filename){
+  pthread_mutex_lock(&replayLogsMutex);
+  shared_ptr<ReplayLog> log = replayLogs[filename].lock();
+  if(!log){
+    log = shared_ptr<ReplayLog>(new ReplayLog(filename));
+    if(log->map() && (log->binary ? log->indexBinary() : log->indexText())){
+      replayLogs[filename] = log;
+    } else {
+      log.reset();
+      replayLogs.erase(filename);
+    }
+  }
+  pthread_mutex_unlock(&replayLogsMutex);
+  return log;
+}
+
+ReplayLog::ReplayLog(const string& filename)
+  : filename(filename), data(0), size(0), binary(false), lines(0), values(0) {
+}
+
+ReplayLog::~ReplayLog(){
+  if(data) munmap((void*)data, size);
+}
+
+bool ReplayLog::map(){
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if(fd < 0) return false;
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size == 0){
+    ::close(fd);
+    return false;
+  }
+  size = st.st_size;
+  void* p = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(p == MAP_FAILED){
+    data = 0;
+    return false;
+  }
+  data   = (const char*)p;
+  binary = size >= sizeof(ReplayLogBinaryHeader) && memcmp(data, REPLAYLOG_MAGIC, 8) == 0;
+  return true;
+}
+
+static inline bool isBlank(char c){
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool ReplayLog::indexText(){
+  const char* end = data + size;
+  const char* p   = data;
+  bool header     = false;
+  lineOffsets.clear();
+  while(p < end){
+    const char* eol = (const char*)memchr(p, '\n', end - p);
+    if(!eol) eol = end;
+    if(p[0] == '#'){
+      if(!header && eol - p > 1 && p[1] == 'C'){ // column names: #C t x[0] ...
+        const char* q = p + 2;
+        while(q < eol){
+          while(q < eol && isBlank(*q)) q++;
+          const char* s = q;
+          while(q < eol && !isBlank(*q)) q++;
+          if(q > s) columns.push_back(string(s, q - s));
+        }
+        header = true;
+      }
+    } else if(header) {
+      const char* q = p;
+      while(q < eol && isBlank(*q)) q++;
+      if(q < eol) lineOffsets.push_back(p - data);
+    }
+    p = eol + 1;
+  }
+  lines = lineOffsets.size();
+  return header;
+}
+
+bool ReplayLog::indexBinary(){
+  const ReplayLogBinaryHeader* h = (const ReplayLogBinaryHeader*)data;
+  // check the sizes before any addition, garbage could overflow them
+  if(h->namesbytes > size - sizeof(ReplayLogBinaryHeader) || h->lines > (uint64_t)INT_MAX)
+    return false;
+  size_t namesend = sizeof(ReplayLogBinaryHeader) + h->namesbytes;
+  size_t start    = (namesend + 7) & ~size_t(7);
+  if(start > size || (size - start) / sizeof(double) / max(h->columns, 1u) < h->lines)
+    return false;
+  const char* p = data + sizeof(ReplayLogBinaryHeader);
+  for(uint32_t c = 0; c < h->columns && p < data + namesend; c++){
+    // every name has to be terminated within the names block
+    size_t len = strnlen(p, data + namesend - p);
+    if(p + len == data + namesend) return false;
+    columns.push_back(string(p, len));
+    p += len + 1;
+  }
+  if(columns.size() != h->columns) return false;
+  lines  = h->lines;
+  values = (const double*)(data + start);
+  return true;
+}
+
+int ReplayLog::getColumn(const string& name) const {
+  for(size_t i = 0; i < columns.size(); i++){
+    if(columns[i] == name) return i;
+  }
+  return -1;
+}
+
+bool ReplayLog::getColumnRange(const string& prefix, int& first, int& last) const {
+  first = last = -1;
+  for(size_t i = 0; i < columns.size(); i++){
+    if(columns[i].compare(0, prefix.size(), prefix) == 0){
+      if(first == -1) first = i;
+      last = i;
+    }
+  }
+  return first != -1;
+}
+
+int ReplayLog::getLine(double position, bool repeat) const {
+  if(lines == 0) return -1;
+  long l = (long)floor(position);
+  if(repeat){
+    l %= lines;
+    if(l < 0) l += lines;
+  } else {
+    l = min(max(l, 0l), (long)lines - 1);
+  }
+  return l;
+}
+
+bool ReplayLog::getColumns(int line, int first, int last, double* dest) const {
+  if(line < 0 || line >= lines || first > last) return false;
+  int n = last - first + 1;
+  if(binary){
+    const double* row = values + size_t(line) * columns.size();
+    for(int i = 0; i < n; i++){
+      int c = first + i;
+      dest[i] = (c >= 0 && c < (int)columns.size()) ? row[c] : 0;
+    }
+    return true;
+  }
+  const char* p   = data + lineOffsets[line];
+  const char* end = data + size;
+  int i = 0;
+  while(p < end && *p != '\n' && i <= last){
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    const char* s = p;
+    bool number = false;
+    while(p < end && !isBlank(*p)){
+      if(*p >= '0' && *p <= '9') number = true;
+      p++;
+    }
+    if(p == s) continue;
+    // the first entry is always taken, others only if they contain a number
+    if(i == 0 || number){
+      if(i >= first) dest[i - first] = strtod(s, 0);
+      i++;
+    }
+  }
+  for(; i <= last; i++){
+    if(i >= first) dest[i - first] = 0;
+  }
+  return true;
+}
+
+bool ReplayLog::writeBinary(const string& binaryfilename) const {
+  FILE* f = fopen(binaryfilename.c_str(), "wb");
+  if(!f) return false;
+  ReplayLogBinaryHeader h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, REPLAYLOG_MAGIC, 8);
+  h.columns    = columns.size();
+  h.lines      = lines;
+  h.namesbytes = 0;
+  for(size_t c = 0; c < columns.size(); c++) h.namesbytes += columns[c].size() + 1;
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  for(size_t c = 0; c < columns.size() && ok; c++)
+    ok = fwrite(columns[c].c_str(), columns[c].size() + 1, 1, f) == 1;
+  const char zeros[8] = {0};
+  size_t pad = ((sizeof(h) + h.namesbytes + 7) & ~size_t(7)) - (sizeof(h) + h.namesbytes);
+  if(ok && pad > 0) ok = fwrite(zeros, pad, 1, f) == 1;
+  vector<double> row(columns.size());
+  for(int l = 0; l < lines && ok && !row.empty(); l++){
+    getColumns(l, 0, columns.size() - 1, row.data());
+    ok = fwrite(row.data(), sizeof(double), row.size(), f) == row.size();
+  }
+  return fclose(f) == 0 && ok;
+}
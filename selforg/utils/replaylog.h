@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __REPLAYLOG_H
+#define __REPLAYLOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+/**
+ * Read-only access to a log file (as written by the File PlotOption)
+ * for replaying it (@see ReplayController, ReplayRobot).
+ *
+ * The file is mapped into memory and indexed once: the offsets of all
+ * data lines and the columns of the "#C" header line are stored, such that
+ * every line can be accessed directly (random seeking) and only the
+ * requested columns are parsed.
+ * Alternatively a binary log (@see writeBinary) is mapped and read
+ * without any parsing.
+ *
+ * Use open() to get a log: all users of the same file share one mapping.
+ */
+class ReplayLog {
+public:
+  /** opens (or returns the already opened) log file.
+      @return 0 if the file cannot be read or has no "#C" header line
+  */
+  static std::shared_ptr<ReplayLog> open(const std::string& filename);
+
+  ~ReplayLog();
+
+  const std::string& getFilename() const { return filename; }
+
+  /// number of data lines (time steps)
+  int getLineNumber() const { return lines; }
+  /// number of columns (as given in the header)
+  int getColumnNumber() const { return (int)columns.size(); }
+  /// names of the columns
+  const std::vector<std::string>& getColumnNames() const { return columns; }
+  /// index of the column with the given name or -1
+  int getColumn(const std::string& name) const;
+  /** first and last column whose names start with the given prefix
+      (e.g. "x[" for the sensors)
+      @return false if there is no such column
+   */
+  bool getColumnRange(const std::string& prefix, int& first, int& last) const;
+
+  /** line of a (fractional) playback position: it wraps around if
+      repeat is true and is clamped to the valid lines otherwise */
+  int getLine(double position, bool repeat) const;
+
+  /** reads the columns [first, last] of the given line into dest
+      (which must have space for last-first+1 values).
+      Missing values are set to 0.
+      @return false if line is out of range
+   */
+  bool getColumns(int line, int first, int last, double* dest) const;
+
+  /** writes the log in binary format (readable by open()), which can be
+      replayed without any parsing */
+  bool writeBinary(const std::string& binaryfilename) const;
+
+protected:
+  ReplayLog(const std::string& filename);
+  bool map();
+  bool indexText();
+  bool indexBinary();
+
+  std::string filename;
+  const char* data;   ///< mapped file
+  size_t size;
+  bool binary;
+  int lines;
+  std::vector<std::string> columns;
+  std::vector<size_t> lineOffsets; ///< start of each data line (text log)
+  const double* values;            ///< row major values (binary log)
+};
+
+#endif
@@ -39,3 +39,13 @@ bool Storeable::restoreFromFile(const char* filename) {
   fclose(f);
   return rv;
 }
+
+uint32_t Storeable::checksum(const void* data, size_t len){
+  const unsigned char* p = (const unsigned char*)data;
+  uint32_t h = 2166136261u;
+  for(size_t i=0; i<len; i++){
+    h ^= p[i];
+    h *= 16777619u;
+  }
+  return h;
+}
@@ -25,6 +25,8 @@
 #define __STOREABLE_H
 
 #include<stdio.h>
+#include<stdint.h>
+#include<stddef.h>
 
 /**
  * Interface for objects, that can be stored and restored to/from a file stream (binary).
@@ -51,6 +53,10 @@ public:
    */
   bool restoreFromFile(const char* filename);
 
+  /** checksum (32 bit FNV-1a) of len bytes, used by the binary formats
+      to detect corrupted data */
+  static uint32_t checksum(const void* data, size_t len);
+
 };
 
 #endif
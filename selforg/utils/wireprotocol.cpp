@@ -0,0 +1,449 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef WIN32
+
+#include "wireprotocol.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <atomic>
+#include <algorithm>
+
+// largest accepted payload (protects against garbage headers)
+#define WIRE_MAX_PAYLOAD (64u<<20)
+
+static inline size_t pad8(size_t bytes){
+  return (bytes + 7) & ~size_t(7);
+}
+
+
+WireFrame::WireFrame(){
+  begin(CLOSE, 0);
+}
+
+void WireFrame::begin(Type type, uint32_t step){
+  buffer.resize(sizeof(Header));
+  records.clear();
+  Header* h  = header();
+  h->magic   = Magic;
+  h->version = Version;
+  h->type    = (uint16_t)type;
+  h->step    = step;
+  h->length  = 0;
+}
+
+char* WireFrame::append(size_t bytes){
+  size_t offset = buffer.size();
+  buffer.resize(offset + bytes);
+  header()->length += bytes;
+  return buffer.data() + offset;
+}
+
+double* WireFrame::addAgent(uint32_t agent, uint32_t n){
+  records.push_back(buffer.size());
+  char* p = append(2*sizeof(uint32_t) + n*sizeof(double));
+  memcpy(p, &agent, sizeof(uint32_t));
+  memcpy(p + sizeof(uint32_t), &n, sizeof(uint32_t));
+  return (double*)(p + 2*sizeof(uint32_t));
+}
+
+void WireFrame::addAgent(uint32_t agent, const double* values, uint32_t n){
+  double* v = addAgent(agent, n);
+  memcpy(v, values, n*sizeof(double));
+}
+
+void WireFrame::setHello(uint32_t sensornumber, uint32_t motornumber, const std::string& name){
+  uint32_t len = name.size();
+  char* p = append(pad8(3*sizeof(uint32_t) + len));
+  memcpy(p, &sensornumber, sizeof(uint32_t));
+  memcpy(p + sizeof(uint32_t), &motornumber, sizeof(uint32_t));
+  memcpy(p + 2*sizeof(uint32_t), &len, sizeof(uint32_t));
+  memcpy(p + 3*sizeof(uint32_t), name.data(), len);
+}
+
+void WireFrame::setParam(const std::string& key, double value){
+  uint32_t len = key.size();
+  char* p = append(pad8(sizeof(double) + sizeof(uint32_t) + len));
+  memcpy(p, &value, sizeof(double));
+  memcpy(p + sizeof(double), &len, sizeof(uint32_t));
+  memcpy(p + sizeof(double) + sizeof(uint32_t), key.data(), len);
+}
+
+const double* WireFrame::getAgent(int i, uint32_t& agent, uint32_t& n) const {
+  const char* p = buffer.data() + records[i];
+  memcpy(&agent, p, sizeof(uint32_t));
+  memcpy(&n, p + sizeof(uint32_t), sizeof(uint32_t));
+  return (const double*)(p + 2*sizeof(uint32_t));
+}
+
+const double* WireFrame::findAgent(uint32_t agent, uint32_t& n) const {
+  uint32_t a;
+  for(int i=0; i<getAgentNumber(); i++){
+    const double* v = getAgent(i, a, n);
+    if(a == agent) return v;
+  }
+  n = 0;
+  return 0;
+}
+
+bool WireFrame::getHello(uint32_t& sensornumber, uint32_t& motornumber, std::string& name) const {
+  const char* p = buffer.data() + sizeof(Header);
+  uint32_t len;
+  if(getType() != HELLO || header()->length < 3*sizeof(uint32_t)) return false;
+  memcpy(&sensornumber, p, sizeof(uint32_t));
+  memcpy(&motornumber, p + sizeof(uint32_t), sizeof(uint32_t));
+  memcpy(&len, p + 2*sizeof(uint32_t), sizeof(uint32_t));
+  if(3*sizeof(uint32_t) + len > header()->length) return false;
+  name.assign(p + 3*sizeof(uint32_t), len);
+  return true;
+}
+
+bool WireFrame::getParam(std::string& key, double& value) const {
+  const char* p = buffer.data() + sizeof(Header);
+  uint32_t len;
+  if(getType() != PARAM || header()->length < sizeof(double) + sizeof(uint32_t)) return false;
+  memcpy(&value, p, sizeof(double));
+  memcpy(&len, p + sizeof(double), sizeof(uint32_t));
+  if(sizeof(double) + sizeof(uint32_t) + len > header()->length) return false;
+  key.assign(p + sizeof(double) + sizeof(uint32_t), len);
+  return true;
+}
+
+WireFrame::Header* WireFrame::prepareHeader(){
+  buffer.resize(sizeof(Header));
+  records.clear();
+  return header();
+}
+
+char* WireFrame::preparePayload(){
+  const Header* h = header();
+  if(h->magic != Magic){
+    fprintf(stderr, "WireFrame: wrong magic number (byte order?) %x\n", h->magic);
+    return 0;
+  }
+  if(h->version != Version){
+    fprintf(stderr, "WireFrame: unsupported protocol version %i (expect %i)\n",
+            h->version, Version);
+    return 0;
+  }
+  if(h->length > WIRE_MAX_PAYLOAD) {
+    fprintf(stderr, "WireFrame: frame too large (%u bytes)\n", h->length);
+    return 0;
+  }
+  buffer.resize(sizeof(Header) + h->length);
+  return buffer.data() + sizeof(Header);
+}
+
+bool WireFrame::finishReceive(){
+  records.clear();
+  Type t = getType();
+  if(t != SENSORS && t != MOTORS) return true;
+  size_t offset = sizeof(Header);
+  while(offset < buffer.size()){
+    uint32_t n;
+    if(offset + 2*sizeof(uint32_t) > buffer.size()) return false;
+    memcpy(&n, buffer.data() + offset + sizeof(uint32_t), sizeof(uint32_t));
+    size_t recordsize = 2*sizeof(uint32_t) + size_t(n)*sizeof(double);
+    if(offset + recordsize > buffer.size()) return false;
+    records.push_back(offset);
+    offset += recordsize;
+  }
+  return true;
+}
+
+
+/************************** TCP ****************************/
+
+TcpWireTransport::TcpWireTransport()
+  : sock(-1), listensock(-1) {
+}
+
+TcpWireTransport::~TcpWireTransport(){
+  close();
+}
+
+static void setNoDelay(int sock){
+  int flag = 1;
+  setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&flag, sizeof(int));
+#ifdef SO_NOSIGPIPE
+  setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, (char*)&flag, sizeof(int));
+#endif
+}
+
+bool TcpWireTransport::listen(int port){
+  struct sockaddr_in addr;
+  int flag = 1;
+  close();
+  if((listensock = socket(AF_INET, SOCK_STREAM, 0)) < 0){
+    perror("TcpWireTransport::listen: socket()");
+    return false;
+  }
+  setsockopt(listensock, SOL_SOCKET, SO_REUSEADDR, (char*)&flag, sizeof(int));
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port        = htons(port);
+  if(bind(listensock, (struct sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(listensock, 1) < 0){
+    perror("TcpWireTransport::listen: bind()/listen()");
+    close();
+    return false;
+  }
+  if((sock = ::accept(listensock, NULL, NULL)) < 0){
+    perror("TcpWireTransport::listen: accept()");
+    close();
+    return false;
+  }
+  setNoDelay(sock);
+  return true;
+}
+
+bool TcpWireTransport::connect(const std::string& host, int port){
+  struct addrinfo hints;
+  struct addrinfo* res;
+  char portstr[16];
+  close();
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family   = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  snprintf(portstr, sizeof(portstr), "%i", port);
+  if(getaddrinfo(host.c_str(), portstr, &hints, &res) != 0){
+    fprintf(stderr, "TcpWireTransport::connect: cannot resolve %s\n", host.c_str());
+    return false;
+  }
+  sock = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if(sock < 0 || ::connect(sock, res->ai_addr, res->ai_addrlen) < 0){
+    freeaddrinfo(res);
+    close();
+    return false;
+  }
+  freeaddrinfo(res);
+  setNoDelay(sock);
+  return true;
+}
+
+bool TcpWireTransport::send(const WireFrame& frame){
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif
+  const char* p = frame.data();
+  size_t len    = frame.size();
+  if(sock < 0) return false;
+  while(len > 0){ // usually a single call
+    ssize_t r = ::send(sock, p, len, flags);
+    if(r <= 0) return false;
+    p   += r;
+    len -= r;
+  }
+  return true;
+}
+
+bool TcpWireTransport::readFully(char* buf, size_t len){
+  while(len > 0){
+    ssize_t r = recv(sock, buf, len, MSG_WAITALL);
+    if(r <= 0) return false;
+    buf += r;
+    len -= r;
+  }
+  return true;
+}
+
+bool TcpWireTransport::receive(WireFrame& frame){
+  if(sock < 0) return false;
+  if(!readFully((char*)frame.prepareHeader(), sizeof(WireFrame::Header))) return false;
+  char* payload = frame.preparePayload();
+  if(!payload) return false;
+  if(!readFully(payload, frame.size() - sizeof(WireFrame::Header))) return false;
+  return frame.finishReceive();
+}
+
+void TcpWireTransport::close(){
+  if(sock >= 0){
+    ::shutdown(sock, SHUT_RDWR);
+    ::close(sock);
+  }
+  if(listensock >= 0){
+    ::close(listensock);
+  }
+  sock       = -1;
+  listensock = -1;
+}
+
+
+/********************** Shared memory ***********************/
+
+struct ShmWireTransport::Region {
+  std::atomic<uint32_t> ready;
+  std::atomic<uint32_t> closed;
+  uint64_t capacity;
+  char pad[48];
+};
+
+// head is written by the producer, tail by the consumer (both count bytes)
+struct ShmWireTransport::Ring {
+  std::atomic<uint64_t> head;
+  char pad1[56];
+  std::atomic<uint64_t> tail;
+  char pad2[56];
+  char* data() { return (char*)(this + 1); }
+};
+
+// spins for a short while and then gives the processor away
+static inline void backoff(int& spins){
+  if(++spins > 1000){
+    sched_yield();
+  }
+}
+
+ShmWireTransport::ShmWireTransport(const std::string& name, bool create, size_t capacity)
+  : name(name), creator(create), region(0), in(0), out(0) {
+  this->capacity = (capacity + 63) & ~size_t(63);
+  int fd;
+  if(creator){
+    shm_unlink(name.c_str()); // remove stale region
+    mapsize = sizeof(Region) + 2*(sizeof(Ring) + this->capacity);
+    fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if(fd < 0 || ftruncate(fd, mapsize) < 0){
+      perror("ShmWireTransport: shm_open()/ftruncate()");
+      if(fd >= 0) ::close(fd);
+      return;
+    }
+  } else {
+    struct stat st;
+    while((fd = shm_open(name.c_str(), O_RDWR, 0600)) < 0) usleep(10000);
+    while(fstat(fd, &st) == 0 && st.st_size == 0) usleep(1000);
+    mapsize = st.st_size;
+  }
+  void* p = mmap(0, mapsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(p == MAP_FAILED){
+    perror("ShmWireTransport: mmap()");
+    return;
+  }
+  region = (Region*)p;
+  if(creator){
+    region->closed   = 0;
+    region->capacity = this->capacity;
+  } else {
+    while(region->ready.load(std::memory_order_acquire) == 0) usleep(1000);
+    this->capacity = region->capacity;
+  }
+  Ring* r0 = (Ring*)(region + 1);
+  Ring* r1 = (Ring*)(r0->data() + this->capacity);
+  if(creator){
+    r0->head = 0; r0->tail = 0;
+    r1->head = 0; r1->tail = 0;
+    region->ready.store(1, std::memory_order_release);
+  }
+  out = creator ? r0 : r1;
+  in  = creator ? r1 : r0;
+}
+
+ShmWireTransport::~ShmWireTransport(){
+  close();
+}
+
+bool ShmWireTransport::write(const char* buf, size_t len){
+  uint64_t head = out->head.load(std::memory_order_relaxed);
+  int spins = 0;
+  while(len > 0){
+    uint64_t tail = out->tail.load(std::memory_order_acquire);
+    size_t space  = capacity - (head - tail);
+    if(space == 0){
+      if(region->closed.load(std::memory_order_relaxed)) return false;
+      backoff(spins);
+      continue;
+    }
+    size_t pos   = head % capacity;
+    size_t chunk = std::min(std::min(len, space), capacity - pos);
+    memcpy(out->data() + pos, buf, chunk);
+    head += chunk;
+    out->head.store(head, std::memory_order_release);
+    buf += chunk;
+    len -= chunk;
+    spins = 0;
+  }
+  return true;
+}
+
+bool ShmWireTransport::read(char* buf, size_t len){
+  uint64_t tail = in->tail.load(std::memory_order_relaxed);
+  int spins = 0;
+  while(len > 0){
+    uint64_t head = in->head.load(std::memory_order_acquire);
+    size_t avail  = head - tail;
+    if(avail == 0){
+      if(region->closed.load(std::memory_order_relaxed)) return false;
+      backoff(spins);
+      continue;
+    }
+    size_t pos   = tail % capacity;
+    size_t chunk = std::min(std::min(len, avail), capacity - pos);
+    memcpy(buf, in->data() + pos, chunk);
+    tail += chunk;
+    in->tail.store(tail, std::memory_order_release);
+    buf += chunk;
+    len -= chunk;
+    spins = 0;
+  }
+  return true;
+}
+
+bool ShmWireTransport::send(const WireFrame& frame){
+  if(!region) return false;
+  return write(frame.data(), frame.size());
+}
+
+bool ShmWireTransport::receive(WireFrame& frame){
+  if(!region) return false;
+  if(!read((char*)frame.prepareHeader(), sizeof(WireFrame::Header))) return false;
+  char* payload = frame.preparePayload();
+  if(!payload) return false;
+  if(!read(payload, frame.size() - sizeof(WireFrame::Header))) return false;
+  return frame.finishReceive();
+}
+
+void ShmWireTransport::close(){
+  if(!region) return;
+  region->closed.store(1, std::memory_order_relaxed);
+  munmap(region, mapsize);
+  if(creator) shm_unlink(name.c_str());
+  region = 0;
+  in = out = 0;
+}
+
+#endif // WIN32
@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2011 LpzRobots development team                    *
+ *    Georg Martius  <georg dot martius at web dot de>                     *
+ *    Frank Guettler <guettler at informatik dot uni-leipzig dot de        *
+ *    Frank Hesse    <frank at nld dot ds dot mpg dot de>                  *
+ *    Ralf Der       <ralfder at mis dot mpg dot de>                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __WIREPROTOCOL_H
+#define __WIREPROTOCOL_H
+
+#ifndef WIN32
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/**
+ * Frame of the binary protocol for remote controllers (@see TcpController).
+ *
+ * A frame is a fixed header followed by \c length bytes of payload:
+ * \verbatim
+   uint32 magic    'LPZW' (0x575a504c)
+   uint16 version  WireFrame::Version
+   uint16 type     WireFrame::Type
+   uint32 step     time step of the simulation
+   uint32 length   number of payload bytes
+   \endverbatim
+ * The payload of SENSORS and MOTORS frames is a batch of agent records
+ * \verbatim
+   uint32 agent    id of the agent
+   uint32 n        number of values
+   double values[n]
+   \endverbatim
+ * such that the channels of several agents can be exchanged with a single
+ * frame (and a single system call). Such batching is up to the user of the
+ * frames: TcpController sends one agent per connection. HELLO frames contain
+ * uint32 sensornumber, uint32 motornumber and the name of the robot,
+ * PARAM frames a double value followed by the name of the parameter
+ * and CLOSE frames are empty.
+ *
+ * All numbers are in the byte order of the sender; a peer with the other
+ * byte order sees a wrong magic number and rejects the frame.
+ * The payload is padded to multiples of 8 bytes, so the values of all
+ * records are properly aligned doubles.
+ */
+class WireFrame {
+public:
+  enum Type { HELLO=1, SENSORS, MOTORS, PARAM, CLOSE };
+
+  struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t type;
+    uint32_t step;
+    uint32_t length;
+  };
+
+  static const uint32_t Magic   = 0x575a504c;
+  static const uint16_t Version = 1;
+
+  WireFrame();
+
+  /// starts a new (empty) frame. The allocated memory is kept.
+  void begin(Type type, uint32_t step);
+
+  /// appends the record of an agent to a SENSORS or MOTORS frame
+  void addAgent(uint32_t agent, const double* values, uint32_t n);
+  /** appends a record of an agent and returns the place for its \p n values,
+      which are valid until the next modification of the frame */
+  double* addAgent(uint32_t agent, uint32_t n);
+  /// sets the payload of a HELLO frame
+  void setHello(uint32_t sensornumber, uint32_t motornumber, const std::string& name);
+  /// sets the payload of a PARAM frame
+  void setParam(const std::string& key, double value);
+
+  Type     getType()  const { return (Type)header()->type; }
+  uint32_t getStep()  const { return header()->step; }
+
+  /// number of agent records (of a SENSORS or MOTORS frame)
+  int getAgentNumber() const { return (int)records.size(); }
+  /** values of the i-th record
+      @param agent id of the agent (output)
+      @param n number of values (output)
+  */
+  const double* getAgent(int i, uint32_t& agent, uint32_t& n) const;
+  /// values of the record of the given agent or 0 if it is not contained
+  const double* findAgent(uint32_t agent, uint32_t& n) const;
+  bool getHello(uint32_t& sensornumber, uint32_t& motornumber, std::string& name) const;
+  bool getParam(std::string& key, double& value) const;
+
+  /// the complete frame (header and payload)
+  const char* data() const { return buffer.data(); }
+  /// size of the complete frame in bytes
+  size_t size() const { return buffer.size(); }
+
+  /// used by transports: place for the header of a frame to be received
+  Header* prepareHeader();
+  /** used by transports: checks the received header and returns the
+      place for the payload, or 0 if the header is invalid */
+  char* preparePayload();
+  /** used by transports: indexes the records of the received payload.
+      @return false if the payload is malformed */
+  bool finishReceive();
+
+protected:
+  Header* header() { return (Header*)buffer.data(); }
+  const Header* header() const { return (const Header*)buffer.data(); }
+  char* append(size_t bytes);
+
+  std::vector<char> buffer;
+  std::vector<uint32_t> records; ///< offsets of the agent records in buffer
+};
+
+
+/// interface of transports for WireFrames
+class WireTransport {
+public:
+  virtual ~WireTransport() {}
+
+  /// sends the frame, returns false on errors (e.g. peer closed)
+  virtual bool send(const WireFrame& frame) = 0;
+  /// receives the next frame (blocking), returns false on errors
+  virtual bool receive(WireFrame& frame) = 0;
+  virtual void close() = 0;
+};
+
+
+/**
+ * WireTransport over a TCP connection. TCP_NODELAY is set and
+ * every frame is written with a single system call.
+ */
+class TcpWireTransport : public WireTransport {
+public:
+  TcpWireTransport();
+  virtual ~TcpWireTransport();
+
+  /// waits for a peer on the given port (blocking)
+  bool listen(int port);
+  bool connect(const std::string& host, int port);
+
+  virtual bool send(const WireFrame& frame);
+  virtual bool receive(WireFrame& frame);
+  virtual void close();
+
+protected:
+  bool readFully(char* buf, size_t len);
+
+  int sock;
+  int listensock;
+};
+
+
+/**
+ * WireTransport via POSIX shared memory for peers on the same host.
+ * The shared region contains two single producer/single consumer
+ * ring buffers, one for each direction. The waiting side spins for a
+ * short time and then yields, so no system call is needed if the
+ * peer answers quickly.
+ */
+class ShmWireTransport : public WireTransport {
+public:
+  /**
+     @param name name of the shared memory object (e.g. "/lpzrobots-4000")
+     @param create true for the side creating (and finally removing) the region,
+                   the other side waits until it exists
+     @param capacity size of each ring buffer in bytes
+   */
+  ShmWireTransport(const std::string& name, bool create, size_t capacity = 1<<20);
+  virtual ~ShmWireTransport();
+
+  bool isOpen() const { return region != 0; }
+
+  virtual bool send(const WireFrame& frame);
+  virtual bool receive(WireFrame& frame);
+  virtual void close();
+
+protected:
+  struct Ring;
+  struct Region;
+
+  bool write(const char* buf, size_t len);
+  bool read(char* buf, size_t len);
+
+  std::string name;
+  bool creator;
+  size_t capacity;
+  size_t mapsize;
+  Region* region;
+  Ring* in;
+  Ring* out;
+};
+
+#endif // WIN32
+
+#endif
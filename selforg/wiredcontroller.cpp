@@ -37,6 +37,7 @@
 #include "motorbabbler.h"
 
 #include "callbackable.h"
+#include "replaybuffer.h"
 
 using namespace std;
 
@@ -59,6 +60,7 @@ void WiredController::internInit(){
   csensors=0;
 
   motorBabbler = 0;
+  replayBuffer = 0;
   motorBabblingSteps = 0;
 
   t=1;
@@ -95,6 +97,7 @@ bool WiredController::init(AbstractController* controller, AbstractWiring* wirin
 
   csensors      = (sensor*) malloc(sizeof(sensor) * csensornumber);
   cmotors       = (motor*)  malloc(sizeof(motor)  * cmotornumber);
+  memset(cmotors, 0, sizeof(motor) * cmotornumber); // held until the first step of slow controllers
 
   // wire infos and send to controller and for plotting
   const std::list<SensorMotorInfo>& controllerSensorInfos = wiring->wireSensorInfos(robotSensorInfos);
@@ -173,15 +176,21 @@ void WiredController::step(const sensor* sensors, int sensornumber,
   }
 
   wiring->wireSensors(sensors, rsensornumber, csensors, csensornumber, noise * noisefactor);
+  bool stepped = true;
   if(motorBabblingSteps>0){
     motorBabbler->step(csensors, csensornumber, cmotors, cmotornumber);
     controller->motorBabblingStep(csensors, csensornumber, cmotors, cmotornumber);
     motorBabblingSteps--;
     if(motorBabblingSteps==0) stopMotorBabblingMode();
-  }else{
+  }else if(controller->isDue(t-1)){ // t counts from 1
     controller->step(csensors, csensornumber, cmotors, cmotornumber);
+  }else{
+    // the controller runs at a lower rate (see setRate()): hold the motor values
+    stepped = false;
   }
   wiring->wireMotors(motors, rmotornumber, cmotors, cmotornumber);
+  if(replayBuffer && stepped)
+    replayBuffer->add(csensors, csensornumber, cmotors, cmotornumber);
   plot(time);
   // do a callback for all registered Callbackable classes
   callBack();
@@ -45,6 +45,7 @@ class AbstractController;
 class AbstractWiring;
 class Callbackable;
 class WiredController;
+class ReplayBuffer;
 
 /** The WiredController contains a controller and a wiring, which
     connects the controller with the robot.
@@ -142,6 +143,12 @@ public:
    */
   virtual AbstractWiring* getWiring() { return wiring;}
 
+  /** sets a replay buffer that records the controller sensor and motor values
+      of every step (e.g. for training models with ReplayTrainer).
+      The buffer is not owned. Use 0 to stop recording.
+   */
+  virtual void setReplayBuffer(ReplayBuffer* buffer) { replayBuffer = buffer; }
+
 protected:
   /**
    * Plots controller sensor- and motorvalues and internal controller parameters.
@@ -180,6 +187,8 @@ protected:
 
   std::list<Callbackable* > callbackables;
 
+  ReplayBuffer* replayBuffer;
+
   long int t;
 };
 
@@ -125,6 +125,13 @@ public:
   /** routes the infos of the motors from robot to controller */
   virtual std::list<SensorMotorInfo> wireMotorInfos(const std::list<SensorMotorInfo>& robotMotorInfos);
 
+  /** Returns true if wireSensors() and wireMotors() may be called with the
+      same array as input and output (needs equal numbers on both sides).
+      WiringSequence then lets the neighbouring stage write directly into
+      the output and saves the intermediate buffer and copy.
+   */
+  virtual bool wiresInPlace() const { return false; }
+
   /// reset internal state
   virtual void reset() {}
 
@@ -32,22 +32,15 @@ DerivativeWiring::DerivativeWiring(const DerivativeWiringConf& conf,
   : AbstractWiring::AbstractWiring(noise, Controller, name), conf(conf){
 
   time     = buffersize;
-  first    = 0;
-  second   = 0;
+  history  = 0;
+  for(int i=0; i<buffersize; i++) sensorbuffer[i] = 0;
   blindMotors = 0;
-  //  this->conf.derivativeScale*= 1/this->conf.eps+0.01;
-  // delay    = min(buffersize/2-1, int(0.25/(conf.eps+0.01))+1);
   // make sure that at least id is on.
   if ((!conf.useFirstD) && (!conf.useSecondD)) this->conf.useId=true;
 }
 
 DerivativeWiring::~DerivativeWiring(){
-  for(int i=0 ; i<buffersize; i++){
-    if(sensorbuffer[i]) free(sensorbuffer[i]);
-  }
-  //  if(id) free(id);
-  if(first) free(first);
-  if(second) free(second);
+  if(history) free(history);
   if(blindMotors) free(blindMotors);
 }
 
@@ -57,15 +50,10 @@ bool DerivativeWiring::initIntern(){
     + conf.blindMotors;
   cmotornumber  = rmotornumber + conf.blindMotors;
 
+  history = (sensor*) calloc(buffersize * this->rsensornumber + 1, sizeof(sensor));
   for(int i=0; i<buffersize; i++){
-    sensorbuffer[i]      = (sensor*) malloc(sizeof(sensor) * this->rsensornumber);
-    for(int k=0; k < rsensornumber; k++){
-      sensorbuffer[i][k]=0;
-    }
+    sensorbuffer[i] = history + i * this->rsensornumber;
   }
-  // if(conf.useId)     id           = (sensor*) malloc(sizeof(sensor) * rsensornumber);
-  if(conf.useFirstD)  first  = (sensor*) malloc(sizeof(sensor) * this->rsensornumber);
-  if(conf.useSecondD) second = (sensor*) malloc(sizeof(sensor) * this->rsensornumber);
   if(conf.blindMotors>0){
     blindMotors       = (motor*) malloc(sizeof(motor) * conf.blindMotors);
     for(unsigned int k=0; k < conf.blindMotors; k++){
@@ -77,6 +65,10 @@ bool DerivativeWiring::initIntern(){
 }
 
 /// Realizes a wiring from robot sensors to controller sensors.
+//   Smoothing, id, derivatives and noise are computed in a single pass
+//   over the sensors:
+//   f'(x)  = (f(x+1) - f(x-1)) / 2, since we do not have f(x+1) we go one timestep in the past
+//   f''(x) = f(x) - 2f(x-1) + f(x-2)
 //   @param rsensors pointer to array of sensorvalues from robot
 //   @param rsensornumber number of sensors from robot
 //   @param csensors pointer to array of sensorvalues for controller (includes derivatives if specified)
@@ -92,57 +84,25 @@ bool DerivativeWiring::wireSensorsIntern(const sensor* rsensors, int rsensornumb
             this->csensornumber, csensornumber);
     return false;
   }
-  int index = (time) % buffersize;
-  int lastIndex = (time-1) % buffersize;
-
-  if(conf.useFirstD || conf.useSecondD){ // calc smoothed sensor values
-    for(int i=0; i < this->rsensornumber; i++ ){
-      sensorbuffer[index][i] = (1-conf.eps)*sensorbuffer[lastIndex][i] + conf.eps*rsensors[i];
-    }
-  }
-
-  if(conf.useId) { // normal sensors values
-    memcpy(csensors, rsensors, sizeof(sensor) * this->rsensornumber);
-  }
-
-  if(conf.useFirstD) { // first derivative
-    calcFirstDerivative();
-    int offset = conf.useId*this->rsensornumber;
-    memcpy(csensors+offset, first, sizeof(sensor) * this->rsensornumber);
-  }
-  if(conf.useSecondD) { // second derivative
-    calcSecondDerivative();
-    int offset = (conf.useId + conf.useFirstD)*this->rsensornumber;
-    memcpy(csensors+offset, second, sizeof(sensor) * this->rsensornumber);
-  }
-
+  sensor* t          = sensorbuffer[time % buffersize];
+  const sensor* tm1  = sensorbuffer[(time-1) % buffersize];
+  const sensor* tm2  = sensorbuffer[(time-2) % buffersize];
+  // the first block gets the noise (id if used, otherwise the first derivative)
+  sensor* idOut     = conf.useId ? csensors : 0;
+  sensor* firstOut  = conf.useFirstD ? csensors + conf.useId*rsensornumber : 0;
+  sensor* secondOut = conf.useSecondD ?
+    csensors + (conf.useId + conf.useFirstD)*rsensornumber : 0;
+  const double eps   = conf.eps;
+  const double scale = conf.derivativeScale;
+  const bool smooth  = conf.useFirstD || conf.useSecondD;
 
-//   int blocksize = conf.useId + conf.useFirstD + conf.useSecondD;
-//   if(conf.useId) { // normal sensors values
-//     memcpy(id, rsensors, sizeof(sensor) * this->rsensornumber);
-//     for(int i=0; i < this->rsensornumber; i++ ){
-//       csensors[i*blocksize] = id[i];
-//     }
-//   }
-
-//   if(conf.useFirstD) { // first derivative
-//     calcFirstDerivative();
-//     int offset = conf.useId;
-//     for(int i=0; i < this->rsensornumber; i++ ){
-//       csensors[i*blocksize+offset] = first[i];
-//     }
-//   }
-//   if(conf.useSecondD) { // second derivative
-//     calcSecondDerivative();
-//     int offset = conf.useId + conf.useFirstD;
-//     for(int i=0; i < this->rsensornumber; i++ ){
-//       csensors[i*blocksize+offset] = second[i];
-//     }
-//   }
-
-  // add noise only to first used sensors
-  for(int i=0; i< rsensornumber; i++){
-    csensors[i] = csensors[i] + noisevals[i];
+  for(int i=0; i < rsensornumber; i++){
+    if(smooth) t[i] = (1-eps)*tm1[i] + eps*rsensors[i];
+    if(idOut)     idOut[i]     = rsensors[i];
+    if(firstOut)  firstOut[i]  = scale*(t[i] - tm1[i]);
+    if(secondOut) secondOut[i] = (t[i] - 2*tm1[i] + tm2[i])*scale*scale;
+    // add noise only to first used sensors
+    csensors[i] += noisevals[i];
   }
 
   if(conf.blindMotors > 0) { // shortcircuit of blind motors
@@ -155,9 +115,7 @@ bool DerivativeWiring::wireSensorsIntern(const sensor* rsensors, int rsensornumb
 }
 
 void DerivativeWiring::reset(){
-  for(int i=0 ; i<buffersize; i++){
-    if(sensorbuffer[i]) memset(sensorbuffer[i],0,sizeof(sensor) * this->rsensornumber);
-  }
+  if(history) memset(history,0,sizeof(sensor) * buffersize * this->rsensornumber);
 }
 
 
@@ -176,24 +134,3 @@ bool DerivativeWiring::wireMotorsIntern(motor* rmotors, int rmotornumber,
   }
   return true;
 }
-
-/// f'(x) = (f(x+1) - f(x-1)) / 2
-//  since we do not have f(x+1) we go one timestep in the past
-void DerivativeWiring::calcFirstDerivative(){
-  sensor* t   = sensorbuffer[time%buffersize];
-  sensor* tmdelay = sensorbuffer[(time-1)%buffersize];
-  for(int i=0; i < rsensornumber; i++){
-    first[i] = conf.derivativeScale*(t[i] - tmdelay[i]);
-  }
-}
-
-/// f'(x) = f(x) - 2f(x-1) + f(x-2)
-void DerivativeWiring::calcSecondDerivative(){
-  sensor* t   = sensorbuffer[time%buffersize];
-  sensor* tmdelay = sensorbuffer[(time-1)%buffersize];
-  sensor* tm2delay = sensorbuffer[(time-2)%buffersize];
-  for(int i=0; i < rsensornumber; i++){
-    second[i] = (t[i] - 2*tmdelay[i] + tm2delay[i])*conf.derivativeScale*conf.derivativeScale;
-  }
-}
-
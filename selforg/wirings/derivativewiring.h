@@ -100,37 +100,23 @@ protected:
                                 const motor* cmotors, int cmotornumber);
 
 protected:
-  /** Calculate the first derivative of the sensorvalues given by the robot
-   *  f'(x) = (f(x+1) - f(x-1)) / 2
-   *  since we do not have f(x+1) we go one timestep in the past
-   */
-  void calcFirstDerivative();
-
-  /** Calculate the secound derivative of the sensorvalues given by the robot
-   *  f'(x) = f(x) - 2f(x-1) + f(x-2)
-   */
-  void calcSecondDerivative();
-
   /// used configuration
   DerivativeWiringConf conf;
-  static const int buffersize=40;
+  /** number of smoothed sensor vectors kept in the history ring.
+      Only the last three are used by the derivatives, so the ring is kept
+      small to stay in cache for large sensor numbers.
+   */
+  static const int buffersize=4;
   int time;
-  /// number timesteps the sensor values are delayed for calculation of the derivative
-  //  int delay;
 
+  /** current and old smoothed sensor values of robot,
+      one contiguous block of buffersize x rsensornumber values
+   */
+  sensor* history;
 
-  /// current and old smoothed sensor values of robot
+  /// rows of the history (pointers into history)
   sensor* sensorbuffer[buffersize];
 
-  /// current sensors (with noise)
-  // sensor* id;
-
-  /// current first derivative
-  sensor* first;
-
-  /// current second derivative
-  sensor* second;
-
   /// array that stored the values of the blind motors
   motor *blindMotors;
 
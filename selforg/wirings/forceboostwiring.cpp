@@ -73,12 +73,14 @@ bool ForceBoostWiring::wireMotorsIntern(motor* rmotors, int rmotornumber,
   assert(rmotornumber == this->rmotornumber);
   assert(cmotornumber == this->cmotornumber);
   if(boost>0){
-    ///
-    Matrix mot(cmotornumber ,1,  cmotors);
-    error += (mot-sens)*boost - error*.001 - (error.map(power3))*0.1;
-    error.toMapP(1.0,clip); // limit error to [-1,1]
-    Matrix rmot = (mot + error).mapP(1.0,clip);
-    rmot.convertToBuffer(rmotors, rmotornumber);
+    // elementwise, without temporary matrices
+    double* e       = (double*)error.unsafeGetData();
+    const double* s = sens.unsafeGetData();
+    for(int i=0; i<cmotornumber; i++){
+      e[i] += (cmotors[i]-s[i])*boost - e[i]*.001 - power3(e[i])*0.1;
+      e[i]  = clip(1.0,e[i]); // limit error to [-1,1]
+      rmotors[i] = clip(1.0,cmotors[i] + e[i]);
+    }
   }else{
     memcpy(rmotors, cmotors, sizeof(motor)*rmotornumber);
   }
@@ -83,7 +83,8 @@ bool One2OneWiring::wireMotorsIntern(motor* rmotors, int rmotornumber,
                                      const motor* cmotors, int cmotornumber){
   assert(rmotornumber == this->rmotornumber);
   assert(cmotornumber == this->cmotornumber);
-  memcpy(rmotors, cmotors, sizeof(motor)*rmotornumber);
+  if(rmotors != cmotors)
+    memcpy(rmotors, cmotors, sizeof(motor)*rmotornumber);
   if(blind)
     memcpy(blindmotors, cmotors+rmotornumber, sizeof(motor)*blind);
   return true;
@@ -43,6 +43,11 @@ public:
    */
   virtual ~One2OneWiring();
 
+  /** without blind channels the wiring is the identity plus noise
+      and can be done in place (unless the bare robot sensors are plotted)
+   */
+  virtual bool wiresInPlace() const { return blind==0 && !(plotMode & Robot); }
+
 protected:
 
   /** initializes the number of sensors and motors on robot side, calculate
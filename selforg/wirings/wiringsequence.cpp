@@ -60,14 +60,47 @@ bool WiringSequence::initIntern(){
   assert(wirings.size());
   int snum = rsensornumber;
   int mnum = rmotornumber;
-  FOREACH(vector<AbstractWiring*>, wirings, w){
+  int num  = wirings.size();
+  for(int i=0; i<num; i++){
     // initialize the wiring with the output of the last wiring
-    (*w)->init(snum,mnum, randGen);
-    snum  = (*w)->getControllerSensornumber();
-    mnum  = (*w)->getControllerMotornumber();
+    wirings[i]->init(snum,mnum, randGen);
+    snum  = wirings[i]->getControllerSensornumber();
+    mnum  = wirings[i]->getControllerMotornumber();
   }
   csensornumber = snum;
   cmotornumber  = mnum;
+
+  // flatten the sequence: a stage that wires in place shares its buffer with
+  //  the stage before it (sensors) or after it (motors), so the chain is
+  //  computed in as few passes over as few buffers as possible.
+  //  A negative offset denotes the external array (csensors, rmotors).
+  vector<long> soffsets(num, -1);
+  vector<long> moffsets(num, -1);
+  size_t total = 0;
+  for(int i=num-2; i>=0; i--){
+    if(wirings[i+1]->wiresInPlace()){
+      soffsets[i] = soffsets[i+1];
+    }else{
+      soffsets[i] = total;
+      total += wirings[i]->getControllerSensornumber();
+    }
+  }
+  for(int i=1; i<num; i++){
+    if(wirings[i-1]->wiresInPlace()){
+      moffsets[i] = moffsets[i-1];
+    }else{
+      moffsets[i] = total;
+      total += wirings[i]->getRobotMotornumber();
+    }
+  }
+
+  buffers.assign(total, 0);
+  sensorbufs.assign(num, (sensor*)0);
+  motorbufs.assign(num, (motor*)0);
+  for(int i=0; i<num; i++){
+    if(soffsets[i]>=0) sensorbufs[i] = buffers.data() + soffsets[i];
+    if(moffsets[i]>=0) motorbufs[i]  = buffers.data() + moffsets[i];
+  }
   initialised=true;
   return true;
 }
@@ -80,18 +113,11 @@ bool WiringSequence::wireSensorsIntern(const sensor* rsensors, int rsensornumber
 
   const sensor* inp =  rsensors;
   int inp_s = rsensornumber;
-  sensor* sensorbuf;
   int num = wirings.size();
   for(int i=0; i< num; i++){
     int d = wirings[i]->getControllerSensornumber();
-    if(i==num-1){
-      sensorbuf = csensors;
-      assert(d == csensornumber);
-    }else{
-      sensorbuf = new sensor[d];
-    }
+    sensor* sensorbuf = sensorbufs[i] ? sensorbufs[i] : csensors;
     wirings[i]->wireSensors(inp, inp_s, sensorbuf, d, noiseStrength);
-    if(i!=0) delete[] inp; // delete buffer, but not in first round
     inp   = sensorbuf;
     inp_s = d;
   }
@@ -105,22 +131,14 @@ bool WiringSequence::wireMotorsIntern(motor* rmotors, int rmotornumber,
 
   const motor* inp =  cmotors;
   int inp_s = cmotornumber;
-  motor* motorbuf;
   int num = wirings.size();
   for(int i=num-1; i>=0; i--){
     int d = wirings[i]->getRobotMotornumber();
-    if(i==0){
-      motorbuf = rmotors;
-      assert(d == rmotornumber);
-    }else{
-      motorbuf = new motor[d];
-    }
+    motor* motorbuf = motorbufs[i] ? motorbufs[i] : rmotors;
     wirings[i]->wireMotors(motorbuf, d, inp, inp_s);
-    if(i!=num-1) delete[] inp; // delete buffer, but not in first round
     inp   = motorbuf;
     inp_s = d;
   }
   return true;
 
 }
-
@@ -27,7 +27,14 @@
 #include "abstractwiring.h"
 #include <vector>
 
-/** Implements a sequence of wirings
+/** Implements a sequence of wirings.
+    All intermediate sensor and motor buffers between the stages are
+    allocated once at initialisation in one contiguous block, so that
+    wiring a step does not allocate. Stages that wire in place
+    (see AbstractWiring::wiresInPlace(), e.g. One2OneWiring) are fused with
+    their neighbour: e.g. a DerivativeWiring followed by a One2OneWiring
+    writes directly into the controller sensors, to which the noise of the
+    second stage is then added in one bulk pass.
  */
 class WiringSequence :public AbstractWiring{
 public:
@@ -63,6 +70,13 @@ protected:
   std::vector<AbstractWiring*> wirings;
   bool initialised;
 
+  /// storage for all intermediate buffers
+  std::vector<double> buffers;
+  /// sensorbufs[i] is the output of stage i (0: csensors)
+  std::vector<sensor*> sensorbufs;
+  /// motorbufs[i] is the robot side of stage i (0: rmotors)
+  std::vector<motor*> motorbufs;
+
 };
 
 #endif